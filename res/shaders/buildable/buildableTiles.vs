@@ -3,7 +3,7 @@
 layout (location = 0) in vec4 i_pos;
 layout (location = 1) in vec4 i_translation;
 
-uniform mat4 u_projectionView;
+@include frameUniforms.ivs
 
 void main()
 {
@@ -7,7 +7,7 @@ and is to be cut out from the project in release time
 
 layout (location = 0) in vec3 i_pos;
 
-uniform mat4 u_projectionView;
+@include frameUniforms.ivs
 
 void main()
 {
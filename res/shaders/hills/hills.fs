@@ -19,13 +19,12 @@ uniform float     u_normalMapTilingReciprocal;
 uniform float     u_mapDimensionReciprocal;
 //u_maxHillHeight - used in createCanyonRings function
 uniform float     u_maxHillHeight;
-uniform vec3      u_lightDir;
+@include frameUniforms.ivs
 uniform bool      u_shadowEnable;
 //u_debugRenderMode - project temporal flag to bypass all other shading
 uniform bool      u_debugRenderMode;
 uniform float     u_ambientDay;
 uniform float     u_ambientNight;
-uniform vec3      u_viewPosition;
 
 const vec3  NORMAL = vec3( 0.0, 1.0, 0.0 );
 //VERTEX_NORMAL_INFLUENCE_HILL(LAND) - define impact vertex normal has on the resulting normal
@@ -1,10 +1,8 @@
 #version 450
 
-layout (location = 0) in vec3 i_pos;
-layout (location = 1) in vec2 i_texCoords;
-layout (location = 2) in vec3 i_normal;
-layout (location = 3) in vec3 i_tangent;
-layout (location = 4) in vec3 i_bitangent;
+layout (location = 0) in uint  i_gridPosition;
+layout (location = 1) in float i_height;
+layout (location = 2) in uint  i_normal;
 
 /*
 is using for land/hills texture splatting "randomization"
@@ -14,13 +12,13 @@ keep it in range[0;1]
 const float TERRAIN_TYPE_HEIGHT_DAMP_FACTOR = 0.75;
 const float SPECULAR_SHININESS = 64.0;
 
-uniform mat4        u_projectionView;
-uniform vec3        u_lightDir;
+@include frameUniforms.ivs
 //u_mapDimensionReciprocal - used for different tiling techniques
 uniform float       u_mapDimensionReciprocal;
+//u_textureTilingDimension - number of tiles covered by one hill texture quad along each axis
+uniform int         u_textureTilingDimension;
 //u_diffuseMixMap - is using for land/hills texture splatting "randomization"
 uniform sampler2D   u_diffuseMixMap;
-uniform vec3        u_viewPosition;
 
 out vec3  v_FragPos;
 out vec3  v_Normal;
@@ -38,20 +36,27 @@ but rather one that is rotated -90 degrees around X axis
 */
 out mat3  v_TNB;
 
+@include terrainVertex.ivs
+
 void main()
 {
-    gl_Position = u_projectionView * vec4( i_pos, 1.0 );
+    vec3 position = ext_unpackTerrainPosition( i_gridPosition, i_height );
+    vec3 normal = ext_unpackTerrainNormal( i_normal );
+    vec3 tangent, bitangent;
+    ext_createTerrainTangentFrame( normal, tangent, bitangent );
+    gl_Position = u_projectionView * vec4( position, 1.0 );
 
-    v_FragPos = i_pos;
-    v_Normal = i_normal;
-    v_TexCoords = i_texCoords;
-    v_TNB = mat3( i_tangent, i_normal, i_bitangent );
+    v_FragPos = position;
+    v_Normal = normal;
+    //texture coordinates grow continuously across the map, the texture is sampled in repeat mode
+    v_TexCoords = vec2( position.x + 1.0, -position.z ) / float( u_textureTilingDimension );
+    v_TNB = mat3( tangent, normal, bitangent );
 
-    float terrainSplattingRatio = texture( u_diffuseMixMap, i_pos.xz * u_mapDimensionReciprocal + 0.5 ).g;
-    v_TerrainTypeMix = i_pos.y * ( 1.0 - terrainSplattingRatio * TERRAIN_TYPE_HEIGHT_DAMP_FACTOR );
+    float terrainSplattingRatio = texture( u_diffuseMixMap, position.xz * u_mapDimensionReciprocal + 0.5 ).g;
+    v_TerrainTypeMix = position.y * ( 1.0 - terrainSplattingRatio * TERRAIN_TYPE_HEIGHT_DAMP_FACTOR );
 
     //specular component
-    vec3 lightDirReflected = reflect( -u_lightDir, i_normal );
-    vec3 viewDirection = normalize( u_viewPosition - i_pos );
+    vec3 lightDirReflected = reflect( -u_lightDir, normal );
+    vec3 viewDirection = normalize( u_viewPosition - position );
     v_SpecularComponent = pow( max( dot( lightDirReflected, viewDirection ), 0.0 ), SPECULAR_SHININESS );
 }
@@ -8,7 +8,7 @@ in vec2 v_TexCoords;
 uniform sampler2D u_landDiffuse[2];
 uniform sampler2D u_diffuseMixMap;
 uniform sampler2D u_normalMap;
-uniform vec3      u_lightDir;
+@include frameUniforms.ivs
 uniform float     u_mapDimensionReciprocal;
 uniform float     u_normalMapTilingReciprocal;
 uniform bool      u_shadowEnable;
@@ -2,17 +2,21 @@
 
 layout (location = 0) in vec4 i_pos;
 layout (location = 1) in vec2 i_texCoords;
-layout (location = 2) in vec4 i_instanceTranslation;
+layout (location = 2) in vec4 i_instanceRectangle;
 
-uniform mat4 u_projectionView;
+@include frameUniforms.ivs
 
 out vec2 v_TexCoords;
 out vec3 v_FragPos;
 
 void main()
 {
-    vec4 worldPosition = i_pos + i_instanceTranslation;
+    //unit quad is scaled to the instance rectangle: world position of its corner (xy) and its size (zw)
+    vec4 worldPosition = vec4( i_instanceRectangle.x + i_pos.x * i_instanceRectangle.z,
+                               i_pos.y,
+                               i_instanceRectangle.y + i_pos.z * i_instanceRectangle.w,
+                               1.0 );
     gl_Position = u_projectionView * worldPosition;
     v_FragPos = vec3(worldPosition);
-    v_TexCoords = i_texCoords;
+    v_TexCoords = i_texCoords * i_instanceRectangle.zw;
 }
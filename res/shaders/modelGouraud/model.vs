@@ -15,9 +15,7 @@ layout (location = 9) in uvec2 i_texIndices;
 const float MAX_ANIMATION_DISTANCE = 30.0;
 const float SPECULAR_SHININESS = 4.0;
 
-uniform mat4  u_projectionView;
-uniform vec3  u_lightDir;
-uniform vec3  u_viewPosition;
+@include frameUniforms.ivs
 uniform float u_ambientDay;
 
 out vec2        v_TexCoords;
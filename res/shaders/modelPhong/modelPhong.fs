@@ -13,13 +13,12 @@ flat in uvec2   v_TexIndices;
 uniform uint64_t  u_textureDiffuse[200];
 uniform uint64_t  u_textureSpecular[150];
 uniform bool      u_shadow;
-uniform vec3      u_lightDir;
+@include frameUniforms.ivs
 uniform bool      u_shadowEnable;
 uniform bool      u_useLandBlending;
 uniform int       u_type;
 uniform float     u_ambientDay;
 uniform float     u_ambientNight;
-uniform vec3      u_viewPosition;
 uniform bool      u_isLowPoly;
 uniform float	  u_landBlendingAlphaValueScaler;
 uniform int		  u_loadDistance;
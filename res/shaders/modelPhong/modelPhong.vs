@@ -14,8 +14,7 @@ layout (location = 9) in uvec2 i_texIndices;
 
 const float MAX_ANIMATION_DISTANCE = 30.0;
 
-uniform mat4  u_projectionView;
-uniform vec3  u_viewPosition;
+@include frameUniforms.ivs
 
 out vec2        v_TexCoords;
 out vec3        v_Normal;
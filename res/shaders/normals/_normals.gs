@@ -8,7 +8,7 @@ and is to be cut out from the project in release time
 layout (points) in;
 layout (line_strip, max_vertices = 6) out;
 
-uniform mat4 u_projectionView;
+@include frameUniforms.ivs
 
 in vec3 v_Normal[];
 in vec3 v_Tangent[];
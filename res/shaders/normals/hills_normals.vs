@@ -5,24 +5,26 @@ and is to be cut out from the project in release time
 
 #version 450
 
-layout (location = 0) in vec4 i_pos;
-layout (location = 2) in vec3 i_normal;
-layout (location = 3) in vec3 i_tangent;
-layout (location = 4) in vec3 i_bitangent;
+layout (location = 0) in uint  i_gridPosition;
+layout (location = 1) in float i_height;
+layout (location = 2) in uint  i_normal;
 
-uniform mat4        u_projectionView;
+@include frameUniforms.ivs
 uniform sampler2D   u_normalMap;
 
 out vec3 v_Normal;
 out vec3 v_Tangent;
 out vec3 v_Bitangent;
 
+@include terrainVertex.ivs
+
 void main()
 {
-    gl_Position = u_projectionView * i_pos;
-    vec3 ShadingNormal = texture( u_normalMap, i_pos.xz * 0.125 ).xzy;
+    vec3 position = ext_unpackTerrainPosition( i_gridPosition, i_height );
+    vec3 normal = ext_unpackTerrainNormal( i_normal );
+    gl_Position = u_projectionView * vec4( position, 1.0 );
+    vec3 ShadingNormal = texture( u_normalMap, position.xz * 0.125 ).xzy;
     ShadingNormal.xyz -= vec3(0.5);
-    v_Normal = normalize( i_normal + ShadingNormal );
-    v_Tangent = normalize(i_tangent);
-    v_Bitangent = normalize(i_bitangent);
+    v_Normal = normalize( normal + ShadingNormal );
+    ext_createTerrainTangentFrame( normal, v_Tangent, v_Bitangent );
 }
@@ -5,20 +5,24 @@ and is to be cut out from the project in release time
 
 #version 450
 
-layout (location = 0) in vec4 i_pos;
-layout (location = 1) in vec3 i_normal;
+layout (location = 0) in uint  i_gridPosition;
+layout (location = 1) in float i_height;
+layout (location = 2) in uint  i_normal;
 
-uniform mat4        u_projectionView;
+@include frameUniforms.ivs
 uniform sampler2D   u_normalMap;
 
 out vec3 v_Normal;
 out vec3 v_Tangent; //unused
 out vec3 v_Bitangent; //unused
 
+@include terrainVertex.ivs
+
 void main()
 {
-    gl_Position = u_projectionView * i_pos;
-    vec3 ShadingNormal = texture( u_normalMap, i_pos.xz * 0.125 ).xzy;
+    vec3 position = ext_unpackTerrainPosition( i_gridPosition, i_height );
+    gl_Position = u_projectionView * vec4( position, 1.0 );
+    vec3 ShadingNormal = texture( u_normalMap, position.xz * 0.125 ).xzy;
     ShadingNormal.xyz -= vec3(0.5);
-    v_Normal = normalize( i_normal + ShadingNormal );
+    v_Normal = normalize( ext_unpackTerrainNormal( i_normal ) + ShadingNormal );
 }
@@ -2,7 +2,7 @@
 
 layout (location = 0) in vec4 i_pos;
 
-uniform mat4 u_projectionView;
+@include frameUniforms.ivs
 uniform vec4 u_translation;
 
 void main()
@@ -5,7 +5,7 @@ const int NUM_LAYERS = 3;
 layout (triangles) in;
 layout (triangle_strip, max_vertices = NUM_LAYERS * 3) out;
 
-uniform mat4 u_lightSpaceMatrix[NUM_LAYERS];
+@include frameUniforms.ivs
 
 void main()
 {
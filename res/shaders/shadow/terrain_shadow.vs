@@ -1,13 +1,16 @@
 #version 450
 
-layout (location = 0) in vec4 i_pos;
-layout (location = 2) in vec3 i_normal;
+layout (location = 0) in uint  i_gridPosition;
+layout (location = 1) in float i_height;
+layout (location = 2) in uint  i_normal;
 
 uniform int u_terrainType;
 
+@include terrainVertex.ivs
+
 void main()
 {
-	vec4 pos = i_pos;
+	vec4 pos = vec4( ext_unpackTerrainPosition( i_gridPosition, i_height ), 1.0 );
 	if( u_terrainType == 0 )
 	{
 		//slightly change y coord for smoother shadows at surface edges
@@ -28,7 +31,7 @@ void main()
 		//slightly change y coord for smoother shadows at surface edges
 		pos.y -= 0.045;
 		//for shore move fragment on the opposite of the normal X direction 
-		if ( i_normal.x > 0 )
+		if ( ext_unpackTerrainNormal( i_normal ).x > 0 )
 		{
 			pos.x -= 0.08;
 		}
@@ -16,13 +16,12 @@ uniform sampler2D u_bottomReliefDiffuse;
 uniform float     u_normalMapTilingReciprocal;
 uniform float     u_mapDimensionReciprocal;
 uniform sampler2D u_normalMap;
-uniform vec3      u_lightDir;
+@include frameUniforms.ivs
 uniform bool      u_shadowEnable;
 //u_debugRenderMode - project temporal flag to bypass all other shading
 uniform bool      u_debugRenderMode;
 uniform float     u_ambientDay;
 uniform float     u_ambientNight;
-uniform vec3      u_viewPosition;
 
 const vec3  NORMAL = vec3( 0.0, 1.0, 0.0 );
 const float MAX_DESATURATING_VALUE_LAND = 0.5;
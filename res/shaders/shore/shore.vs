@@ -1,10 +1,10 @@
 #version 450
 
-layout (location = 0) in vec4 i_pos;
-layout (location = 1) in vec2 i_texCoords;
-layout (location = 2) in vec3 i_normal;
+layout (location = 0) in uint  i_gridPosition;
+layout (location = 1) in float i_height;
+layout (location = 2) in uint  i_normal;
 
-uniform mat4      u_projectionView;
+@include frameUniforms.ivs
 uniform float     u_mapDimensionReciprocal;
 uniform sampler2D u_diffuseMixMap;
 uniform float     u_underwaterSurfaceLevel;
@@ -26,26 +26,30 @@ out float v_ShoreLandMix;
 out float v_ShoreUnderwaterMix;
 out vec3  v_Normal;
 
+@include terrainVertex.ivs
+
 void main()
 {
-    gl_Position = u_projectionView * i_pos;
+    vec4 position = vec4( ext_unpackTerrainPosition( i_gridPosition, i_height ), 1.0 );
+    gl_Position = u_projectionView * position;
     if(u_useClipDistanceReflection)
 	{
-        gl_ClipDistance[0] = dot( CLIP_PLANE_REFLECTION, i_pos );
+        gl_ClipDistance[0] = dot( CLIP_PLANE_REFLECTION, position );
 	}
     if(u_useClipDistanceRefraction)
 	{
-        gl_ClipDistance[0] = dot( CLIP_PLANE_REFRACTION, i_pos );
+        gl_ClipDistance[0] = dot( CLIP_PLANE_REFRACTION, position );
 	}
 
-    v_FragPos = i_pos.xyz;
-    v_TexCoords = i_texCoords;
-    v_Normal = i_normal;
+    v_FragPos = position.xyz;
+    //one texture quad per tile, the texture is sampled in repeat mode
+    v_TexCoords = vec2( position.x, -position.z );
+    v_Normal = ext_unpackTerrainNormal( i_normal );
 
-	float terrainSplattingOffset = texture( u_diffuseMixMap, i_pos.xz * u_mapDimensionReciprocal * 0.125 + 0.5 ).g * 2;
+	float terrainSplattingOffset = texture( u_diffuseMixMap, position.xz * u_mapDimensionReciprocal * 0.125 + 0.5 ).g * 2;
 	terrainSplattingOffset = max( terrainSplattingOffset, 0.6 );
-	v_ShoreLandMix = 0.4 + i_pos.y * TERRAIN_TYPE_HEIGHT_DAMP_FACTOR + terrainSplattingOffset;
+	v_ShoreLandMix = 0.4 + position.y * TERRAIN_TYPE_HEIGHT_DAMP_FACTOR + terrainSplattingOffset;
 
     //for this its okay to clamp in a vertex shader stage
-    v_ShoreUnderwaterMix = 1.0 - clamp( ( i_pos.y + u_underwaterSurfaceLevel ) * 0.5 - 0.1, 0.0, 1.0 );
+    v_ShoreUnderwaterMix = 1.0 - clamp( ( position.y + u_underwaterSurfaceLevel ) * 0.5 - 0.1, 0.0, 1.0 );
 }
@@ -8,7 +8,7 @@ uniform samplerCube u_skyboxColor[2];
 uniform samplerCube u_skyboxNormals[2];
 //u_type - defines what kind of skybox is being rendered
 uniform int         u_type;
-uniform vec3        u_lightDir;
+@include frameUniforms.ivs
 uniform float       u_ambientDay;
 uniform float       u_ambientNight;
 
@@ -4,8 +4,7 @@ layout (location = 0) in vec3 i_pos;
 
 out vec3 v_TexCoords;
 
-uniform mat4  u_projectionView;
-uniform vec3  u_viewPosition;
+@include frameUniforms.ivs
 //u_type - defines what kind of skybox is being rendered
 uniform int   u_type;
 
@@ -19,7 +18,7 @@ void main()
 	//apply some parallax to skybox position depending on the view position
     vec3 newPos = i_pos - u_viewPosition * ( PARALLAX_SCROLLING_OFFSET + u_type * PARALLAX_SCROLLING_OFFSET );
 
-    vec4 correctPosition = u_projectionView * vec4( newPos, 1.0 );
+    vec4 correctPosition = u_ambienceProjectionView * vec4( newPos, 1.0 );
     //use W as Z, so after perspective division we get Z as 1.0
     gl_Position = correctPosition.xyww;
 }
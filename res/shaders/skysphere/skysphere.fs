@@ -5,7 +5,7 @@ out vec4 o_FragColor;
 uniform sampler2D u_theSunAmbientLightingDiffuse;
 uniform sampler2D u_starsDiffuse;
 uniform sampler2D u_cloudsDiffuse;
-uniform vec3      u_lightDir;
+@include frameUniforms.ivs
 uniform float	  u_sunPositionAttenuation;
 //u_type - defines what kind of skysphere is being rendered
 uniform int       u_type;
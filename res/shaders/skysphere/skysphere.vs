@@ -4,9 +4,8 @@ layout (location = 0) in vec4  i_pos;
 layout (location = 1) in vec3  i_normal;
 layout (location = 2) in vec2  i_texCoords;
 
-uniform mat4 u_projectionView;
+@include frameUniforms.ivs
 uniform mat4 u_model;
-uniform vec3 u_lightDir;
 //u_type - defines what kind of skysphere is being rendered
 uniform int  u_type;
 
@@ -39,7 +38,7 @@ void main()
     position.y += positionVerticalOffset;
 
     //use W as Z, so after perspective division we get Z as 1.0
-    gl_Position = ( u_projectionView * position ).xyww;
+    gl_Position = ( u_ambienceProjectionView * position ).xyww;
     v_TexCoords = i_texCoords;
     v_Normal = mat3(u_model) * i_normal;
 }
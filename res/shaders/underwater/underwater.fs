@@ -10,7 +10,7 @@ uniform sampler2D u_bottomReliefDiffuse;
 uniform sampler2D u_normalMap;
 uniform float     u_normalMapTilingReciprocal;
 uniform float     u_mapDimensionReciprocal;
-uniform vec3      u_lightDir;
+@include frameUniforms.ivs
 uniform float     u_ambientDay;
 uniform float     u_ambientNight;
 uniform bool	  u_useDesaturation;
@@ -3,7 +3,7 @@
 layout (location = 0) in vec4 i_pos;
 layout (location = 1) in vec2 i_texCoords;
 
-uniform mat4 u_projectionView;
+@include frameUniforms.ivs
 
 out vec2  v_TexCoords;
 out vec2  v_FragPosXZ;
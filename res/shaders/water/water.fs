@@ -11,8 +11,7 @@ uniform sampler2D   u_reflectionMap;
 uniform sampler2D   u_refractionMap;
 uniform sampler2D   u_refractionDepthMap;
 uniform float       u_normalMapTilingReciprocal;
-uniform vec3        u_lightDir;
-uniform vec3        u_viewPosition;
+@include frameUniforms.ivs
 //u_debugRenderMode - project temporal flag to bypass all other shading
 uniform bool        u_debugRenderMode;
 uniform float       u_ambientDay;
@@ -1,19 +1,29 @@
 #version 450
 
-layout (location = 0) in vec3 i_pos;
-layout (location = 0, component = 3) in float i_animationOffset;
+layout (location = 0) in uint  i_gridPosition;
+layout (location = 1) in float i_height;
 
-uniform mat4  u_projectionView;
+@include frameUniforms.ivs
 uniform float u_time;
+//u_worldHalfDimensions - offset from the world center based grid to the map origin based one
+uniform vec2  u_worldHalfDimensions;
 
 out vec3  v_FragPos;
 
+//keep in sync with WaterGenerator::WAVE_AMPLITUDE which is used to estimate levels of detail error
 const float WAVE_AMPLITUDE = 0.0825;
+//pair of map position coordinates is crunched into a phase of water animation
+const float X_POS_ANIM_MULTIPLIER = 15.11;
+const float X_POS_ANIM_OFFSET = 121.197;
+
+@include terrainVertex.ivs
 
 void main()
 {
-    vec3 animatedPos = i_pos;
-    animatedPos.y += sin( u_time + i_animationOffset ) * WAVE_AMPLITUDE;
+    vec3 animatedPos = ext_unpackTerrainPosition( i_gridPosition, i_height );
+    vec2 mapPosition = animatedPos.xz + u_worldHalfDimensions;
+    float animationOffset = mapPosition.x * X_POS_ANIM_MULTIPLIER + mapPosition.y * ( mapPosition.x + X_POS_ANIM_OFFSET );
+    animatedPos.y += sin( u_time + animationOffset ) * WAVE_AMPLITUDE;
     gl_Position = u_projectionView * vec4( animatedPos, 1.0 );
     v_FragPos = animatedPos;
 }
@@ -24,11 +24,18 @@
 #include "DirectoriesSettings"
 #include "ScreenResolution"
 #include "RendererState"
+#include "UploadManager"
 #include "Shader"
 #include "SettingsManager"
+#include "RandomStream"
+#include "Logger"
+
+#include <chrono>
+#include <fstream>
+#include <string>
 
 /**
-* @brief plain ctor. Creates all the submodules, sets randomizer seed
+* @brief plain ctor. Creates all the submodules, sets world seed
 * @param window window of the game
 * @param screenResolution current resolution of the screen
 */
@@ -59,13 +66,16 @@ Game::Game( GLFWwindow * window,
 	, scene( shaderManager, options, textureManager, screenResolution, shadowVolume )
 	, shadowVolumeRenderer( shadowVolume )
 	, saveLoadManager( scene, camera, shadowCamera )
+	, worldCache( scene )
 	, keyboard( window, camera, shadowCamera, options, scene.getSunFacade() )
 	, mouseInput( MouseInputManager::getInstance() )
 	, textManager( "data\\font.fnt", "font.png", shaderManager.get( SHADER_FONT ), screenResolution )
 	, setupCompleted( false )
 	, mouseInputCallbacksInitialized( false )
 {
-	srand( time( nullptr ) );
+	const int CONFIG_WORLD_SEED = SettingsManager::getInt( "SCENE", "world_seed" );
+	RandomStream::setWorldSeed( CONFIG_WORLD_SEED != 0 ? (uint32_t)CONFIG_WORLD_SEED : RandomStream::generateWorldSeed() );
+	Logger::log( "world seed: %\n", std::to_string( RandomStream::getWorldSeed() ).c_str() );
 	Model::bindTextureLoader( textureLoader );
 
 	//setup shadow volume projections
@@ -82,6 +92,10 @@ Game::Game( GLFWwindow * window,
 	//threads stuff
 	modelsIndirectBufferPrepared = false;
 	modelsIndirectBufferNeedUpdate = false;
+	modelsIndirectBufferUpdateTime = 0;
+	plantsOcclusionReused = 0;
+	plantsOcclusionTested = 0;
+	plantsOcclusionDeferred = 0;
 	landIndirectBufferHasUpdated = false;
 }
 
@@ -92,6 +106,7 @@ Game::~Game()
 {
 	meshIndirectBufferUpdater->join();
 	BindlessTextureManager::makeAllNonResident();
+	UploadManager::getInstance().release();
 }
 
 /**
@@ -101,7 +116,17 @@ void Game::setup()
 {
 	Shader::setCachingOfUniformsMode( true );
 	RendererState::setInitialRenderingState( options[OPT_USE_MULTISAMPLING] );
-	scene.setup();
+
+	//generated world might be taken from the cache, report startup time for both cases to see the difference
+	const auto WORLD_SETUP_START_TIME = std::chrono::steady_clock::now();
+	const bool WORLD_FROM_CACHE = worldCache.load();
+	if( !WORLD_FROM_CACHE )
+	{
+		scene.setup();
+		worldCache.store();
+	}
+	const auto WORLD_SETUP_DURATION = std::chrono::duration<float, std::milli>( std::chrono::steady_clock::now() - WORLD_SETUP_START_TIME );
+	Logger::log( "world ready in % ms (% start)\n", std::to_string( WORLD_SETUP_DURATION.count() ).c_str(), WORLD_FROM_CACHE ? "warm" : "cold" );
 	MouseInputManager::initialize( window, options, screenResolution, camera, shadowCamera );
 	BindlessTextureManager::makeAllResident();
 	BindlessTextureManager::loadToShader( shaderManager.get( SHADER_MODELS_GOURAUD ), BINDLESS_TEXTURE_MODEL );
@@ -174,7 +199,7 @@ void Game::loop()
 	{
 		if( !landIndirectBufferHasUpdated )
 		{
-			scene.getLandFacade().updateCellsIndirectBuffer( viewFrustum );
+			scene.getLandFacade().updateIndirectBuffer( viewFrustum );
 			landIndirectBufferHasUpdated = true;
 		}
 		else
@@ -185,7 +210,7 @@ void Game::loop()
 	modelsIndirectBufferPrepared = false;
 	if( !landIndirectBufferHasUpdated )
 	{
-		scene.getLandFacade().updateCellsIndirectBuffer( viewFrustum );
+		scene.getLandFacade().updateIndirectBuffer( viewFrustum );
 	}
 
 	//world recreation routine
@@ -194,11 +219,15 @@ void Game::loop()
 		recreate();
 	}
 
-	/*
-	* by this time model indirect buffer updater thread has prepared data, so buffer them to GPU.
-	* This also should be done before any draw call that uses that data, even draw call to depthmap
-	*/
-	scene.getPlantsFacade().updateIndirectBufferData();
+	//terrain levels of detail depend on the distance from the camera and on how large a world unit looks on the screen
+	const float TERRAIN_LOD_PROJECTION_SCALE = screenResolution.getHeight() / ( 2.0f * glm::tan( glm::radians( camera.getZoom() ) * 0.5f ) );
+	scene.updateTerrainLevelsOfDetail( camera.getPosition(), TERRAIN_LOD_PROJECTION_SCALE, viewFrustum, cullingViewFrustum );
+
+	//per-frame shader data shared by all the shader programs, reflection view is only needed if water is to be reflected
+	updateFrameUniforms( projectionView );
+
+	//all the data uploaded by this moment (including world recreation) should be copied before the first draw call
+	UploadManager::getInstance().flush();
 
 	//save some processing time by updating depthmap every two frames
 	if( options[OPT_USE_SHADOWS] && updateCount % 2 )
@@ -212,19 +241,23 @@ void Game::loop()
 	*/
 	if( scene.getWaterFacade().hasWaterInFrame() )
 	{
+		RendererState::beginPass( RENDER_PASS_REFLECTION );
 		reflectionFramebuffer.bindToViewport( SettingsManager::getInt( "GRAPHICS", "frame_water_reflection_width" ),
 											  SettingsManager::getInt( "GRAPHICS", "frame_water_reflection_height" ) );
 		drawFrameReflection();
+		RendererState::beginPass( RENDER_PASS_REFRACTION );
 		refractionFramebuffer.bindToViewport( SettingsManager::getInt( "GRAPHICS", "frame_water_refraction_width" ),
 											  SettingsManager::getInt( "GRAPHICS", "frame_water_refraction_height" ) );
-		drawFrameRefraction( projectionView );
+		drawFrameRefraction();
 		refractionFramebuffer.unbindToViewport( screenResolution.getWidth(), screenResolution.getHeight() );
 	}
 
 	//render the whole scene onto appropriate FBO, depend on multisampling option
 	bool multisamplingEnabled = options[OPT_USE_MULTISAMPLING];
+	RendererState::beginPass( RENDER_PASS_MAIN );
 	screenFramebuffer.bindAppropriateFBO( multisamplingEnabled );
-	drawFrame( projectionView );
+	drawFrame();
+	RendererState::beginPass( RENDER_PASS_POSTPROCESS );
 	screenFramebuffer.draw( multisamplingEnabled, options[OPT_USE_DOF], options[OPT_USE_VIGNETTE] );
 
 	//save/load routines
@@ -236,62 +269,96 @@ void Game::loop()
 	{
 		loadState();
 	}
+	if( options[OPT_SAVE_BENCHMARK_REQUEST] )
+	{
+		benchmarkSaveFormats();
+	}
 
 	//wait for buffer swapping
 	glfwSwapBuffers( window );
+	UploadManager::getInstance().finishFrame();
+	RendererState::finishFrame();
+	BufferCollection::finishFrame();
+	Shader::finishFrame();
 
 	//frame is complete
 	++updateCount;
 }
 
 /**
-* @brief prepares OpenGL state to new rendering cycle and manages rendering order of the "onscreen" elements (scene, gui etc.)
+* @brief uploads camera views and lighting data of the frame shared by all the shader programs,
+* shadow data is uploaded separately whenever depthmap is updated
 * @param projectionView "projection * view" matrix
 */
-void Game::drawFrame( const glm::mat4 & projectionView )
+void Game::updateFrameUniforms( const glm::mat4 & projectionView )
+{
+	FrameUniforms & frameUniforms = scene.getFrameUniforms();
+	frameUniforms.updateCamera( CAMERA_VIEW_MAIN,
+								projectionView,
+								projection * glm::mat4( camera.getViewMatrixMat3() ),
+								camera.getPosition() );
+	if( scene.getWaterFacade().hasWaterInFrame() )
+	{
+		const glm::mat4 VIEW_REFLECTED = camera.getReflectionViewMatrix();
+		glm::vec3 reflectedViewPosition = camera.getPosition();
+		reflectedViewPosition.y *= -1;
+		frameUniforms.updateCamera( CAMERA_VIEW_REFLECTION,
+									projection * VIEW_REFLECTED,
+									projection * glm::mat4( glm::mat3( VIEW_REFLECTED ) ),
+									reflectedViewPosition );
+	}
+	frameUniforms.updateLighting( scene.getSunFacade().getLightDir() );
+}
+
+/**
+* @brief prepares OpenGL state to new rendering cycle and manages rendering order of the "onscreen" elements (scene, gui etc.)
+*/
+void Game::drawFrame()
 {
 	glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
-	glPolygonMode( GL_FRONT_AND_BACK, options[OPT_POLYGON_LINE] ? GL_LINE : GL_FILL );
+	RendererState::setPolygonMode( options[OPT_POLYGON_LINE] ? GL_LINE : GL_FILL );
 
 	if( options[OPT_CSM_VISUALIZATION] )
 	{
-		drawFrustumVisualizations( projectionView );
+		drawFrustumVisualizations();
 	}
 
-	scene.drawWorld( projectionView,
-					 projection * glm::mat4( camera.getViewMatrixMat3() ),
-					 viewFrustum,
-					 cullingViewFrustum,
+	scene.drawWorld( projection * glm::mat4( camera.getViewMatrixMat3() ),
 					 camera,
 					 mouseInput );
 
 	/*
 	* after all mesh related draw calls we could start updating meshes indirect data buffers
-	* start updating right after we've used it and before we need that data to be updated and buffered again
+	* start updating right after we've used it and before we need that data to be updated again.
+	* Commands of this frame are fenced and the next frame commands are written to the next region of the ring
 	*/
+	scene.getIndirectCommandRing().advance();
 	modelsIndirectBufferNeedUpdate = true;
 	modelsIndirectBufferNeedUpdateCV.notify_all();
 
 	if( options[OPT_DRAW_DEBUG_TEXT] )
 	{
-		textManager.addDebugText( camera, options, mouseInput, scene.getSunFacade().getPosition(), CPU_timer.getFPS() );
+		ChunkOcclusionStatistics plantsOcclusionStatistics;
+		plantsOcclusionStatistics.numReused = plantsOcclusionReused;
+		plantsOcclusionStatistics.numTested = plantsOcclusionTested;
+		plantsOcclusionStatistics.numDeferred = plantsOcclusionDeferred;
+		textManager.addDebugText( camera, options, mouseInput, scene.getSunFacade().getPosition(), CPU_timer.getFPS(), modelsIndirectBufferUpdateTime, plantsOcclusionStatistics );
 		textManager.drawText();
 		csRenderer.draw( camera.getViewMatrixMat3(), screenResolution.getAspectRatio() );
 	}
 
-	glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
+	RendererState::setPolygonMode( GL_FILL );
 }
 
 /**
-* @brief manages frustum visualization routine
-* @param projectionView "projection * view" matrix
+* @brief manages frustum visualization routine, projectionView comes from the main camera block
 * @todo remove this function from the release version of the game
 */
-void Game::drawFrustumVisualizations( const glm::mat4 & projectionView )
+void Game::drawFrustumVisualizations()
 {
+	scene.getFrameUniforms().bindCamera( CAMERA_VIEW_MAIN );
 	Shader & frustumShader = shaderManager.get( SHADER_FRUSTUM );
 	frustumShader.use();
-	frustumShader.setMat4( "u_projectionView", projectionView );
 	if( options[OPT_FRUSTUM_VISUALIZATION] )
 	{
 		frustumShader.setInt( "u_colorIndex", 3 );
@@ -339,12 +406,8 @@ void Game::drawFrameReflection()
 		RendererState::disableState( GL_MULTISAMPLE );
 	}
 
-	//for reflection rendering we need reflection view matrix
-	const glm::mat4 VIEW_REFLECTED = camera.getReflectionViewMatrix();
-	scene.drawWorldReflection( projection * VIEW_REFLECTED,
-							   projection * glm::mat4( glm::mat3( VIEW_REFLECTED ) ),
-							   cullingViewFrustum,
-							   camera );
+	//reflected view has been uploaded to the frame uniforms along with the main one
+	scene.drawWorldReflection();
 
 	if( options[OPT_USE_MULTISAMPLING] )
 	{
@@ -354,9 +417,8 @@ void Game::drawFrameReflection()
 
 /**
 * @brief manages OpenGL state to new world refraction rendering cycle and delegates draw refraction command to the scene
-* @param projectionView "projection * view" matrix
 */
-void Game::drawFrameRefraction( const glm::mat4 & projectionView )
+void Game::drawFrameRefraction()
 {
 	glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
 	if( options[OPT_USE_MULTISAMPLING] )
@@ -364,7 +426,7 @@ void Game::drawFrameRefraction( const glm::mat4 & projectionView )
 		RendererState::disableState( GL_MULTISAMPLE );
 	}
 
-	scene.drawWorldRefraction( projectionView );
+	scene.drawWorldRefraction();
 
 	if( options[OPT_USE_MULTISAMPLING] )
 	{
@@ -399,6 +461,7 @@ void Game::drawDepthmap()
 	shadowVolume.update( shadowRegionsFrustums, scene.getSunFacade() );
 
 	//draw scene onto depthmap
+	RendererState::beginPass( RENDER_PASS_DEPTHMAP );
 	depthmapFramebuffer.bindToViewport( SettingsManager::getInt( "GRAPHICS", "depthmap_texture_width" ),
 										SettingsManager::getInt( "GRAPHICS", "depthmap_texture_height" ) );
 	scene.drawWorldDepthmap( options[OPT_GRASS_SHADOW] );
@@ -411,21 +474,36 @@ void Game::drawDepthmap()
 */
 void Game::saveState()
 {
-	saveLoadManager.saveToFile( ( SAVES_DIR + "testSave.txt" ).c_str() );
+	saveLoadManager.saveToFile( ( SAVES_DIR + "testSave.scdw" ).c_str() );
 	options[OPT_SAVE_REQUEST] = false;
 }
 
 /**
-* @brief handles file loading routine. Explicitly sends load command to scene as it should recalculate its internal data
+* @brief handles file loading routine. Explicitly sends load command to scene as it should recalculate its internal data.
+* If there is no binary save yet, legacy text save is imported
 * @todo make proper loading system (with GUI, file naming stuff and other user-friendly bullshit)
 */
 void Game::loadState()
 {
-	saveLoadManager.loadFromFile( ( SAVES_DIR + "testSave.txt" ).c_str() );
-	scene.load();
+	const std::string BINARY_SAVE_FILENAME = SAVES_DIR + "testSave.scdw";
+	const std::string SAVE_FILENAME = std::ifstream( BINARY_SAVE_FILENAME ) ? BINARY_SAVE_FILENAME : SAVES_DIR + "testSave.txt";
+	if( saveLoadManager.loadFromFile( SAVE_FILENAME.c_str() ) )
+	{
+		scene.load();
+	}
 	options[OPT_LOAD_REQUEST] = false;
 }
 
+/**
+* @brief compares text and binary save formats on the current world. Scene is reloaded afterwards the same way as on load
+*/
+void Game::benchmarkSaveFormats()
+{
+	saveLoadManager.benchmarkFormats( SAVES_DIR );
+	scene.load();
+	options[OPT_SAVE_BENCHMARK_REQUEST] = false;
+}
+
 /**
 * @brief initializes all game-coroutines threads
 * @note although there is only one coroutine thread at the moment, things might have changed in a future
@@ -438,7 +516,14 @@ void Game::setupThreads()
 		{
 			if( modelsIndirectBufferNeedUpdate )
 			{
-				scene.getPlantsFacade().prepareIndirectBufferData( camera, viewFrustum, scene.getHillsFacade().getMap() );
+				const auto UPDATE_START_TIME = std::chrono::steady_clock::now();
+				scene.getPlantsFacade().prepareIndirectBufferData( camera, viewFrustum, scene.getHillsOcclusion() );
+				const auto UPDATE_DURATION = std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now() - UPDATE_START_TIME );
+				modelsIndirectBufferUpdateTime = (unsigned int)UPDATE_DURATION.count();
+				const ChunkOcclusionStatistics PLANTS_OCCLUSION_STATISTICS = scene.getPlantsFacade().getOcclusionStatistics();
+				plantsOcclusionReused = PLANTS_OCCLUSION_STATISTICS.numReused;
+				plantsOcclusionTested = PLANTS_OCCLUSION_STATISTICS.numTested;
+				plantsOcclusionDeferred = PLANTS_OCCLUSION_STATISTICS.numDeferred;
 				modelsIndirectBufferPrepared = true;
 				modelsIndirectBufferNeedUpdate = false;
 			}
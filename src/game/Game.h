@@ -24,6 +24,7 @@
 #include "Timer"
 #include "KeyboardManager"
 #include "SaveLoadManager"
+#include "WorldCache"
 #include "Camera"
 #include "Scene"
 #include "Options"
@@ -66,14 +67,16 @@ public:
 	void initializeMouseInputCallbacks();
 
 private:
-	void drawFrame( const glm::mat4 & projectionView );
-	void drawFrustumVisualizations( const glm::mat4 & projectionView );
+	void updateFrameUniforms( const glm::mat4 & projectionView );
+	void drawFrame();
+	void drawFrustumVisualizations();
 	void drawFrameReflection();
-	void drawFrameRefraction( const glm::mat4 & projectionView );
+	void drawFrameRefraction();
 	void recreate();
 	void drawDepthmap();
 	void saveState();
 	void loadState();
+	void benchmarkSaveFormats();
 
 	//context and hardware related
 	/**
@@ -124,6 +127,7 @@ private:
 	/** @todo remove this in the game release version*/
 	ShadowVolumeRenderer shadowVolumeRenderer;
 	SaveLoadManager saveLoadManager;
+	WorldCache worldCache;
 
 	//input
 	KeyboardManager keyboard;
@@ -140,6 +144,12 @@ private:
 	std::condition_variable modelsIndirectBufferNeedUpdateCV;
 	std::atomic_bool modelsIndirectBufferPrepared;
 	std::atomic_bool modelsIndirectBufferNeedUpdate;
+	/** @brief duration (in microseconds) of the last models indirect buffer update on the coroutine thread */
+	std::atomic_uint modelsIndirectBufferUpdateTime;
+	/** @brief numbers of plants chunks occlusion results reused, tested and deferred during the last models indirect buffer update */
+	std::atomic_uint plantsOcclusionReused;
+	std::atomic_uint plantsOcclusionTested;
+	std::atomic_uint plantsOcclusionDeferred;
 	std::atomic_bool setupCompleted;
 	std::atomic_bool mouseInputCallbacksInitialized;
 
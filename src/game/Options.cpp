@@ -31,6 +31,7 @@ Options::Options() noexcept
 	options[OPT_RECREATE_TERRAIN_REQUEST] = false;
 	options[OPT_SAVE_REQUEST] = false;
 	options[OPT_LOAD_REQUEST] = false;
+	options[OPT_SAVE_BENCHMARK_REQUEST] = false;
 	options[OPT_SHOW_CURSOR] = false;
 	options[OPT_DRAW_BUILDABLE] = false;
 	options[OPT_HILLS_CULLING] = true;
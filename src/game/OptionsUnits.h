@@ -28,6 +28,7 @@ enum OPTION
 	OPT_RECREATE_TERRAIN_REQUEST,
 	OPT_SAVE_REQUEST,
 	OPT_LOAD_REQUEST,
+	OPT_SAVE_BENCHMARK_REQUEST,
 	OPT_SHOW_CURSOR,
 	OPT_DRAW_BUILDABLE,
 	OPT_HILLS_CULLING,
@@ -22,6 +22,10 @@
 #include "Camera"
 #include "Scene"
 #include "Logger"
+#include "WorldFile"
+
+#include <chrono>
+#include <fstream>
 
 /**
 * @brief plain ctor
@@ -38,10 +42,99 @@ SaveLoadManager::SaveLoadManager( Scene & scene,
 {}
 
 /**
-* @brief handles file saving routine
+* @brief handles file saving routine, world is saved in binary format
 * @param filename string file name to write data to
 */
 bool SaveLoadManager::saveToFile( const char * filename )
+{
+	WorldFileWriter writer;
+	scene.serialize( writer );
+	writer.beginSection( SECTION_CAMERA );
+	camera.serialize( writer );
+	writer.endSection();
+	if( !writer.saveToFile( filename ) )
+	{
+		return false;
+	}
+	Logger::log( "serialization finished\n---------------------------\n" );
+	return true;
+}
+
+/**
+* @brief handles file loading routine. File is mapped to memory and validated before any data is loaded,
+* files in legacy text format are imported instead
+* @param filename string file name to read data from
+*/
+bool SaveLoadManager::loadFromFile( const char * filename )
+{
+	if( !WorldFile::isWorldFile( filename ) )
+	{
+		return importFromTextFile( filename );
+	}
+	WorldFileReader reader;
+	if( !reader.open( filename ) )
+	{
+		Logger::log( "Could not load world file: %\n", filename );
+		return false;
+	}
+	//camera is loaded to a copy first, so that the scene is changed only if the camera section is valid as well
+	WorldFileSection cameraSection = reader.getSection( SECTION_CAMERA );
+	Camera loadedCamera( camera );
+	if( !loadedCamera.deserialize( cameraSection ) || !scene.deserialize( reader ) )
+	{
+		return false;
+	}
+	camera = loadedCamera;
+	shadowCamera = camera; //temporary assignment as long as shadowCamera exists in application code
+	Logger::log( "deserialization finished\n---------------------------\n" );
+	return true;
+}
+
+/**
+* @brief saves and loads current world in both text and binary formats and reports file sizes and timings
+* @param directory directory to put benchmark files to
+* @note world state after the benchmark is the one loaded from the binary file, thus it is identical to the current one
+*/
+void SaveLoadManager::benchmarkFormats( const std::string & directory )
+{
+	using std::chrono::steady_clock;
+	const std::string TEXT_FILENAME = directory + "benchmark.txt";
+	const std::string BINARY_FILENAME = directory + "benchmark.scdw";
+	auto millisecondsSince = []( steady_clock::time_point startTime )
+	{
+		return std::to_string( std::chrono::duration<float, std::milli>( steady_clock::now() - startTime ).count() );
+	};
+	auto fileSize = []( const std::string & filename )
+	{
+		std::ifstream file( filename, std::ios::binary | std::ios::ate );
+		return std::to_string( file ? (long long)file.tellg() : 0 );
+	};
+
+	auto startTime = steady_clock::now();
+	exportToTextFile( TEXT_FILENAME.c_str() );
+	const std::string TEXT_SAVE_TIME = millisecondsSince( startTime );
+	startTime = steady_clock::now();
+	saveToFile( BINARY_FILENAME.c_str() );
+	const std::string BINARY_SAVE_TIME = millisecondsSince( startTime );
+
+	startTime = steady_clock::now();
+	importFromTextFile( TEXT_FILENAME.c_str() );
+	const std::string TEXT_LOAD_TIME = millisecondsSince( startTime );
+	startTime = steady_clock::now();
+	loadFromFile( BINARY_FILENAME.c_str() );
+	const std::string BINARY_LOAD_TIME = millisecondsSince( startTime );
+
+	Logger::log( "save format benchmark:\n\ttext: % bytes, save % ms, load % ms\n",
+				 fileSize( TEXT_FILENAME ).c_str(), TEXT_SAVE_TIME.c_str(), TEXT_LOAD_TIME.c_str() );
+	Logger::log( "\tbinary: % bytes, save % ms, load % ms\n",
+				 fileSize( BINARY_FILENAME ).c_str(), BINARY_SAVE_TIME.c_str(), BINARY_LOAD_TIME.c_str() );
+}
+
+/**
+* @brief saves world in legacy text format
+* @param filename string file name to write data to
+*/
+bool SaveLoadManager::exportToTextFile( const char * filename )
 {
 	std::ofstream output( filename );
 	if( !output )
@@ -57,10 +150,10 @@ bool SaveLoadManager::saveToFile( const char * filename )
 }
 
 /**
-* @brief handles file loading routine
+* @brief loads world from legacy text format file
 * @param filename string file name to read data from
 */
-bool SaveLoadManager::loadFromFile( const char * filename )
+bool SaveLoadManager::importFromTextFile( const char * filename )
 {
 	std::ifstream input( filename );
 	if( !input )
@@ -20,13 +20,16 @@
 
 #pragma once
 
+#include <string>
+
 class Camera;
 class Scene;
 
 /**
 * @brief manager to file save/load operations.
 * Responsible for handling file i/o streams, ordering serialization/deserialization calls of the game modules data
-* that should be stored to or loaded from a file
+* that should be stored to or loaded from a file. Saves are written in binary world file format,
+* legacy text saves are still supported for loading
 */
 class SaveLoadManager
 {
@@ -36,8 +39,12 @@ public:
 					 Camera & shadowCamera ) noexcept;
 	bool saveToFile( const char * filename );
 	bool loadFromFile( const char * filename );
+	void benchmarkFormats( const std::string & directory );
 
 private:
+	bool exportToTextFile( const char * filename );
+	bool importFromTextFile( const char * filename );
+
 	Scene & scene;
 	Camera & camera;
 	/** @todo remove this in release version of the game */
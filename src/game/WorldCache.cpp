@@ -0,0 +1,143 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * WorldCache.cpp
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains definition for WorldCache class
+ * @version 0.1.0
+ */
+
+#include "WorldCache"
+#include "Scene"
+#include "WorldFile"
+#include "RandomStream"
+#include "SettingsManager"
+#include "DirectoriesSettings"
+#include "SceneSettings"
+#include "Logger"
+
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <sstream>
+
+/**
+* @brief plain ctor. Cache is used only if enabled in config and the world seed is fixed (otherwise entries would never be reused)
+* @param scene game scene
+*/
+WorldCache::WorldCache( Scene & scene )
+	: scene( scene )
+	, ENABLED( SettingsManager::getBool( "SCENE", "world_cache" ) && SettingsManager::getInt( "SCENE", "world_seed" ) != 0 )
+{}
+
+/**
+* @brief tries to load world from the cache entry matching current seed and settings.
+* Scene is reset in case the entry turns out to be unusable, so that the world might be generated from scratch
+* @return true if the world was loaded, false means world should be generated
+*/
+bool WorldCache::load()
+{
+	if( !ENABLED )
+	{
+		return false;
+	}
+	const std::string FILENAME = getCacheFilename();
+	if( !std::filesystem::exists( FILENAME ) )
+	{
+		Logger::log( "world cache miss: %\n", FILENAME.c_str() );
+		return false;
+	}
+
+	bool deserialized = false;
+	{
+		//reader has to be destroyed before the entry might be removed as the file is mapped while the reader exists
+		WorldFileReader reader;
+		deserialized = reader.open( FILENAME.c_str() ) && scene.deserialize( reader );
+	}
+	if( !deserialized )
+	{
+		Logger::log( "world cache entry is invalid and will be regenerated: %\n", FILENAME.c_str() );
+		std::error_code errorCode;
+		std::filesystem::remove( FILENAME, errorCode );
+		scene.reset();
+		return false;
+	}
+	scene.load();
+	Logger::log( "world loaded from cache: %\n", FILENAME.c_str() );
+	return true;
+}
+
+/**
+* @brief stores current world as a cache entry for current seed and settings. Other entries are removed as stale ones
+*/
+void WorldCache::store() const
+{
+	if( !ENABLED )
+	{
+		return;
+	}
+	const auto START_TIME = std::chrono::steady_clock::now();
+	std::error_code errorCode;
+	std::filesystem::create_directories( CACHE_DIR, errorCode );
+	if( errorCode )
+	{
+		Logger::log( "could not create world cache directory: %\n", CACHE_DIR.c_str() );
+		return;
+	}
+	for( const std::filesystem::directory_entry & entry : std::filesystem::directory_iterator( CACHE_DIR, errorCode ) )
+	{
+		if( entry.path().extension() == ".scdw" )
+		{
+			std::filesystem::remove( entry.path(), errorCode );
+		}
+	}
+
+	const std::string FILENAME = getCacheFilename();
+	WorldFileWriter writer;
+	scene.serialize( writer );
+	if( writer.saveToFile( FILENAME.c_str() ) )
+	{
+		const auto DURATION = std::chrono::duration<float, std::milli>( std::chrono::steady_clock::now() - START_TIME );
+		Logger::log( "world cache stored in % ms: %\n", std::to_string( DURATION.count() ).c_str(), FILENAME.c_str() );
+	}
+}
+
+bool WorldCache::isEnabled() const noexcept
+{
+	return ENABLED;
+}
+
+/**
+* @brief calculates cache key from everything that affects world generation result
+*/
+uint32_t WorldCache::calculateKey() const
+{
+	const uint64_t KEY_DATA[] = { WORLD_FILE_VERSION,
+								  WORLD_WIDTH,
+								  WORLD_HEIGHT,
+								  RandomStream::getWorldSeed(),
+								  SettingsManager::getCategoryHash( "HILLS_GENERATOR" ),
+								  SettingsManager::getCategoryHash( "SCENE" ),
+								  SettingsManager::getCategoryHash( "HILL_TREES" ),
+								  SettingsManager::getCategoryHash( "LAND_TREES" ),
+								  SettingsManager::getCategoryHash( "GRASS" ) };
+	return WorldFile::checksum( KEY_DATA, sizeof( KEY_DATA ) );
+}
+
+std::string WorldCache::getCacheFilename() const
+{
+	std::ostringstream filename;
+	filename << CACHE_DIR << "world_" << std::hex << std::setw( 8 ) << std::setfill( '0' ) << calculateKey() << ".scdw";
+	return filename.str();
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * WorldCache.h
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains declaration for WorldCache class
+ * @version 0.1.0
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+class Scene;
+
+/**
+* @brief cache of the fully generated world. Cache entry is identified by a key calculated from the world seed
+* and all the generator related settings, thus the entry is reused only as long as generation would give the same result.
+* World is stored in binary world file format, so loading from cache costs as much as loading a save
+*/
+class WorldCache
+{
+public:
+	WorldCache( Scene & scene );
+	bool load();
+	void store() const;
+	bool isEnabled() const noexcept;
+
+private:
+	uint32_t calculateKey() const;
+	std::string getCacheFilename() const;
+
+	Scene & scene;
+	const bool ENABLED;
+};
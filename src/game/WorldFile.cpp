@@ -0,0 +1,287 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * WorldFile.cpp
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains definitions for binary world file writer and reader
+ * @version 0.1.0
+ */
+
+#include "WorldFile"
+#include "Logger"
+
+#include <array>
+#include <fstream>
+#include <string>
+
+/**
+* @brief calculates CRC-32 (IEEE 802.3 polynomial) of the data
+* @param data pointer to the data
+* @param size size of the data in bytes
+*/
+uint32_t WorldFile::checksum( const void * data,
+							  size_t size ) noexcept
+{
+	static const std::array<uint32_t, 256> CRC_TABLE = []() noexcept
+	{
+		std::array<uint32_t, 256> table{};
+		for( uint32_t byte = 0; byte < 256; byte++ )
+		{
+			uint32_t crc = byte;
+			for( unsigned int bit = 0; bit < 8; bit++ )
+			{
+				crc = ( crc & 1 ) ? ( crc >> 1 ) ^ 0xEDB88320u : crc >> 1;
+			}
+			table[byte] = crc;
+		}
+		return table;
+	}();
+
+	const unsigned char * bytes = static_cast<const unsigned char*>( data );
+	uint32_t crc = 0xFFFFFFFFu;
+	for( size_t byteIndex = 0; byteIndex < size; byteIndex++ )
+	{
+		crc = CRC_TABLE[( crc ^ bytes[byteIndex] ) & 0xFF] ^ ( crc >> 8 );
+	}
+	return crc ^ 0xFFFFFFFFu;
+}
+
+/**
+* @brief checks whether given file starts with the world file signature (used to tell binary saves from legacy text ones)
+* @param filename name of the file to check
+*/
+bool WorldFile::isWorldFile( const char * filename )
+{
+	std::ifstream input( filename, std::ios::binary );
+	char magic[sizeof( WORLD_FILE_MAGIC )] = {};
+	input.read( magic, sizeof( magic ) );
+	return input && std::memcmp( magic, WORLD_FILE_MAGIC, sizeof( magic ) ) == 0;
+}
+
+WorldFileSection::WorldFileSection( const unsigned char * data,
+									size_t size ) noexcept
+	: sectionData( data )
+	, sectionSize( size )
+	, cursor( 0 )
+	, failed( data == nullptr )
+{}
+
+/**
+* @brief reads heightfield dimensions and returns read-only view of its values within the mapped file
+*/
+Heightfield2DView<const float> WorldFileSection::readHeightfield() noexcept
+{
+	uint32_t width = 0;
+	uint32_t height = 0;
+	read( width );
+	read( height );
+	const float * values = readArray<float>( (size_t)width * height );
+	if( !values )
+	{
+		return Heightfield2DView<const float>( nullptr, 0, 0, 0 );
+	}
+	return Heightfield2DView<const float>( values, width, height, width );
+}
+
+bool WorldFileSection::isFailed() const noexcept
+{
+	return failed;
+}
+
+size_t WorldFileSection::align( size_t offset,
+								size_t alignment ) noexcept
+{
+	return ( offset + alignment - 1 ) / alignment * alignment;
+}
+
+/**
+* @brief starts new section, all subsequent writes go to this section until it is ended
+* @param id identifier of the section
+*/
+void WorldFileWriter::beginSection( WORLD_FILE_SECTION id )
+{
+	alignSection( WORLD_FILE_SECTION_ALIGNMENT );
+	WorldFileSectionEntry entry;
+	entry.id = id;
+	entry.checksum = 0;
+	entry.offset = sectionsData.size();
+	entry.size = 0;
+	sections.push_back( entry );
+}
+
+/**
+* @brief writes heightfield dimensions followed by its values row by row (without padding)
+* @param heightfield heightfield to write
+*/
+void WorldFileWriter::writeHeightfield( Heightfield2DView<const float> heightfield )
+{
+	write( (uint32_t)heightfield.width() );
+	write( (uint32_t)heightfield.height() );
+	for( size_t y = 0; y < heightfield.height(); y++ )
+	{
+		writeArray( heightfield[y].data(), heightfield.width() );
+	}
+}
+
+/**
+* @brief finishes current section and calculates its checksum
+*/
+void WorldFileWriter::endSection()
+{
+	WorldFileSectionEntry & entry = sections.back();
+	entry.size = sectionsData.size() - entry.offset;
+	entry.checksum = WorldFile::checksum( sectionsData.data() + entry.offset, (size_t)entry.size );
+}
+
+/**
+* @brief writes header, section table and all the sections data to the file
+* @param filename name of the file to write to
+*/
+bool WorldFileWriter::saveToFile( const char * filename )
+{
+	const size_t TABLE_SIZE = sections.size() * sizeof( WorldFileSectionEntry );
+	const size_t DATA_OFFSET = ( sizeof( WorldFileHeader ) + TABLE_SIZE + WORLD_FILE_SECTION_ALIGNMENT - 1 ) / WORLD_FILE_SECTION_ALIGNMENT * WORLD_FILE_SECTION_ALIGNMENT;
+
+	//section offsets in the file are absolute
+	std::vector<WorldFileSectionEntry> table( sections );
+	for( WorldFileSectionEntry & entry : table )
+	{
+		entry.offset += DATA_OFFSET;
+	}
+
+	WorldFileHeader header;
+	std::memcpy( header.magic, WORLD_FILE_MAGIC, sizeof( header.magic ) );
+	header.version = WORLD_FILE_VERSION;
+	header.numSections = (uint32_t)table.size();
+	header.tableChecksum = WorldFile::checksum( table.data(), TABLE_SIZE );
+	header.fileSize = DATA_OFFSET + sectionsData.size();
+
+	std::ofstream output( filename, std::ios::binary );
+	if( !output )
+	{
+		Logger::log( "Could not open file for saving: %\n", filename );
+		return false;
+	}
+	const char PADDING[WORLD_FILE_SECTION_ALIGNMENT] = {};
+	output.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+	output.write( reinterpret_cast<const char*>( table.data() ), TABLE_SIZE );
+	output.write( PADDING, DATA_OFFSET - sizeof( header ) - TABLE_SIZE );
+	output.write( reinterpret_cast<const char*>( sectionsData.data() ), sectionsData.size() );
+	if( !output )
+	{
+		Logger::log( "Error while writing world file: %\n", filename );
+		return false;
+	}
+	return true;
+}
+
+/**
+* @brief pads current section data so that next value starts at the given alignment
+* @param alignment desired alignment (relative to the sections data start, which is aligned in the file)
+*/
+void WorldFileWriter::alignSection( size_t alignment )
+{
+	const size_t ALIGNED_SIZE = ( sectionsData.size() + alignment - 1 ) / alignment * alignment;
+	sectionsData.resize( ALIGNED_SIZE, 0 );
+}
+
+/**
+* @brief maps the file and validates it, no section data is accessible if validation fails
+* @param filename name of the file to read
+*/
+bool WorldFileReader::open( const char * filename )
+{
+	sections = nullptr;
+	numSections = 0;
+	if( !file.open( filename ) )
+	{
+		return false;
+	}
+
+	WorldFileHeader header;
+	if( file.size() < sizeof( header ) )
+	{
+		Logger::log( "World file is truncated: %\n", filename );
+		return false;
+	}
+	std::memcpy( &header, file.data(), sizeof( header ) );
+	if( std::memcmp( header.magic, WORLD_FILE_MAGIC, sizeof( header.magic ) ) != 0 )
+	{
+		Logger::log( "File is not a world file: %\n", filename );
+		return false;
+	}
+	if( header.version != WORLD_FILE_VERSION )
+	{
+		Logger::log( "Unsupported world file version % in %\n", std::to_string( header.version ).c_str(), filename );
+		return false;
+	}
+	const size_t TABLE_SIZE = (size_t)header.numSections * sizeof( WorldFileSectionEntry );
+	if( header.fileSize != file.size() || file.size() < sizeof( header ) + TABLE_SIZE )
+	{
+		Logger::log( "World file is truncated: %\n", filename );
+		return false;
+	}
+	const WorldFileSectionEntry * table = reinterpret_cast<const WorldFileSectionEntry*>( file.data() + sizeof( header ) );
+	if( WorldFile::checksum( table, TABLE_SIZE ) != header.tableChecksum )
+	{
+		Logger::log( "World file section table is corrupted: %\n", filename );
+		return false;
+	}
+	for( uint32_t sectionIndex = 0; sectionIndex < header.numSections; sectionIndex++ )
+	{
+		const WorldFileSectionEntry & entry = table[sectionIndex];
+		if( entry.offset > file.size() || entry.size > file.size() - entry.offset ||
+			WorldFile::checksum( file.data() + entry.offset, (size_t)entry.size ) != entry.checksum )
+		{
+			Logger::log( "World file section % is corrupted: %\n", std::to_string( entry.id ).c_str(), filename );
+			return false;
+		}
+	}
+	sections = table;
+	numSections = header.numSections;
+	return true;
+}
+
+bool WorldFileReader::hasSection( WORLD_FILE_SECTION id ) const noexcept
+{
+	for( uint32_t sectionIndex = 0; sectionIndex < numSections; sectionIndex++ )
+	{
+		if( sections[sectionIndex].id == id )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+* @brief returns read cursor for the given section, cursor is in failed state if there is no such section
+* @param id identifier of the section
+*/
+WorldFileSection WorldFileReader::getSection( WORLD_FILE_SECTION id ) const noexcept
+{
+	for( uint32_t sectionIndex = 0; sectionIndex < numSections; sectionIndex++ )
+	{
+		if( sections[sectionIndex].id == id )
+		{
+			return WorldFileSection( file.data() + sections[sectionIndex].offset, (size_t)sections[sectionIndex].size );
+		}
+	}
+	return WorldFileSection( nullptr, 0 );
+}
+
+size_t WorldFileReader::getFileSize() const noexcept
+{
+	return file.size();
+}
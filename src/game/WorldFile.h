@@ -0,0 +1,192 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * WorldFile.h
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains declarations for binary world file format, its writer and reader
+ * @version 0.1.0
+ */
+
+#pragma once
+
+#include "TypeAliases"
+#include "MappedFile"
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+/**
+* @brief binary world file layout:
+* header, table of section entries, then sections data, each section starts at WORLD_FILE_SECTION_ALIGNMENT boundary.
+* Every value inside a section is aligned to its natural alignment, so arrays might be read right from the mapped file.
+* All values are stored in native (little-endian) byte order
+*/
+constexpr char WORLD_FILE_MAGIC[4] = { 'S', 'C', 'D', 'W' };
+constexpr uint32_t WORLD_FILE_VERSION = 1;
+constexpr size_t WORLD_FILE_SECTION_ALIGNMENT = 64;
+
+enum WORLD_FILE_SECTION : uint32_t
+{
+	SECTION_LAND = 0,
+	SECTION_HILLS = 1,
+	SECTION_WATER = 2,
+	SECTION_LAND_PLANTS = 3,
+	SECTION_GRASS = 4,
+	SECTION_HILL_TREES = 5,
+	SECTION_THE_SUN = 6,
+	SECTION_CAMERA = 7,
+	SECTION_WORLD_SEED = 8,
+	SECTION_SHORE = 9
+};
+
+struct WorldFileHeader
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t numSections;
+	//checksum of the section table
+	uint32_t tableChecksum;
+	uint64_t fileSize;
+};
+
+struct WorldFileSectionEntry
+{
+	uint32_t id;
+	uint32_t checksum;
+	uint64_t offset;
+	uint64_t size;
+};
+
+namespace WorldFile
+{
+	uint32_t checksum( const void * data,
+					   size_t size ) noexcept;
+	bool isWorldFile( const char * filename );
+};
+
+/**
+* @brief read cursor over one section of the mapped world file. Returned pointers point right into the mapped file.
+* Reading beyond the section end puts the section into failed state and returns null pointers
+*/
+class WorldFileSection
+{
+public:
+	WorldFileSection( const unsigned char * data,
+					  size_t size ) noexcept;
+
+	/**
+	* @brief returns pointer to the array of values in the section and advances the cursor
+	* @param count number of values in the array
+	*/
+	template <typename T>
+	const T * readArray( size_t count ) noexcept
+	{
+		static_assert( std::is_trivially_copyable<T>::value, "only trivially copyable types might be read from world file" );
+		const size_t OFFSET = align( cursor, alignof( T ) );
+		if( failed || OFFSET > sectionSize || count > ( sectionSize - OFFSET ) / sizeof( T ) )
+		{
+			failed = true;
+			return nullptr;
+		}
+		cursor = OFFSET + count * sizeof( T );
+		return reinterpret_cast<const T*>( sectionData + OFFSET );
+	}
+
+	/**
+	* @brief reads one value from the section
+	* @param value value to read to, remains unchanged if there is no data left in the section
+	*/
+	template <typename T>
+	bool read( T & value ) noexcept
+	{
+		const T * valuePointer = readArray<T>( 1 );
+		if( valuePointer )
+		{
+			std::memcpy( &value, valuePointer, sizeof( T ) );
+		}
+		return valuePointer != nullptr;
+	}
+	Heightfield2DView<const float> readHeightfield() noexcept;
+	bool isFailed() const noexcept;
+
+private:
+	static size_t align( size_t offset,
+						 size_t alignment ) noexcept;
+
+	const unsigned char * sectionData;
+	size_t sectionSize;
+	size_t cursor;
+	bool failed;
+};
+
+/**
+* @brief collects sections data in memory and writes the whole world file at once
+*/
+class WorldFileWriter
+{
+public:
+	WorldFileWriter() = default;
+	void beginSection( WORLD_FILE_SECTION id );
+
+	/**
+	* @brief appends array of values to the current section keeping natural alignment of the type
+	* @param data pointer to the values
+	* @param count number of values
+	*/
+	template <typename T>
+	void writeArray( const T * data,
+					 size_t count )
+	{
+		static_assert( std::is_trivially_copyable<T>::value, "only trivially copyable types might be written to world file" );
+		alignSection( alignof( T ) );
+		const unsigned char * bytes = reinterpret_cast<const unsigned char*>( data );
+		sectionsData.insert( sectionsData.end(), bytes, bytes + count * sizeof( T ) );
+	}
+
+	template <typename T>
+	void write( const T & value )
+	{
+		writeArray( &value, 1 );
+	}
+	void writeHeightfield( Heightfield2DView<const float> heightfield );
+	void endSection();
+	bool saveToFile( const char * filename );
+
+private:
+	void alignSection( size_t alignment );
+
+	std::vector<WorldFileSectionEntry> sections;
+	//data of all sections, each section starts at aligned offset relative to sections data start
+	std::vector<unsigned char> sectionsData;
+};
+
+/**
+* @brief maps world file and validates its header, section table and checksums of all sections
+*/
+class WorldFileReader
+{
+public:
+	WorldFileReader() = default;
+	bool open( const char * filename );
+	bool hasSection( WORLD_FILE_SECTION id ) const noexcept;
+	WorldFileSection getSection( WORLD_FILE_SECTION id ) const noexcept;
+	size_t getFileSize() const noexcept;
+
+private:
+	MappedFile file;
+	const WorldFileSectionEntry * sections = nullptr;
+	uint32_t numSections = 0;
+};
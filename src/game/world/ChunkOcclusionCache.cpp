@@ -0,0 +1,208 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * ChunkOcclusionCache.cpp
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains definition for ChunkOcclusionCache class
+ * @version 0.1.0
+ */
+
+
+#include "ChunkOcclusionCache"
+#include "HeightfieldOcclusion"
+
+#include <algorithm>
+#include <chrono>
+#include <glm/gtx/norm.hpp>
+
+/**
+* @param testBudgetMicroseconds time given to the occlusion tests during each update, zero means no limit
+*/
+ChunkOcclusionCache::ChunkOcclusionCache( unsigned int testBudgetMicroseconds ) noexcept
+	: TEST_BUDGET_MICROSECONDS( testBudgetMicroseconds )
+	, nextTestChunk( 0 )
+{}
+
+/**
+* @brief removes all the chunks along with their results
+*/
+void ChunkOcclusionCache::clear() noexcept
+{
+	chunksSides.clear();
+	chunksHeights.clear();
+	testViewPositions.clear();
+	validityRadiiSquared.clear();
+	occludedResults.clear();
+	validResults.clear();
+	listPositions.clear();
+	nextTestChunk = 0;
+}
+
+/**
+* @brief reserves space for the given number of chunks
+* @param numChunks number of chunks to be added
+*/
+void ChunkOcclusionCache::reserve( size_t numChunks )
+{
+	chunksSides.reserve( numChunks );
+	chunksHeights.reserve( numChunks );
+	testViewPositions.reserve( numChunks );
+	validityRadiiSquared.reserve( numChunks );
+	occludedResults.reserve( numChunks );
+	validResults.reserve( numChunks );
+	listPositions.reserve( numChunks );
+}
+
+/**
+* @brief adds chunk without any result, its index is the number of chunks added before it
+* @param left left side of the chunk in map coordinates
+* @param right right side of the chunk in map coordinates
+* @param top top side of the chunk in map coordinates
+* @param bottom bottom side of the chunk in map coordinates
+* @param height height of the chunk corners to test
+*/
+void ChunkOcclusionCache::addChunk( float left,
+									float right,
+									float top,
+									float bottom,
+									float height )
+{
+	chunksSides.emplace_back( left, right, top, bottom );
+	chunksHeights.emplace_back( height );
+	testViewPositions.emplace_back( 0.0f );
+	validityRadiiSquared.emplace_back( 0.0f );
+	occludedResults.emplace_back( false );
+	validResults.emplace_back( false );
+	listPositions.emplace_back( NOT_IN_LIST );
+}
+
+/**
+* @brief fills occlusion flags of the given chunks. Results which are still valid for the view position are reused,
+* the rest of the chunks are retested in the order of their indices until the time budget runs out,
+* starting from the chunk the previous update has stopped at. Chunks left untested are marked visible
+* @param occlusion occlusion queries of the height map
+* @param viewPosition position of the camera in map coordinates
+* @param chunkIndices indices of the chunks to update
+* @param occluded occlusion flags to fill, one per chunk index
+*/
+void ChunkOcclusionCache::update( const HeightfieldOcclusion & occlusion,
+								  const glm::vec3 & viewPosition,
+								  const std::vector<unsigned int> & chunkIndices,
+								  std::vector<unsigned char> & occluded )
+{
+	statistics = ChunkOcclusionStatistics();
+	auto isValid = [&]( unsigned int chunkIndex ) noexcept
+	{
+		return validResults[chunkIndex] && glm::distance2( viewPosition, testViewPositions[chunkIndex] ) <= validityRadiiSquared[chunkIndex];
+	};
+	unsigned int numInvalid = 0;
+	for( size_t position = 0; position < chunkIndices.size(); position++ )
+	{
+		const unsigned int CHUNK_INDEX = chunkIndices[position];
+		listPositions[CHUNK_INDEX] = (unsigned int)position;
+		if( isValid( CHUNK_INDEX ) )
+		{
+			occluded[position] = occludedResults[CHUNK_INDEX];
+			statistics.numReused++;
+		}
+		else
+		{
+			occluded[position] = false;
+			numInvalid++;
+		}
+	}
+
+	//listed chunks are looked up by their indices, so the order of retesting does not depend on the order of the list
+	const auto START_TIME = std::chrono::steady_clock::now();
+	const unsigned int NUM_CHUNKS = (unsigned int)chunksHeights.size();
+	const unsigned int START_CHUNK = nextTestChunk < NUM_CHUNKS ? nextTestChunk : 0;
+	bool hasBudget = true;
+	for( unsigned int offset = 0; offset < NUM_CHUNKS && numInvalid != 0; offset++ )
+	{
+		const unsigned int CHUNK_INDEX = ( START_CHUNK + offset ) % NUM_CHUNKS;
+		const unsigned int POSITION = listPositions[CHUNK_INDEX];
+		if( POSITION == NOT_IN_LIST || isValid( CHUNK_INDEX ) )
+		{
+			continue;
+		}
+		numInvalid--;
+		if( hasBudget && TEST_BUDGET_MICROSECONDS != 0 )
+		{
+			const auto ELAPSED_TIME = std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now() - START_TIME );
+			hasBudget = ELAPSED_TIME.count() < TEST_BUDGET_MICROSECONDS;
+			if( !hasBudget )
+			{
+				nextTestChunk = CHUNK_INDEX;
+			}
+		}
+		if( hasBudget )
+		{
+			occluded[POSITION] = testChunk( occlusion, viewPosition, CHUNK_INDEX );
+			statistics.numTested++;
+		}
+		else
+		{
+			statistics.numDeferred++;
+		}
+	}
+
+	for( unsigned int chunkIndex : chunkIndices )
+	{
+		listPositions[chunkIndex] = NOT_IN_LIST;
+	}
+}
+
+const ChunkOcclusionStatistics & ChunkOcclusionCache::getStatistics() const noexcept
+{
+	return statistics;
+}
+
+/**
+* @brief tests corners of the chunk and stores the result. The occluded result is valid while the view moves less than
+* the smallest tolerance of the lines of sight, the visible one - while it moves less than the tolerance of the first visible line of sight
+* @param occlusion occlusion queries of the height map
+* @param viewPosition position of the camera in map coordinates
+* @param chunkIndex index of the chunk to test
+* @return true if all the corners of the chunk are occluded
+*/
+bool ChunkOcclusionCache::testChunk( const HeightfieldOcclusion & occlusion,
+									 const glm::vec3 & viewPosition,
+									 unsigned int chunkIndex )
+{
+	const glm::vec4 & SIDES = chunksSides[chunkIndex];
+	const float HEIGHT = chunksHeights[chunkIndex];
+	const glm::vec3 CORNERS[4] = { glm::vec3( SIDES.x, HEIGHT, SIDES.w ),
+								   glm::vec3( SIDES.y, HEIGHT, SIDES.w ),
+								   glm::vec3( SIDES.x, HEIGHT, SIDES.z ),
+								   glm::vec3( SIDES.y, HEIGHT, SIDES.z ) };
+	bool isOccluded = true;
+	float validityRadius = MAX_VALIDITY_RADIUS;
+	for( const glm::vec3 & corner : CORNERS )
+	{
+		const float TOLERANCE = occlusion.getViewTolerance( viewPosition, corner );
+		if( TOLERANCE >= 0.0f )
+		{
+			isOccluded = false;
+			validityRadius = std::min( TOLERANCE, MAX_VALIDITY_RADIUS );
+			break;
+		}
+		validityRadius = std::min( validityRadius, -TOLERANCE );
+	}
+
+	testViewPositions[chunkIndex] = viewPosition;
+	validityRadiiSquared[chunkIndex] = validityRadius * validityRadius;
+	occludedResults[chunkIndex] = isOccluded;
+	validResults[chunkIndex] = true;
+	return isOccluded;
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * ChunkOcclusionCache.h
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains declaration for ChunkOcclusionCache class and ChunkOcclusionStatistics structure
+ * @version 0.1.0
+ */
+
+
+#pragma once
+
+#include <vector>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+class HeightfieldOcclusion;
+
+/**
+* @brief numbers of chunks occlusion results reused from the cache, tested anew and left untested due to time budget during the last update
+*/
+struct ChunkOcclusionStatistics
+{
+	unsigned int numReused = 0;
+	unsigned int numTested = 0;
+	unsigned int numDeferred = 0;
+};
+
+/**
+* @brief temporally coherent hills occlusion results of the chunks. A chunk is occluded if lines of sight to all four
+* of its corners (at the chunk height) are blocked. Each result is kept with the view position it was computed for
+* and the radius of a sphere around that position in which the result stays the same: the sphere is derived from
+* the clearance (or the depth) of the lines of sight and the maximum slope of the height map.
+* Results depend only on the view position, thus view direction changes never invalidate them.
+* Chunks whose result is not valid anymore are retested within the time budget in round robin order of their indices,
+* the rest of them are treated as visible until their turn comes in the next updates, so postponed tests never hide a chunk which is visible
+*/
+class ChunkOcclusionCache
+{
+public:
+	explicit ChunkOcclusionCache( unsigned int testBudgetMicroseconds ) noexcept;
+	void clear() noexcept;
+	void reserve( size_t numChunks );
+	void addChunk( float left,
+				   float right,
+				   float top,
+				   float bottom,
+				   float height );
+	void update( const HeightfieldOcclusion & occlusion,
+				 const glm::vec3 & viewPosition,
+				 const std::vector<unsigned int> & chunkIndices,
+				 std::vector<unsigned char> & occluded );
+	const ChunkOcclusionStatistics & getStatistics() const noexcept;
+
+private:
+	//validity radius is limited so that results computed from far above the chunks are still retested eventually
+	constexpr static float MAX_VALIDITY_RADIUS = 16.0f;
+	//position of the chunk which is not in the list being updated
+	constexpr static unsigned int NOT_IN_LIST = ~0u;
+
+	bool testChunk( const HeightfieldOcclusion & occlusion,
+					const glm::vec3 & viewPosition,
+					unsigned int chunkIndex );
+
+	const unsigned int TEST_BUDGET_MICROSECONDS;
+	//left, right, top and bottom sides of the chunks in map coordinates
+	std::vector<glm::vec4> chunksSides;
+	std::vector<float> chunksHeights;
+	std::vector<glm::vec3> testViewPositions;
+	std::vector<float> validityRadiiSquared;
+	std::vector<unsigned char> occludedResults;
+	std::vector<unsigned char> validResults;
+	//positions of the chunks in the list being updated, only valid during the update
+	std::vector<unsigned int> listPositions;
+	//chunks are retested in the order of their indices, next update starts from this chunk so that postponed chunks get their turn
+	unsigned int nextTestChunk;
+	ChunkOcclusionStatistics statistics;
+};
@@ -0,0 +1,178 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * ChunkQuadtree.cpp
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains definitions for ChunkQuadtree class
+ * @version 0.1.0
+ */
+
+
+#include "ChunkQuadtree"
+
+#include <algorithm>
+#include <numeric>
+#include <glm/common.hpp>
+#include <glm/vec2.hpp>
+
+/**
+* @brief removes all the chunks and nodes
+*/
+void ChunkQuadtree::clear() noexcept
+{
+	chunksBoundsMin.clear();
+	chunksBoundsMax.clear();
+	orderedChunks.clear();
+	nodes.clear();
+}
+
+/**
+* @brief reserves space for the given number of chunks
+* @param numChunks number of chunks to be added
+*/
+void ChunkQuadtree::reserve( size_t numChunks )
+{
+	chunksBoundsMin.reserve( numChunks );
+	chunksBoundsMax.reserve( numChunks );
+	orderedChunks.reserve( numChunks );
+}
+
+/**
+* @brief adds chunk to the tree, its index is the number of chunks added before it. Tree should be rebuilt afterwards
+* @param boundsMin minimum corner of the chunk box
+* @param boundsMax maximum corner of the chunk box
+*/
+void ChunkQuadtree::addChunk( const glm::vec3 & boundsMin,
+							  const glm::vec3 & boundsMax )
+{
+	chunksBoundsMin.emplace_back( boundsMin );
+	chunksBoundsMax.emplace_back( boundsMax );
+}
+
+/**
+* @brief builds the tree over all the added chunks. The root square covers centers of all the chunks
+* and is recursively split into quadrants until a node contains only a few chunks
+*/
+void ChunkQuadtree::build()
+{
+	nodes.clear();
+	orderedChunks.resize( chunksBoundsMin.size() );
+	std::iota( orderedChunks.begin(), orderedChunks.end(), 0 );
+	if( orderedChunks.empty() )
+	{
+		return;
+	}
+
+	glm::vec3 centersMin = ( chunksBoundsMin.front() + chunksBoundsMax.front() ) * 0.5f;
+	glm::vec3 centersMax = centersMin;
+	for( size_t chunkIndex = 0; chunkIndex < chunksBoundsMin.size(); chunkIndex++ )
+	{
+		const glm::vec3 CENTER = ( chunksBoundsMin[chunkIndex] + chunksBoundsMax[chunkIndex] ) * 0.5f;
+		centersMin = glm::min( centersMin, CENTER );
+		centersMax = glm::max( centersMax, CENTER );
+	}
+	const float HALF_SIZE = std::max( centersMax.x - centersMin.x, centersMax.z - centersMin.z ) * 0.5f;
+
+	nodes.reserve( orderedChunks.size() / MAX_LEAF_CHUNKS * 2 + 1 );
+	nodes.push_back( Node{ glm::vec3( 0.0f ), glm::vec3( 0.0f ), 0, (unsigned int)orderedChunks.size(), 0, 0 } );
+	buildNode( 0, ( centersMin.x + centersMax.x ) * 0.5f, ( centersMin.z + centersMax.z ) * 0.5f, HALF_SIZE, 0 );
+	nodes.shrink_to_fit();
+}
+
+/**
+* @brief calculates bounds of the given node and splits its chunks between up to four child nodes (empty quadrants are skipped)
+* @param nodeIndex index of the node to build
+* @param centerX X coordinate of the node square center
+* @param centerZ Z coordinate of the node square center
+* @param halfSize half of the node square side
+* @param depth depth of the node in the tree
+*/
+void ChunkQuadtree::buildNode( unsigned int nodeIndex,
+							   float centerX,
+							   float centerZ,
+							   float halfSize,
+							   unsigned int depth )
+{
+	updateNodeBounds( nodes[nodeIndex] );
+	const unsigned int FIRST_CHUNK = nodes[nodeIndex].firstChunk;
+	const unsigned int NUM_CHUNKS = nodes[nodeIndex].numChunks;
+	if( NUM_CHUNKS <= MAX_LEAF_CHUNKS || depth == MAX_DEPTH )
+	{
+		return;
+	}
+
+	//stable partitioning keeps the order chunks were added in within each quadrant
+	auto isUpper = [this, centerZ]( unsigned int chunkIndex )
+	{
+		return chunksBoundsMin[chunkIndex].z + chunksBoundsMax[chunkIndex].z < centerZ * 2.0f;
+	};
+	auto isLeft = [this, centerX]( unsigned int chunkIndex )
+	{
+		return chunksBoundsMin[chunkIndex].x + chunksBoundsMax[chunkIndex].x < centerX * 2.0f;
+	};
+	const auto BEGIN = orderedChunks.begin() + FIRST_CHUNK;
+	const auto END = BEGIN + NUM_CHUNKS;
+	const auto LOWER_BEGIN = std::stable_partition( BEGIN, END, isUpper );
+	const std::array<decltype( orderedChunks.begin() ), 5> QUADRANT_BOUNDS = {
+		BEGIN,
+		std::stable_partition( BEGIN, LOWER_BEGIN, isLeft ),
+		LOWER_BEGIN,
+		std::stable_partition( LOWER_BEGIN, END, isLeft ),
+		END };
+
+	const float CHILD_HALF_SIZE = halfSize * 0.5f;
+	const std::array<glm::vec2, 4> CHILD_CENTERS = {
+		glm::vec2( centerX - CHILD_HALF_SIZE, centerZ - CHILD_HALF_SIZE ),
+		glm::vec2( centerX + CHILD_HALF_SIZE, centerZ - CHILD_HALF_SIZE ),
+		glm::vec2( centerX - CHILD_HALF_SIZE, centerZ + CHILD_HALF_SIZE ),
+		glm::vec2( centerX + CHILD_HALF_SIZE, centerZ + CHILD_HALF_SIZE ) };
+	std::array<glm::vec2, 4> childCenters;
+	const unsigned int FIRST_CHILD = (unsigned int)nodes.size();
+	unsigned int numChildren = 0;
+	for( unsigned int quadrant = 0; quadrant < 4; quadrant++ )
+	{
+		const unsigned int NUM_QUADRANT_CHUNKS = (unsigned int)( QUADRANT_BOUNDS[quadrant + 1] - QUADRANT_BOUNDS[quadrant] );
+		if( NUM_QUADRANT_CHUNKS != 0 )
+		{
+			const unsigned int QUADRANT_FIRST_CHUNK = (unsigned int)( QUADRANT_BOUNDS[quadrant] - orderedChunks.begin() );
+			nodes.push_back( Node{ glm::vec3( 0.0f ), glm::vec3( 0.0f ), QUADRANT_FIRST_CHUNK, NUM_QUADRANT_CHUNKS, 0, 0 } );
+			childCenters[numChildren++] = CHILD_CENTERS[quadrant];
+		}
+	}
+	nodes[nodeIndex].firstChild = FIRST_CHILD;
+	nodes[nodeIndex].numChildren = numChildren;
+
+	//nodes storage might be reallocated during recursion, thus children are referred to by indices
+	for( unsigned int child = 0; child < numChildren; child++ )
+	{
+		buildNode( FIRST_CHILD + child, childCenters[child].x, childCenters[child].y, CHILD_HALF_SIZE, depth + 1 );
+	}
+}
+
+/**
+* @brief calculates bounds of the given node as the union of bounds of its chunks
+* @param node node to update
+*/
+void ChunkQuadtree::updateNodeBounds( Node & node ) const
+{
+	const unsigned int FIRST_CHUNK_INDEX = orderedChunks[node.firstChunk];
+	node.boundsMin = chunksBoundsMin[FIRST_CHUNK_INDEX];
+	node.boundsMax = chunksBoundsMax[FIRST_CHUNK_INDEX];
+	for( unsigned int orderIndex = node.firstChunk + 1; orderIndex < node.firstChunk + node.numChunks; orderIndex++ )
+	{
+		const unsigned int CHUNK_INDEX = orderedChunks[orderIndex];
+		node.boundsMin = glm::min( node.boundsMin, chunksBoundsMin[CHUNK_INDEX] );
+		node.boundsMax = glm::max( node.boundsMax, chunksBoundsMax[CHUNK_INDEX] );
+	}
+}
@@ -0,0 +1,219 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * ChunkQuadtree.h
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains declaration and inline functions for ChunkQuadtree class
+ * @version 0.1.0
+ */
+
+
+#pragma once
+
+#include "Frustum"
+
+#include <array>
+#include <vector>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+/**
+* @brief static quadtree over the chunks of a generator. Each node keeps bounds (including height range) of all the chunks below it,
+* thus whole subtrees lying outside of the frustum are rejected with a single box test and subtrees lying completely inside
+* are accepted without testing their chunks. Chunks of each subtree are stored contiguously in the tree order.
+* The tree is built once after chunks are generated, culling neither allocates nor modifies the tree
+*/
+class ChunkQuadtree
+{
+public:
+	ChunkQuadtree() noexcept = default;
+	void clear() noexcept;
+	void reserve( size_t numChunks );
+	void addChunk( const glm::vec3 & boundsMin,
+				   const glm::vec3 & boundsMax );
+	void build();
+	size_t getNumChunks() const noexcept;
+	size_t getNumNodes() const noexcept;
+	template <typename Visitor>
+	void forEachVisible( const Frustum & frustum,
+						 float cullingOffset,
+						 Visitor && visitor ) const;
+
+private:
+	//subdivision stops once a node contains no more chunks than this
+	constexpr static unsigned int MAX_LEAF_CHUNKS = 4;
+	constexpr static unsigned int MAX_DEPTH = 16;
+	constexpr static unsigned int ALL_PLANES_MASK = ( 1 << Frustum::NUMBER_OF_PLANES ) - 1;
+
+	using Planes = std::array<glm::vec4, Frustum::NUMBER_OF_PLANES>;
+
+	struct Node
+	{
+		glm::vec3 boundsMin;
+		glm::vec3 boundsMax;
+		//range of the tree ordered chunks covered by the node
+		unsigned int firstChunk;
+		unsigned int numChunks;
+		//children are stored contiguously, leaves have none
+		unsigned int firstChild;
+		unsigned int numChildren;
+	};
+
+	void buildNode( unsigned int nodeIndex,
+					float centerX,
+					float centerZ,
+					float halfSize,
+					unsigned int depth );
+	void updateNodeBounds( Node & node ) const;
+	static bool classifyBox( const Planes & planes,
+							 const glm::vec3 & boundsMin,
+							 const glm::vec3 & boundsMax,
+							 float cullingOffset,
+							 unsigned int & planesMask ) noexcept;
+	template <typename Visitor>
+	void visitNode( const Node & node,
+					const Planes & planes,
+					float cullingOffset,
+					unsigned int planesMask,
+					Visitor & visitor ) const;
+
+	std::vector<glm::vec3> chunksBoundsMin;
+	std::vector<glm::vec3> chunksBoundsMax;
+	//indices of the chunks (in the order of addition) sorted in the tree order
+	std::vector<unsigned int> orderedChunks;
+	std::vector<Node> nodes;
+};
+
+inline size_t ChunkQuadtree::getNumChunks() const noexcept
+{
+	return chunksBoundsMin.size();
+}
+
+inline size_t ChunkQuadtree::getNumNodes() const noexcept
+{
+	return nodes.size();
+}
+
+/**
+* @brief checks box against the planes of the given mask. Planes the box lies completely in front of are removed from the mask
+* @param planes frustum planes
+* @param boundsMin minimum corner of the box
+* @param boundsMax maximum corner of the box
+* @param cullingOffset offset applied to frustum sides
+* @param planesMask mask of the planes the box still needs to be tested against
+* @return false if the box lies completely behind any of the planes
+*/
+inline bool ChunkQuadtree::classifyBox( const Planes & planes,
+										const glm::vec3 & boundsMin,
+										const glm::vec3 & boundsMax,
+										float cullingOffset,
+										unsigned int & planesMask ) noexcept
+{
+	for( unsigned int planeIndex = 0; planeIndex < Frustum::NUMBER_OF_PLANES; planeIndex++ )
+	{
+		const unsigned int PLANE_BIT = 1 << planeIndex;
+		if( !( planesMask & PLANE_BIT ) )
+		{
+			continue;
+		}
+		const glm::vec4 & plane = planes[planeIndex];
+		//corners lying furthest along and against the plane normal
+		const glm::vec3 FURTHEST( plane.x >= 0.0f ? boundsMax.x : boundsMin.x,
+								  plane.y >= 0.0f ? boundsMax.y : boundsMin.y,
+								  plane.z >= 0.0f ? boundsMax.z : boundsMin.z );
+		if( plane.x * FURTHEST.x + plane.y * FURTHEST.y + plane.z * FURTHEST.z + plane.w <= -cullingOffset )
+		{
+			return false;
+		}
+		const glm::vec3 NEAREST( plane.x >= 0.0f ? boundsMin.x : boundsMax.x,
+								 plane.y >= 0.0f ? boundsMin.y : boundsMax.y,
+								 plane.z >= 0.0f ? boundsMin.z : boundsMax.z );
+		if( plane.x * NEAREST.x + plane.y * NEAREST.y + plane.z * NEAREST.z + plane.w > -cullingOffset )
+		{
+			planesMask &= ~PLANE_BIT;
+		}
+	}
+	return true;
+}
+
+/**
+* @brief calls visitor for each chunk which box is (at least partially) inside the frustum, chunks are visited in the tree order
+* @param frustum view frustum to check
+* @param cullingOffset offset applied to frustum sides
+* @param visitor callable taking index of a visible chunk (in the order chunks were added)
+*/
+template <typename Visitor>
+void ChunkQuadtree::forEachVisible( const Frustum & frustum,
+									float cullingOffset,
+									Visitor && visitor ) const
+{
+	if( nodes.empty() )
+	{
+		return;
+	}
+	Planes planes;
+	for( unsigned int planeIndex = 0; planeIndex < Frustum::NUMBER_OF_PLANES; planeIndex++ )
+	{
+		planes[planeIndex] = frustum.getPlane( (FRUSTUM_PLANE)planeIndex );
+	}
+	visitNode( nodes.front(), planes, cullingOffset, ALL_PLANES_MASK, visitor );
+}
+
+/**
+* @brief culls subtree of the given node, planes the parent node lies completely in front of are not tested again
+* @param node node to start from
+* @param planes frustum planes
+* @param cullingOffset offset applied to frustum sides
+* @param planesMask mask of the planes the parent node intersects
+* @param visitor callable taking index of a visible chunk
+*/
+template <typename Visitor>
+void ChunkQuadtree::visitNode( const Node & node,
+							   const Planes & planes,
+							   float cullingOffset,
+							   unsigned int planesMask,
+							   Visitor & visitor ) const
+{
+	if( !classifyBox( planes, node.boundsMin, node.boundsMax, cullingOffset, planesMask ) )
+	{
+		return;
+	}
+	const unsigned int CHUNKS_END = node.firstChunk + node.numChunks;
+	//whole subtree is inside the frustum
+	if( planesMask == 0 )
+	{
+		for( unsigned int orderIndex = node.firstChunk; orderIndex < CHUNKS_END; orderIndex++ )
+		{
+			visitor( orderedChunks[orderIndex] );
+		}
+		return;
+	}
+	if( node.numChildren == 0 )
+	{
+		for( unsigned int orderIndex = node.firstChunk; orderIndex < CHUNKS_END; orderIndex++ )
+		{
+			const unsigned int CHUNK_INDEX = orderedChunks[orderIndex];
+			unsigned int chunkPlanesMask = planesMask;
+			if( classifyBox( planes, chunksBoundsMin[CHUNK_INDEX], chunksBoundsMax[CHUNK_INDEX], cullingOffset, chunkPlanesMask ) )
+			{
+				visitor( CHUNK_INDEX );
+			}
+		}
+		return;
+	}
+	for( unsigned int childIndex = node.firstChild; childIndex < node.firstChild + node.numChildren; childIndex++ )
+	{
+		visitNode( nodes[childIndex], planes, cullingOffset, planesMask, visitor );
+	}
+}
@@ -26,9 +26,15 @@
 #include "MouseInputManager"
 #include "ShadowVolume"
 #include "RendererState"
+#include "UploadManager"
 #include "Options"
 #include "Logger"
 #include "SettingsManager"
+#include "WorldFile"
+#include "RandomStream"
+
+#include <chrono>
+#include <string>
 
 /**
 * @brief plain ctor, creates subsystems objects
@@ -43,15 +49,15 @@ Scene::Scene( ShaderManager & shaderManager,
 			  const ScreenResolution & screenResolution,
 			  const ShadowVolume & shadowVolume )
 	: PLANET_MOVE_SPEED( SettingsManager::getFloat( "SCENE", "planet_move_speed" ) )
+	, TERRAIN_LOD_PIXEL_ERROR( SettingsManager::getFloat( "GRAPHICS", "terrain_lod_pixel_error" ) )
 	, shaderManager( shaderManager )
 	, options( options )
 	, textureManager( textureManager )
 	, shadowVolume( shadowVolume )
+	, indirectCommandRing( SettingsManager::getInt( "GRAPHICS", "indirect_commands_per_frame" ) )
 	, waterFacade( shaderManager.get( SHADER_WATER ),
-				   shaderManager.get( SHADER_WATER_CULLING ),
 				   shaderManager.get( SHADER_WATER_NORMALS ) )
 	, hillsFacade( shaderManager.get( SHADER_HILLS ),
-				   shaderManager.get( SHADER_HILLS_CULLING ),
 				   shaderManager.get( SHADER_HILLS_NORMALS ),
 				   waterFacade.getMap() )
 	, shoreFacade( shaderManager.get( SHADER_SHORE ),
@@ -60,13 +66,15 @@ Scene::Scene( ShaderManager & shaderManager,
 	, buildableFacade( shaderManager.get( SHADER_BUILDABLE ),
 					   shaderManager.get( SHADER_SELECTED ) )
 	, plantsFacade( shaderManager.get( SHADER_MODELS_PHONG ),
-					shaderManager.get( SHADER_MODELS_GOURAUD ) )
+					shaderManager.get( SHADER_MODELS_GOURAUD ),
+					indirectCommandRing )
 	, skyboxFacade( shaderManager.get( SHADER_SKYBOX ) )
 	, theSunFacade( shaderManager.get( SHADER_SUN ), screenResolution )
 	, underwaterFacade( shaderManager.get( SHADER_UNDERWATER ) )
-	, landFacade( shaderManager.get( SHADER_LAND ) )
+	, landFacade( shaderManager.get( SHADER_LAND ), indirectCommandRing )
 	, lensFlareFacade( shaderManager.get( SHADER_LENS_FLARE ), textureManager.getLoader(), screenResolution )
 	, skysphereFacade( shaderManager.get( SHADER_SKYSPHERE ) )
+	, shoreLoaded( false )
 {}
 
 /**
@@ -74,26 +82,43 @@ Scene::Scene( ShaderManager & shaderManager,
 */
 void Scene::setup()
 {
+	const auto SETUP_START_TIME = std::chrono::steady_clock::now();
 	waterFacade.setup();
 	hillsFacade.setup();
 	shoreFacade.setup();
 	landFacade.setup( shoreFacade.getMap() );
 	waterFacade.setupConsiderTerrain( landFacade.getMap() );
-	buildableFacade.setup( landFacade.getMap(), hillsFacade.getMap() );
-	plantsFacade.setup( landFacade.getMap(), hillsFacade.getMap(), hillsFacade.getNormalMap() );
+	terrainMasks.build( landFacade.getMap(), hillsFacade.getMap() );
+	hillsOcclusion.build( hillsFacade.getMap(), HILLS_OFFSET_Y );
+	buildableFacade.setup( terrainMasks.get( TERRAIN_MASK_FREE_CELLS ) );
+	plantsFacade.setup( landFacade.getMap(), hillsFacade.getMap(), hillsFacade.getNormalMap(), terrainMasks.get( TERRAIN_MASK_FREE_CELLS ) );
 	textureManager.createUnderwaterReliefTexture( waterFacade.getMap() );
+
+	//report world generation time so that generation algorithms changes could be measured
+	const auto SETUP_DURATION = std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - SETUP_START_TIME );
+	Logger::log( "scene setup completed in % ms\n", std::to_string( SETUP_DURATION.count() ).c_str() );
 }
 
 /**
-* @brief explicitly reinitializes some terrain maps and prepares subsystems again
+* @brief explicitly reinitializes some terrain maps and prepares subsystems again with a new random world seed
 * @todo get rid of ugly castings (then probably this function will lose any reason to exist)
 */
 void Scene::recreate()
+{
+	RandomStream::setWorldSeed( RandomStream::generateWorldSeed() );
+	Logger::log( "recreating world with seed %\n", std::to_string( RandomStream::getWorldSeed() ).c_str() );
+	reset();
+	setup();
+}
+
+/**
+* @brief reinitializes terrain maps, so that the world might be generated from scratch
+*/
+void Scene::reset()
 {
 	Generator::initializeMap( const_cast<map2D_f &>( landFacade.getMap() ) );
 	Generator::initializeMap( const_cast<map2D_f &>( waterFacade.getMap() ) );
 	Generator::initializeMap( const_cast<map2D_f &>( hillsFacade.getMap() ) );
-	setup();
 }
 
 /**
@@ -102,10 +127,19 @@ void Scene::recreate()
 void Scene::load()
 {
 	hillsFacade.recreateTilesAndBufferData();
-	shoreFacade.setup();
+	if( shoreLoaded )
+	{
+		shoreFacade.recreateTilesAndBufferData();
+	}
+	else
+	{
+		shoreFacade.setup();
+	}
 	landFacade.setup( shoreFacade.getMap() );
 	waterFacade.setupConsiderTerrain( landFacade.getMap() );
-	buildableFacade.setup( landFacade.getMap(), hillsFacade.getMap() );
+	terrainMasks.build( landFacade.getMap(), hillsFacade.getMap() );
+	hillsOcclusion.build( hillsFacade.getMap(), HILLS_OFFSET_Y );
+	buildableFacade.setup( terrainMasks.get( TERRAIN_MASK_FREE_CELLS ) );
 	textureManager.createUnderwaterReliefTexture( waterFacade.getMap() );
 	plantsFacade.reinitializeModelRenderChunks( landFacade.getMap(), hillsFacade.getMap() );
 }
@@ -148,51 +182,157 @@ void Scene::deserialize( std::ifstream & input )
 	Logger::log( "plants deserialized successfully\n" );
 	theSunFacade.deserialize( input );
 	Logger::log( "the Sun deserialized successfully\n" );
+	shoreLoaded = false;
+}
+
+/**
+* @brief handles binary serialization process, each subsystem is written to its own section of the world file
+* @param writer world file writer
+* @see deserialize
+*/
+void Scene::serialize( WorldFileWriter & writer ) const
+{
+	writer.beginSection( SECTION_LAND );
+	landFacade.serialize( writer );
+	writer.endSection();
+	writer.beginSection( SECTION_HILLS );
+	hillsFacade.serialize( writer );
+	writer.endSection();
+	writer.beginSection( SECTION_WATER );
+	waterFacade.serialize( writer );
+	writer.endSection();
+	writer.beginSection( SECTION_SHORE );
+	shoreFacade.serialize( writer );
+	writer.endSection();
+	plantsFacade.serialize( writer );
+	writer.beginSection( SECTION_THE_SUN );
+	theSunFacade.serialize( writer );
+	writer.endSection();
+	writer.beginSection( SECTION_WORLD_SEED );
+	writer.write( RandomStream::getWorldSeed() );
+	writer.endSection();
+	Logger::log( "scene serialized successfully\n" );
+}
+
+/**
+* @brief handles binary deserialization process. Sections might be read in any order as they are looked up by identifier.
+* Scene state is changed only after all the sections have been read and matched the scene
+* @param reader world file reader with already validated content
+* @return false if any of the sections does not match the scene
+* @see serialize
+*/
+bool Scene::deserialize( const WorldFileReader & reader )
+{
+	//every section is read and validated first, so that a broken file leaves the scene untouched
+	WorldFileSection landSection = reader.getSection( SECTION_LAND );
+	WorldFileSection hillsSection = reader.getSection( SECTION_HILLS );
+	WorldFileSection waterSection = reader.getSection( SECTION_WATER );
+	WorldFileSection theSunSection = reader.getSection( SECTION_THE_SUN );
+	Heightfield2DView<const float> savedLandMap;
+	Heightfield2DView<const float> savedHillsMap;
+	Heightfield2DView<const float> savedWaterMap;
+	PlantsSavedData savedPlants;
+	TheSunSavedState savedTheSun;
+	if( !landFacade.read( landSection, savedLandMap ) ||
+		!hillsFacade.read( hillsSection, savedHillsMap ) ||
+		!waterFacade.read( waterSection, savedWaterMap ) ||
+		!plantsFacade.read( reader, savedPlants ) ||
+		!theSunFacade.read( theSunSection, savedTheSun ) )
+	{
+		Logger::log( "scene data in world file does not match the scene layout\n" );
+		return false;
+	}
+	//seed is required to regenerate subsystems that are not saved (e.g. shore of older files) the same way they were in the saved world
+	const bool HAS_WORLD_SEED = reader.hasSection( SECTION_WORLD_SEED );
+	uint64_t worldSeed = 0;
+	if( HAS_WORLD_SEED )
+	{
+		WorldFileSection seedSection = reader.getSection( SECTION_WORLD_SEED );
+		if( !seedSection.read( worldSeed ) )
+		{
+			Logger::log( "world seed in world file is corrupted\n" );
+			return false;
+		}
+	}
+	//shore is optional as well, when it is missing it would be regenerated on load
+	const bool HAS_SHORE = reader.hasSection( SECTION_SHORE );
+	Heightfield2DView<const float> savedShoreMap;
+	if( HAS_SHORE )
+	{
+		WorldFileSection shoreSection = reader.getSection( SECTION_SHORE );
+		if( !shoreFacade.read( shoreSection, savedShoreMap ) )
+		{
+			Logger::log( "shore data in world file does not match the scene layout\n" );
+			return false;
+		}
+	}
+
+	landFacade.deserialize( savedLandMap );
+	hillsFacade.deserialize( savedHillsMap );
+	waterFacade.deserialize( savedWaterMap );
+	plantsFacade.deserialize( savedPlants, landFacade.getMap(), hillsFacade.getMap() );
+	theSunFacade.deserialize( savedTheSun );
+	if( HAS_WORLD_SEED )
+	{
+		RandomStream::setWorldSeed( worldSeed );
+	}
+	if( HAS_SHORE )
+	{
+		shoreFacade.deserialize( savedShoreMap );
+	}
+	shoreLoaded = HAS_SHORE;
+	Logger::log( "scene deserialized successfully\n" );
+	return true;
 }
 
 /**
-* @brief handles plain onscreen rendering of the scene objects
-* @param projectionView 'projection * view' matrix
-* @param ambienceProjectionView auxiliary 'projection * view' matrix used for ambience-like objects (skybox, sun etc.)
-* @param viewFrustum camera's view frustum
-* @param cullingViewFrustum auxiliary view frustum, used for hills frustum culling routine
+* @brief selects levels of detail of the terrain grid meshes and culls their chunks once per frame,
+* selection is then used by all the render passes
+* @param viewPosition position of the camera
+* @param projectionScale number of pixels a unit long segment takes on the screen at a unit distance from the camera
+* @param viewFrustum camera's view frustum, used for shore and water culling
+* @param cullingViewFrustum auxiliary (wider) view frustum, used for hills culling as hills are drawn to the reflection as well
+*/
+void Scene::updateTerrainLevelsOfDetail( const glm::vec3 & viewPosition,
+										 float projectionScale,
+										 const Frustum & viewFrustum,
+										 const Frustum & cullingViewFrustum )
+{
+	hillsFacade.updateLevelsOfDetail( viewPosition, projectionScale, TERRAIN_LOD_PIXEL_ERROR, cullingViewFrustum );
+	shoreFacade.updateLevelsOfDetail( viewPosition, projectionScale, TERRAIN_LOD_PIXEL_ERROR, viewFrustum );
+	waterFacade.updateLevelsOfDetail( viewPosition, projectionScale, TERRAIN_LOD_PIXEL_ERROR, viewFrustum );
+}
+
+/**
+* @brief handles plain onscreen rendering of the scene objects.
+* Camera, lighting and shadow data of the frame should be uploaded to the frame uniforms beforehand
+* @param ambienceProjectionView auxiliary 'projection * view' matrix used for ambience-like objects (lens flare)
 * @param camera player's camera
 * @param mouseInput mouse input manager
 */
-void Scene::drawWorld( const glm::mat4 & projectionView,
-					   const glm::mat4 & ambienceProjectionView,
-					   const Frustum & viewFrustum,
-					   const Frustum & cullingViewFrustum,
+void Scene::drawWorld( const glm::mat4 & ambienceProjectionView,
 					   const Camera & camera,
 					   MouseInputManager & mouseInput )
 {
 	glm::vec3 viewPosition = camera.getPosition();
 	const glm::vec3 & lightDir = theSunFacade.getLightDir();
-	const std::array<glm::mat4, NUM_SHADOW_LAYERS> & lightSpaceMatrices = shadowVolume.getLightSpaceMatrices();
+	frameUniforms.bindCamera( CAMERA_VIEW_MAIN );
 	bool useShadows = options[OPT_USE_SHADOWS];
 	bool isDebugRender = options[OPT_DEBUG_RENDER];
 
 	if( options[OPT_DRAW_HILLS] )
 	{
-		hillsFacade.draw( lightDir,
-						  lightSpaceMatrices,
-						  projectionView,
-						  viewPosition,
-						  camera.getViewAcceleration(),
-						  cullingViewFrustum,
-						  options[OPT_HILLS_CULLING],
-						  useShadows,
-						  isDebugRender );
+		hillsFacade.draw( options[OPT_HILLS_CULLING], useShadows, isDebugRender );
 	}	
 
 	if( options[OPT_DRAW_LAND] )
 	{
-		landFacade.draw( lightDir, lightSpaceMatrices, projectionView, useShadows );
+		landFacade.draw( useShadows );
 	}
 
-	underwaterFacade.draw( lightDir, projectionView, useShadows );
+	underwaterFacade.draw( useShadows );
 
-	shoreFacade.draw( lightDir, lightSpaceMatrices, projectionView, useShadows, isDebugRender, false, false );
+	shoreFacade.draw( useShadows, isDebugRender, false, false );
 
 	//render everything that requires blending
 
@@ -200,33 +340,29 @@ void Scene::drawWorld( const glm::mat4 & projectionView,
 
 	if( options[OPT_DRAW_BUILDABLE] )
 	{
-		buildableFacade.drawBuildable( projectionView );
+		buildableFacade.drawBuildable();
 	}
 
 	if( options[OPT_SHOW_CURSOR] )
 	{
-		mouseInput.updateCursorMappingCoordinates( landFacade.getMap(), hillsFacade.getMap(), buildableFacade.getMap() );
-		buildableFacade.drawSelected( projectionView, mouseInput );
+		mouseInput.updateCursorMappingCoordinates( terrainMasks, buildableFacade.getMap() );
+		buildableFacade.drawSelected( mouseInput );
 	}
 
 	RendererState::setAmbienceRenderingState( true );
-	skysphereFacade.draw( theSunFacade.getRotationTransform(), ambienceProjectionView, lightDir );
-	theSunFacade.draw( ambienceProjectionView, true, false );
-	skyboxFacade.draw( ambienceProjectionView, viewPosition, lightDir );
+	skysphereFacade.draw( theSunFacade.getRotationTransform(), lightDir );
+	theSunFacade.draw( true, false );
+	skyboxFacade.draw();
 	RendererState::setAmbienceRenderingState( false );
 
 	if( options[OPT_DRAW_WATER] )
 	{
-		waterFacade.draw( lightDir, lightSpaceMatrices, projectionView, viewPosition, viewFrustum, options[OPT_WATER_CULLING], isDebugRender );
+		waterFacade.draw( options[OPT_WATER_CULLING], isDebugRender );
 	}
 
 	if( options[OPT_DRAW_TREES] )
 	{
-		plantsFacade.draw( lightDir,
-						   lightSpaceMatrices,
-						   projectionView,
-						   viewPosition,
-						   options[OPT_MODELS_PHONG_SHADING],
+		plantsFacade.draw( options[OPT_MODELS_PHONG_SHADING],
 						   useShadows,
 						   options[OPT_MODELS_LAND_BLENDING] );
 	}
@@ -243,22 +379,21 @@ void Scene::drawWorld( const glm::mat4 & projectionView,
 /**
 * @brief handles offscreen rendering of the world parts to depthmap (from the sun point of view)
 * @param grassCastShadow defines whether grass models would be rendered to depthmap
+* @note shadow volume should be updated beforehand, its light space matrices are uploaded here
+* and are used by the onscreen passes as well until the next depthmap update
 */
 void Scene::drawWorldDepthmap( bool grassCastShadow )
 {
-	const std::array<glm::mat4, NUM_SHADOW_LAYERS> & lightSpaceMatrices = shadowVolume.getLightSpaceMatrices();
+	frameUniforms.updateShadows( shadowVolume.getLightSpaceMatrices() );
+	UploadManager::getInstance().flush();
 	glClear( GL_DEPTH_BUFFER_BIT );
 
 	//must disable multisampling for this rendering mode
 	RendererState::disableState( GL_MULTISAMPLE );
 
-	/** @todo smells like it is code duplicate, may be move this part to shader manager as separate function */
 	shaderManager.get( SHADER_SHADOW_TERRAIN ).use();
 	if( options[OPT_DRAW_HILLS] )
 	{
-		shaderManager.get( SHADER_SHADOW_TERRAIN ).setMat4( "u_lightSpaceMatrix[0]", lightSpaceMatrices[0] );
-		shaderManager.get( SHADER_SHADOW_TERRAIN ).setMat4( "u_lightSpaceMatrix[1]", lightSpaceMatrices[1] );
-		shaderManager.get( SHADER_SHADOW_TERRAIN ).setMat4( "u_lightSpaceMatrix[2]", lightSpaceMatrices[2] );
 		shaderManager.get( SHADER_SHADOW_TERRAIN ).setInt( "u_terrainType", 0 );
 		hillsFacade.drawDepthmap();
 	}	
@@ -269,9 +404,6 @@ void Scene::drawWorldDepthmap( bool grassCastShadow )
 	if( options[OPT_DRAW_TREES] )
 	{
 		shaderManager.get( SHADER_SHADOW_MODELS ).use();
-		shaderManager.get( SHADER_SHADOW_MODELS ).setMat4( "u_lightSpaceMatrix[0]", lightSpaceMatrices[0] );
-		shaderManager.get( SHADER_SHADOW_MODELS ).setMat4( "u_lightSpaceMatrix[1]", lightSpaceMatrices[1] );
-		shaderManager.get( SHADER_SHADOW_MODELS ).setMat4( "u_lightSpaceMatrix[2]", lightSpaceMatrices[2] );
 		plantsFacade.drawDepthmap( grassCastShadow );
 	}
 
@@ -279,64 +411,47 @@ void Scene::drawWorldDepthmap( bool grassCastShadow )
 }
 
 /**
-* @brief handles offscreen rendering of the world reflection image from the water surface point of view
-* @param projectionView 'projection * view' matrix
-* @param ambienceProjectionView auxiliary 'projection * view' matrix used for ambience-like objects (i.e. skyboxes)
-* @param cullingViewFrustum auxiliary view frustum, used for hills frustum culling routine
-* @param camera player's camera
+* @brief handles offscreen rendering of the world reflection image from the water surface point of view.
+* Uses reflected camera view of the frame uniforms, which should be uploaded beforehand
 */
-void Scene::drawWorldReflection( const glm::mat4 & projectionView,
-								 const glm::mat4 & ambienceProjectionView,
-								 const Frustum & cullingViewFrustum,
-								 const Camera & camera )
+void Scene::drawWorldReflection()
 {
-	glm::vec3 viewPosition = camera.getPosition();
 	const glm::vec3 & lightDir = theSunFacade.getLightDir();
-	const std::array<glm::mat4, NUM_SHADOW_LAYERS> & lightSpaceMatrices = shadowVolume.getLightSpaceMatrices();
-	viewPosition.y *= -1;
+	frameUniforms.bindCamera( CAMERA_VIEW_REFLECTION );
 
 	if( options[OPT_DRAW_HILLS] )
 	{
-		hillsFacade.draw( lightDir,
-						  lightSpaceMatrices,
-						  projectionView,
-						  viewPosition,
-						  camera.getViewAcceleration(),
-						  cullingViewFrustum,
-						  options[OPT_HILLS_CULLING],
-						  options[OPT_USE_SHADOWS],
-						  false );
+		hillsFacade.draw( options[OPT_HILLS_CULLING], options[OPT_USE_SHADOWS], false );
 	}	
 
-	shoreFacade.draw( lightDir, lightSpaceMatrices, projectionView, false, false, true, false );
+	shoreFacade.draw( false, false, true, false );
 
 	RendererState::enableState( GL_BLEND );
 
 	if( options[OPT_DRAW_TREES] )
 	{
-		plantsFacade.draw( lightDir, lightSpaceMatrices, projectionView, viewPosition, false, false, false, true );
+		plantsFacade.draw( false, false, false, true );
 	}
 
 	RendererState::setAmbienceRenderingState( true );
-	skysphereFacade.draw( theSunFacade.getRotationTransform(), ambienceProjectionView, lightDir );
-	skyboxFacade.draw( ambienceProjectionView, viewPosition, lightDir );
+	skysphereFacade.draw( theSunFacade.getRotationTransform(), lightDir );
+	skyboxFacade.draw();
 	RendererState::setAmbienceRenderingState( false );
 
 	RendererState::disableState( GL_BLEND );
 }
 
 /**
-* @brief handles offscreen rendering of the world refraction image from the water surface point of view
-* @param projectionView 'projection * view' matrix
+* @brief handles offscreen rendering of the world refraction image from the water surface point of view.
+* Refraction is seen through the water surface from the camera position, thus the main camera view is used
 */
-void Scene::drawWorldRefraction( const glm::mat4 & projectionView )
+void Scene::drawWorldRefraction()
 {
-	const glm::vec3 & lightDir = theSunFacade.getLightDir();
-	const std::array<glm::mat4, NUM_SHADOW_LAYERS> & lightSpaceMatrices = shadowVolume.getLightSpaceMatrices();
+	frameUniforms.bindCamera( CAMERA_VIEW_MAIN );
 
-	underwaterFacade.draw( lightDir, projectionView, options[OPT_USE_SHADOWS] );
+	underwaterFacade.draw( options[OPT_USE_SHADOWS] );
 
-	shoreFacade.draw( lightDir, lightSpaceMatrices, projectionView, false, false, false, true );
+	shoreFacade.draw( false, false, false, true );
 }
 
 WaterFacade & Scene::getWaterFacade() noexcept
@@ -368,3 +483,18 @@ LandFacade & Scene::getLandFacade() noexcept
 {
 	return landFacade;
 }
+
+IndirectCommandRing & Scene::getIndirectCommandRing() noexcept
+{
+	return indirectCommandRing;
+}
+
+FrameUniforms & Scene::getFrameUniforms() noexcept
+{
+	return frameUniforms;
+}
+
+const HeightfieldOcclusion & Scene::getHillsOcclusion() const noexcept
+{
+	return hillsOcclusion;
+}
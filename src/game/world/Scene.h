@@ -31,6 +31,10 @@
 #include "SkyboxFacade"
 #include "TheSunFacade"
 #include "LensFlareFacade"
+#include "TerrainMasks"
+#include "HeightfieldOcclusion"
+#include "IndirectCommandRing"
+#include "FrameUniforms"
 
 class ShaderManager;
 class TextureManager;
@@ -39,6 +43,8 @@ class Camera;
 class ScreenResolution;
 class Options;
 class ShadowVolume;
+class WorldFileWriter;
+class WorldFileReader;
 
 /**
 * @brief Game scene. Responsible for initializing and managing all the game objects and subsystems, render ordering,
@@ -56,23 +62,24 @@ public:
 	//subsystems functions
 	void setup();
 	void recreate();
+	void reset();
 	void load();
 	void serialize( std::ofstream & output );
 	void deserialize( std::ifstream & input );
+	void serialize( WorldFileWriter & writer ) const;
+	bool deserialize( const WorldFileReader & reader );
 
 	//rendering stuff
-	void drawWorld( const glm::mat4 & projectionView,
-					const glm::mat4 & ambienceProjectionView,
-					const Frustum & viewFrustum,
-					const Frustum & cullingViewFrustum,
+	void updateTerrainLevelsOfDetail( const glm::vec3 & viewPosition,
+									  float projectionScale,
+									  const Frustum & viewFrustum,
+									  const Frustum & cullingViewFrustum );
+	void drawWorld( const glm::mat4 & ambienceProjectionView,
 					const Camera & camera,
 					MouseInputManager & mouseInput );
 	void drawWorldDepthmap( bool grassCastShadow );
-	void drawWorldReflection( const glm::mat4 & projectionView,
-							  const glm::mat4 & ambienceProjectionView,
-							  const Frustum & cullingViewFrustum,
-							  const Camera & camera );
-	void drawWorldRefraction( const glm::mat4 & projectionView );
+	void drawWorldReflection();
+	void drawWorldRefraction();
 
 	//getters
 	WaterFacade & getWaterFacade() noexcept;
@@ -81,15 +88,21 @@ public:
 	TheSunFacade & getSunFacade() noexcept;
 	SkysphereFacade & getSkysphereFacade() noexcept;
 	LandFacade & getLandFacade() noexcept;
+	IndirectCommandRing & getIndirectCommandRing() noexcept;
+	FrameUniforms & getFrameUniforms() noexcept;
+	const HeightfieldOcclusion & getHillsOcclusion() const noexcept;
 
 	const float PLANET_MOVE_SPEED;
 
 private:
+	const float TERRAIN_LOD_PIXEL_ERROR;
 	ShaderManager & shaderManager;
 	Options & options;
 	TextureManager & textureManager;
 	const ShadowVolume & shadowVolume;
 
+	IndirectCommandRing indirectCommandRing;
+	FrameUniforms frameUniforms;
 	WaterFacade waterFacade;
 	HillsFacade hillsFacade;
 	ShoreFacade shoreFacade;
@@ -101,4 +114,8 @@ private:
 	LandFacade landFacade;
 	LensFlareFacade lensFlareFacade;
 	SkysphereFacade skysphereFacade;
+	TerrainMasks terrainMasks;
+	HeightfieldOcclusion hillsOcclusion;
+	/** @brief whether shore map was taken from the loaded file, otherwise it is regenerated during load */
+	bool shoreLoaded;
 };
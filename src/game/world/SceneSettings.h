@@ -21,8 +21,14 @@
 #pragma once
 
 //scene config
+//world size might be overridden at compile time, e.g. to benchmark generators on larger worlds with headless tools
+#ifdef WORLD_SIZE_OVERRIDE
+constexpr int WORLD_WIDTH = WORLD_SIZE_OVERRIDE;
+constexpr int WORLD_HEIGHT = WORLD_SIZE_OVERRIDE;
+#else
 constexpr int WORLD_WIDTH = 384;
 constexpr int WORLD_HEIGHT = 384;
+#endif
 constexpr int HALF_WORLD_WIDTH = WORLD_WIDTH / 2;
 constexpr float HALF_WORLD_WIDTH_F = static_cast<float>( HALF_WORLD_WIDTH );
 constexpr int HALF_WORLD_HEIGHT = WORLD_HEIGHT / 2;
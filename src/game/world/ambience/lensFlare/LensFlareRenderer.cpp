@@ -38,10 +38,10 @@ void LensFlareRenderer::draw( unsigned int numFlares )
 	basicGLBuffer.bind( VAO );
 
 	RendererState::enableState( GL_PROGRAM_POINT_SIZE );
-	glDepthMask( GL_FALSE ); //do not write to depth buffer otherwise flares would occlude each other
-	glBlendFunc( GL_SRC_ALPHA, GL_ONE ); //apply additive blending
+	RendererState::setDepthMask( false ); //do not write to depth buffer otherwise flares would occlude each other
+	RendererState::setBlendFunc( GL_SRC_ALPHA, GL_ONE ); //apply additive blending
 	glDrawArrays( GL_POINTS, 0, numFlares );
-	glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA ); //switch back to default blending function
-	glDepthMask( GL_TRUE ); //switch back depth writing
+	RendererState::setBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA ); //switch back to default blending function
+	RendererState::setDepthMask( true ); //switch back depth writing
 	RendererState::disableState( GL_PROGRAM_POINT_SIZE );
 }
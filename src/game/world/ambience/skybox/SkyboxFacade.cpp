@@ -31,15 +31,10 @@ SkyboxFacade::SkyboxFacade( Shader & renderShader ) noexcept
 /**
  * @brief manages shader program object state changes during rendering and delegates draw call
  * invocations to skybox member object
- * @param skyboxProjectionView Projection*View matrix
- * @param viewPosition current position of the camera
- * @param lightDir direction of the sunlight (directional lighting)
  */
-void SkyboxFacade::draw( const glm::mat4 & skyboxProjectionView,
-						 const glm::vec3 & viewPosition,
-						 const glm::vec3 & lightDir )
+void SkyboxFacade::draw()
 {
-	shader.update( skyboxProjectionView, viewPosition, lightDir );
+	shader.update();
 	shader.selectSkyboxType( SKYBOX_HILLS_NEAR );
 	skybox.draw();
 	shader.selectSkyboxType( SKYBOX_HIILS_FAR );
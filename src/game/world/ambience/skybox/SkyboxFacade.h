@@ -31,9 +31,7 @@ class SkyboxFacade
 {
 public:
 	SkyboxFacade( Shader & renderShader ) noexcept;
-	void draw( const glm::mat4 & skyboxProjectionView,
-			   const glm::vec3 & viewPosition,
-			   const glm::vec3 & lightDir );
+	void draw();
 
 private:
 	//define possible modes of skybox for shader
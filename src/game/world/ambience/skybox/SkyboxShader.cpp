@@ -29,20 +29,11 @@ SkyboxShader::SkyboxShader( Shader & renderShader ) noexcept
 {}
 
 /**
- * @brief activates shader program and updates its uniform variables
- * @param projectionView Projection*View matrix
- * @param viewPosition current position of the camera
- * @param lightDir direction of the sunlight (directional lighting)
+ * @brief activates shader program, camera and lighting data come from the frame uniform blocks
  */
-void SkyboxShader::update( const glm::mat4 & projectionView,
-						   const glm::vec3 & viewPosition,
-						   const glm::vec3 & lightDir )
+void SkyboxShader::update()
 {
 	renderShader.use();
-	renderShader.setMat4( "u_projectionView", projectionView );
-	renderShader.setVec3( "u_viewPosition", viewPosition );
-	//send this as reverse direction
-	renderShader.setVec3( "u_lightDir", -lightDir );
 }
 
 /**
@@ -20,9 +20,6 @@
 
 #pragma once
 
-#include <glm/vec3.hpp>
-#include <glm/mat4x4.hpp>
-
 class Shader;
 
 /**
@@ -33,9 +30,7 @@ class SkyboxShader
 {
 public:
 	SkyboxShader( Shader & renderShader ) noexcept;
-	void update( const glm::mat4 & projectionView,
-				 const glm::vec3 & viewPosition,
-				 const glm::vec3 & lightDir );
+	void update();
 	void selectSkyboxType( int type );
 
 private:
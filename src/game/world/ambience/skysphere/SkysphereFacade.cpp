@@ -37,15 +37,13 @@ SkysphereFacade::SkysphereFacade( Shader & renderShader )
  * @brief manages shader program object state changes during rendering and delegates draw call
  * invocations to skysphere member objects
  * @param transform transformation matrix to apply
- * @param projectionView Projection*View matrix
  * @param lightDir direction of the sunlight (directional lighting)
  */
 void SkysphereFacade::draw( const glm::mat4 & transform,
-							const glm::mat4 & projectionView,
 							const glm::vec3 & lightDir )
 {
 	float sunPositionAttenuation = glm::clamp( ( -lightDir.y + 0.05 ) * 8, 0.0, 1.0 );
-	shader.update( projectionView, lightDir, sunPositionAttenuation );
+	shader.update( sunPositionAttenuation );
 
 	//is the Sun is low enough bypass drawing ambient lighting 
 	if( sunPositionAttenuation > 0.01 )
@@ -33,7 +33,6 @@ class SkysphereFacade
 public:
 	SkysphereFacade( Shader & renderShader );
 	void draw( const glm::mat4 & transform,
-			   const glm::mat4 & projectionView,
 			   const glm::vec3 & lightDir );
 	void moveStarsSkysphere( float angleDegrees );
 
@@ -30,19 +30,12 @@ SkysphereShader::SkysphereShader( Shader & renderShader ) noexcept
 {}
 
 /**
- * @brief activates shader program and updates its uniforms
- * @param projectionView Projection*View matrix
- * @param lightDir direction of the sunlight (directional lighting)
+ * @brief activates shader program and updates its uniforms, camera and lighting data come from the frame uniform blocks
  * @param sunPositionAttenuation value defining how much the sun position would affect output color
  */
-void SkysphereShader::update( const glm::mat4 & projectionView, 
-							  const glm::vec3 & lightDir,
-							  float sunPositionAttenuation )
+void SkysphereShader::update( float sunPositionAttenuation )
 {
 	renderShader.use();
-	renderShader.setMat4( "u_projectionView", projectionView );
-	//send this as reverse direction
-	renderShader.setVec3( "u_lightDir", -lightDir );
 	renderShader.setFloat( "u_sunPositionAttenuation", sunPositionAttenuation );
 }
 
@@ -21,7 +21,6 @@
 #pragma once
 
 #include <glm/mat4x4.hpp>
-#include <glm/vec3.hpp>
 
 class Shader;
 
@@ -34,9 +33,7 @@ class SkysphereShader
 {
 public:
 	SkysphereShader( Shader & renderShader ) noexcept;
-	void update( const glm::mat4 & projectionView, 
-				 const glm::vec3 & lightDir,
-				 float sunPositionAttenuation );
+	void update( float sunPositionAttenuation );
 	void setSkysphereType( int type, 
 						   const glm::mat4 & transform );
 
@@ -20,6 +20,7 @@
 
 #include "TheSun"
 #include "SceneSettings"
+#include "WorldFile"
 
 #include <glm/gtc/type_ptr.hpp>
 #include <fstream>
@@ -93,6 +94,41 @@ void TheSun::deserialize( std::ifstream & input )
 	lightDirTo = glm::normalize( -currentPosition );
 }
 
+/**
+ * @brief performs binary serialization of necessary data
+ * @param writer world file writer
+ */
+void TheSun::serialize( WorldFileWriter & writer ) const
+{
+	writer.write( currentPosition );
+	writer.write( rotationTransform );
+}
+
+/**
+ * @brief reads the state from the binary world file section without applying it
+ * @param section world file section to read data from
+ * @param savedState state to read to
+ * @return false if section data is incomplete
+ */
+bool TheSun::read( WorldFileSection & section,
+				   TheSunSavedState & savedState ) noexcept
+{
+	section.read( savedState.position );
+	section.read( savedState.rotationTransform );
+	return !section.isFailed();
+}
+
+/**
+ * @brief applies the state previously read from the binary world file
+ * @param savedState position and rotation transform of the Sun
+ */
+void TheSun::deserialize( const TheSunSavedState & savedState ) noexcept
+{
+	currentPosition = savedState.position;
+	rotationTransform = savedState.rotationTransform;
+	lightDirTo = glm::normalize( -currentPosition );
+}
+
 const glm::vec3 & TheSun::getPosition() const noexcept
 {
 	return currentPosition;
@@ -24,6 +24,18 @@
 
 #include <glm/gtx/rotate_vector.hpp>
 
+class WorldFileWriter;
+class WorldFileSection;
+
+/**
+ * @brief state of the Sun as it is stored in the binary world file
+ */
+struct TheSunSavedState
+{
+	glm::vec3 position;
+	glm::mat4 rotationTransform;
+};
+
 /**
  * @brief Represents the Sun entity, contains its own buffer collection and transformations applied.
  * Responsible for keeping track of its position, direction of light and buffer data
@@ -37,6 +49,10 @@ public:
 	void moveAbsolutePosition( float angleDegrees );
 	void serialize( std::ofstream & output );
 	void deserialize( std::ifstream & input );
+	void serialize( WorldFileWriter & writer ) const;
+	static bool read( WorldFileSection & section,
+					  TheSunSavedState & savedState ) noexcept;
+	void deserialize( const TheSunSavedState & savedState ) noexcept;
 	const glm::vec3 & getPosition() const noexcept;
 	const glm::vec3 & getLightDir() const noexcept;
 	const glm::mat4 & getRotationTransform() const noexcept;
@@ -78,15 +78,13 @@ void TheSunFacade::moveAbsolutePosition( float angleRadians )
 
 /**
  * @brief updates the shader and delegates draw call to renderer
- * @param skyProjectionView Projection*View matrix
  * @param doOcclusionTest define whether or not occlusion query takes place during rendering
  * @param useReflectionPointSize a flag for renderer indicating what point size to use
  */
-void TheSunFacade::draw( const glm::mat4 & skyProjectionView,
-						 bool doOcclusionTest,
+void TheSunFacade::draw( bool doOcclusionTest,
 						 bool useReflectionPointSize )
 {
-	shader.update( skyProjectionView, theSun.getRotationTransform() );
+	shader.update( theSun.getRotationTransform() );
 	renderer.render( doOcclusionTest, useReflectionPointSize );
 }
 
@@ -108,6 +106,35 @@ void TheSunFacade::deserialize( std::ifstream & input )
 	theSun.deserialize( input );
 }
 
+/**
+ * @brief delegates binary serialization to the sun
+ * @param writer world file writer
+ */
+void TheSunFacade::serialize( WorldFileWriter & writer ) const
+{
+	theSun.serialize( writer );
+}
+
+/**
+ * @brief delegates binary section reading to the sun
+ * @param section world file section to read data from
+ * @param savedState state to read to
+ */
+bool TheSunFacade::read( WorldFileSection & section,
+						 TheSunSavedState & savedState ) const noexcept
+{
+	return TheSun::read( section, savedState );
+}
+
+/**
+ * @brief delegates binary deserialization to the sun
+ * @param savedState state previously read from the world file
+ */
+void TheSunFacade::deserialize( const TheSunSavedState & savedState ) noexcept
+{
+	theSun.deserialize( savedState );
+}
+
 const glm::vec3 & TheSunFacade::getPosition() const noexcept
 {
 	return theSun.getPosition();
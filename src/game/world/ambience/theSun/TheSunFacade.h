@@ -38,11 +38,14 @@ public:
 				  const ScreenResolution & screenResolution ) noexcept;
 	void move( float angleDegrees );
 	void moveAbsolutePosition( float angleDegrees );
-	void draw( const glm::mat4 & skyProjectionView, 
-			   bool doOcclusionTest, 
+	void draw( bool doOcclusionTest, 
 			   bool useReflectionPointSize );
 	void serialize( std::ofstream & output );
 	void deserialize( std::ifstream & input );
+	void serialize( WorldFileWriter & writer ) const;
+	bool read( WorldFileSection & section,
+			   TheSunSavedState & savedState ) const noexcept;
+	void deserialize( const TheSunSavedState & savedState ) noexcept;
 	const glm::vec3 & getPosition() const noexcept;
 	const glm::vec3 & getLightDir() const noexcept;
 	const glm::mat4 & getRotationTransform() const noexcept;
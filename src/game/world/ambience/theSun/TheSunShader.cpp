@@ -29,14 +29,11 @@ TheSunShader::TheSunShader( Shader & renderShader ) noexcept
 {}
 
 /**
- * @brief activates shader program and updates its uniforms
- * @param projectionView Projection*View matrix
+ * @brief activates shader program and updates its uniforms, projectionView comes from the camera block
  * @param model Model matrix
  */
-void TheSunShader::update( const glm::mat4 & projectionView, 
-						   const glm::mat4 & model )
+void TheSunShader::update( const glm::mat4 & model )
 {
 	renderShader.use();
-	renderShader.setMat4( "u_projectionView", projectionView );
 	renderShader.setMat4( "u_model", model );
 }
@@ -31,8 +31,7 @@ class TheSunShader
 {
 public:
 	TheSunShader( Shader & renderShader ) noexcept;
-	void update( const glm::mat4 & projectionView, 
-				 const glm::mat4 & model );
+	void update( const glm::mat4 & model );
 
 private:
 	Shader & renderShader;
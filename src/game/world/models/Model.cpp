@@ -46,7 +46,7 @@ Model::Model( const char * localName,
 	, isLowPoly( isLowPoly )
 	, numRepetitions( numRepetitions )
 	, GPUDataManager( isLowPoly )
-	, renderer( GPUDataManager.getBasicGLBuffers(), GPUDataManager.getDepthmapDIBO(), GPUDataManager.getReflectionDIBO() )
+	, renderer( GPUDataManager.getBasicGLBuffers() )
 {
 	load( localName );
 }
@@ -62,7 +62,7 @@ void Model::load( const char * localName )
 	//parse textures
 	loadTextures( resource );
 
-	GPUDataManager.setupBuffers( resource.verticesData, resource.numVertices, resource.indicesData, resource.numIndices, isInstanced );
+	GPUDataManager.setupBuffers( resource.verticesData, resource.numVertices, resource.indicesData, resource.numIndices );
 }
 
 /**
@@ -98,7 +98,7 @@ void Model::loadTextures( const ModelResource & resource )
 void Model::draw( bool isShadow )
 {
 	MODEL_INDIRECT_BUFFER_TYPE type = isShadow ? DEPTHMAP_OFFSCREEN : PLAIN_ONSCREEN;
-	renderer.render( type, GPUDataManager.getPrimitiveCount( type ) );
+	renderer.render( GPUDataManager.getDrawCommands( type ) );
 }
 
 /**
@@ -106,7 +106,7 @@ void Model::draw( bool isShadow )
 */
 void Model::drawWorldReflection()
 {
-	renderer.render( REFLECTION_ONSCREEN, GPUDataManager.getPrimitiveCount( REFLECTION_ONSCREEN ) );
+	renderer.render( GPUDataManager.getDrawCommands( REFLECTION_ONSCREEN ) );
 }
 
 void Model::drawOneInstance()
@@ -116,25 +116,21 @@ void Model::drawOneInstance()
 
 /**
  * @brief delegates indirect buffer data preparation to model's data manager
- * @param visibleChunks model's chunks storage with corresponding distance from the camera position
+ * @param renderChunks storage of the model chunks of the generator
+ * @param visibleChunks chunks visible during this frame with corresponding distance from the camera position
  * @param modelIndex model's index in a chunks storage
  * @param loadingDistance rendering distance for full-res models
  * @param loadingDistanceShadow rendering distance for models' shadows
+ * @param indirectCommandRing shared storage of the indirect draw commands for the current frame
  */
-void Model::prepareIndirectBufferData( const std::vector<std::pair<ModelChunk, unsigned int>> & visibleChunks,
+void Model::prepareIndirectBufferData( const ModelRenderChunks & renderChunks,
+									   const VisibleModelChunks & visibleChunks,
 									   unsigned int modelIndex,
 									   float loadingDistance,
-									   float loadingDistanceShadow )
+									   float loadingDistanceShadow,
+									   IndirectCommandRing & indirectCommandRing )
 {
-	GPUDataManager.prepareIndirectBufferData( visibleChunks, modelIndex, loadingDistance, loadingDistanceShadow );
-}
-
-/**
- * @brief delegates indirect buffer data GPU update to model's data manager
- */
-void Model::updateIndirectBufferData()
-{
-	GPUDataManager.updateIndirectBufferData();
+	GPUDataManager.prepareIndirectBufferData( renderChunks, visibleChunks, modelIndex, loadingDistance, loadingDistanceShadow, indirectCommandRing );
 }
 
 /**
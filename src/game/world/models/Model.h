@@ -24,7 +24,8 @@
 #include "ModelRenderer"
 
 class TextureLoader;
-class ModelChunk;
+class ModelRenderChunks;
+struct VisibleModelChunks;
 class ModelResource;
 
 /**
@@ -43,11 +44,12 @@ public:
 	void draw( bool isShadow );
 	void drawWorldReflection();
 	void drawOneInstance();
-	void prepareIndirectBufferData( const std::vector<std::pair<ModelChunk, unsigned int> > & visibleChunks,
+	void prepareIndirectBufferData( const ModelRenderChunks & renderChunks,
+									const VisibleModelChunks & visibleChunks,
 									unsigned int modelIndex,
 									float loadingDistance,
-									float loadingDistanceShadow );
-	void updateIndirectBufferData();
+									float loadingDistanceShadow,
+									IndirectCommandRing & indirectCommandRing );
 	void loadModelInstances( const std::vector<glm::mat4> & instanceMatrices );
 	unsigned int getRepeatCount() const noexcept;
 
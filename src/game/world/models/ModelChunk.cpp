@@ -26,5 +26,4 @@ ModelChunk::ModelChunk( unsigned int left,
 						unsigned int bottom, 
 						float height )
 	: Chunk( left, right, top, bottom, height )
-	, occluded( false )
 {}
@@ -43,6 +43,7 @@ public:
 							unsigned int offset );
 	unsigned int getInstanceOffset( int index ) const;
 	std::vector<unsigned int> & getInstanceOffsetVector() noexcept;
+	const std::vector<unsigned int> & getInstanceOffsetVector() const noexcept;
 
 	//number of models instances (one unsigned int per model)
 	void setNumInstancesVector( std::vector<unsigned int> & numInstances );
@@ -50,15 +51,11 @@ public:
 						  unsigned int instances );
 	unsigned int getNumInstances( int index ) const;
 	std::vector<unsigned int> & getNumInstancesVector() noexcept;
-
-	//occlusion
-	bool isOccluded() const noexcept;
-	void setOccluded( bool isOccluded ) noexcept;
+	const std::vector<unsigned int> & getNumInstancesVector() const noexcept;
 
 private:
 	std::vector<unsigned int> instanceOffsets;
 	std::vector<unsigned int> numInstances;
-	bool occluded;
 };
 
 inline void ModelChunk::setInstanceOffsetsVector( std::vector<unsigned int> & instanceOffsets )
@@ -99,6 +96,11 @@ inline std::vector<unsigned int> & ModelChunk::getInstanceOffsetVector() noexcep
 	return instanceOffsets;
 }
 
+inline const std::vector<unsigned int> & ModelChunk::getInstanceOffsetVector() const noexcept
+{
+	return instanceOffsets;
+}
+
 inline unsigned int ModelChunk::getNumInstances( int index ) const
 {
 	return numInstances[index];
@@ -109,12 +111,7 @@ inline std::vector<unsigned int> & ModelChunk::getNumInstancesVector() noexcept
 	return numInstances;
 }
 
-inline bool ModelChunk::isOccluded() const noexcept
+inline const std::vector<unsigned int> & ModelChunk::getNumInstancesVector() const noexcept
 {
-	return occluded;
-}
-
-inline void ModelChunk::setOccluded( bool isOccluded ) noexcept
-{
-	this->occluded = isOccluded;
+	return numInstances;
 }
@@ -19,9 +19,10 @@
  */
 
 #include "ModelGPUDataManager"
-#include "ModelChunk"
+#include "ModelRenderChunks"
 #include "ModelVertex"
 #include "SceneSettings"
+#include "UploadManager"
 
 /**
 * @brief plain ctor
@@ -38,18 +39,17 @@ ModelGPUDataManager::ModelGPUDataManager( bool isParentModelLowPoly )
 * @param numVertices number of vertices in array
 * @param indices array of indices data
 * @param indicesCount number of indices in array
-* @param useIndirectBuffer indicator of whether indirect buffer will be used for this model
 */
 void ModelGPUDataManager::setupBuffers( const char * vertices, 
 										unsigned int numVertices, 
 										const char * indices, 
-										unsigned int indicesCount, 
-										bool useIndirectBuffer )
+										unsigned int indicesCount )
 {
 	this->indicesCount = indicesCount;
 	basicGLBuffers.bind( VAO | VBO | EBO );
-	glBufferData( GL_ARRAY_BUFFER, MODEL_VERTEX_SIZE * numVertices, &vertices[0], GL_STATIC_DRAW );
-	glBufferData( GL_ELEMENT_ARRAY_BUFFER, sizeof( GLuint ) * indicesCount, &indices[0], GL_STATIC_DRAW );
+	UploadManager & uploadManager = UploadManager::getInstance();
+	uploadManager.uploadBufferData( basicGLBuffers.get( VBO ), MODEL_VERTEX_SIZE * numVertices, vertices, GL_STATIC_DRAW );
+	uploadManager.uploadBufferData( basicGLBuffers.get( EBO ), sizeof( GLuint ) * indicesCount, indices, GL_STATIC_DRAW );
 	glEnableVertexAttribArray( 0 );
 	glVertexAttribPointer( 0, 3, GL_FLOAT, GL_FALSE, MODEL_VERTEX_SIZE, (void*)0 );
 	glEnableVertexAttribArray( 1 );
@@ -64,82 +64,53 @@ void ModelGPUDataManager::setupBuffers( const char * vertices,
 	//intentionally set GL_FLOAT although the data is a pair of unsigned integers
 	glVertexAttribPointer( 9, 2, GL_FLOAT, GL_FALSE, MODEL_VERTEX_SIZE, (void*)offsetof( ModelVertexImpl, TexIndices ) );
 
-	if( useIndirectBuffer )
-	{
-		setupIndirectBuffers();
-	}
-
 	BufferCollection::bindZero( VAO | VBO | EBO );
 }
 
 /**
-* @brief initializes indirect buffer for plain onscreen, depthmap and world reflection buffer collections
-*/
-void ModelGPUDataManager::setupIndirectBuffers()
-{
-	GLuint numElements = NUM_CHUNKS * INDIRECT_DRAW_COMMAND_ARGUMENTS;
-	GLsizei sizeInBytes = sizeof( GLuint ) * numElements;
-	if( basicGLBuffers.get( DIBO ) == 0 )
-	{
-		multiDrawIndirectData = std::make_unique<GLuint[]>( numElements );
-		basicGLBuffers.add( DIBO );
-		basicGLBuffers.bind( DIBO );
-		glNamedBufferStorage( basicGLBuffers.get( DIBO ), sizeInBytes, 0, GL_DYNAMIC_STORAGE_BIT );
-	}
-	if( depthmapDIBO.get( DIBO ) == 0 )
-	{
-		multiDrawIndirectDataDepthmap = std::make_unique<GLuint[]>( numElements );
-		depthmapDIBO.add( DIBO );
-		depthmapDIBO.bind( DIBO );
-		glNamedBufferStorage( depthmapDIBO.get( DIBO ), sizeInBytes, 0, GL_DYNAMIC_STORAGE_BIT );
-	}
-	if( reflectionDIBO.get( DIBO ) == 0 )
-	{
-		multiDrawIndirectDataReflection = std::make_unique<GLuint[]>( numElements );
-		reflectionDIBO.add( DIBO );
-		reflectionDIBO.bind( DIBO );
-		glNamedBufferStorage( reflectionDIBO.get( DIBO ), sizeInBytes, 0, GL_DYNAMIC_STORAGE_BIT );
-	}
-}
-
-/**
-* @brief updates internal indirect buffer storages with given chunks data
-* @param visibleChunks storage of the currently visible models chunks
+* @brief collects draw commands for the given chunks and writes them to the indirect command ring
+* @param renderChunks storage of the model chunks of the generator
+* @param visibleChunks currently visible models chunks
 * @param modelIndex index of this model in each chunk
 * @param loadingDistance maximum distance for onscreen rendering of full-poly models
 * @param loadingDistanceShadow maximum distance for offscreen depthmap rendering of all models
+* @param indirectCommandRing shared storage of the indirect draw commands for the current frame
 */
-void ModelGPUDataManager::prepareIndirectBufferData( const std::vector<std::pair<ModelChunk, unsigned int>> & visibleChunks,
+void ModelGPUDataManager::prepareIndirectBufferData( const ModelRenderChunks & renderChunks,
+													 const VisibleModelChunks & visibleChunks,
 													 unsigned int modelIndex,
 													 float loadingDistance,
-													 float loadingDistanceShadow )
+													 float loadingDistanceShadow,
+													 IndirectCommandRing & indirectCommandRing )
 {
-	//recreate indirect draw commands storages
+	//recreate indirect draw commands storages, each takes at most one token per chunk,
+	//thus capacity is reserved for all the chunks once and kept between frames
 	indirectTokens.clear();
-	indirectTokens.reserve( visibleChunks.size() );
+	indirectTokens.reserve( renderChunks.size() );
 	indirectTokensDepthmap.clear();
-	indirectTokensDepthmap.reserve( visibleChunks.size() );
+	indirectTokensDepthmap.reserve( renderChunks.size() );
 	indirectTokensReflection.clear();
-	indirectTokensReflection.reserve( visibleChunks.size() );
+	indirectTokensReflection.reserve( renderChunks.size() );
 
-	for( unsigned int chunkIndex = 0; chunkIndex < visibleChunks.size(); chunkIndex++ )
+	for( size_t visibleIndex = 0; visibleIndex < visibleChunks.size(); visibleIndex++ )
 	{
-		const ModelChunk & chunk = visibleChunks[chunkIndex].first;
-		unsigned int distanceToChunk = visibleChunks[chunkIndex].second;
+		const unsigned int CHUNK_INDEX = visibleChunks.chunkIndices[visibleIndex];
+		unsigned int distanceToChunk = visibleChunks.distances[visibleIndex];
+		const bool IS_OCCLUDED = visibleChunks.occluded[visibleIndex] != 0;
 
-		unsigned int numInstancesInChunk = chunk.getNumInstances( modelIndex );
+		unsigned int numInstancesInChunk = renderChunks.getNumInstances( CHUNK_INDEX, modelIndex );
 		//no need to process chunk if this model is not presented in there
 		if( numInstancesInChunk == 0 )
 		{
 			continue;
 		}
-		unsigned int instanceOffsetInChunk = chunk.getInstanceOffset( modelIndex );
+		unsigned int instanceOffsetInChunk = renderChunks.getInstanceOffset( CHUNK_INDEX, modelIndex );
 
 		if( distanceToChunk < loadingDistanceShadow )
 		{
 			if( !isLowPoly )
 			{
-				if( distanceToChunk < loadingDistance && !chunk.isOccluded() )
+				if( distanceToChunk < loadingDistance && !IS_OCCLUDED )
 				{
 					//draw nearby camera if fullpoly
 					addIndirectBufferToken( numInstancesInChunk, instanceOffsetInChunk, PLAIN_ONSCREEN );
@@ -152,82 +123,49 @@ void ModelGPUDataManager::prepareIndirectBufferData( const std::vector<std::pair
 			}
 		}
 		//draw farther from camera if lowpoly
-		if( isLowPoly && distanceToChunk >= loadingDistance && !chunk.isOccluded() )
+		if( isLowPoly && distanceToChunk >= loadingDistance && !IS_OCCLUDED )
 		{
 			addIndirectBufferToken( numInstancesInChunk, instanceOffsetInChunk, PLAIN_ONSCREEN );
 		}
 
 		//for world reflection rendering mode better render all models as lowpoly regardless of distance 
-		if( isLowPoly && !chunk.isOccluded() )
+		if( isLowPoly && !IS_OCCLUDED )
 		{
 			addIndirectBufferToken( numInstancesInChunk, instanceOffsetInChunk, REFLECTION_ONSCREEN );
 		}
 	}
 
-	//after indirect tokens have been updated load them to local buffers
-	GLuint dataOffset = 0;
-	for( const auto & token : indirectTokens )
-	{
-		multiDrawIndirectData[dataOffset++] = indicesCount;
-		multiDrawIndirectData[dataOffset++] = token.numInstances;
-		multiDrawIndirectData[dataOffset++] = token.FIRST_INDEX;
-		multiDrawIndirectData[dataOffset++] = token.BASE_VERTEX;
-		multiDrawIndirectData[dataOffset++] = token.instanceOffset;
-	}
-	drawIndirectCommandPrimCount = indirectTokens.size();
-
-	dataOffset = 0;
-	for( const auto & token : indirectTokensDepthmap )
-	{
-		multiDrawIndirectDataDepthmap[dataOffset++] = indicesCount;
-		multiDrawIndirectDataDepthmap[dataOffset++] = token.numInstances;
-		multiDrawIndirectDataDepthmap[dataOffset++] = token.FIRST_INDEX;
-		multiDrawIndirectDataDepthmap[dataOffset++] = token.BASE_VERTEX;
-		multiDrawIndirectDataDepthmap[dataOffset++] = token.instanceOffset;
-	}
-	drawIndirectCommandPrimCountDepthmap = indirectTokensDepthmap.size();
-
-	dataOffset = 0;
-	for( const auto & token : indirectTokensReflection )
+	//after indirect tokens have been updated reserve space for all the model commands at once and write them straight to the ring
+	const GLsizei NUM_COMMANDS = GLsizei( indirectTokens.size() + indirectTokensDepthmap.size() + indirectTokensReflection.size() );
+	IndirectCommandRange modelCommands;
+	GLuint * commands = indirectCommandRing.allocate( NUM_COMMANDS, modelCommands );
+	if( !commands )
 	{
-		multiDrawIndirectDataReflection[dataOffset++] = indicesCount;
-		multiDrawIndirectDataReflection[dataOffset++] = token.numInstances;
-		multiDrawIndirectDataReflection[dataOffset++] = token.FIRST_INDEX;
-		multiDrawIndirectDataReflection[dataOffset++] = token.BASE_VERTEX;
-		multiDrawIndirectDataReflection[dataOffset++] = token.instanceOffset;
+		drawCommands = drawCommandsDepthmap = drawCommandsReflection = IndirectCommandRange();
+		return;
 	}
-	drawIndirectCommandPrimCountReflection = indirectTokensReflection.size();
+	GLintptr byteOffset = modelCommands.byteOffset;
+	commands = writeDrawCommands( indirectTokens, commands, byteOffset, drawCommands );
+	byteOffset += INDIRECT_DRAW_COMMAND_BYTE_SIZE * drawCommands.numCommands;
+	commands = writeDrawCommands( indirectTokensDepthmap, commands, byteOffset, drawCommandsDepthmap );
+	byteOffset += INDIRECT_DRAW_COMMAND_BYTE_SIZE * drawCommandsDepthmap.numCommands;
+	writeDrawCommands( indirectTokensReflection, commands, byteOffset, drawCommandsReflection );
 }
 
 /**
-* @brief updates indirect buffers on the GPU side with data from client buffer storages
-*/
-void ModelGPUDataManager::updateIndirectBufferData()
-{
-	basicGLBuffers.bind( DIBO );
-	glBufferSubData( GL_DRAW_INDIRECT_BUFFER, 0, INDIRECT_DRAW_COMMAND_BYTE_SIZE * drawIndirectCommandPrimCount, multiDrawIndirectData.get() );
-	depthmapDIBO.bind( DIBO );
-	glBufferSubData( GL_DRAW_INDIRECT_BUFFER, 0, INDIRECT_DRAW_COMMAND_BYTE_SIZE * drawIndirectCommandPrimCountDepthmap, multiDrawIndirectDataDepthmap.get() );
-	reflectionDIBO.bind( DIBO );
-	glBufferSubData( GL_DRAW_INDIRECT_BUFFER, 0, INDIRECT_DRAW_COMMAND_BYTE_SIZE * drawIndirectCommandPrimCountReflection, multiDrawIndirectDataReflection.get() );
-}
-
-/**
-* @brief updates instances dedicated vbo with given data
+* @brief updates instances dedicated vbo with given data. Buffer is reused between loads, its storage is only
+* reallocated if the number of instances has changed
 * @param instanceMatrices storage of instances 'model' matrices
 */
 void ModelGPUDataManager::loadModelInstancesData( const std::vector<glm::mat4> & instanceMatrices )
 {
 	basicGLBuffers.bind( VAO );
-	if( basicGLBuffers.get( INSTANCE_VBO ) != 0 )
+	if( basicGLBuffers.get( INSTANCE_VBO ) == 0 )
 	{
-		basicGLBuffers.bind( INSTANCE_VBO );
-		glInvalidateBufferData( basicGLBuffers.get( INSTANCE_VBO ) );
-		basicGLBuffers.deleteBuffer( INSTANCE_VBO );
+		basicGLBuffers.add( INSTANCE_VBO );
 	}
-	basicGLBuffers.add( INSTANCE_VBO );
 	basicGLBuffers.bind( INSTANCE_VBO );
-	glBufferData( GL_ARRAY_BUFFER, sizeof( glm::mat4 ) * instanceMatrices.size(), &instanceMatrices[0], GL_STATIC_DRAW );
+	UploadManager::getInstance().uploadBufferData( basicGLBuffers.get( INSTANCE_VBO ), sizeof( glm::mat4 ) * instanceMatrices.size(), instanceMatrices.data(), GL_STATIC_DRAW );
 	for( unsigned int i = 0; i < 4; ++i )
 	{
 		glEnableVertexAttribArray( i + 5 );
@@ -296,19 +234,45 @@ void ModelGPUDataManager::reduceIndirectBufferTokens( std::vector<IndirectBuffer
 	tokens.assign( reduced.begin(), reduced.end() );
 }
 
-GLsizei ModelGPUDataManager::getPrimitiveCount( MODEL_INDIRECT_BUFFER_TYPE type ) const noexcept
+/**
+* @brief writes draw commands for the given tokens to the mapped memory
+* @param tokens collection of tokens
+* @param commands mapped memory to write commands to
+* @param byteOffset offset of the first command in the ring buffer
+* @param range location of the written commands to fill
+* @return pointer to the memory right after the last written command
+*/
+GLuint * ModelGPUDataManager::writeDrawCommands( const std::vector<IndirectBufferToken> & tokens,
+												 GLuint * commands,
+												 GLintptr byteOffset,
+												 IndirectCommandRange & range ) const noexcept
+{
+	for( const auto & token : tokens )
+	{
+		*commands++ = indicesCount;
+		*commands++ = token.numInstances;
+		*commands++ = token.FIRST_INDEX;
+		*commands++ = token.BASE_VERTEX;
+		*commands++ = token.instanceOffset;
+	}
+	range.byteOffset = byteOffset;
+	range.numCommands = GLsizei( tokens.size() );
+	return commands;
+}
+
+const IndirectCommandRange & ModelGPUDataManager::getDrawCommands( MODEL_INDIRECT_BUFFER_TYPE type ) const noexcept
 {
 	if( type == PLAIN_ONSCREEN )
 	{
-		return drawIndirectCommandPrimCount;
+		return drawCommands;
 	}
 	else if( type == DEPTHMAP_OFFSCREEN )
 	{
-		return drawIndirectCommandPrimCountDepthmap;
+		return drawCommandsDepthmap;
 	}
 	else
 	{
-		return drawIndirectCommandPrimCountReflection;
+		return drawCommandsReflection;
 	}
 }
 
@@ -322,16 +286,6 @@ BufferCollection & ModelGPUDataManager::getBasicGLBuffers() noexcept
 	return basicGLBuffers;
 }
 
-BufferCollection & ModelGPUDataManager::getDepthmapDIBO() noexcept
-{
-	return depthmapDIBO;
-}
-
-BufferCollection & ModelGPUDataManager::getReflectionDIBO() noexcept
-{
-	return reflectionDIBO;
-}
-
 /**
 * @brief plain ctor
 * @param numInstances number of instances used in an indirect draw command
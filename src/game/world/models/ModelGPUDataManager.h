@@ -21,16 +21,19 @@
 #pragma once
 
 #include "BufferCollection"
+#include "IndirectCommandRing"
 #include "ModelIndirectBufferTypes"
 
 #include <glm/mat4x4.hpp>
-#include <memory>
+#include <vector>
 
-class ModelChunk;
+class ModelRenderChunks;
+struct VisibleModelChunks;
 
 /**
 * @brief manager for GPU model data. Responsible for initializing and updating data for indirect rendering of a model.
-* Has a separate indirect draw buffer for depthmap rendering
+* Has separate lists of indirect draw commands for onscreen, depthmap and world reflection rendering,
+* all of them are written directly to the shared indirect command ring
 */
 class ModelGPUDataManager
 {
@@ -39,19 +42,17 @@ public:
 	void setupBuffers( const char * vertices,
 					   unsigned int numVertices,
 					   const char * indices,
-					   unsigned int indicesCount,
-					   bool useIndirectBuffer );
-	void prepareIndirectBufferData( const std::vector<std::pair<ModelChunk, unsigned int> > & chunks,
+					   unsigned int indicesCount );
+	void prepareIndirectBufferData( const ModelRenderChunks & renderChunks,
+									const VisibleModelChunks & visibleChunks,
 									unsigned int modelIndex,
 									float loadingDistance,
-									float loadingDistanceShadow );
-	void updateIndirectBufferData();
+									float loadingDistanceShadow,
+									IndirectCommandRing & indirectCommandRing );
 	void loadModelInstancesData( const std::vector<glm::mat4> & instanceMatrices );
-	GLsizei getPrimitiveCount( MODEL_INDIRECT_BUFFER_TYPE type ) const noexcept;
+	const IndirectCommandRange & getDrawCommands( MODEL_INDIRECT_BUFFER_TYPE type ) const noexcept;
 	GLuint getIndicesCount() const noexcept;
 	BufferCollection & getBasicGLBuffers() noexcept;
-	BufferCollection & getDepthmapDIBO() noexcept;
-	BufferCollection & getReflectionDIBO() noexcept;
 
 private:
 	/**
@@ -69,11 +70,14 @@ private:
 		static constexpr GLuint BASE_VERTEX = 0;
 	};
 
-	void setupIndirectBuffers();
 	void addIndirectBufferToken( GLuint numInstances, 
 								 GLuint instanceOffset, 
 								 MODEL_INDIRECT_BUFFER_TYPE type );
 	void reduceIndirectBufferTokens( std::vector<IndirectBufferToken> & tokens );
+	GLuint * writeDrawCommands( const std::vector<IndirectBufferToken> & tokens,
+								GLuint * commands,
+								GLintptr byteOffset,
+								IndirectCommandRange & range ) const noexcept;
 
 	//parent model attributes
 	GLuint indicesCount;
@@ -81,19 +85,14 @@ private:
 
 	//screen rendering related variables
 	BufferCollection basicGLBuffers;
-	std::unique_ptr<GLuint[]> multiDrawIndirectData;
 	std::vector<IndirectBufferToken> indirectTokens;
-	GLsizei drawIndirectCommandPrimCount = 0;
+	IndirectCommandRange drawCommands;
 
 	//depthmap rendering related variables
-	BufferCollection depthmapDIBO;
-	std::unique_ptr<GLuint[]> multiDrawIndirectDataDepthmap;
 	std::vector<IndirectBufferToken> indirectTokensDepthmap;
-	GLsizei drawIndirectCommandPrimCountDepthmap = 0;
+	IndirectCommandRange drawCommandsDepthmap;
 
 	//world reflection rendering related variables
-	BufferCollection reflectionDIBO;
-	std::unique_ptr<GLuint[]> multiDrawIndirectDataReflection;
 	std::vector<IndirectBufferToken> indirectTokensReflection;
-	GLsizei drawIndirectCommandPrimCountReflection = 0;
+	IndirectCommandRange drawCommandsReflection;
 };
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * ModelRenderChunks.cpp
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains definitions for ModelRenderChunks class and VisibleModelChunks structure
+ * @version 0.1.0
+ */
+
+#include "ModelRenderChunks"
+#include "SceneSettings"
+
+#include <algorithm>
+
+/**
+* @brief reserves space for the given number of visible chunks in all the parallel arrays
+* @param numChunks maximum number of chunks expected to be visible
+*/
+void VisibleModelChunks::reserve( size_t numChunks )
+{
+	chunkIndices.reserve( numChunks );
+	distances.reserve( numChunks );
+	occluded.reserve( numChunks );
+}
+
+ModelRenderChunks::ModelRenderChunks() noexcept
+	: numModels( 0 )
+{}
+
+/**
+* @brief rebuilds storage and culling tree from the non-empty chunks of the given list and updates their height values
+* @param chunks all the model chunks of a generator (including empty ones)
+* @param map 2d map of the given terrain type
+* @param approximateHeight approximate height of the models above the terrain
+*/
+void ModelRenderChunks::assign( const std::vector<ModelChunk> & chunks,
+								const map2D_f & map,
+								float approximateHeight )
+{
+	numModels = chunks.empty() ? 0 : (unsigned int)chunks.front().getNumInstancesVector().size();
+	lefts.clear();
+	rights.clear();
+	tops.clear();
+	bottoms.clear();
+	midPointsX.clear();
+	midPointsZ.clear();
+	heights.clear();
+	numInstances.clear();
+	instanceOffsets.clear();
+
+	for( const ModelChunk & chunk : chunks )
+	{
+		const std::vector<unsigned int> & chunkNumInstances = chunk.getNumInstancesVector();
+		const std::vector<unsigned int> & chunkInstanceOffsets = chunk.getInstanceOffsetVector();
+		const bool IS_EMPTY = std::all_of( chunkNumInstances.begin(), chunkNumInstances.end(), []( unsigned int numInstances ) noexcept
+		{
+			return numInstances == 0;
+		} );
+		if( IS_EMPTY )
+		{
+			continue;
+		}
+
+		const float MAP_MAX_HEIGHT = std::max( std::max( map[chunk.getTop()][chunk.getLeft()], map[chunk.getBottom()][chunk.getLeft()] ),
+											   std::max( map[chunk.getTop()][chunk.getRight()], map[chunk.getBottom()][chunk.getRight()] ) );
+		lefts.emplace_back( chunk.getLeft() );
+		rights.emplace_back( chunk.getRight() );
+		tops.emplace_back( chunk.getTop() );
+		bottoms.emplace_back( chunk.getBottom() );
+		midPointsX.emplace_back( chunk.getMidPoint().x );
+		midPointsZ.emplace_back( chunk.getMidPoint().y );
+		heights.emplace_back( std::max( approximateHeight, MAP_MAX_HEIGHT + approximateHeight ) );
+		numInstances.insert( numInstances.end(), chunkNumInstances.begin(), chunkNumInstances.begin() + numModels );
+		instanceOffsets.insert( instanceOffsets.end(), chunkInstanceOffsets.begin(), chunkInstanceOffsets.begin() + numModels );
+	}
+
+	lefts.shrink_to_fit();
+	rights.shrink_to_fit();
+	tops.shrink_to_fit();
+	bottoms.shrink_to_fit();
+	midPointsX.shrink_to_fit();
+	midPointsZ.shrink_to_fit();
+	heights.shrink_to_fit();
+	numInstances.shrink_to_fit();
+	instanceOffsets.shrink_to_fit();
+
+	chunksTree.clear();
+	chunksTree.reserve( heights.size() );
+	for( size_t chunkIndex = 0; chunkIndex < heights.size(); chunkIndex++ )
+	{
+		chunksTree.addChunk( glm::vec3( midPointsX[chunkIndex] - HALF_CHUNK_SIZE, 0.0f, midPointsZ[chunkIndex] - HALF_CHUNK_SIZE ),
+							 glm::vec3( midPointsX[chunkIndex] + HALF_CHUNK_SIZE, heights[chunkIndex], midPointsZ[chunkIndex] + HALF_CHUNK_SIZE ) );
+	}
+	chunksTree.build();
+}
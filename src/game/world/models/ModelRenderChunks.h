@@ -0,0 +1,171 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * ModelRenderChunks.h
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains declaration and inline functions for ModelRenderChunks class and VisibleModelChunks structure
+ * @version 0.1.0
+ */
+
+#pragma once
+
+#include "ModelChunk"
+#include "TypeAliases"
+#include "ChunkQuadtree"
+
+#include <vector>
+
+/**
+* @brief list of the render chunks that passed culling during the current frame.
+* Chunks are referred to by their index in the render chunks storage, squared distances to the camera
+* and occlusion flags are kept in parallel arrays. The lists are cleared but never shrunk,
+* thus filling them does not allocate once they have grown to the maximum number of visible chunks
+*/
+struct VisibleModelChunks
+{
+	void clear() noexcept;
+	void reserve( size_t numChunks );
+	void add( unsigned int chunkIndex,
+			  unsigned int distanceToChunk );
+	size_t size() const noexcept;
+
+	std::vector<unsigned int> chunkIndices;
+	std::vector<unsigned int> distances;
+	std::vector<unsigned char> occluded;
+};
+
+/**
+* @brief structure-of-arrays storage of the non-empty model chunks used during rendering.
+* Chunk bounds and heights live in flat per-chunk arrays, number of instances and instance offsets of all the models
+* live in flat arrays with one row of numModels values per chunk, thus culling and indirect commands preparation
+* walk over contiguous memory and never copy chunks. Chunk boxes (from the ground to the chunk height) are kept in a quadtree
+* for hierarchical frustum culling
+*/
+class ModelRenderChunks
+{
+public:
+	ModelRenderChunks() noexcept;
+	void assign( const std::vector<ModelChunk> & chunks,
+				 const map2D_f & map,
+				 float approximateHeight );
+	size_t size() const noexcept;
+	unsigned int getNumModels() const noexcept;
+	unsigned int getLeft( size_t chunkIndex ) const noexcept;
+	unsigned int getRight( size_t chunkIndex ) const noexcept;
+	unsigned int getTop( size_t chunkIndex ) const noexcept;
+	unsigned int getBottom( size_t chunkIndex ) const noexcept;
+	float getMidPointX( size_t chunkIndex ) const noexcept;
+	float getMidPointZ( size_t chunkIndex ) const noexcept;
+	float getHeight( size_t chunkIndex ) const noexcept;
+	unsigned int getNumInstances( size_t chunkIndex,
+								  unsigned int modelIndex ) const noexcept;
+	unsigned int getInstanceOffset( size_t chunkIndex,
+									unsigned int modelIndex ) const noexcept;
+	const ChunkQuadtree & getChunksTree() const noexcept;
+
+private:
+	unsigned int numModels;
+	std::vector<unsigned int> lefts;
+	std::vector<unsigned int> rights;
+	std::vector<unsigned int> tops;
+	std::vector<unsigned int> bottoms;
+	std::vector<float> midPointsX;
+	std::vector<float> midPointsZ;
+	std::vector<float> heights;
+	std::vector<unsigned int> numInstances;
+	std::vector<unsigned int> instanceOffsets;
+	ChunkQuadtree chunksTree;
+};
+
+inline void VisibleModelChunks::clear() noexcept
+{
+	chunkIndices.clear();
+	distances.clear();
+	occluded.clear();
+}
+
+inline void VisibleModelChunks::add( unsigned int chunkIndex,
+									 unsigned int distanceToChunk )
+{
+	chunkIndices.emplace_back( chunkIndex );
+	distances.emplace_back( distanceToChunk );
+	occluded.emplace_back( false );
+}
+
+inline size_t VisibleModelChunks::size() const noexcept
+{
+	return chunkIndices.size();
+}
+
+inline size_t ModelRenderChunks::size() const noexcept
+{
+	return heights.size();
+}
+
+inline unsigned int ModelRenderChunks::getNumModels() const noexcept
+{
+	return numModels;
+}
+
+inline unsigned int ModelRenderChunks::getLeft( size_t chunkIndex ) const noexcept
+{
+	return lefts[chunkIndex];
+}
+
+inline unsigned int ModelRenderChunks::getRight( size_t chunkIndex ) const noexcept
+{
+	return rights[chunkIndex];
+}
+
+inline unsigned int ModelRenderChunks::getTop( size_t chunkIndex ) const noexcept
+{
+	return tops[chunkIndex];
+}
+
+inline unsigned int ModelRenderChunks::getBottom( size_t chunkIndex ) const noexcept
+{
+	return bottoms[chunkIndex];
+}
+
+inline float ModelRenderChunks::getMidPointX( size_t chunkIndex ) const noexcept
+{
+	return midPointsX[chunkIndex];
+}
+
+inline float ModelRenderChunks::getMidPointZ( size_t chunkIndex ) const noexcept
+{
+	return midPointsZ[chunkIndex];
+}
+
+inline float ModelRenderChunks::getHeight( size_t chunkIndex ) const noexcept
+{
+	return heights[chunkIndex];
+}
+
+inline unsigned int ModelRenderChunks::getNumInstances( size_t chunkIndex,
+														unsigned int modelIndex ) const noexcept
+{
+	return numInstances[chunkIndex * numModels + modelIndex];
+}
+
+inline unsigned int ModelRenderChunks::getInstanceOffset( size_t chunkIndex,
+														  unsigned int modelIndex ) const noexcept
+{
+	return instanceOffsets[chunkIndex * numModels + modelIndex];
+}
+
+inline const ChunkQuadtree & ModelRenderChunks::getChunksTree() const noexcept
+{
+	return chunksTree;
+}
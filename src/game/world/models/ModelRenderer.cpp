@@ -19,44 +19,29 @@
  */
 
 #include "ModelRenderer"
-#include "BufferCollection"
+#include "IndirectCommandRing"
 
 /**
 * @brief plain ctor
 * @param basicGLBuffers onscreen rendering buffer collection
-* @param depthmapDIBO offscreen indirect draw buffer for depthmap rendering
-* @param reflectionDIBO onscreen indirect draw buffer for world reflection rendering
 */
-ModelRenderer::ModelRenderer( BufferCollection & basicGLBuffers,
-							  BufferCollection & depthmapDIBO,
-							  BufferCollection & reflectionDIBO ) noexcept
+ModelRenderer::ModelRenderer( BufferCollection & basicGLBuffers ) noexcept
 	: basicGLBuffers( basicGLBuffers )
-	, depthmapDIBO( depthmapDIBO )
-	, reflectionDIBO( reflectionDIBO )
 {}
 
 /**
-* @brief sends draw calls to OpenGL depending on the current mode
-* @param isDepthmap rendering mode
-* @param primCount number of instances to render
+* @brief sends indirect draw call for the given commands to OpenGL
+* @param drawCommands location of the commands of the current rendering mode
+* @note indirect command ring is expected to be bound already
 */
-void ModelRenderer::render( MODEL_INDIRECT_BUFFER_TYPE type, 
-							GLsizei primCount )
+void ModelRenderer::render( const IndirectCommandRange & drawCommands )
 {
-	basicGLBuffers.bind( VAO );
-	if( type == PLAIN_ONSCREEN )
-	{
-		basicGLBuffers.bind( DIBO );
-	}
-	else if( type == DEPTHMAP_OFFSCREEN )
+	if( drawCommands.numCommands == 0 )
 	{
-		depthmapDIBO.bind( DIBO );
+		return;
 	}
-	else
-	{
-		reflectionDIBO.bind( DIBO );
-	}
-	glMultiDrawElementsIndirect( GL_TRIANGLES, GL_UNSIGNED_INT, 0, primCount, 0 );
+	basicGLBuffers.bind( VAO );
+	glMultiDrawElementsIndirect( GL_TRIANGLES, GL_UNSIGNED_INT, (void*)drawCommands.byteOffset, drawCommands.numCommands, 0 );
 }
 
 /**
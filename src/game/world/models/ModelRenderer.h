@@ -20,11 +20,10 @@
 
 #pragma once
 
-#include "ModelIndirectBufferTypes.h"
-
 #include <GL/glew.h>
 
 class BufferCollection;
+struct IndirectCommandRange;
 
 /**
 * @brief renderer for model for both onscreen and depthmap modes.
@@ -33,15 +32,10 @@ class BufferCollection;
 class ModelRenderer
 {
 public:
-	ModelRenderer( BufferCollection & basicGLBuffers,
-				   BufferCollection & depthmapDIBO,
-				   BufferCollection & reflectionDIBO ) noexcept;
-	void render( MODEL_INDIRECT_BUFFER_TYPE type, 
-				 GLsizei primCount );
+	ModelRenderer( BufferCollection & basicGLBuffers ) noexcept;
+	void render( const IndirectCommandRange & drawCommands );
 	void renderOneInstance( GLsizei numIndices );
 
 private:
 	BufferCollection & basicGLBuffers;
-	BufferCollection & depthmapDIBO;
-	BufferCollection & reflectionDIBO;
 };
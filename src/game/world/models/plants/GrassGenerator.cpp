@@ -19,8 +19,10 @@
  */
 
 #include "GrassGenerator"
+#include "TileMask"
 #include "Model"
 #include "SettingsManager"
+#include "RandomStream"
 
 #include <glm/gtc/matrix_transform.hpp>
 
@@ -54,26 +56,24 @@ GrassGenerator::GrassGenerator() noexcept
 /**
  * @brief initialize models chunks and accomodate grass models on the world map based on input maps
  * @param landMap map of the land
- * @param hillMap map of the hills
+ * @param freeCells mask of cells lying on flat land without visible hills
  * @param distributionMap map filled with distribution seed values
  */
 void GrassGenerator::setup( const map2D_f & landMap,
-							const map2D_f & hillMap,
+							const TileMask & freeCells,
 							const map2D_i & distributionMap )
 {
 	initializeModelChunks( landMap );
-	setupMatrices( landMap, hillMap, distributionMap );
+	setupMatrices( freeCells, distributionMap );
 	initializeModelRenderChunks( landMap, APPROXIMATE_GRASS_CHUNK_HEIGHT );
 }
 
 /**
  * @brief calculates instance matrices for grass models and spreads them on world map
- * @param landMap map of the land
- * @param hillMap map of the hills
+ * @param freeCells mask of cells lying on flat land without visible hills
  * @param distributionMap map filled with distribution seed values
  */
-void GrassGenerator::setupMatrices( const map2D_f & landMap,
-									const map2D_f & hillMap,
+void GrassGenerator::setupMatrices( const TileMask & freeCells,
 									const map2D_i & distributionMap )
 {
 	const int PLANTS_DISTRIBUTION_FREQUENCY = SettingsManager::getInt( "SCENE", "plants_distribution_freq" );
@@ -82,7 +82,6 @@ void GrassGenerator::setupMatrices( const map2D_f & landMap,
 
 	//get empty boilerplate storage to fill during (re)allocation
 	map2D_mat4 matricesStorage = substituteMatricesStorage();
-	std::uniform_real_distribution<float> modelSizeDistribution( MIN_SCALE, MAX_SCALE );
 
 	size_t numberOfModels = models.size();
 	std::vector<unsigned int> instanceOffsetsVector( numberOfModels, 0 );
@@ -100,21 +99,21 @@ void GrassGenerator::setupMatrices( const map2D_f & landMap,
 			{
 				for( unsigned int x = startX; x < startX + CHUNK_SIZE; x++ )
 				{
+					RandomStream random( RANDOM_STREAM_GRASS, x, y );
 					//check if there is land and no visible hills
-					if( ( landMap[y][x] == 0 && landMap[y + 1][x + 1] == 0 && landMap[y + 1][x] == 0 && landMap[y][x + 1] == 0 ) &&
-						!( hillMap[y][x] > -HILLS_OFFSET_Y ||
-						   hillMap[y + 1][x + 1] > -HILLS_OFFSET_Y ||
-						   hillMap[y + 1][x] > -HILLS_OFFSET_Y ||
-						   hillMap[y][x + 1] > -HILLS_OFFSET_Y ) &&
-						rand() % ( PLANTS_DISTRIBUTION_FREQUENCY / 2 - 1 ) == 0 &&     //is there a randomizer "hit"
+					if( freeCells.test( x, y ) &&
+						random.nextUint( PLANTS_DISTRIBUTION_FREQUENCY / 2 - 1 ) == 0 && //is there a randomizer "hit"
 						distributionMap[y][x] > PLANTS_DISTRIBUTION_FREQUENCY / 2 )   //is a seed value at these coordinates high enough to proceed
 					{
 						glm::mat4 model;
 						//offset on XZ to place on a tile center
 						glm::vec3 translateVector( -HALF_WORLD_WIDTH_F + x + 0.5f, 0.0f, -HALF_WORLD_HEIGHT_F + y + 0.5f );
 						model = glm::translate( model, translateVector );
-						model = glm::rotate( model, glm::radians( (float)( rand() * WORLD_WIDTH + x * 5 ) ), glm::vec3( 0.0f, 1.0f, 0.0f ) );
-						glm::vec3 scaleVector( modelSizeDistribution( randomizer ), modelSizeDistribution( randomizer ), modelSizeDistribution( randomizer ) );
+						model = glm::rotate( model, glm::radians( random.nextFloat( 0.0f, 360.0f ) ), glm::vec3( 0.0f, 1.0f, 0.0f ) );
+						const float SCALE_X = random.nextFloat( MIN_SCALE, MAX_SCALE );
+						const float SCALE_Y = random.nextFloat( MIN_SCALE, MAX_SCALE );
+						const float SCALE_Z = random.nextFloat( MIN_SCALE, MAX_SCALE );
+						glm::vec3 scaleVector( SCALE_X, SCALE_Y, SCALE_Z );
 						model = glm::scale( model, scaleVector );
 
 						size_t currentModelIndex = matrixCounter % numberOfModels;
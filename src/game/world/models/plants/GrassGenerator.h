@@ -22,6 +22,8 @@
 
 #include "PlantGenerator"
 
+class TileMask;
+
 /**
  * @brief Generator for grass. Responsible for accomodating all grass models on the world map
  */
@@ -30,11 +32,10 @@ class GrassGenerator : public PlantGenerator
 public:
 	GrassGenerator() noexcept;
 	void setup( const map2D_f & landMap, 
-				const map2D_f & hillMap, 
+				const TileMask & freeCells, 
 				const map2D_i & distributionMap );
 
 private:
-	void setupMatrices( const map2D_f & landMap, 
-						const map2D_f & hillMap, 
+	void setupMatrices( const TileMask & freeCells, 
 						const map2D_i & distributionMap );
 };
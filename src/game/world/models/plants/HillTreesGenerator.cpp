@@ -21,6 +21,7 @@
 #include "HillTreesGenerator"
 #include "Model"
 #include "SettingsManager"
+#include "RandomStream"
 
 #include <glm/gtc/matrix_transform.hpp>
 
@@ -101,10 +102,6 @@ void HillTreesGenerator::setupMatrices( const map2D_f & hillMap,
 
 	//get empty boilerplate storage to fill during (re)allocation
 	map2D_mat4 matricesStorage = substituteMatricesStorage();
-	std::uniform_real_distribution<float> sizeDistribution( MIN_SCALE_TREES, MAX_SCALE_TREES );
-	std::uniform_real_distribution<float> sizeDistributionRocks( MIN_SCALE_ROCKS, MAX_SCALE_ROCKS );
-	std::uniform_real_distribution<float> positionDistribution( MIN_POSITION_OFFSET, MAX_POSITION_OFFSET );
-	std::uniform_real_distribution<float> rotationDistribution( MIN_ROTATION_OFFSET, MAX_ROTATION_OFFSET );
 
 	size_t numberOfModels = models.size();
 	std::vector<unsigned int> instanceOffsetsVector( numberOfModels, 0 );
@@ -124,6 +121,7 @@ void HillTreesGenerator::setupMatrices( const map2D_f & hillMap,
 			{
 				for( unsigned int x = startX; x < startX + CHUNK_SIZE; x++ )
 				{
+					RandomStream random( RANDOM_STREAM_HILL_TREES, x, y );
 					float maxHeight = std::max( hillMap[y][x], std::max( hillMap[y][x + 1], std::max( hillMap[y + 1][x], hillMap[y + 1][x + 1] ) ) );
 					float minHeight = std::min( hillMap[y][x], std::min( hillMap[y][x + 1], std::min( hillMap[y + 1][x], hillMap[y + 1][x + 1] ) ) );
 					float slope = maxHeight - minHeight;
@@ -142,19 +140,24 @@ void HillTreesGenerator::setupMatrices( const map2D_f & hillMap,
 	//firstly check whether to allocate a tree at these coordinates
 					if( slope < MAX_SURFACE_SLOPE_FOR_TREES && //hill at these coordinates is not too steep
 						( hillMap[y][x] != 0 || hillMap[y + 1][x + 1] != 0 || hillMap[y + 1][x] != 0 || hillMap[y][x + 1] != 0 ) && //are there hills
-						( rand() % ( PLANTS_DISTRIBUTION_FREQUENCY / 2 - 1 ) ) == 0 &&            //is there a randomizer "hit"
+						random.nextUint( PLANTS_DISTRIBUTION_FREQUENCY / 2 - 1 ) == 0 &&          //is there a randomizer "hit"
 						distributionMap[y][x] >( PLANTS_DISTRIBUTION_FREQUENCY / 2 - 1 ) &&    //is a seed value at these coordinates high enough to proceed
 						translationY > 0 )
 					{
 						glm::mat4 model;
 						//additional XZ offset
-						float offsetX = positionDistribution( randomizer ) * ( 1.0f - slope );
-						float offsetZ = positionDistribution( randomizer ) * ( 1.0f - slope );
+						float offsetX = random.nextFloat( MIN_POSITION_OFFSET, MAX_POSITION_OFFSET ) * ( 1.0f - slope );
+						float offsetZ = random.nextFloat( MIN_POSITION_OFFSET, MAX_POSITION_OFFSET ) * ( 1.0f - slope );
 						glm::vec3 translationVector( translationX + offsetX, translationY, translationZ + offsetZ );
 						model = glm::translate( model, translationVector );
-						glm::vec3 rotateVector( rotationDistribution( randomizer ), 1.0f, rotationDistribution( randomizer ) );
+						const float ROTATION_X = random.nextFloat( MIN_ROTATION_OFFSET, MAX_ROTATION_OFFSET );
+						const float ROTATION_Z = random.nextFloat( MIN_ROTATION_OFFSET, MAX_ROTATION_OFFSET );
+						glm::vec3 rotateVector( ROTATION_X, 1.0f, ROTATION_Z );
 						model = glm::rotate( model, glm::radians( (float)( y * WORLD_WIDTH + x * 5 ) ), rotateVector );
-						glm::vec3 scaleVector( sizeDistribution( randomizer ), sizeDistribution( randomizer ), sizeDistribution( randomizer ) );
+						const float SCALE_X = random.nextFloat( MIN_SCALE_TREES, MAX_SCALE_TREES );
+						const float SCALE_Y = random.nextFloat( MIN_SCALE_TREES, MAX_SCALE_TREES );
+						const float SCALE_Z = random.nextFloat( MIN_SCALE_TREES, MAX_SCALE_TREES );
+						glm::vec3 scaleVector( SCALE_X, SCALE_Y, SCALE_Z );
 						model = glm::scale( model, scaleVector );
 
 						size_t currentModelIndex = matrixCounter % ( numberOfModels - numSurfaceOrientedModels );
@@ -175,7 +178,7 @@ void HillTreesGenerator::setupMatrices( const map2D_f & hillMap,
 					//check whether surface oriented model should be allocated here
 					if( slope < MAX_SURFACE_SLOPE_FOR_ROCKS && //hill at these coordinates is not too steep
 						( hillMap[y][x] != 0 || hillMap[y + 1][x + 1] != 0 || hillMap[y + 1][x] != 0 || hillMap[y][x + 1] != 0 ) &&
-						( rand() % ( PLANTS_DISTRIBUTION_FREQUENCY / 2 + 1 ) ) == 0 && //is there a randomizer "hit"
+						random.nextUint( PLANTS_DISTRIBUTION_FREQUENCY / 2 + 1 ) == 0 && //is there a randomizer "hit"
 						translationY > 1.0f )
 					{
 						glm::mat4 model;
@@ -194,7 +197,7 @@ void HillTreesGenerator::setupMatrices( const map2D_f & hillMap,
 						model *= changeOfBasisTransform;
 
 						model = glm::rotate( model, glm::radians( (float)( y * WORLD_WIDTH + x * 29 ) ), glm::vec3( 0.0f, 1.0f, 0.0f ) );
-						glm::vec3 scaleVector( sizeDistributionRocks( randomizer ) ); //uniform scaling
+						glm::vec3 scaleVector( random.nextFloat( MIN_SCALE_ROCKS, MAX_SCALE_ROCKS ) ); //uniform scaling
 						model = glm::scale( model, scaleVector );
 
 						size_t surfaceOrientedModelIndex = numberOfModels - numSurfaceOrientedModels + ( orientedMatrixCounter % numSurfaceOrientedModels );
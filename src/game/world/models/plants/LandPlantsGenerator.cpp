@@ -19,8 +19,10 @@
  */
 
 #include "LandPlantsGenerator"
+#include "TileMask"
 #include "Model"
 #include "SettingsManager"
+#include "RandomStream"
 
 #include <glm/gtc/matrix_transform.hpp>
 
@@ -70,26 +72,24 @@ LandPlantsGenerator::LandPlantsGenerator() noexcept
 /**
  * @brief initialize models chunks and accomodate land plants models on the world map based on input maps
  * @param landMap map of the land
- * @param hillMap map of the hills
+ * @param freeCells mask of cells lying on flat land without visible hills
  * @param distributionMap map filled with distribution seed values
  */
 void LandPlantsGenerator::setup( const map2D_f & landMap, 
-								 const map2D_f & hillMap, 
+								 const TileMask & freeCells, 
 								 const map2D_i & distributionMap )
 {
 	initializeModelChunks( landMap );
-	setupMatrices( landMap, hillMap, distributionMap );
+	setupMatrices( freeCells, distributionMap );
 	initializeModelRenderChunks( landMap, APPROXIMATE_LAND_PLANTS_CHUNK_HEIGHT );
 }
 
 /**
  * @brief calculates instance matrices for land plants models and spreads them on world map
- * @param landMap map of the land
- * @param hillMap map of the hills
+ * @param freeCells mask of cells lying on flat land without visible hills
  * @param distributionMap map filled with distribution seed values
  */
-void LandPlantsGenerator::setupMatrices( const map2D_f & landMap, 
-										 const map2D_f & hillMap, 
+void LandPlantsGenerator::setupMatrices( const TileMask & freeCells, 
 										 const map2D_i & distributionMap )
 {
 	const int PLANTS_DISTRIBUTION_FREQUENCY = SettingsManager::getInt( "SCENE", "plants_distribution_freq" );
@@ -100,8 +100,6 @@ void LandPlantsGenerator::setupMatrices( const map2D_f & landMap,
 
 	//get empty boilerplate storage to fill during (re)allocation
 	map2D_mat4 matricesStorage = substituteMatricesStorage();
-	std::uniform_real_distribution<float> sizeDistribution( MIN_SCALE, MAX_SCALE );
-	std::uniform_real_distribution<float> positionDistribution( MIN_POSITION_OFFSET, MAX_POSITION_OFFSET );
 
 	size_t numberOfModels = models.size();
 	std::vector<unsigned int> instanceOffsetsVector( numberOfModels, 0 );
@@ -119,24 +117,23 @@ void LandPlantsGenerator::setupMatrices( const map2D_f & landMap,
 			{
 				for( unsigned int x = startX; x < startX + CHUNK_SIZE; x++ )
 				{
+					RandomStream random( RANDOM_STREAM_LAND_PLANTS, x, y );
 					//check if there is land and no visible hills
-					if( ( landMap[y][x] == 0 && landMap[y + 1][x + 1] == 0 && landMap[y + 1][x] == 0 && landMap[y][x + 1] == 0 ) &&
-						!( hillMap[y][x] > -HILLS_OFFSET_Y ||
-						   hillMap[y + 1][x + 1] > -HILLS_OFFSET_Y ||
-						   hillMap[y + 1][x] > -HILLS_OFFSET_Y ||
-						   hillMap[y][x + 1] > -HILLS_OFFSET_Y ) &&
-						( rand() % ( PLANTS_DISTRIBUTION_FREQUENCY / 2 ) ) == 0 &&      //is there a randomizer "hit"
+					if( freeCells.test( x, y ) &&
+						random.nextUint( PLANTS_DISTRIBUTION_FREQUENCY / 2 ) == 0 &&    //is there a randomizer "hit"
 						distributionMap[y][x] > PLANTS_DISTRIBUTION_FREQUENCY / 2 )  //is a seed value at these coordinates high enough to proceed
 					{
 						glm::mat4 model;
 						//offset on XZ to place on a tile center
-						glm::vec3 translationVector( -HALF_WORLD_WIDTH_F + x + positionDistribution( randomizer ) + 0.5f,
+						const float OFFSET_X = random.nextFloat( MIN_POSITION_OFFSET, MAX_POSITION_OFFSET );
+						const float OFFSET_Z = random.nextFloat( MIN_POSITION_OFFSET, MAX_POSITION_OFFSET );
+						glm::vec3 translationVector( -HALF_WORLD_WIDTH_F + x + OFFSET_X + 0.5f,
 													 0.0f,
-													 -HALF_WORLD_HEIGHT_F + y + positionDistribution( randomizer ) + 0.5f );
+													 -HALF_WORLD_HEIGHT_F + y + OFFSET_Z + 0.5f );
 						model = glm::translate( model, translationVector );
 						model = glm::rotate( model, glm::radians( (float)( y * WORLD_WIDTH + x * 5 ) ), glm::vec3( 0.0f, 1.0f, 0.0f ) );
-						float scaleXandZ = sizeDistribution( randomizer );
-						glm::vec3 scaleVector( scaleXandZ, sizeDistribution( randomizer ), scaleXandZ ); //uniform scaling for X and Z
+						float scaleXandZ = random.nextFloat( MIN_SCALE, MAX_SCALE );
+						glm::vec3 scaleVector( scaleXandZ, random.nextFloat( MIN_SCALE, MAX_SCALE ), scaleXandZ ); //uniform scaling for X and Z
 						model = glm::scale( model, scaleVector );
 
 						size_t currentModelIndex = matrixCounter % numberOfModels;
@@ -22,6 +22,8 @@
 
 #include "PlantGenerator"
 
+class TileMask;
+
 /**
  * @brief Generator for plants located on the land.
  * Responsible for accomodating all land plants models on the world map
@@ -31,11 +33,10 @@ class LandPlantsGenerator : public PlantGenerator
 public:
 	LandPlantsGenerator() noexcept;
 	void setup( const map2D_f & landMap, 
-				const map2D_f & hillMap, 
+				const TileMask & freeCells, 
 				const map2D_i & distributionMap );
 
 private:
-	void setupMatrices( const map2D_f & landMap, 
-						const map2D_f & hillMap, 
+	void setupMatrices( const TileMask & freeCells, 
 						const map2D_i & distributionMap );
 };
@@ -22,17 +22,20 @@
 #include "Model"
 #include "Camera"
 #include "SettingsManager"
+#include "WorldFile"
+#include "HeightfieldOcclusion"
 
 #include <iomanip>
-#include <chrono>
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtx/norm.hpp>
 
 /**
- * @brief sets seed for randomizer
+ * @brief plain ctor
  */
 PlantGenerator::PlantGenerator() noexcept
-	: LOADING_DISTANCE_CHUNKS( SettingsManager::getInt( "PLANT_GENERATOR", "loading_distance_chunks" ) )
+	: occlusionCache( SettingsManager::getInt( "PLANT_GENERATOR", "occlusion_test_budget_us" ) )
+
+	, LOADING_DISTANCE_CHUNKS( SettingsManager::getInt( "PLANT_GENERATOR", "loading_distance_chunks" ) )
 	, LOADING_DISTANCE_UNITS( CHUNK_SIZE * LOADING_DISTANCE_CHUNKS )
 	, LOADING_DISTANCE_UNITS_SQUARE( LOADING_DISTANCE_UNITS * LOADING_DISTANCE_UNITS )
 
@@ -43,14 +46,7 @@ PlantGenerator::PlantGenerator() noexcept
 	, LOADING_DISTANCE_CHUNKS_SHADOW( SettingsManager::getInt( "PLANT_GENERATOR", "loading_distance_chunks_shadow" ) )
 	, LOADING_DISTANCE_UNITS_SHADOW( CHUNK_SIZE * LOADING_DISTANCE_CHUNKS_SHADOW )
 	, LOADING_DISTANCE_UNITS_SHADOW_SQUARE( LOADING_DISTANCE_UNITS_SHADOW * LOADING_DISTANCE_UNITS_SHADOW )
-{
-	static bool randomizerInitialized = false;
-	if( !randomizerInitialized )
-	{
-		randomizer.seed( std::chrono::system_clock::now().time_since_epoch().count() );
-		randomizerInitialized = true;
-	}
-}
+{}
 
 /**
  * @brief fills model chunks storage with empty chunks to work during next stages
@@ -78,36 +74,22 @@ void PlantGenerator::initializeModelChunks( const map2D_f & map )
 void PlantGenerator::initializeModelRenderChunks( const map2D_f & map,
 												  const float approximateHeight )
 {
-	//in case of reinitialization make sure to clear previous content
-	renderChunks.clear();
-	renderChunks.reserve( chunks.size() );
-	for( auto& chunk : chunks )
-	{
-		bool isEmpty = true;
-		for( auto numInstances : chunk.getNumInstancesVector() )
-		{
-			if( numInstances != 0 )
-			{
-				isEmpty = false;
-				break;
-			}
-		}
-		if( !isEmpty )
-		{
-			renderChunks.push_back( chunk );
-		}
-	}
-	renderChunks.shrink_to_fit();
+	renderChunks.assign( chunks, map, approximateHeight );
+
+	//every render chunk might be visible at once, thus visible list never grows during rendering
+	visibleChunks.clear();
+	visibleChunks.reserve( renderChunks.size() );
 
-	for( ModelChunk & renderChunk : renderChunks )
+	//occlusion results of the previous chunks (if any) are not relevant anymore
+	occlusionCache.clear();
+	occlusionCache.reserve( renderChunks.size() );
+	for( size_t chunkIndex = 0; chunkIndex < renderChunks.size(); chunkIndex++ )
 	{
-		float mapMaxHeight = glm::max(
-			glm::max(
-				glm::max( map[renderChunk.getTop()][renderChunk.getLeft()],
-						  map[renderChunk.getBottom()][renderChunk.getLeft()] ),
-				map[renderChunk.getTop()][renderChunk.getRight()] ),
-			map[renderChunk.getBottom()][renderChunk.getRight()] );
-		renderChunk.setHeight( glm::max( approximateHeight, mapMaxHeight + approximateHeight ) );
+		occlusionCache.addChunk( renderChunks.getLeft( chunkIndex ),
+								 renderChunks.getRight( chunkIndex ),
+								 renderChunks.getTop( chunkIndex ),
+								 renderChunks.getBottom( chunkIndex ),
+								 renderChunks.getHeight( chunkIndex ) );
 	}
 }
 
@@ -259,65 +241,137 @@ void PlantGenerator::deserialize( std::ifstream & input )
 }
 
 /**
- * @brief for each model prepare its indirect buffer data using CPU frustum culling
- * @param camera player's camera
- * @param viewFrustum frustum to perform CPU culling
- * @param hillMap map of the hills
+ * @brief performs binary serialization of generated data: chunks instances info followed by instance matrices of each model
+ * @param writer world file writer
  */
-void PlantGenerator::prepareIndirectBufferData( const Camera & camera,
-												const Frustum & viewFrustum,
-												const map2D_f & hillMap )
+void PlantGenerator::serialize( WorldFileWriter & writer ) const
 {
-	const float CAMERA_ON_MAP_X = glm::clamp( camera.getPosition().x, -HALF_WORLD_WIDTH_F, HALF_WORLD_WIDTH_F );
-	const float CAMERA_ON_MAP_Z = glm::clamp( camera.getPosition().z, -HALF_WORLD_HEIGHT_F, HALF_WORLD_HEIGHT_F );
-	const glm::vec2 CAMERA_POSITION_XZ( CAMERA_ON_MAP_X, CAMERA_ON_MAP_Z );
-
-	//firstly precalculate only those chunks that are visible in a view frustum and close enough to a camera
-	std::vector<std::pair<ModelChunk, unsigned int>> visibleChunks;
-	visibleChunks.reserve( NUM_CHUNKS / 2 );
-
-	for( ModelChunk & chunk : renderChunks )
+	const uint32_t NUM_MODELS = (uint32_t)matrices.size();
+	writer.write( (uint32_t)chunks.size() );
+	writer.write( NUM_MODELS );
+	for( const ModelChunk & chunk : chunks )
 	{
-		if( chunk.isInsideFrustum( viewFrustum, cullingOffset ) )
-		{
-			glm::vec2 directionToChunkCenter = chunk.getMidPoint() - CAMERA_POSITION_XZ;
-			unsigned int distanceToChunk = glm::length2( directionToChunkCenter );
+		writer.writeArray( chunk.getNumInstancesVector().data(), NUM_MODELS );
+		writer.writeArray( chunk.getInstanceOffsetVector().data(), NUM_MODELS );
+	}
+	for( unsigned int modelIndex = 0; modelIndex < NUM_MODELS; modelIndex++ )
+	{
+		writer.write( (uint32_t)numPlants[modelIndex] );
+		writer.writeArray( matrices[modelIndex].data(), numPlants[modelIndex] );
+	}
+}
 
-			//if a chunk is farther than the low-poly render distance - just discard it
-			if( distanceToChunk < LOADING_DISTANCE_UNITS_LOWPOLY_SQUARE )
-			{
-				visibleChunks.emplace_back( chunk, distanceToChunk );
-			}
-		}
+/**
+ * @brief reads binary world file section without touching the generator state
+ * @param section world file section to read data from
+ * @param savedData chunks instances info and instance matrices of each model pointing right into the mapped file
+ * @return false if section data does not match chunks and models layout
+ */
+bool PlantGenerator::read( WorldFileSection & section,
+						   PlantGeneratorSavedData & savedData ) const
+{
+	//chunks are laid out the same way initializeModelChunks does it
+	const size_t NUM_CHUNKS = ( ( WORLD_HEIGHT + CHUNK_SIZE - 1 ) / CHUNK_SIZE ) * ( ( WORLD_WIDTH + CHUNK_SIZE - 1 ) / CHUNK_SIZE );
+	uint32_t numChunks = 0;
+	uint32_t numModels = 0;
+	section.read( numChunks );
+	section.read( numModels );
+	if( section.isFailed() || numChunks != NUM_CHUNKS || numModels != models.size() )
+	{
+		return false;
+	}
+	savedData.chunksNumInstances.resize( numChunks );
+	savedData.chunksInstanceOffsets.resize( numChunks );
+	for( unsigned int chunkIndex = 0; chunkIndex < numChunks; chunkIndex++ )
+	{
+		savedData.chunksNumInstances[chunkIndex] = section.readArray<unsigned int>( numModels );
+		savedData.chunksInstanceOffsets[chunkIndex] = section.readArray<unsigned int>( numModels );
 	}
+	savedData.modelsMatrices.resize( numModels );
+	savedData.modelsNumPlants.resize( numModels );
+	for( unsigned int modelIndex = 0; modelIndex < numModels; modelIndex++ )
+	{
+		section.read( savedData.modelsNumPlants[modelIndex] );
+		savedData.modelsMatrices[modelIndex] = section.readArray<glm::mat4>( savedData.modelsNumPlants[modelIndex] );
+	}
+	return !section.isFailed();
+}
 
-	//additional check of hills occlusion
-	for( auto & chunkDistancePair : visibleChunks )
+/**
+ * @brief performs binary deserialization of the data previously read from the world file,
+ * instance matrices are copied right from the mapped file into models storage.
+ * Model chunks are reinitialized, so the generator does not have to be set up beforehand
+ * @param savedData data read from the world file section
+ * @param map terrain map used to define height values of the chunk coordinates
+ */
+void PlantGenerator::deserialize( const PlantGeneratorSavedData & savedData,
+								  const map2D_f & map )
+{
+	initializeModelChunks( map );
+	const size_t NUM_MODELS = savedData.modelsMatrices.size();
+	for( unsigned int chunkIndex = 0; chunkIndex < chunks.size(); chunkIndex++ )
 	{
-		ModelChunk & chunk = chunkDistancePair.first;
-		chunk.setOccluded( testHillsOcclusionChunk( camera, chunk, hillMap ) );
+		const unsigned int * numInstances = savedData.chunksNumInstances[chunkIndex];
+		const unsigned int * instanceOffsets = savedData.chunksInstanceOffsets[chunkIndex];
+		std::vector<unsigned int> numInstancesVector( numInstances, numInstances + NUM_MODELS );
+		std::vector<unsigned int> instanceOffsetsVector( instanceOffsets, instanceOffsets + NUM_MODELS );
+		chunks[chunkIndex].setNumInstancesVector( numInstancesVector );
+		chunks[chunkIndex].setInstanceOffsetsVector( instanceOffsetsVector );
 	}
 
-	for( unsigned int modelIndex = 0; modelIndex < models.size(); modelIndex++ )
+	matrices = substituteMatricesStorage();
+	numPlants.reset( new unsigned int[NUM_MODELS] );
+	for( unsigned int modelIndex = 0; modelIndex < NUM_MODELS; modelIndex++ )
 	{
-		Model & model = models[modelIndex];
-		model.prepareIndirectBufferData( visibleChunks, modelIndex, LOADING_DISTANCE_UNITS_SQUARE, LOADING_DISTANCE_UNITS_SHADOW_SQUARE );
-		Model & lowPolyModel = lowPolyModels[modelIndex];
-		lowPolyModel.prepareIndirectBufferData( visibleChunks, modelIndex, LOADING_DISTANCE_UNITS_SQUARE, LOADING_DISTANCE_UNITS_SHADOW_SQUARE );
+		const glm::mat4 * savedMatrices = savedData.modelsMatrices[modelIndex];
+		matrices[modelIndex].assign( savedMatrices, savedMatrices + savedData.modelsNumPlants[modelIndex] );
+		numPlants[modelIndex] = savedData.modelsNumPlants[modelIndex];
 	}
+	loadModelsInstances();
 }
 
 /**
- * @brief for each model upload data kept in indirect buffer from CPU to GPU
+ * @brief for each model prepare its indirect buffer data using CPU frustum culling
+ * @param camera player's camera
+ * @param viewFrustum frustum to perform CPU culling
+ * @param hillsOcclusion occlusion queries of the hills
+ * @param indirectCommandRing shared storage to write models' draw commands to
  */
-void PlantGenerator::updateIndirectBufferData()
+void PlantGenerator::prepareIndirectBufferData( const Camera & camera,
+												const Frustum & viewFrustum,
+												const HeightfieldOcclusion & hillsOcclusion,
+												IndirectCommandRing & indirectCommandRing )
 {
+	const float CAMERA_ON_MAP_X = glm::clamp( camera.getPosition().x, -HALF_WORLD_WIDTH_F, HALF_WORLD_WIDTH_F );
+	const float CAMERA_ON_MAP_Z = glm::clamp( camera.getPosition().z, -HALF_WORLD_HEIGHT_F, HALF_WORLD_HEIGHT_F );
+	const glm::vec2 CAMERA_POSITION_XZ( CAMERA_ON_MAP_X, CAMERA_ON_MAP_Z );
+
+	//firstly collect indices of only those chunks that are visible in a view frustum and close enough to a camera
+	visibleChunks.clear();
+	renderChunks.getChunksTree().forEachVisible( viewFrustum, cullingOffset, [&]( unsigned int chunkIndex )
+	{
+		glm::vec2 directionToChunkCenter = glm::vec2( renderChunks.getMidPointX( chunkIndex ), renderChunks.getMidPointZ( chunkIndex ) ) - CAMERA_POSITION_XZ;
+		unsigned int distanceToChunk = glm::length2( directionToChunkCenter );
+
+		//if a chunk is farther than the low-poly render distance - just discard it
+		if( distanceToChunk < LOADING_DISTANCE_UNITS_LOWPOLY_SQUARE )
+		{
+			visibleChunks.add( chunkIndex, distanceToChunk );
+		}
+	} );
+
+	//additional check of hills occlusion, results which are still valid for the camera position are taken from the cache
+	const glm::vec3 VIEW_POSITION_ON_MAP( camera.getPosition().x + HALF_WORLD_WIDTH,
+										  camera.getPosition().y,
+										  camera.getPosition().z + HALF_WORLD_HEIGHT );
+	occlusionCache.update( hillsOcclusion, VIEW_POSITION_ON_MAP, visibleChunks.chunkIndices, visibleChunks.occluded );
+
 	for( unsigned int modelIndex = 0; modelIndex < models.size(); modelIndex++ )
 	{
 		Model & model = models[modelIndex];
-		model.updateIndirectBufferData();
+		model.prepareIndirectBufferData( renderChunks, visibleChunks, modelIndex, LOADING_DISTANCE_UNITS_SQUARE, LOADING_DISTANCE_UNITS_SHADOW_SQUARE, indirectCommandRing );
 		Model & lowPolyModel = lowPolyModels[modelIndex];
-		lowPolyModel.updateIndirectBufferData();
+		lowPolyModel.prepareIndirectBufferData( renderChunks, visibleChunks, modelIndex, LOADING_DISTANCE_UNITS_SQUARE, LOADING_DISTANCE_UNITS_SHADOW_SQUARE, indirectCommandRing );
 	}
 }
 
@@ -343,7 +397,14 @@ void PlantGenerator::loadMatrices( const map2D_mat4 & newMatrices )
 		numPlants[modelIndex] = newMatrices[modelIndex].size();
 	}
 
-	//update instance matrices for each provided model
+	loadModelsInstances();
+}
+
+/**
+ * @brief updates instance matrices for each model (both plain and low-poly) with the current matrices storage
+ */
+void PlantGenerator::loadModelsInstances()
+{
 	for( unsigned int modelIndex = 0; modelIndex < models.size(); modelIndex++ )
 	{
 		models[modelIndex].loadModelInstances( matrices[modelIndex] );
@@ -370,138 +431,6 @@ map2D_mat4 PlantGenerator::substituteMatricesStorage()
 	return newMatrices;
 }
 
-/**
-* @brief performs test of hills occlusion for the given chunk
-* @param camera player's camera
-* @param chunk a chunk to test
-* @param hillMap map of the hills
-* @return true if this chunk is occluded by hills
-*/
-bool PlantGenerator::testHillsOcclusionChunk( const Camera & camera,
-											  const ModelChunk & chunk,
-											  const map2D_f & hillMap )
-{
-	const glm::vec3 VIEW_POSITION( camera.getPosition().x + HALF_WORLD_WIDTH,
-								   camera.getPosition().y,
-								   camera.getPosition().z + HALF_WORLD_HEIGHT );
-	const float CHUNK_APPROXIMATE_HEIGHT = chunk.getHeight();
-	const glm::vec3 CHUNK_LL( chunk.getLeft(), CHUNK_APPROXIMATE_HEIGHT, chunk.getBottom() );
-	const glm::vec3 CHUNK_LR( chunk.getRight(), CHUNK_APPROXIMATE_HEIGHT, chunk.getBottom() );
-	const glm::vec3 CHUNK_UL( chunk.getLeft(), CHUNK_APPROXIMATE_HEIGHT, chunk.getTop() );
-	const glm::vec3 CHUNK_UR( chunk.getRight(), CHUNK_APPROXIMATE_HEIGHT, chunk.getTop() );
-
-	//discard this chunk only if all its key points are occluded
-	return( testHillsOcclusionPoint( CHUNK_LL, VIEW_POSITION, hillMap ) &&
-			testHillsOcclusionPoint( CHUNK_LR, VIEW_POSITION, hillMap ) &&
-			testHillsOcclusionPoint( CHUNK_UL, VIEW_POSITION, hillMap ) &&
-			testHillsOcclusionPoint( CHUNK_UR, VIEW_POSITION, hillMap ) );
-}
-
-/**
-* @brief performs test of hills occlusion for the given point
-* @param point a point to test
-* @param viewPosition current position of the camera
-* @param hillMap map of the hills
-*/
-bool PlantGenerator::testHillsOcclusionPoint( const glm::vec3 & point,
-											  const glm::vec3 & viewPosition,
-											  const map2D_f & hillMap )
-{
-	const glm::vec3 VIEW_DIRECTION( point - viewPosition );
-
-	//culling based on crossing hills map vertical lines
-	if( VIEW_DIRECTION.x > 0 )
-	{
-		float xPosition = viewPosition.x;
-		while( xPosition < point.x )
-		{
-			xPosition = std::trunc( xPosition + 1.0f );
-			float dx = ( xPosition - viewPosition.x ) / VIEW_DIRECTION.x;
-			float zPosition = viewPosition.z + VIEW_DIRECTION.z * dx;
-			float yPosition = viewPosition.y + VIEW_DIRECTION.y * dx;
-
-			if( yPosition < hillOccluderHeightAt( zPosition, xPosition, true, hillMap ) )
-			{
-				return true;
-			}
-		}
-	}
-	else
-	{
-		float xPosition = viewPosition.x;
-		while( xPosition > point.x )
-		{
-			xPosition = std::trunc( xPosition );
-			float dx = std::abs( ( viewPosition.x - xPosition ) / VIEW_DIRECTION.x );
-			float zPosition = viewPosition.z + VIEW_DIRECTION.z * dx;
-			float yPosition = viewPosition.y + VIEW_DIRECTION.y * dx;
-
-			if( yPosition < hillOccluderHeightAt( zPosition, xPosition, true, hillMap ) )
-			{
-				return true;
-			}
-			xPosition -= 1.0f;
-		}
-	}
-
-	//culling based on crossing hills map horizontal lines
-	if( VIEW_DIRECTION.z > 0 )
-	{
-		float zPosition = viewPosition.z;
-		while( zPosition < point.z )
-		{
-			zPosition = std::trunc( zPosition + 1.0f );
-			float dz = ( zPosition - viewPosition.z ) / VIEW_DIRECTION.z;
-			float xPosition = viewPosition.x + VIEW_DIRECTION.x * dz;
-			float yPosition = viewPosition.y + VIEW_DIRECTION.y * dz;
-
-			if( yPosition < hillOccluderHeightAt( xPosition, zPosition, false, hillMap ) )
-			{
-				return true;
-			}
-		}
-	}
-	else
-	{
-		float zPosition = viewPosition.z;
-		while( zPosition > point.z )
-		{
-			zPosition = std::trunc( zPosition );
-			float dz = std::abs( ( viewPosition.z - zPosition ) / VIEW_DIRECTION.z );
-			float xPosition = viewPosition.x + VIEW_DIRECTION.x * dz;
-			float yPosition = viewPosition.y + VIEW_DIRECTION.y * dz;
-
-			if( yPosition < hillOccluderHeightAt( xPosition, zPosition, false, hillMap ) )
-			{
-				return true;
-			}
-			zPosition -= 1.0f;
-		}
-	}
-
-	return false;
-}
-
-/**
-* @brief returns height value in the given map for given coordinates
-* @param interpolantCoord coordinate that would be used for interpolation
-* @param fixedCoord coordinate that would be used as it is
-* @param fixedCoordIsX define whether fixed coords is used as X index for given map
-* @param hillMap map of the hills
-*/
-float PlantGenerator::hillOccluderHeightAt( const float interpolantCoord,
-											const float fixedCoord,
-											const bool fixedCoordIsX,
-											const map2D_f & hillMap )
-{
-	const int MAP_COORD_1 = std::floor( interpolantCoord );
-	const int MAP_COORD_2 = std::ceil( interpolantCoord );
-	const float INTERPOLATION = glm::fract( std::abs( interpolantCoord ) );
-	float hillHeightAtCoord1 = hillMap[fixedCoordIsX ? MAP_COORD_1 : fixedCoord][fixedCoordIsX ? fixedCoord : MAP_COORD_1];
-	float hillHeightAtCoord2 = hillMap[fixedCoordIsX ? MAP_COORD_2 : fixedCoord][fixedCoordIsX ? fixedCoord : MAP_COORD_2];
-	return glm::mix( hillHeightAtCoord1, hillHeightAtCoord2, INTERPOLATION ) + HILLS_OFFSET_Y;
-}
-
 std::vector<Model> & PlantGenerator::getModels( bool isLowPoly ) noexcept
 {
 	return isLowPoly ? lowPolyModels : models;
@@ -516,3 +445,8 @@ unsigned int PlantGenerator::getLoadingDistanceLowPoly() const noexcept
 {
 	return LOADING_DISTANCE_UNITS_LOWPOLY;
 }
+
+const ChunkOcclusionStatistics & PlantGenerator::getOcclusionStatistics() const noexcept
+{
+	return occlusionCache.getStatistics();
+}
\ No newline at end of file
@@ -21,16 +21,32 @@
 #pragma once
 
 #include "ModelChunk"
+#include "ModelRenderChunks"
 #include "TypeAliases"
 #include "SceneSettings"
+#include "ChunkOcclusionCache"
 
 #include <vector>
 #include <fstream>
 #include <memory>
-#include <random>
 
 class Model;
 class Camera;
+class IndirectCommandRing;
+class WorldFileWriter;
+class WorldFileSection;
+class HeightfieldOcclusion;
+
+/**
+ * @brief plants data of one generator read from the binary world file, arrays point right into the mapped file
+ */
+struct PlantGeneratorSavedData
+{
+	std::vector<const unsigned int*> chunksNumInstances;
+	std::vector<const unsigned int*> chunksInstanceOffsets;
+	std::vector<const glm::mat4*> modelsMatrices;
+	std::vector<uint32_t> modelsNumPlants;
+};
 
 /**
  * @brief Boilerplate generator for all the plants.
@@ -43,39 +59,39 @@ public:
 	PlantGenerator() noexcept;
 	void serialize( std::ofstream & output );
 	void deserialize( std::ifstream & input );
+	void serialize( WorldFileWriter & writer ) const;
+	bool read( WorldFileSection & section,
+			   PlantGeneratorSavedData & savedData ) const;
+	void deserialize( const PlantGeneratorSavedData & savedData,
+					  const map2D_f & map );
 	void initializeModelRenderChunks( const map2D_f & map,
 									  const float approximateHeight );
 	void prepareIndirectBufferData( const Camera & camera, 
 									const Frustum & viewFrustum,
-									const map2D_f & hillMap );
-	void updateIndirectBufferData();
+									const HeightfieldOcclusion & hillsOcclusion,
+									IndirectCommandRing & indirectCommandRing );
 	std::vector<Model> & getModels( bool isLowPoly ) noexcept;
 	std::vector<ModelChunk> & getChunks() noexcept;
 	unsigned int getLoadingDistanceLowPoly() const noexcept;
+	const ChunkOcclusionStatistics & getOcclusionStatistics() const noexcept;
 
 protected:
 	void initializeModelChunks( const map2D_f & map );
 	void loadMatrices( const map2D_mat4 & newMatrices );
+	void loadModelsInstances();
 	map2D_mat4 substituteMatricesStorage();
-	bool testHillsOcclusionChunk( const Camera & camera, 
-								  const ModelChunk & chunk,
-								  const map2D_f & hillMap );
-	bool testHillsOcclusionPoint( const glm::vec3 & point,
-								  const glm::vec3 & viewPosition,
-								  const map2D_f & hillMap );
-	float hillOccluderHeightAt( const float interpolantCoord,
-								const float fixedCoord,
-								const bool fixedCoordIsX,
-								const map2D_f & hillMap );
 
 	std::vector<Model> models;
 	std::vector<Model> lowPolyModels;
 	map2D_mat4 matrices;
 	std::unique_ptr<unsigned int[]> numPlants;
 	std::vector<ModelChunk> chunks;
-	decltype( chunks ) renderChunks;
+	ModelRenderChunks renderChunks;
+	/** @note reused from frame to frame to avoid allocations during indirect buffer preparation */
+	VisibleModelChunks visibleChunks;
+	/** @note hills occlusion results of the render chunks are kept between frames and retested only when the camera moves far enough */
+	ChunkOcclusionCache occlusionCache;
 	float cullingOffset;
-	std::default_random_engine randomizer;
 
 private:
     /**
@@ -22,14 +22,20 @@
 #include "Generator"
 #include "Model"
 #include "SettingsManager"
+#include "WorldFile"
+#include "RandomStream"
+#include "IndirectCommandRing"
 
 /**
  * @param renderPhongShader compiled Phong shader program provided to a personal shader manager
  * @param renderGouraudShader compiled Gouraud shader program provided to a personal shader manager
+ * @param indirectCommandRing shared storage of the indirect draw commands
  */
 PlantsFacade::PlantsFacade( Shader & renderPhongShader, 
-							Shader & renderGouraudShader ) noexcept
-	: shaders( renderPhongShader, renderGouraudShader )
+							Shader & renderGouraudShader,
+							IndirectCommandRing & indirectCommandRing ) noexcept
+	: indirectCommandRing( indirectCommandRing )
+	, shaders( renderPhongShader, renderGouraudShader )
 {}
 
 /**
@@ -37,14 +43,16 @@ PlantsFacade::PlantsFacade( Shader & renderPhongShader,
  * @param landMap map of the land
  * @param hillMap map of the hills
  * @param hillsNormalMap map of the hills normals
+ * @param freeCells mask of cells lying on flat land without visible hills
  */
 void PlantsFacade::setup( const map2D_f & landMap, 
 						  const map2D_f & hillMap, 
-						  const map2D_vec3 & hillsNormalMap )
+						  const map2D_vec3 & hillsNormalMap, 
+						  const TileMask & freeCells )
 {
 	prepareDistributionMap();
-	landPlantsGenerator.setup( landMap, hillMap, distributionMap );
-	grassGenerator.setup( landMap, hillMap, distributionMap );
+	landPlantsGenerator.setup( landMap, freeCells, distributionMap );
+	grassGenerator.setup( landMap, freeCells, distributionMap );
 	hillTreesGenerator.setup( hillMap, distributionMap, hillsNormalMap );
 }
 
@@ -62,58 +70,57 @@ void PlantsFacade::reinitializeModelRenderChunks( const map2D_f & landMap,
 }
 
 /**
- * @brief for each generator's models delegates command to prepare its indirect buffer data on CPU side
+ * @brief for each generator's models delegates command to write its draw commands to the indirect command ring.
+ * Might be called from the coroutine thread
  * @param camera player's camera
  * @param viewFrustum frustum to perform CPU culling
- * @param hillMap map of the hills
+ * @param hillsOcclusion occlusion queries of the hills
  */
 void PlantsFacade::prepareIndirectBufferData( const Camera & camera, 
 											  const Frustum & viewFrustum,
-											  const map2D_f & hillMap )
+											  const HeightfieldOcclusion & hillsOcclusion )
 {
-	landPlantsGenerator.prepareIndirectBufferData( camera, viewFrustum, hillMap );
-	hillTreesGenerator.prepareIndirectBufferData( camera, viewFrustum, hillMap );
-	grassGenerator.prepareIndirectBufferData( camera, viewFrustum, hillMap );
+	landPlantsGenerator.prepareIndirectBufferData( camera, viewFrustum, hillsOcclusion, indirectCommandRing );
+	hillTreesGenerator.prepareIndirectBufferData( camera, viewFrustum, hillsOcclusion, indirectCommandRing );
+	grassGenerator.prepareIndirectBufferData( camera, viewFrustum, hillsOcclusion, indirectCommandRing );
 }
 
 /**
- * @brief for each generator's models delegates command to upload indirect buffer data from CPU to GPU
+ * @brief sums up hills occlusion statistics of the last indirect buffer update of all the generators
+ * @return numbers of chunks occlusion results reused, tested and deferred
  */
-void PlantsFacade::updateIndirectBufferData()
+ChunkOcclusionStatistics PlantsFacade::getOcclusionStatistics() const noexcept
 {
-	landPlantsGenerator.updateIndirectBufferData();
-	hillTreesGenerator.updateIndirectBufferData();
-	grassGenerator.updateIndirectBufferData();
+	ChunkOcclusionStatistics sum;
+	const ChunkOcclusionStatistics * GENERATORS_STATISTICS[] = { &landPlantsGenerator.getOcclusionStatistics(),
+																 &hillTreesGenerator.getOcclusionStatistics(),
+																 &grassGenerator.getOcclusionStatistics() };
+	for( const ChunkOcclusionStatistics * statistics : GENERATORS_STATISTICS )
+	{
+		sum.numReused += statistics->numReused;
+		sum.numTested += statistics->numTested;
+		sum.numDeferred += statistics->numDeferred;
+	}
+	return sum;
 }
 
 /**
  * @brief updates the shader program state, switches GL_BLEND mode if necessary and delegates draw calls to renderers
- * @param lightDir direction of the sunlight (directional lighting)
- * @param lightSpaceMatrices matrices for shadow sampling
- * @param projectionView Projection*View matrix
- * @param viewPosition current position of the camera
  * @param usePhongShading define what shading model to use
  * @param useShadows define whether to use shadows
  * @param useLandBlending define whether to use blending
  * @param worldReflectionMode define whether world reflection rendering stage is currently on
  */
-void PlantsFacade::draw( const glm::vec3 & lightDir,
-						 const std::array<glm::mat4, NUM_SHADOW_LAYERS> & lightSpaceMatrices,
-						 const glm::mat4 & projectionView,
-						 const glm::vec3 & viewPosition,
-						 bool usePhongShading,
+void PlantsFacade::draw( bool usePhongShading,
 						 bool useShadows,
 						 bool useLandBlending,
 						 bool worldReflectionMode )
 {
 	shaders.updateAllPlants( usePhongShading,
-							 lightDir,
-							 lightSpaceMatrices,
-							 projectionView,
-							 viewPosition,
 							 useShadows,
 							 useLandBlending,
 							 landPlantsGenerator.getLoadingDistanceLowPoly() - 1 );
+	indirectCommandRing.bind();
 
 	//draw trees and hill models first (plain and low-poly)
 	shaders.setType( PLANT_TREES, 30.0f );
@@ -148,6 +155,7 @@ void PlantsFacade::draw( const glm::vec3 & lightDir,
  */
 void PlantsFacade::drawDepthmap( bool grassCastShadow )
 {
+	indirectCommandRing.bind();
 	treesRenderer.render( landPlantsGenerator.getModels( false ), hillTreesGenerator.getModels( false ), true );
 	treesRenderer.render( landPlantsGenerator.getModels( true ), hillTreesGenerator.getModels( true ), true );
 	if( grassCastShadow )
@@ -178,6 +186,55 @@ void PlantsFacade::deserialize( std::ifstream & input )
 	hillTreesGenerator.deserialize( input );
 }
 
+/**
+ * @brief writes data of each generator to its own section of the binary world file
+ * @param writer world file writer
+ */
+void PlantsFacade::serialize( WorldFileWriter & writer ) const
+{
+	writer.beginSection( SECTION_LAND_PLANTS );
+	landPlantsGenerator.serialize( writer );
+	writer.endSection();
+	writer.beginSection( SECTION_GRASS );
+	grassGenerator.serialize( writer );
+	writer.endSection();
+	writer.beginSection( SECTION_HILL_TREES );
+	hillTreesGenerator.serialize( writer );
+	writer.endSection();
+}
+
+/**
+ * @brief delegates binary section reading command to generators, each one reads its own section
+ * @param reader world file reader
+ * @param savedData data of each generator to read to
+ * @return false if any of the sections does not match its generator
+ */
+bool PlantsFacade::read( const WorldFileReader & reader,
+						 PlantsSavedData & savedData ) const
+{
+	WorldFileSection landPlantsSection = reader.getSection( SECTION_LAND_PLANTS );
+	WorldFileSection grassSection = reader.getSection( SECTION_GRASS );
+	WorldFileSection hillTreesSection = reader.getSection( SECTION_HILL_TREES );
+	return landPlantsGenerator.read( landPlantsSection, savedData.landPlants ) &&
+		grassGenerator.read( grassSection, savedData.grass ) &&
+		hillTreesGenerator.read( hillTreesSection, savedData.hillTrees );
+}
+
+/**
+ * @brief delegates binary deserialization command to generators
+ * @param savedData data of each generator previously read from the world file
+ * @param landMap map of the land
+ * @param hillMap map of the hills
+ */
+void PlantsFacade::deserialize( const PlantsSavedData & savedData,
+								const map2D_f & landMap,
+								const map2D_f & hillMap )
+{
+	landPlantsGenerator.deserialize( savedData.landPlants, landMap );
+	grassGenerator.deserialize( savedData.grass, landMap );
+	hillTreesGenerator.deserialize( savedData.hillTrees, hillMap );
+}
+
 /**
  * @brief prepares distribution map used by generators during plants allocation
  */
@@ -194,7 +251,8 @@ void PlantsFacade::prepareDistributionMap()
 		{
 			for( unsigned int startX = 0; startX < distributionMap[0].size(); startX++ )
 			{
-				if( rand() % ( PLANTS_DISTRIBUTION_FREQUENCY * 5 ) == 0 ) //check for randomizer "hit"
+				RandomStream random( RANDOM_STREAM_PLANTS_DISTRIBUTION, startX, startY, cycle );
+				if( random.nextUint( PLANTS_DISTRIBUTION_FREQUENCY * 5 ) == 0 ) //check for randomizer "hit"
 				{
 					//calculate borders for kernel
 					unsigned int yBorder = startY + cycle - 1;
@@ -30,6 +30,20 @@
 
 class Frustum;
 class Camera;
+class IndirectCommandRing;
+class WorldFileReader;
+class TileMask;
+class HeightfieldOcclusion;
+
+/**
+ * @brief plants data of all the generators read from the binary world file
+ */
+struct PlantsSavedData
+{
+	PlantGeneratorSavedData landPlants;
+	PlantGeneratorSavedData grass;
+	PlantGeneratorSavedData hillTrees;
+};
 
 /**
  * @brief Facade for plants related code module.
@@ -39,21 +53,19 @@ class PlantsFacade
 {
 public:
 	PlantsFacade( Shader & renderPhongShader, 
-				  Shader & renderGouraudShader ) noexcept;
+				  Shader & renderGouraudShader,
+				  IndirectCommandRing & indirectCommandRing ) noexcept;
 	void setup( const map2D_f & landMap, 
 				const map2D_f & hillMap, 
-				const map2D_vec3 & hillsNormalMap );
+				const map2D_vec3 & hillsNormalMap, 
+				const TileMask & freeCells );
 	void reinitializeModelRenderChunks( const map2D_f & landMap, 
 									    const map2D_f & hillMap );
 	void prepareIndirectBufferData( const Camera & camera,
 									const Frustum & viewFrustum,
-									const map2D_f & hillMap );
-	void updateIndirectBufferData();
-	void draw( const glm::vec3 & lightDir,
-			   const std::array<glm::mat4, NUM_SHADOW_LAYERS> & lightSpaceMatrices,
-			   const glm::mat4 & projectionView,
-			   const glm::vec3 & viewPosition,
-			   bool usePhongShading,
+									const HeightfieldOcclusion & hillsOcclusion );
+	ChunkOcclusionStatistics getOcclusionStatistics() const noexcept;
+	void draw( bool usePhongShading,
 			   bool useShadows,
 			   bool useLandBlending,
 			   bool worldReflectionMode = false );
@@ -62,6 +74,12 @@ public:
 	//save/load routine
 	void serialize( std::ofstream & output );
 	void deserialize( std::ifstream & input );
+	void serialize( WorldFileWriter & writer ) const;
+	bool read( const WorldFileReader & reader,
+			   PlantsSavedData & savedData ) const;
+	void deserialize( const PlantsSavedData & savedData,
+					  const map2D_f & landMap,
+					  const map2D_f & hillMap );
 
 private:
 	//define possible state for plants
@@ -73,6 +91,7 @@ private:
 	void prepareDistributionMap();
 
 	map2D_i distributionMap;
+	IndirectCommandRing & indirectCommandRing;
 	PlantsShader shaders;
 	LandPlantsGenerator landPlantsGenerator;
 	GrassGenerator grassGenerator;
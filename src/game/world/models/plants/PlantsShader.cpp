@@ -34,36 +34,22 @@ PlantsShader::PlantsShader( Shader & renderPhongShader,
 {}
 
 /**
- * @brief activates necessary shader program and updates its uniforms
+ * @brief activates necessary shader program and updates its uniforms.
+ * Camera, lighting and shadow data come from the frame uniform blocks
  * @param usePhongShading define what shading model to use
- * @param lightDir direction of the sunlight (directional lighting)
- * @param lightSpaceMatrices matrices for shadow sampling
- * @param projectionView Projection*View matrix
- * @param viewPosition current position of the camera
  * @param useShadows define whether to use shadows
  * @param useLandBlending define whether to use blending
  * @param loadDistance loading distance used for fadeout
  */
 void PlantsShader::updateAllPlants( bool usePhongShading,
-									const glm::vec3 & lightDir,
-									const std::array<glm::mat4, NUM_SHADOW_LAYERS> & lightSpaceMatrices,
-									const glm::mat4 & projectionView,
-									const glm::vec3 & viewPosition,
 									bool useShadows,
 									bool useLandBlending,
 									unsigned int loadDistance )
 {
 	currentShader = usePhongShading ? &renderPhongShader : &renderGouraudShader;
 	currentShader->use();
-	currentShader->setMat4( "u_projectionView", projectionView );
-	currentShader->setVec3( "u_viewPosition", viewPosition );
 	currentShader->setBool( "u_shadowEnable", useShadows );
 	currentShader->setBool( "u_useLandBlending", useLandBlending );
-	//send this as reverse direction
-	currentShader->setVec3( "u_lightDir", -lightDir );
-	currentShader->setMat4( "u_lightSpaceMatrix[0]", lightSpaceMatrices[0] );
-	currentShader->setMat4( "u_lightSpaceMatrix[1]", lightSpaceMatrices[1] );
-	currentShader->setMat4( "u_lightSpaceMatrix[2]", lightSpaceMatrices[2] );
 	currentShader->setInt( "u_loadDistance", loadDistance );
 }
 
@@ -20,11 +20,6 @@
 
 #pragma once
 
-#include <array>
-#include <glm/vec3.hpp>
-#include <glm/mat4x4.hpp>
-#include "GraphicsConstants"
-
 class Shader;
 
 /**
@@ -37,10 +32,6 @@ public:
 	PlantsShader( Shader & renderPhongShader,
 				  Shader & renderGouraudShader ) noexcept;
 	void updateAllPlants( bool usePhongShading,
-						  const glm::vec3 & lightDir,
-						  const std::array<glm::mat4, NUM_SHADOW_LAYERS> & lightSpaceMatrices,
-						  const glm::mat4 & projectionView,
-						  const glm::vec3 & viewPosition,
 						  bool useShadows,
 						  bool useLandBlending,
 						  unsigned int loadDistance );
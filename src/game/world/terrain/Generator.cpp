@@ -14,21 +14,117 @@
  * GNU General Public License for more details.
  * See <http://www.gnu.org/licenses/>
  *
- * Purpose: contains definition for Generator class
+ * Purpose: contains definitions for Generator class, TerrainMeshData and PackedTerrainVertex structs
  * @version 0.1.0
  */
 
 #include "Generator"
 #include "SettingsManager"
+#include "StencilEngine"
+#include "ThreadPool"
+#include "Logger"
+#include "WorldFile"
+#include "UploadManager"
 
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <iomanip>
 #include <fstream>
+#include <string>
+#include <glm/gtc/packing.hpp>
 
 /**
-* @brief plain ctor. Initializes buffer collection (vao+vbo+ebo), map, reserves enough capacity for tiles storage
+* @brief calculates total size of the mesh data as it would take on the GPU
+*/
+size_t TerrainMeshData::getByteSize() const noexcept
+{
+	return vertices.size() * sizeof( GLfloat ) +
+		   packedVertices.size() * sizeof( PackedTerrainVertex ) +
+		   indices.size() * sizeof( GLuint ) +
+		   instances.size() * sizeof( glm::vec4 );
+}
+
+/**
+* @brief frees memory of all the mesh data storages
+*/
+void TerrainMeshData::clear()
+{
+	std::vector<GLfloat>().swap( vertices );
+	std::vector<PackedTerrainVertex>().swap( packedVertices );
+	std::vector<GLuint>().swap( indices );
+	std::vector<glm::vec4>().swap( instances );
+}
+
+/**
+* @brief packs terrain vertex
+* @param mapX X coordinate of the vertex on the world map
+* @param mapY Y coordinate of the vertex on the world map
+* @param height vertex height
+* @param normal unit normal of the vertex
+* @note the normal is projected onto the octahedron whose upper half is unfolded to the XZ plane
+* and the lower half is folded over the diagonals, zero length normal is packed as the up vector
+*/
+PackedTerrainVertex::PackedTerrainVertex( int mapX,
+										  int mapY,
+										  float height,
+										  const glm::vec3 & normal ) noexcept
+	: gridPosition( (GLuint)(uint16_t)( mapX - HALF_WORLD_WIDTH ) | (GLuint)(uint16_t)( mapY - HALF_WORLD_HEIGHT ) << 16 )
+	, height( height )
+	, normal( 0 )
+{
+	static_assert( HALF_WORLD_WIDTH <= INT16_MAX && HALF_WORLD_HEIGHT <= INT16_MAX, "grid coordinates must fit 16 bits" );
+	const float L1_NORM = std::abs( normal.x ) + std::abs( normal.y ) + std::abs( normal.z );
+	if( !( L1_NORM > 0.0f ) )
+	{
+		return;
+	}
+	glm::vec2 octahedral( normal.x / L1_NORM, normal.z / L1_NORM );
+	if( normal.y < 0.0f )
+	{
+		octahedral = glm::vec2( ( 1.0f - std::abs( octahedral.y ) ) * ( octahedral.x >= 0.0f ? 1.0f : -1.0f ),
+								( 1.0f - std::abs( octahedral.x ) ) * ( octahedral.y >= 0.0f ? 1.0f : -1.0f ) );
+	}
+	this->normal = glm::packSnorm2x16( octahedral );
+}
+
+/**
+* @brief sets layout of the packed terrain vertex for currently bound VAO and VBO
+* @note grid position and normal are fed to shaders as raw unsigned integers and decoded there
+*/
+void PackedTerrainVertex::setupAttributes() noexcept
+{
+	glEnableVertexAttribArray( 0 );
+	glVertexAttribIPointer( 0, 1, GL_UNSIGNED_INT, sizeof( PackedTerrainVertex ), (void*)offsetof( PackedTerrainVertex, gridPosition ) );
+	glEnableVertexAttribArray( 1 );
+	glVertexAttribPointer( 1, 1, GL_FLOAT, GL_FALSE, sizeof( PackedTerrainVertex ), (void*)offsetof( PackedTerrainVertex, height ) );
+	glEnableVertexAttribArray( 2 );
+	glVertexAttribIPointer( 2, 1, GL_UNSIGNED_INT, sizeof( PackedTerrainVertex ), (void*)offsetof( PackedTerrainVertex, normal ) );
+}
+
+/**
+* @brief decodes X map coordinate of the vertex
+*/
+int PackedTerrainVertex::getMapX() const noexcept
+{
+	return (int16_t)( gridPosition & 0xFFFF ) + HALF_WORLD_WIDTH;
+}
+
+/**
+* @brief decodes Y map coordinate of the vertex
+*/
+int PackedTerrainVertex::getMapY() const noexcept
+{
+	return (int16_t)( gridPosition >> 16 ) + HALF_WORLD_HEIGHT;
+}
+
+/**
+* @brief plain ctor. Initializes map, reserves enough capacity for tiles storage.
+* @note GL buffer collection is not created here, thus generator could be used without OpenGL context
 */
 Generator::Generator() noexcept
-	: basicGLBuffers( VAO | VBO | EBO )
+	: indirectBufferCapacity( 0 )
 {
 	initializeMap( map );
 	tiles.reserve( NUM_TILES );
@@ -39,6 +135,67 @@ const map2D_f & Generator::getMap() const noexcept
 	return map;
 }
 
+const std::vector<TerrainTile> & Generator::getTiles() const noexcept
+{
+	return tiles;
+}
+
+const TerrainMeshData & Generator::getMeshData() const noexcept
+{
+	return meshData;
+}
+
+TerrainLod & Generator::getLevelsOfDetail() noexcept
+{
+	return levelsOfDetail;
+}
+
+/**
+* @brief selects levels of detail of the mesh chunks for the current frame and uploads resulting draw commands
+* to the indirect buffer. Upload is skipped if the mesh has not been uploaded yet
+* @param viewPosition position of the camera
+* @param projectionScale number of pixels a unit long segment takes on the screen at a unit distance from the camera
+* @param pixelError maximum allowed error of the coarse levels projected to the screen (in pixels)
+* @param cullingFrustum frustum to test chunks against
+*/
+void Generator::updateLevelsOfDetail( const glm::vec3 & viewPosition,
+									  float projectionScale,
+									  float pixelError,
+									  const Frustum & cullingFrustum )
+{
+	levelsOfDetail.selectLevels( viewPosition, projectionScale, pixelError, cullingFrustum );
+	if( basicGLBuffers.get( VAO ) == 0 )
+	{
+		return;
+	}
+	//storage is allocated once for the maximum number of commands, so it is not reallocated whenever the number of commands changes
+	UploadManager & uploadManager = UploadManager::getInstance();
+	const GLsizei MAX_NUM_COMMANDS = levelsOfDetail.getMaxNumDrawCommands();
+	if( indirectBufferCapacity != MAX_NUM_COMMANDS )
+	{
+		//pending copies to this buffer are still sized for the old storage, so they should be sent before it is replaced
+		uploadManager.flush();
+		glNamedBufferData( basicGLBuffers.get( DIBO ), INDIRECT_DRAW_COMMAND_BYTE_SIZE * MAX_NUM_COMMANDS, nullptr, GL_STREAM_DRAW );
+		indirectBufferCapacity = MAX_NUM_COMMANDS;
+	}
+	const std::vector<GLuint> & DRAW_COMMANDS = levelsOfDetail.getDrawCommands();
+	uploadManager.uploadBufferSubData( basicGLBuffers.get( DIBO ), 0, sizeof( GLuint ) * DRAW_COMMANDS.size(), DRAW_COMMANDS.data() );
+}
+
+/**
+* @brief creates GL objects of a buffer collection unless they have been already created
+* @param buffers buffer collection to initialize
+* @param flags integer union of individual GL object flags
+*/
+void Generator::createBuffersOnFirstUse( BufferCollection & buffers,
+										 int flags )
+{
+	if( buffers.get( VAO ) == 0 )
+	{
+		buffers.create( flags );
+	}
+}
+
 /**
 * @brief saves map data to file
 * @param output file stream to write data to
@@ -121,6 +278,40 @@ void Generator::deserialize( std::ifstream & input )
 	}
 }
 
+/**
+* @brief writes map data to the current section of the binary world file
+* @param writer world file writer
+*/
+void Generator::serialize( WorldFileWriter & writer ) const
+{
+	writer.writeHeightfield( map.view() );
+}
+
+/**
+* @brief reads map data from the binary world file section without touching the map
+* @param section world file section to read data from
+* @param savedMap view of the saved map, points right into the mapped file
+* @return false if section data does not match the map
+*/
+bool Generator::read( WorldFileSection & section,
+					  Heightfield2DView<const float> & savedMap ) const noexcept
+{
+	savedMap = section.readHeightfield();
+	return !section.isFailed() && savedMap.width() == map.width() && savedMap.height() == map.height();
+}
+
+/**
+* @brief loads map data previously read from the binary world file, map values are copied right from the mapped file
+* @param savedMap view of the saved map, its size should have been checked by read
+*/
+void Generator::deserialize( Heightfield2DView<const float> savedMap )
+{
+	for( size_t row = 0; row < map.height(); row++ )
+	{
+		std::copy( savedMap[row].begin(), savedMap[row].end(), map[row].begin() );
+	}
+}
+
 /**
 * @brief utility function that makes value transitions at neighbouring coordinates smoother
 * @param selfWeight percentage value defining how much impact original height value has on final result
@@ -133,31 +324,29 @@ void Generator::smoothMapAdjacentHeights( float selfWeight,
 										  float sideNeighbourWeight,
 										  float diagonalNeighbourWeight )
 {
-	//another boilerplate map is needed to prevent feedback during processing
-	map2D_f mapSmoothed;
-	Generator::initializeMap( mapSmoothed );
-	for( unsigned int y = 1; y < WORLD_HEIGHT; y++ )
+	//back buffer is needed to prevent feedback during processing, it is allocated once and then swapped with the map
+	if( mapBackBuffer.empty() )
 	{
-		for( unsigned int x = 1; x < WORLD_WIDTH; x++ )
-		{
-			if( map[y][x] == 0 )
-			{
-				continue;
-			}
-			float smoothedHeight =
-				map[y][x] * selfWeight
-				+ map[y - 1][x] * sideNeighbourWeight
-				+ map[y + 1][x] * sideNeighbourWeight
-				+ map[y][x - 1] * sideNeighbourWeight
-				+ map[y][x + 1] * sideNeighbourWeight
-				+ map[y - 1][x - 1] * diagonalNeighbourWeight
-				+ map[y - 1][x + 1] * diagonalNeighbourWeight
-				+ map[y + 1][x - 1] * diagonalNeighbourWeight
-				+ map[y + 1][x + 1] * diagonalNeighbourWeight;
-			mapSmoothed[y][x] = smoothedHeight;
-		}
+		Generator::initializeMap( mapBackBuffer );
 	}
-	map.assign( mapSmoothed.begin(), mapSmoothed.end() );
+	StencilEngine::smoothWeighted( map.slice( 1, 1, WORLD_WIDTH - 1, WORLD_HEIGHT - 1 ),
+								   mapBackBuffer.slice( 1, 1, WORLD_WIDTH - 1, WORLD_HEIGHT - 1 ),
+								   selfWeight,
+								   sideNeighbourWeight,
+								   diagonalNeighbourWeight );
+
+	//edges of the map are never smoothed and always become zero
+	for( unsigned int x = 0; x <= WORLD_WIDTH; x++ )
+	{
+		mapBackBuffer[0][x] = 0.0f;
+		mapBackBuffer[WORLD_HEIGHT][x] = 0.0f;
+	}
+	for( unsigned int y = 0; y <= WORLD_HEIGHT; y++ )
+	{
+		mapBackBuffer[y][0] = 0.0f;
+		mapBackBuffer[y][WORLD_WIDTH] = 0.0f;
+	}
+	map.swap( mapBackBuffer );
 }
 
 /**
@@ -168,37 +357,25 @@ void Generator::createNormalMap( map2D_vec3 & normalMap )
 {
 	using glm::vec3;
 
-	//first initialize and reserve enough capacity for normal map
-	normalMap.clear();
-	normalMap.reserve( WORLD_HEIGHT + 1 );
-	for( size_t row = 0; row < WORLD_HEIGHT + 1; row++ )
-	{
-		vec3 defaultNormal( 0.0f, 1.0f, 0.0f );
-		std::vector<vec3> defaultNormalsVec( WORLD_WIDTH + 1, defaultNormal );
-		normalMap.emplace_back( defaultNormalsVec );
-	}
+	//first initialize normal map storage with default normals
+	normalMap.assign( WORLD_WIDTH + 1, WORLD_HEIGHT + 1, vec3( 0.0f, 1.0f, 0.0f ) );
 
-	//create normals for each coordinate of the source map
-	for( unsigned int y = 1; y < map.size() - 1; y++ )
+	//create normals for each coordinate of the source map, rows are independent so they are split among threads
+	const auto NORMALS_START_TIME = std::chrono::steady_clock::now();
+	const size_t REGION_WIDTH = map[0].size() - 2;
+	ThreadPool::getInstance().parallelFor( 1, map.size() - 1, [&]( size_t bandBegin, size_t bandEnd )
 	{
-		for( unsigned int x = 1; x < map[0].size() - 1; x++ )
-		{
-			vec3 n0 = glm::normalize( vec3( map[y][x - 1] - map[y][x], 1, map[y - 1][x] - map[y][x] ) );
-			vec3 n3 = glm::normalize( vec3( map[y][x] - map[y][x + 1], 1, map[y - 1][x + 1] - map[y][x + 1] ) );
-			vec3 n6 = glm::normalize( vec3( map[y + 1][x - 1] - map[y + 1][x], 1, map[y][x] - map[y + 1][x] ) );
-			vec3 n1 = glm::normalize( vec3( map[y - 1][x] - map[y - 1][x + 1], 1, map[y - 1][x] - map[y][x] ) );
-			vec3 n4 = glm::normalize( vec3( map[y][x] - map[y][x + 1], 1, map[y][x] - map[y + 1][x] ) );
-			vec3 n9 = glm::normalize( vec3( map[y][x - 1] - map[y][x], 1, map[y][x - 1] - map[y + 1][x - 1] ) );
-			vec3 averagedNormal = glm::normalize( n0 + n1 + n3 + n4 + n6 + n9 );
-			normalMap[y][x] = averagedNormal;
-		}
-	}
+		StencilEngine::computeNormals( map.slice( 1, bandBegin, REGION_WIDTH, bandEnd - bandBegin ),
+									   normalMap.slice( 1, bandBegin, REGION_WIDTH, bandEnd - bandBegin ) );
+	} );
+	const auto FIXUP_START_TIME = std::chrono::steady_clock::now();
 
 	/*
 	 * make sure that we do not have a default normal where it should not be (0,1,0)
 	 * in this case just assign an approximation of three already calculated nearby normals
 	 * case 1: incorrect normal on the upper-left edge of the surface with no adjacent surfaces
 	 * case 2: incorrect normal on the bottom-right edge of the surface with no adjacent surfaces
+	 * each fixed normal may be used to fix the next ones, thus this pass remains sequential
 	 */
 	for( unsigned int y = 1; y < map.size() - 1; y++ )
 	{
@@ -217,6 +394,11 @@ void Generator::createNormalMap( map2D_vec3 & normalMap )
 			}
 		}
 	}
+
+	const auto FIXUP_END_TIME = std::chrono::steady_clock::now();
+	Logger::log( "normal map created: normals % ms, edges fixup % ms\n",
+				 std::to_string( std::chrono::duration<float, std::milli>( FIXUP_START_TIME - NORMALS_START_TIME ).count() ).c_str(),
+				 std::to_string( std::chrono::duration<float, std::milli>( FIXUP_END_TIME - FIXUP_START_TIME ).count() ).c_str() );
 }
 
 /**
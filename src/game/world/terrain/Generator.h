@@ -14,7 +14,7 @@
  * GNU General Public License for more details.
  * See <http://www.gnu.org/licenses/>
  *
- * Purpose: contains declaration for Generator class
+ * Purpose: contains declaration for Generator class, TerrainMeshData and PackedTerrainVertex structs
  * @version 0.1.0
  */
 
@@ -24,14 +24,60 @@
 #include "SceneSettings"
 #include "TypeAliases"
 #include "BufferCollection"
+#include "TerrainLod"
 
 #include <vector>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+class WorldFileWriter;
+class WorldFileSection;
+class Frustum;
 
 constexpr unsigned int UNIQUE_VERTICES_PER_TILE = 4;
 
+/**
+* @brief compact vertex of the terrain grid meshes (hills, shore, water) as it is on the OpenGL side.
+* Position is stored as 16-bit signed grid coordinates relative to the world center and full precision height,
+* normal is octahedral-encoded into two 16-bit snorm values. Texture coordinates and tangent frame are not stored at all,
+* vertex shaders reconstruct them from the grid position and the normal (see terrainVertex.ivs)
+*/
+struct PackedTerrainVertex
+{
+	PackedTerrainVertex( int mapX,
+						 int mapY,
+						 float height,
+						 const glm::vec3 & normal ) noexcept;
+	static void setupAttributes() noexcept;
+	int getMapX() const noexcept;
+	int getMapY() const noexcept;
+
+	/** @note X in the lower 16 bits, Z in the upper 16 bits */
+	GLuint gridPosition;
+	GLfloat height;
+	GLuint normal;
+};
+static_assert( sizeof( PackedTerrainVertex ) == 3 * sizeof( GLuint ), "packed terrain vertex must have no padding" );
+
+/**
+* @brief CPU side mesh of a terrain type as it is to be uploaded to the GPU.
+* Filled during the generation stage which does not touch OpenGL, consumed (and released) by the upload stage
+*/
+struct TerrainMeshData
+{
+	size_t getByteSize() const noexcept;
+	void clear();
+
+	std::vector<GLfloat> vertices;
+	std::vector<PackedTerrainVertex> packedVertices;
+	std::vector<GLuint> indices;
+	std::vector<glm::vec4> instances;
+};
+
 /**
 * @brief base class for generators. Each generator contains a map representing distribution of different kind of terrain on it.
-* Each generator has its own storage of terrain tiles and a GL buffer collection (some subclasses may have additional ones).
+* Each generator has its own storage of terrain tiles, CPU side mesh data and a GL buffer collection (some subclasses may have additional ones).
+* Generation (map processing, tiles and mesh data creation) makes no OpenGL calls, GL objects are created on the first upload.
 * Responsible for map initialization, buffer collection initialization, (de-)serialization.
 * Has some utility functions to transform map data
 */
@@ -41,10 +87,21 @@ public:
 	Generator() noexcept;
 	virtual ~Generator() = default;
 	const map2D_f & getMap() const noexcept;
+	const std::vector<TerrainTile> & getTiles() const noexcept;
+	const TerrainMeshData & getMeshData() const noexcept;
+	TerrainLod & getLevelsOfDetail() noexcept;
+	void updateLevelsOfDetail( const glm::vec3 & viewPosition,
+							   float projectionScale,
+							   float pixelError,
+							   const Frustum & cullingFrustum );
 	virtual void serialize( std::ofstream & output, 
 							bool usePrecision = false, 
 							unsigned int precision = 6 );
 	virtual void deserialize( std::ifstream & input );
+	void serialize( WorldFileWriter & writer ) const;
+	bool read( WorldFileSection & section,
+			   Heightfield2DView<const float> & savedMap ) const noexcept;
+	void deserialize( Heightfield2DView<const float> savedMap );
 
 	/**
 	* @brief creates storage for map data and initializes it with zeroes
@@ -54,12 +111,7 @@ public:
 	template <typename T>
 	static void initializeMap( map2D_template<T> & map )
 	{
-		map.clear();
-		map.reserve( WORLD_HEIGHT + 1 );
-		for( size_t row = 0; row < WORLD_HEIGHT + 1; row++ )
-		{
-			map.emplace_back( std::vector<T>( WORLD_WIDTH + 1, 0 ) );
-		}
+		map.assign( WORLD_WIDTH + 1, WORLD_HEIGHT + 1, T( 0 ) );
 	}
 	void smoothMapAdjacentHeights( float selfWeight, 
 								   float sideNeighbourWeight, 
@@ -67,9 +119,19 @@ public:
 	void createNormalMap( map2D_vec3 & normalMap );
 
 protected:
+	static void createBuffersOnFirstUse( BufferCollection & buffers,
+										 int flags );
+
 	map2D_f map;
+	/** @note auxiliary storage for map processing which would otherwise cause feedback, allocated on first use */
+	map2D_f mapBackBuffer;
 	std::vector<TerrainTile> tiles;
+	TerrainMeshData meshData;
+	/** @note used only by generators of grid meshes (hills, shore, water) */
+	TerrainLod levelsOfDetail;
 	BufferCollection basicGLBuffers;
+	/** @note number of draw commands the indirect buffer storage has been allocated for */
+	GLsizei indirectBufferCapacity;
 
 private:
 	template <typename T>
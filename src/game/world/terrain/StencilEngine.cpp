@@ -0,0 +1,429 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * StencilEngine.cpp
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains definitions for StencilEngine class
+ * @version 0.1.0
+ */
+
+#include "StencilEngine"
+#include "StencilKernels"
+
+#include <vector>
+#include <glm/geometric.hpp>
+
+INSTRUCTION_SET StencilEngine::instructionSet = CpuFeatures::getInstructionSet();
+
+/**
+* @brief scalar version of the weighted 3x3 smoothing for one point
+*/
+static float smoothWeightedPoint( const float * point,
+								  size_t stride,
+								  float selfWeight,
+								  float sideNeighbourWeight,
+								  float diagonalNeighbourWeight ) noexcept
+{
+	if( *point == 0 )
+	{
+		return 0.0f;
+	}
+	return point[0] * selfWeight
+		+ point[-(ptrdiff_t)stride] * sideNeighbourWeight
+		+ point[stride] * sideNeighbourWeight
+		+ point[-1] * sideNeighbourWeight
+		+ point[1] * sideNeighbourWeight
+		+ point[-(ptrdiff_t)stride - 1] * diagonalNeighbourWeight
+		+ point[-(ptrdiff_t)stride + 1] * diagonalNeighbourWeight
+		+ point[stride - 1] * diagonalNeighbourWeight
+		+ point[stride + 1] * diagonalNeighbourWeight;
+}
+
+/**
+* @brief scalar version of counting neighbours of one point whose height is not higher than the threshold value
+*/
+static int countNeighboursNotHigherPoint( const float * point,
+										  size_t stride,
+										  float thresholdValue ) noexcept
+{
+	int count = 0;
+	for( ptrdiff_t yOffset = -1; yOffset <= 1; yOffset++ )
+	{
+		for( ptrdiff_t xOffset = -1; xOffset <= 1; xOffset++ )
+		{
+			if( yOffset == 0 && xOffset == 0 ) //don't need to check itself
+			{
+				continue;
+			}
+			count += ( point[yOffset * (ptrdiff_t)stride + xOffset] <= thresholdValue ? 1 : 0 );
+		}
+	}
+	return count;
+}
+
+/**
+* @brief scalar version of sinks evaluation for one point
+* @param point pointer to the point
+* @param stride row stride of the map
+* @param higherNeighbours number of neighbours higher than the point
+* @param average averaged height of 3x3 neighbourhood
+*/
+static void evaluateSinkPoint( const float * point,
+							   size_t stride,
+							   int & higherNeighbours,
+							   float & average ) noexcept
+{
+	higherNeighbours = 0;
+	float sum = 0.0f;
+	bool firstSummand = true;
+	for( ptrdiff_t yOffset = -1; yOffset <= 1; yOffset++ )
+	{
+		for( ptrdiff_t xOffset = -1; xOffset <= 1; xOffset++ )
+		{
+			const float NEIGHBOUR = point[yOffset * (ptrdiff_t)stride + xOffset];
+			//keep the same summation order as the SIMD code to get identical rounding
+			sum = firstSummand ? NEIGHBOUR : sum + NEIGHBOUR;
+			firstSummand = false;
+			if( yOffset == 0 && xOffset == 0 ) //don't need to compare with itself
+			{
+				continue;
+			}
+			higherNeighbours += ( point[0] < NEIGHBOUR ? 1 : 0 );
+		}
+	}
+	average = sum / 9;
+}
+
+/**
+* @brief scalar version of zeroing a non-zero point that has only zero neighbours
+*/
+static void removeIsolatedPoint( float * point,
+								 size_t stride ) noexcept
+{
+	if( *point == 0.0f )
+	{
+		return;
+	}
+	for( ptrdiff_t yOffset = -1; yOffset <= 1; yOffset++ )
+	{
+		for( ptrdiff_t xOffset = -1; xOffset <= 1; xOffset++ )
+		{
+			if( ( yOffset != 0 || xOffset != 0 ) && point[yOffset * (ptrdiff_t)stride + xOffset] != 0 )
+			{
+				return;
+			}
+		}
+	}
+	*point = 0.0f;
+}
+
+/**
+* @brief scalar version of marking a point whose whole 3x3 neighbourhood is below the threshold value
+*/
+static void markSubmergedPoint( float * point,
+								size_t stride,
+								float thresholdValue,
+								float markValue ) noexcept
+{
+	for( ptrdiff_t yOffset = -1; yOffset <= 1; yOffset++ )
+	{
+		for( ptrdiff_t xOffset = -1; xOffset <= 1; xOffset++ )
+		{
+			if( !( point[yOffset * (ptrdiff_t)stride + xOffset] < thresholdValue ) )
+			{
+				return;
+			}
+		}
+	}
+	*point = markValue;
+}
+
+/**
+* @brief scalar version of the normal calculation for one point. Normal is averaged among six adjacent triangles
+*/
+static glm::vec3 computeNormalPoint( const float * point,
+									 size_t stride ) noexcept
+{
+	using glm::vec3;
+	const ptrdiff_t STRIDE = (ptrdiff_t)stride;
+	vec3 n0 = glm::normalize( vec3( point[-1] - point[0], 1, point[-STRIDE] - point[0] ) );
+	vec3 n3 = glm::normalize( vec3( point[0] - point[1], 1, point[-STRIDE + 1] - point[1] ) );
+	vec3 n6 = glm::normalize( vec3( point[STRIDE - 1] - point[STRIDE], 1, point[0] - point[STRIDE] ) );
+	vec3 n1 = glm::normalize( vec3( point[-STRIDE] - point[-STRIDE + 1], 1, point[-STRIDE] - point[0] ) );
+	vec3 n4 = glm::normalize( vec3( point[0] - point[1], 1, point[0] - point[STRIDE] ) );
+	vec3 n9 = glm::normalize( vec3( point[-1] - point[0], 1, point[-1] - point[STRIDE - 1] ) );
+	return glm::normalize( n0 + n1 + n3 + n4 + n6 + n9 );
+}
+
+/**
+* @brief applies weighted smoothing to each point of the source region and writes result to the destination region
+* @param source region of the map to smooth
+* @param destination region of the map to write result to (must not overlap source)
+* @param selfWeight impact of the point itself on the result
+* @param sideNeighbourWeight impact of each left/right/up/down neighbour on the result
+* @param diagonalNeighbourWeight impact of each diagonal neighbour on the result
+* @note points with zero height are treated as non-smoothable and remain zero
+*/
+void StencilEngine::smoothWeighted( Heightfield2DView<const float> source,
+									Heightfield2DView<float> destination,
+									float selfWeight,
+									float sideNeighbourWeight,
+									float diagonalNeighbourWeight )
+{
+	const Kernels & kernels = getKernels();
+	const size_t WIDTH = source.width();
+	const size_t STRIDE = source.stride();
+	for( size_t y = 0; y < source.height(); y++ )
+	{
+		const float * sourceRow = source[y].data();
+		float * destinationRow = destination[y].data();
+		size_t x = 0;
+		if( kernels.smoothWeighted )
+		{
+			x = kernels.smoothWeighted( sourceRow, destinationRow, STRIDE, x, WIDTH, selfWeight, sideNeighbourWeight, diagonalNeighbourWeight );
+		}
+		for( ; x < WIDTH; x++ )
+		{
+			destinationRow[x] = smoothWeightedPoint( sourceRow + x, STRIDE, selfWeight, sideNeighbourWeight, diagonalNeighbourWeight );
+		}
+	}
+}
+
+/**
+* @brief zeroes non-zero points which have too many neighbours not higher than plateau height.
+* Points are processed in place in row-major order, thus each point sees already processed upper and left neighbours
+* @param region region of the map to process
+* @param plateauHeight reference height value below which a point supposed to be treated as 'low'
+* @param neighboursLimit minimum number of 'low' neighbours to zero a point
+*/
+void StencilEngine::removePlateaus( Heightfield2DView<float> region,
+									float plateauHeight,
+									unsigned int neighboursLimit )
+{
+	const Kernels & kernels = getKernels();
+	const size_t WIDTH = region.width();
+	const size_t STRIDE = region.stride();
+	thread_local std::vector<int> counts;
+	counts.resize( WIDTH );
+	for( size_t y = 0; y < region.height(); y++ )
+	{
+		float * row = region[y].data();
+
+		//upper row is final at this point, so counts are exact unless left neighbour gets changed during this row pass
+		size_t x = 0;
+		if( kernels.countNeighboursNotHigher )
+		{
+			x = kernels.countNeighboursNotHigher( row, STRIDE, counts.data(), x, WIDTH, plateauHeight );
+		}
+		for( ; x < WIDTH; x++ )
+		{
+			counts[x] = countNeighboursNotHigherPoint( row + x, STRIDE, plateauHeight );
+		}
+
+		bool leftNeighbourChanged = false;
+		for( x = 0; x < WIDTH; x++ )
+		{
+			if( row[x] == 0 )
+			{
+				leftNeighbourChanged = false;
+				continue;
+			}
+			const int COUNT = leftNeighbourChanged ? countNeighboursNotHigherPoint( row + x, STRIDE, plateauHeight ) : counts[x];
+			leftNeighbourChanged = COUNT >= (int)neighboursLimit;
+			if( leftNeighbourChanged )
+			{
+				row[x] = 0;
+			}
+		}
+	}
+}
+
+/**
+* @brief levels points which have too many higher neighbours to the average height of their neighbourhood.
+* Points are processed in place in row-major order, thus each point sees already processed upper and left neighbours
+* @param region region of the map to process
+* @param neighboursLimit minimum number of higher neighbours to level a point
+*/
+void StencilEngine::smoothSinks( Heightfield2DView<float> region,
+								 unsigned int neighboursLimit )
+{
+	const Kernels & kernels = getKernels();
+	const size_t WIDTH = region.width();
+	const size_t STRIDE = region.stride();
+	thread_local std::vector<int> higherNeighbours;
+	thread_local std::vector<float> averages;
+	higherNeighbours.resize( WIDTH );
+	averages.resize( WIDTH );
+	for( size_t y = 0; y < region.height(); y++ )
+	{
+		float * row = region[y].data();
+
+		size_t x = 0;
+		if( kernels.evaluateSinks )
+		{
+			x = kernels.evaluateSinks( row, STRIDE, higherNeighbours.data(), averages.data(), x, WIDTH );
+		}
+		for( ; x < WIDTH; x++ )
+		{
+			evaluateSinkPoint( row + x, STRIDE, higherNeighbours[x], averages[x] );
+		}
+
+		bool leftNeighbourChanged = false;
+		for( x = 0; x < WIDTH; x++ )
+		{
+			if( leftNeighbourChanged )
+			{
+				evaluateSinkPoint( row + x, STRIDE, higherNeighbours[x], averages[x] );
+			}
+			leftNeighbourChanged = false;
+			if( higherNeighbours[x] >= (int)neighboursLimit )
+			{
+				leftNeighbourChanged = row[x] != averages[x];
+				row[x] = averages[x];
+			}
+		}
+	}
+}
+
+/**
+* @brief zeroes non-zero points that have only zero neighbours
+* @param region region of the map to process
+* @note zeroing a point never affects result for other points, so the order of processing does not matter
+*/
+void StencilEngine::removeIsolatedPoints( Heightfield2DView<float> region )
+{
+	const Kernels & kernels = getKernels();
+	const size_t WIDTH = region.width();
+	const size_t STRIDE = region.stride();
+	for( size_t y = 0; y < region.height(); y++ )
+	{
+		float * row = region[y].data();
+		size_t x = 0;
+		if( kernels.removeIsolatedPoints )
+		{
+			x = kernels.removeIsolatedPoints( row, STRIDE, x, WIDTH );
+		}
+		for( ; x < WIDTH; x++ )
+		{
+			removeIsolatedPoint( row + x, STRIDE );
+		}
+	}
+}
+
+/**
+* @brief replaces points whose whole 3x3 neighbourhood is below the threshold with the mark value
+* @param region region of the map to process
+* @param thresholdValue value below which a point is treated as submerged
+* @param markValue value to replace submerged points with
+*/
+void StencilEngine::markSubmergedPoints( Heightfield2DView<float> region,
+										 float thresholdValue,
+										 float markValue )
+{
+	/*
+	* if marked point is still below the threshold it never affects result for other points,
+	* otherwise in-place processing order matters and only scalar code keeps it
+	*/
+	const Kernels & kernels = getKernels();
+	const bool USE_KERNEL = kernels.markSubmergedPoints && markValue < thresholdValue;
+	const size_t WIDTH = region.width();
+	const size_t STRIDE = region.stride();
+	for( size_t y = 0; y < region.height(); y++ )
+	{
+		float * row = region[y].data();
+		size_t x = 0;
+		if( USE_KERNEL )
+		{
+			x = kernels.markSubmergedPoints( row, STRIDE, x, WIDTH, thresholdValue, markValue );
+		}
+		for( ; x < WIDTH; x++ )
+		{
+			markSubmergedPoint( row + x, STRIDE, thresholdValue, markValue );
+		}
+	}
+}
+
+/**
+* @brief calculates normal vector for each point of the region
+* @param region region of the height map
+* @param normals region of the normal map to write result to (must have the same dimensions as the height region)
+* @note every point is processed independently, thus different rows of the region might be processed concurrently
+*/
+void StencilEngine::computeNormals( Heightfield2DView<const float> region,
+									Heightfield2DView<glm::vec3> normals )
+{
+	static_assert( sizeof( glm::vec3 ) == 3 * sizeof( float ), "normal vector expected to be tightly packed" );
+	const Kernels & kernels = getKernels();
+	const size_t WIDTH = region.width();
+	const size_t STRIDE = region.stride();
+	for( size_t y = 0; y < region.height(); y++ )
+	{
+		const float * row = region[y].data();
+		glm::vec3 * normalsRow = normals[y].data();
+		size_t x = 0;
+		if( kernels.computeNormals )
+		{
+			x = kernels.computeNormals( row, STRIDE, &normalsRow->x, x, WIDTH );
+		}
+		for( ; x < WIDTH; x++ )
+		{
+			normalsRow[x] = computeNormalPoint( row + x, STRIDE );
+		}
+	}
+}
+
+INSTRUCTION_SET StencilEngine::getInstructionSet() noexcept
+{
+	return instructionSet;
+}
+
+/**
+* @brief restricts instruction set used by the engine (e.g. to compare SIMD results against scalar ones)
+* @param instructionSet desired instruction set, clamped to the one supported by the CPU
+*/
+void StencilEngine::setInstructionSet( INSTRUCTION_SET instructionSet ) noexcept
+{
+	const INSTRUCTION_SET SUPPORTED_INSTRUCTION_SET = CpuFeatures::getInstructionSet();
+	StencilEngine::instructionSet = instructionSet < SUPPORTED_INSTRUCTION_SET ? instructionSet : SUPPORTED_INSTRUCTION_SET;
+}
+
+/**
+* @brief returns set of row kernels for currently used instruction set
+*/
+const StencilEngine::Kernels & StencilEngine::getKernels() noexcept
+{
+	static const Kernels SCALAR_KERNELS = { nullptr, nullptr, nullptr, nullptr, nullptr, nullptr };
+#if CPU_FEATURES_X86
+	static const Kernels SSE4_KERNELS = { StencilKernels::smoothWeightedSSE4,
+										  StencilKernels::countNeighboursNotHigherSSE4,
+										  StencilKernels::evaluateSinksSSE4,
+										  StencilKernels::removeIsolatedPointsSSE4,
+										  StencilKernels::markSubmergedPointsSSE4,
+										  StencilKernels::computeNormalsSSE4 };
+	static const Kernels AVX2_KERNELS = { StencilKernels::smoothWeightedAVX2,
+										  StencilKernels::countNeighboursNotHigherAVX2,
+										  StencilKernels::evaluateSinksAVX2,
+										  StencilKernels::removeIsolatedPointsAVX2,
+										  StencilKernels::markSubmergedPointsAVX2,
+										  StencilKernels::computeNormalsAVX2 };
+	switch( instructionSet )
+	{
+	case ISA_AVX2:	return AVX2_KERNELS;
+	case ISA_SSE4:	return SSE4_KERNELS;
+	default:		return SCALAR_KERNELS;
+	}
+#else
+	return SCALAR_KERNELS;
+#endif
+}
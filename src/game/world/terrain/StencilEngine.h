@@ -0,0 +1,73 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * StencilEngine.h
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains declaration for StencilEngine class
+ * @version 0.1.0
+ */
+
+#pragma once
+
+#include "TypeAliases"
+#include "CpuFeatures"
+
+/**
+* @brief engine for 3x3 neighbourhood filters applied to terrain maps (smoothing, sinks/plateaus/orphans removal, normals etc.).
+* Each filter is processed row by row with SIMD kernels chosen at runtime according to the CPU capabilities,
+* leftover columns (and CPUs without SSE4.1) are processed with scalar code.
+* Every filter produces exactly the same result as its plain scalar version.
+* @note each filter processes every point of the given region, neighbours of the region border points are read
+* from outside of the region, so it is the caller's responsibility to make sure the region has 1-point margin in parent map
+*/
+class StencilEngine
+{
+public:
+	static void smoothWeighted( Heightfield2DView<const float> source,
+								Heightfield2DView<float> destination,
+								float selfWeight,
+								float sideNeighbourWeight,
+								float diagonalNeighbourWeight );
+	static void removePlateaus( Heightfield2DView<float> region,
+								float plateauHeight,
+								unsigned int neighboursLimit );
+	static void smoothSinks( Heightfield2DView<float> region,
+							 unsigned int neighboursLimit );
+	static void removeIsolatedPoints( Heightfield2DView<float> region );
+	static void markSubmergedPoints( Heightfield2DView<float> region,
+									 float thresholdValue,
+									 float markValue );
+	static void computeNormals( Heightfield2DView<const float> region,
+								Heightfield2DView<glm::vec3> normals );
+	static INSTRUCTION_SET getInstructionSet() noexcept;
+	static void setInstructionSet( INSTRUCTION_SET instructionSet ) noexcept;
+
+private:
+	/**
+	* @brief set of SIMD row kernels for one instruction set, null pointer means no SIMD code path
+	*/
+	struct Kernels
+	{
+		size_t ( *smoothWeighted )( const float *, float *, size_t, size_t, size_t, float, float, float ) noexcept;
+		size_t ( *countNeighboursNotHigher )( const float *, size_t, int *, size_t, size_t, float ) noexcept;
+		size_t ( *evaluateSinks )( const float *, size_t, int *, float *, size_t, size_t ) noexcept;
+		size_t ( *removeIsolatedPoints )( float *, size_t, size_t, size_t ) noexcept;
+		size_t ( *markSubmergedPoints )( float *, size_t, size_t, size_t, float, float ) noexcept;
+		size_t ( *computeNormals )( const float *, size_t, float *, size_t, size_t ) noexcept;
+	};
+
+	static const Kernels & getKernels() noexcept;
+
+	static INSTRUCTION_SET instructionSet;
+};
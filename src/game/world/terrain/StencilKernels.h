@@ -0,0 +1,104 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * StencilKernels.h
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains declarations for SIMD row kernels used by StencilEngine
+ * @version 0.1.0
+ */
+
+#pragma once
+
+#include <cstddef>
+
+/**
+* @brief SIMD row kernels of the stencil engine. Each kernel processes points of a map row starting from X coordinate
+* while there are enough points left to fill the whole SIMD register and returns the first unprocessed X coordinate.
+* Neighbour rows are accessed via row stride. Vector rows (normals etc.) are
+* tightly packed xyz triples. Kernels must never be called on CPUs not supporting their instruction set
+*/
+namespace StencilKernels
+{
+	size_t smoothWeightedSSE4( const float * sourceRow,
+							   float * destinationRow,
+							   size_t stride,
+							   size_t x,
+							   size_t xEnd,
+							   float selfWeight,
+							   float sideNeighbourWeight,
+							   float diagonalNeighbourWeight ) noexcept;
+	size_t countNeighboursNotHigherSSE4( const float * row,
+										 size_t stride,
+										 int * counts,
+										 size_t x,
+										 size_t xEnd,
+										 float thresholdValue ) noexcept;
+	size_t evaluateSinksSSE4( const float * row,
+							  size_t stride,
+							  int * higherNeighbours,
+							  float * averages,
+							  size_t x,
+							  size_t xEnd ) noexcept;
+	size_t removeIsolatedPointsSSE4( float * row,
+									 size_t stride,
+									 size_t x,
+									 size_t xEnd ) noexcept;
+	size_t markSubmergedPointsSSE4( float * row,
+									size_t stride,
+									size_t x,
+									size_t xEnd,
+									float thresholdValue,
+									float markValue ) noexcept;
+	size_t computeNormalsSSE4( const float * row,
+							   size_t stride,
+							   float * normals,
+							   size_t x,
+							   size_t xEnd ) noexcept;
+
+	size_t smoothWeightedAVX2( const float * sourceRow,
+							   float * destinationRow,
+							   size_t stride,
+							   size_t x,
+							   size_t xEnd,
+							   float selfWeight,
+							   float sideNeighbourWeight,
+							   float diagonalNeighbourWeight ) noexcept;
+	size_t countNeighboursNotHigherAVX2( const float * row,
+										 size_t stride,
+										 int * counts,
+										 size_t x,
+										 size_t xEnd,
+										 float thresholdValue ) noexcept;
+	size_t evaluateSinksAVX2( const float * row,
+							  size_t stride,
+							  int * higherNeighbours,
+							  float * averages,
+							  size_t x,
+							  size_t xEnd ) noexcept;
+	size_t removeIsolatedPointsAVX2( float * row,
+									 size_t stride,
+									 size_t x,
+									 size_t xEnd ) noexcept;
+	size_t markSubmergedPointsAVX2( float * row,
+									size_t stride,
+									size_t x,
+									size_t xEnd,
+									float thresholdValue,
+									float markValue ) noexcept;
+	size_t computeNormalsAVX2( const float * row,
+							   size_t stride,
+							   float * normals,
+							   size_t x,
+							   size_t xEnd ) noexcept;
+};
@@ -0,0 +1,301 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * StencilKernelsSSE4.cpp
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains definitions for SSE4.1 row kernels of the stencil engine
+ * @version 0.1.0
+ */
+
+#include "StencilKernels"
+#include "CpuFeatures"
+
+#if CPU_FEATURES_X86
+
+#if defined( __GNUC__ ) && !defined( __clang__ )
+#pragma GCC target( "sse4.1" )
+#elif defined( __clang__ )
+#pragma clang attribute push( __attribute__( ( target( "sse4.1" ) ) ), apply_to = function )
+#endif
+
+#include <smmintrin.h>
+
+namespace StencilKernels
+{
+	/**
+	* @brief SSE4.1 version of the weighted 3x3 smoothing. Points with zero height are left zero
+	*/
+	size_t smoothWeightedSSE4( const float * sourceRow,
+							   float * destinationRow,
+							   size_t stride,
+							   size_t x,
+							   size_t xEnd,
+							   float selfWeight,
+							   float sideNeighbourWeight,
+							   float diagonalNeighbourWeight ) noexcept
+	{
+		const float * upRow = sourceRow - stride;
+		const float * downRow = sourceRow + stride;
+		const __m128 SELF_WEIGHT = _mm_set1_ps( selfWeight );
+		const __m128 SIDE_WEIGHT = _mm_set1_ps( sideNeighbourWeight );
+		const __m128 DIAGONAL_WEIGHT = _mm_set1_ps( diagonalNeighbourWeight );
+		const __m128 ZERO = _mm_setzero_ps();
+		for( ; x + 4 <= xEnd; x += 4 )
+		{
+			//keep summation order of the scalar code to get identical rounding
+			const __m128 CENTER = _mm_loadu_ps( sourceRow + x );
+			__m128 sum = _mm_mul_ps( CENTER, SELF_WEIGHT );
+			sum = _mm_add_ps( sum, _mm_mul_ps( _mm_loadu_ps( upRow + x ), SIDE_WEIGHT ) );
+			sum = _mm_add_ps( sum, _mm_mul_ps( _mm_loadu_ps( downRow + x ), SIDE_WEIGHT ) );
+			sum = _mm_add_ps( sum, _mm_mul_ps( _mm_loadu_ps( sourceRow + x - 1 ), SIDE_WEIGHT ) );
+			sum = _mm_add_ps( sum, _mm_mul_ps( _mm_loadu_ps( sourceRow + x + 1 ), SIDE_WEIGHT ) );
+			sum = _mm_add_ps( sum, _mm_mul_ps( _mm_loadu_ps( upRow + x - 1 ), DIAGONAL_WEIGHT ) );
+			sum = _mm_add_ps( sum, _mm_mul_ps( _mm_loadu_ps( upRow + x + 1 ), DIAGONAL_WEIGHT ) );
+			sum = _mm_add_ps( sum, _mm_mul_ps( _mm_loadu_ps( downRow + x - 1 ), DIAGONAL_WEIGHT ) );
+			sum = _mm_add_ps( sum, _mm_mul_ps( _mm_loadu_ps( downRow + x + 1 ), DIAGONAL_WEIGHT ) );
+			const __m128 IS_ZERO = _mm_cmpeq_ps( CENTER, ZERO );
+			_mm_storeu_ps( destinationRow + x, _mm_andnot_ps( IS_ZERO, sum ) );
+		}
+		return x;
+	}
+
+	/**
+	* @brief SSE4.1 version of counting neighbours whose height is not higher than the threshold value
+	*/
+	size_t countNeighboursNotHigherSSE4( const float * row,
+										 size_t stride,
+										 int * counts,
+										 size_t x,
+										 size_t xEnd,
+										 float thresholdValue ) noexcept
+	{
+		const float * upRow = row - stride;
+		const float * downRow = row + stride;
+		const __m128 THRESHOLD = _mm_set1_ps( thresholdValue );
+		auto notHigher = [&]( const float * point )
+		{
+			//comparison result is either 0 or -1 per lane
+			return _mm_castps_si128( _mm_cmple_ps( _mm_loadu_ps( point ), THRESHOLD ) );
+		};
+		for( ; x + 4 <= xEnd; x += 4 )
+		{
+			__m128i count = _mm_setzero_si128();
+			count = _mm_sub_epi32( count, notHigher( upRow + x - 1 ) );
+			count = _mm_sub_epi32( count, notHigher( upRow + x ) );
+			count = _mm_sub_epi32( count, notHigher( upRow + x + 1 ) );
+			count = _mm_sub_epi32( count, notHigher( row + x - 1 ) );
+			count = _mm_sub_epi32( count, notHigher( row + x + 1 ) );
+			count = _mm_sub_epi32( count, notHigher( downRow + x - 1 ) );
+			count = _mm_sub_epi32( count, notHigher( downRow + x ) );
+			count = _mm_sub_epi32( count, notHigher( downRow + x + 1 ) );
+			_mm_storeu_si128( reinterpret_cast<__m128i*>( counts + x ), count );
+		}
+		return x;
+	}
+
+	/**
+	* @brief SSE4.1 version of sinks evaluation: counts neighbours higher than the point and averages 3x3 neighbourhood
+	*/
+	size_t evaluateSinksSSE4( const float * row,
+							  size_t stride,
+							  int * higherNeighbours,
+							  float * averages,
+							  size_t x,
+							  size_t xEnd ) noexcept
+	{
+		const float * upRow = row - stride;
+		const float * downRow = row + stride;
+		const __m128 NINE = _mm_set1_ps( 9.0f );
+		for( ; x + 4 <= xEnd; x += 4 )
+		{
+			const __m128 CENTER = _mm_loadu_ps( row + x );
+			const __m128 UP_LEFT = _mm_loadu_ps( upRow + x - 1 );
+			const __m128 UP = _mm_loadu_ps( upRow + x );
+			const __m128 UP_RIGHT = _mm_loadu_ps( upRow + x + 1 );
+			const __m128 LEFT = _mm_loadu_ps( row + x - 1 );
+			const __m128 RIGHT = _mm_loadu_ps( row + x + 1 );
+			const __m128 DOWN_LEFT = _mm_loadu_ps( downRow + x - 1 );
+			const __m128 DOWN = _mm_loadu_ps( downRow + x );
+			const __m128 DOWN_RIGHT = _mm_loadu_ps( downRow + x + 1 );
+
+			__m128i count = _mm_setzero_si128();
+			count = _mm_sub_epi32( count, _mm_castps_si128( _mm_cmplt_ps( CENTER, UP_LEFT ) ) );
+			count = _mm_sub_epi32( count, _mm_castps_si128( _mm_cmplt_ps( CENTER, UP ) ) );
+			count = _mm_sub_epi32( count, _mm_castps_si128( _mm_cmplt_ps( CENTER, UP_RIGHT ) ) );
+			count = _mm_sub_epi32( count, _mm_castps_si128( _mm_cmplt_ps( CENTER, LEFT ) ) );
+			count = _mm_sub_epi32( count, _mm_castps_si128( _mm_cmplt_ps( CENTER, RIGHT ) ) );
+			count = _mm_sub_epi32( count, _mm_castps_si128( _mm_cmplt_ps( CENTER, DOWN_LEFT ) ) );
+			count = _mm_sub_epi32( count, _mm_castps_si128( _mm_cmplt_ps( CENTER, DOWN ) ) );
+			count = _mm_sub_epi32( count, _mm_castps_si128( _mm_cmplt_ps( CENTER, DOWN_RIGHT ) ) );
+			_mm_storeu_si128( reinterpret_cast<__m128i*>( higherNeighbours + x ), count );
+
+			__m128 sum = _mm_add_ps( UP_LEFT, UP );
+			sum = _mm_add_ps( sum, UP_RIGHT );
+			sum = _mm_add_ps( sum, LEFT );
+			sum = _mm_add_ps( sum, CENTER );
+			sum = _mm_add_ps( sum, RIGHT );
+			sum = _mm_add_ps( sum, DOWN_LEFT );
+			sum = _mm_add_ps( sum, DOWN );
+			sum = _mm_add_ps( sum, DOWN_RIGHT );
+			_mm_storeu_ps( averages + x, _mm_div_ps( sum, NINE ) );
+		}
+		return x;
+	}
+
+	/**
+	* @brief SSE4.1 version of zeroing non-zero points that have only zero neighbours
+	*/
+	size_t removeIsolatedPointsSSE4( float * row,
+									 size_t stride,
+									 size_t x,
+									 size_t xEnd ) noexcept
+	{
+		const float * upRow = row - stride;
+		const float * downRow = row + stride;
+		const __m128 ZERO = _mm_setzero_ps();
+		auto isZero = [&]( const float * point )
+		{
+			return _mm_cmpeq_ps( _mm_loadu_ps( point ), ZERO );
+		};
+		for( ; x + 4 <= xEnd; x += 4 )
+		{
+			const __m128 CENTER = _mm_loadu_ps( row + x );
+			__m128 isolated = _mm_cmpneq_ps( CENTER, ZERO );
+			isolated = _mm_and_ps( isolated, isZero( upRow + x - 1 ) );
+			isolated = _mm_and_ps( isolated, isZero( upRow + x ) );
+			isolated = _mm_and_ps( isolated, isZero( upRow + x + 1 ) );
+			isolated = _mm_and_ps( isolated, isZero( row + x - 1 ) );
+			isolated = _mm_and_ps( isolated, isZero( row + x + 1 ) );
+			isolated = _mm_and_ps( isolated, isZero( downRow + x - 1 ) );
+			isolated = _mm_and_ps( isolated, isZero( downRow + x ) );
+			isolated = _mm_and_ps( isolated, isZero( downRow + x + 1 ) );
+			_mm_storeu_ps( row + x, _mm_andnot_ps( isolated, CENTER ) );
+		}
+		return x;
+	}
+
+	/**
+	* @brief SSE4.1 version of marking points whose whole 3x3 neighbourhood is below the threshold value
+	*/
+	size_t markSubmergedPointsSSE4( float * row,
+									size_t stride,
+									size_t x,
+									size_t xEnd,
+									float thresholdValue,
+									float markValue ) noexcept
+	{
+		const float * upRow = row - stride;
+		const float * downRow = row + stride;
+		const __m128 THRESHOLD = _mm_set1_ps( thresholdValue );
+		const __m128 MARK = _mm_set1_ps( markValue );
+		auto isBelow = [&]( const float * point )
+		{
+			return _mm_cmplt_ps( _mm_loadu_ps( point ), THRESHOLD );
+		};
+		for( ; x + 4 <= xEnd; x += 4 )
+		{
+			const __m128 CENTER = _mm_loadu_ps( row + x );
+			__m128 submerged = _mm_cmplt_ps( CENTER, THRESHOLD );
+			submerged = _mm_and_ps( submerged, isBelow( upRow + x - 1 ) );
+			submerged = _mm_and_ps( submerged, isBelow( upRow + x ) );
+			submerged = _mm_and_ps( submerged, isBelow( upRow + x + 1 ) );
+			submerged = _mm_and_ps( submerged, isBelow( row + x - 1 ) );
+			submerged = _mm_and_ps( submerged, isBelow( row + x + 1 ) );
+			submerged = _mm_and_ps( submerged, isBelow( downRow + x - 1 ) );
+			submerged = _mm_and_ps( submerged, isBelow( downRow + x ) );
+			submerged = _mm_and_ps( submerged, isBelow( downRow + x + 1 ) );
+			_mm_storeu_ps( row + x, _mm_blendv_ps( CENTER, MARK, submerged ) );
+		}
+		return x;
+	}
+
+	/**
+	* @brief SSE4.1 version of the normal vectors calculation, each normal is an averaged normal of six adjacent triangles
+	*/
+	size_t computeNormalsSSE4( const float * row,
+							   size_t stride,
+							   float * normals,
+							   size_t x,
+							   size_t xEnd ) noexcept
+	{
+		const float * upRow = row - stride;
+		const float * downRow = row + stride;
+		const __m128 ONE = _mm_set1_ps( 1.0f );
+		alignas( 16 ) float normalX[4];
+		alignas( 16 ) float normalY[4];
+		alignas( 16 ) float normalZ[4];
+
+		//the same operations as glm::normalize performs to get identical rounding
+		auto normalize = [&]( __m128 & vx, __m128 & vy, __m128 & vz )
+		{
+			const __m128 LENGTH_SQUARED = _mm_add_ps( _mm_add_ps( _mm_mul_ps( vx, vx ), _mm_mul_ps( vy, vy ) ), _mm_mul_ps( vz, vz ) );
+			const __m128 INVERSE_LENGTH = _mm_div_ps( ONE, _mm_sqrt_ps( LENGTH_SQUARED ) );
+			vx = _mm_mul_ps( vx, INVERSE_LENGTH );
+			vy = _mm_mul_ps( vy, INVERSE_LENGTH );
+			vz = _mm_mul_ps( vz, INVERSE_LENGTH );
+		};
+		for( ; x + 4 <= xEnd; x += 4 )
+		{
+			const __m128 CENTER = _mm_loadu_ps( row + x );
+			const __m128 LEFT = _mm_loadu_ps( row + x - 1 );
+			const __m128 RIGHT = _mm_loadu_ps( row + x + 1 );
+			const __m128 UP = _mm_loadu_ps( upRow + x );
+			const __m128 UP_RIGHT = _mm_loadu_ps( upRow + x + 1 );
+			const __m128 DOWN = _mm_loadu_ps( downRow + x );
+			const __m128 DOWN_LEFT = _mm_loadu_ps( downRow + x - 1 );
+			const __m128 LEFT_DIFF = _mm_sub_ps( LEFT, CENTER );
+			const __m128 RIGHT_DIFF = _mm_sub_ps( CENTER, RIGHT );
+			const __m128 UP_DIFF = _mm_sub_ps( UP, CENTER );
+			const __m128 DOWN_DIFF = _mm_sub_ps( CENTER, DOWN );
+
+			//normals of the triangles (named the same way as in the scalar code)
+			__m128 n0x = LEFT_DIFF, n0y = ONE, n0z = UP_DIFF;
+			__m128 n3x = RIGHT_DIFF, n3y = ONE, n3z = _mm_sub_ps( UP_RIGHT, RIGHT );
+			__m128 n6x = _mm_sub_ps( DOWN_LEFT, DOWN ), n6y = ONE, n6z = DOWN_DIFF;
+			__m128 n1x = _mm_sub_ps( UP, UP_RIGHT ), n1y = ONE, n1z = UP_DIFF;
+			__m128 n4x = RIGHT_DIFF, n4y = ONE, n4z = DOWN_DIFF;
+			__m128 n9x = LEFT_DIFF, n9y = ONE, n9z = _mm_sub_ps( LEFT, DOWN_LEFT );
+			normalize( n0x, n0y, n0z );
+			normalize( n3x, n3y, n3z );
+			normalize( n6x, n6y, n6z );
+			normalize( n1x, n1y, n1z );
+			normalize( n4x, n4y, n4z );
+			normalize( n9x, n9y, n9z );
+
+			//n0 + n1 + n3 + n4 + n6 + n9
+			__m128 sumX = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_add_ps( n0x, n1x ), n3x ), n4x ), n6x ), n9x );
+			__m128 sumY = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_add_ps( n0y, n1y ), n3y ), n4y ), n6y ), n9y );
+			__m128 sumZ = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_add_ps( n0z, n1z ), n3z ), n4z ), n6z ), n9z );
+			normalize( sumX, sumY, sumZ );
+
+			_mm_store_ps( normalX, sumX );
+			_mm_store_ps( normalY, sumY );
+			_mm_store_ps( normalZ, sumZ );
+			float * normal = normals + x * 3;
+			for( size_t lane = 0; lane < 4; lane++ )
+			{
+				normal[lane * 3] = normalX[lane];
+				normal[lane * 3 + 1] = normalY[lane];
+				normal[lane * 3 + 2] = normalZ[lane];
+			}
+		}
+		return x;
+	}
+};
+
+#if defined( __clang__ )
+#pragma clang attribute pop
+#endif
+
+#endif
@@ -0,0 +1,576 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * TerrainLod.cpp
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains definition for TerrainLod class
+ * @version 0.1.0
+ */
+
+#include "TerrainLod"
+#include "Generator"
+#include "Frustum"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+namespace
+{
+	/**
+	* @brief corners of a tile (or a quad) in counter-clockwise order.
+	* Edge from corner i to corner i + 1 lies on the side i (see TERRAIN_LOD_SIDE)
+	*/
+	enum TILE_CORNER : int
+	{
+		TILE_CORNER_LOW_LEFT = 0,
+		TILE_CORNER_LOW_RIGHT = 1,
+		TILE_CORNER_UPPER_RIGHT = 2,
+		TILE_CORNER_UPPER_LEFT = 3
+	};
+
+	enum SKIRT_PLACEMENT : int
+	{
+		SKIRT_NONE,
+		SKIRT_IN_BODY, //neighbour geometry differs on the same level, skirt is drawn always
+		SKIRT_IN_SIDE  //neighbour chunk geometry matches on the same level, skirt is drawn only if its level differs
+	};
+}
+
+/**
+* @brief plain ctor
+*/
+TerrainLod::TerrainLod() noexcept
+	: numChunksX( 0 )
+	, numChunksY( 0 )
+	, numDrawCommands( 0 )
+	, numVisibleDrawCommands( 0 )
+	, numSelectedTriangles( 0 )
+	, numVisibleTriangles( 0 )
+	, numFullDetailTriangles( 0 )
+{}
+
+/**
+* @brief rebuilds mesh indices into chunked levels of detail. Makes no OpenGL calls
+* @param tiles tiles of the mesh
+* @param meshData mesh data whose indices contain exactly VERTICES_PER_QUAD indices per tile in the same order as the tiles,
+* indices are replaced with chunked ones, skirt vertices are appended to the packed vertices
+* @param errorBias additional error of coarse levels not visible from the vertex heights (e.g. wave animation amplitude)
+*/
+void TerrainLod::build( const std::vector<TerrainTile> & tiles,
+						TerrainMeshData & meshData,
+						float errorBias )
+{
+	constexpr float SKIRT_DEPTH_MARGIN = 0.05f;
+	std::vector<PackedTerrainVertex> & vertices = meshData.packedVertices;
+	const std::vector<GLuint> FULL_DETAIL_INDICES = std::move( meshData.indices );
+	std::vector<GLuint> & indices = meshData.indices;
+	indices.clear();
+
+	//tiles lookup and prefix sums of tiles presence, tile coordinates here are (mapX - 1; mapY - 1)
+	std::vector<int> tileIndices( WORLD_WIDTH * WORLD_HEIGHT, -1 );
+	for( size_t tileIndex = 0; tileIndex < tiles.size(); tileIndex++ )
+	{
+		tileIndices[( tiles[tileIndex].mapY - 1 ) * WORLD_WIDTH + tiles[tileIndex].mapX - 1] = (int)tileIndex;
+	}
+	const int PREFIX_ROW_LENGTH = WORLD_WIDTH + 1;
+	std::vector<int> tilesPrefixSums( PREFIX_ROW_LENGTH * ( WORLD_HEIGHT + 1 ), 0 );
+	for( int y = 0; y < WORLD_HEIGHT; y++ )
+	{
+		for( int x = 0; x < WORLD_WIDTH; x++ )
+		{
+			tilesPrefixSums[( y + 1 ) * PREFIX_ROW_LENGTH + x + 1] = ( tileIndices[y * WORLD_WIDTH + x] != -1 ) +
+																	 tilesPrefixSums[( y + 1 ) * PREFIX_ROW_LENGTH + x] +
+																	 tilesPrefixSums[y * PREFIX_ROW_LENGTH + x + 1] -
+																	 tilesPrefixSums[y * PREFIX_ROW_LENGTH + x];
+		}
+	}
+	auto countTiles = [&]( int x, int y, int width, int height ) -> int
+	{
+		const int LEFT = std::max( x, 0 ), UPPER = std::max( y, 0 );
+		const int RIGHT = std::min( x + width, WORLD_WIDTH ), LOW = std::min( y + height, WORLD_HEIGHT );
+		if( LEFT >= RIGHT || UPPER >= LOW )
+		{
+			return 0;
+		}
+		return tilesPrefixSums[LOW * PREFIX_ROW_LENGTH + RIGHT] - tilesPrefixSums[UPPER * PREFIX_ROW_LENGTH + RIGHT] -
+			   tilesPrefixSums[LOW * PREFIX_ROW_LENGTH + LEFT] + tilesPrefixSums[UPPER * PREFIX_ROW_LENGTH + LEFT];
+	};
+
+	//vertices of the tiles corners are recognized by their grid position among the tile indices
+	std::vector<std::array<GLuint, UNIQUE_VERTICES_PER_TILE>> tileCorners( tiles.size() );
+	for( size_t tileIndex = 0; tileIndex < tiles.size(); tileIndex++ )
+	{
+		const TerrainTile & tile = tiles[tileIndex];
+		for( unsigned int indexOffset = 0; indexOffset < VERTICES_PER_QUAD; indexOffset++ )
+		{
+			const GLuint VERTEX_INDEX = FULL_DETAIL_INDICES[tileIndex * VERTICES_PER_QUAD + indexOffset];
+			const bool IS_LEFT = vertices[VERTEX_INDEX].getMapX() != tile.mapX;
+			const bool IS_LOW = vertices[VERTEX_INDEX].getMapY() == tile.mapY;
+			const TILE_CORNER CORNER = IS_LOW ? ( IS_LEFT ? TILE_CORNER_LOW_LEFT : TILE_CORNER_LOW_RIGHT )
+											  : ( IS_LEFT ? TILE_CORNER_UPPER_LEFT : TILE_CORNER_UPPER_RIGHT );
+			tileCorners[tileIndex][CORNER] = VERTEX_INDEX;
+		}
+	}
+	auto getQuadCorners = [&]( const Quad & quad ) -> std::array<GLuint, UNIQUE_VERTICES_PER_TILE>
+	{
+		const int RIGHT = quad.x + quad.size - 1, LOW = quad.y + quad.size - 1;
+		return { tileCorners[tileIndices[LOW * WORLD_WIDTH + quad.x]][TILE_CORNER_LOW_LEFT],
+				 tileCorners[tileIndices[LOW * WORLD_WIDTH + RIGHT]][TILE_CORNER_LOW_RIGHT],
+				 tileCorners[tileIndices[quad.y * WORLD_WIDTH + RIGHT]][TILE_CORNER_UPPER_RIGHT],
+				 tileCorners[tileIndices[quad.y * WORLD_WIDTH + quad.x]][TILE_CORNER_UPPER_LEFT] };
+	};
+
+	/*
+	 * first pass: for each chunk and level split the chunk into quads. An aligned block of tiles becomes a single quad
+	 * if all its tiles are present, otherwise it is split into four smaller blocks. Each tile is marked with the size of the quad covering it,
+	 * thus the whole quad sharing an edge with another one might be found by looking at any of its tiles
+	 */
+	numChunksX = ( WORLD_WIDTH + TERRAIN_LOD_CHUNK_SIZE - 1 ) / TERRAIN_LOD_CHUNK_SIZE;
+	numChunksY = ( WORLD_HEIGHT + TERRAIN_LOD_CHUNK_SIZE - 1 ) / TERRAIN_LOD_CHUNK_SIZE;
+	chunks.assign( numChunksX * numChunksY, Chunk() );
+	std::vector<std::vector<Quad>> chunkLevelQuads( chunks.size() * NUM_TERRAIN_LOD_LEVELS );
+	std::array<std::vector<unsigned char>, NUM_TERRAIN_LOD_LEVELS> quadSizes;
+	for( std::vector<unsigned char> & levelQuadSizes : quadSizes )
+	{
+		levelQuadSizes.assign( WORLD_WIDTH * WORLD_HEIGHT, 0 );
+	}
+	std::vector<Quad> pendingBlocks;
+	for( int chunkY = 0; chunkY < numChunksY; chunkY++ )
+	{
+		for( int chunkX = 0; chunkX < numChunksX; chunkX++ )
+		{
+			const int CHUNK_INDEX = chunkY * numChunksX + chunkX;
+			Chunk & chunk = chunks[CHUNK_INDEX];
+			chunk.neighbours[TERRAIN_LOD_SIDE_LOW] = chunkY + 1 < numChunksY ? CHUNK_INDEX + numChunksX : -1;
+			chunk.neighbours[TERRAIN_LOD_SIDE_RIGHT] = chunkX + 1 < numChunksX ? CHUNK_INDEX + 1 : -1;
+			chunk.neighbours[TERRAIN_LOD_SIDE_UPPER] = chunkY > 0 ? CHUNK_INDEX - numChunksX : -1;
+			chunk.neighbours[TERRAIN_LOD_SIDE_LEFT] = chunkX > 0 ? CHUNK_INDEX - 1 : -1;
+			const int CHUNK_LEFT = chunkX * TERRAIN_LOD_CHUNK_SIZE;
+			const int CHUNK_UPPER = chunkY * TERRAIN_LOD_CHUNK_SIZE;
+			const int CHUNK_RIGHT = std::min( CHUNK_LEFT + TERRAIN_LOD_CHUNK_SIZE, WORLD_WIDTH );
+			const int CHUNK_LOW = std::min( CHUNK_UPPER + TERRAIN_LOD_CHUNK_SIZE, WORLD_HEIGHT );
+			chunk.empty = countTiles( CHUNK_LEFT, CHUNK_UPPER, TERRAIN_LOD_CHUNK_SIZE, TERRAIN_LOD_CHUNK_SIZE ) == 0;
+			if( chunk.empty )
+			{
+				continue;
+			}
+
+			chunk.boundsMin = glm::vec3( std::numeric_limits<float>::max() );
+			chunk.boundsMax = glm::vec3( std::numeric_limits<float>::lowest() );
+			for( int y = CHUNK_UPPER; y < CHUNK_LOW; y++ )
+			{
+				for( int x = CHUNK_LEFT; x < CHUNK_RIGHT; x++ )
+				{
+					const int TILE_INDEX = tileIndices[y * WORLD_WIDTH + x];
+					if( TILE_INDEX == -1 )
+					{
+						continue;
+					}
+					for( GLuint vertexIndex : tileCorners[TILE_INDEX] )
+					{
+						const PackedTerrainVertex & vertex = vertices[vertexIndex];
+						const glm::vec3 POSITION( vertex.getMapX() - HALF_WORLD_WIDTH, vertex.height, vertex.getMapY() - HALF_WORLD_HEIGHT );
+						chunk.boundsMin = glm::min( chunk.boundsMin, POSITION );
+						chunk.boundsMax = glm::max( chunk.boundsMax, POSITION );
+					}
+				}
+			}
+			chunk.boundsMin.y -= errorBias;
+			chunk.boundsMax.y += errorBias;
+
+			for( int level = 0; level < NUM_TERRAIN_LOD_LEVELS; level++ )
+			{
+				std::vector<Quad> & quads = chunkLevelQuads[CHUNK_INDEX * NUM_TERRAIN_LOD_LEVELS + level];
+				const int LEVEL_QUAD_SIZE = 1 << level;
+				float levelError = 0.0f;
+				bool hasCoarseQuads = false;
+				for( int blockY = CHUNK_UPPER; blockY < CHUNK_LOW; blockY += LEVEL_QUAD_SIZE )
+				{
+					for( int blockX = CHUNK_LEFT; blockX < CHUNK_RIGHT; blockX += LEVEL_QUAD_SIZE )
+					{
+						pendingBlocks.push_back( { blockX, blockY, LEVEL_QUAD_SIZE, false } );
+					}
+				}
+				while( !pendingBlocks.empty() )
+				{
+					Quad block = pendingBlocks.back();
+					pendingBlocks.pop_back();
+					const int NUM_BLOCK_TILES = countTiles( block.x, block.y, block.size, block.size );
+					if( NUM_BLOCK_TILES == 0 )
+					{
+						continue;
+					}
+					if( NUM_BLOCK_TILES != block.size * block.size )
+					{
+						const int HALF_SIZE = block.size / 2;
+						pendingBlocks.push_back( { block.x, block.y, HALF_SIZE, false } );
+						pendingBlocks.push_back( { block.x + HALF_SIZE, block.y, HALF_SIZE, false } );
+						pendingBlocks.push_back( { block.x, block.y + HALF_SIZE, HALF_SIZE, false } );
+						pendingBlocks.push_back( { block.x + HALF_SIZE, block.y + HALF_SIZE, HALF_SIZE, false } );
+						continue;
+					}
+
+					if( block.size > 1 )
+					{
+						/*
+						 * measure vertical deviation of the fine vertices from both possible triangulations of the quad
+						 * and pick the one closer to the full detail surface. Local coordinates: u grows to the right, v grows upwards
+						 */
+						const std::array<GLuint, UNIQUE_VERTICES_PER_TILE> CORNERS = getQuadCorners( block );
+						const float LL = vertices[CORNERS[TILE_CORNER_LOW_LEFT]].height;
+						const float LR = vertices[CORNERS[TILE_CORNER_LOW_RIGHT]].height;
+						const float UR = vertices[CORNERS[TILE_CORNER_UPPER_RIGHT]].height;
+						const float UL = vertices[CORNERS[TILE_CORNER_UPPER_LEFT]].height;
+						float defaultDiagonalError = 0.0f, alternativeDiagonalError = 0.0f;
+						for( int y = block.y; y < block.y + block.size; y++ )
+						{
+							for( int x = block.x; x < block.x + block.size; x++ )
+							{
+								const std::array<GLuint, UNIQUE_VERTICES_PER_TILE> & TILE_CORNERS = tileCorners[tileIndices[y * WORLD_WIDTH + x]];
+								for( unsigned int corner = 0; corner < UNIQUE_VERTICES_PER_TILE; corner++ )
+								{
+									const bool IS_RIGHT = corner == TILE_CORNER_LOW_RIGHT || corner == TILE_CORNER_UPPER_RIGHT;
+									const bool IS_LOW = corner == TILE_CORNER_LOW_LEFT || corner == TILE_CORNER_LOW_RIGHT;
+									const float U = float( x + IS_RIGHT - block.x ) / block.size;
+									const float V = float( block.y + block.size - ( y + IS_LOW ) ) / block.size;
+									const float HEIGHT = vertices[TILE_CORNERS[corner]].height;
+									//default diagonal goes from the low left to the upper right corner
+									const float DEFAULT_HEIGHT = U >= V ? LL + U * ( LR - LL ) + V * ( UR - LR )
+																		: LL + V * ( UL - LL ) + U * ( UR - UL );
+									//alternative diagonal goes from the upper left to the low right corner
+									const float ALTERNATIVE_HEIGHT = U + V <= 1.0f ? LL + U * ( LR - LL ) + V * ( UL - LL )
+																				   : UR + ( 1.0f - U ) * ( UL - UR ) + ( 1.0f - V ) * ( LR - UR );
+									defaultDiagonalError = std::max( defaultDiagonalError, std::abs( HEIGHT - DEFAULT_HEIGHT ) );
+									alternativeDiagonalError = std::max( alternativeDiagonalError, std::abs( HEIGHT - ALTERNATIVE_HEIGHT ) );
+								}
+							}
+						}
+						block.alternativeDiagonal = alternativeDiagonalError < defaultDiagonalError;
+						levelError = std::max( levelError, std::min( defaultDiagonalError, alternativeDiagonalError ) );
+						hasCoarseQuads = true;
+					}
+					for( int y = block.y; y < block.y + block.size; y++ )
+					{
+						std::fill_n( quadSizes[level].begin() + y * WORLD_WIDTH + block.x, block.size, (unsigned char)block.size );
+					}
+					quads.push_back( block );
+				}
+				chunk.levels[level].error = hasCoarseQuads ? levelError + errorBias : 0.0f;
+				//coarser level is never considered more precise than finer one
+				if( level > 0 )
+				{
+					chunk.levels[level].error = std::max( chunk.levels[level].error, chunk.levels[level - 1].error );
+				}
+			}
+		}
+	}
+
+	/*
+	 * second pass: write indices of each chunk level by level. Body of a level contains its quads and the skirts which are always needed,
+	 * side ranges contain skirts along the chunk border for the case when the neighbour chunk has selected another level.
+	 * Skirts hang down deep enough to cover the largest possible gap between this level and any level of the neighbour
+	 */
+	auto getSkirtPlacement = [&]( const Quad & quad, int side, int level, int chunkIndex ) -> SKIRT_PLACEMENT
+	{
+		const bool ALONG_X = side == TERRAIN_LOD_SIDE_LOW || side == TERRAIN_LOD_SIDE_UPPER;
+		const int NEIGHBOUR_X = side == TERRAIN_LOD_SIDE_RIGHT ? quad.x + quad.size : ( side == TERRAIN_LOD_SIDE_LEFT ? quad.x - 1 : quad.x );
+		const int NEIGHBOUR_Y = side == TERRAIN_LOD_SIDE_LOW ? quad.y + quad.size : ( side == TERRAIN_LOD_SIDE_UPPER ? quad.y - 1 : quad.y );
+		if( countTiles( NEIGHBOUR_X, NEIGHBOUR_Y, ALONG_X ? quad.size : 1, ALONG_X ? 1 : quad.size ) == 0 )
+		{
+			//border of the mesh does not change at full detail only
+			return quad.size > 1 ? SKIRT_IN_BODY : SKIRT_NONE;
+		}
+		const bool NEIGHBOUR_TILE_PRESENT = NEIGHBOUR_X >= 0 && NEIGHBOUR_X < WORLD_WIDTH && NEIGHBOUR_Y >= 0 && NEIGHBOUR_Y < WORLD_HEIGHT;
+		if( NEIGHBOUR_TILE_PRESENT && quadSizes[level][NEIGHBOUR_Y * WORLD_WIDTH + NEIGHBOUR_X] == quad.size )
+		{
+			const int NEIGHBOUR_CHUNK_INDEX = ( NEIGHBOUR_Y / TERRAIN_LOD_CHUNK_SIZE ) * numChunksX + NEIGHBOUR_X / TERRAIN_LOD_CHUNK_SIZE;
+			return NEIGHBOUR_CHUNK_INDEX == chunkIndex ? SKIRT_NONE : SKIRT_IN_SIDE;
+		}
+		return SKIRT_IN_BODY;
+	};
+
+	std::unordered_map<GLuint, GLuint> skirtVertices;
+	std::array<std::vector<GLuint>, NUM_TERRAIN_LOD_SIDES> sideIndices;
+	indices.reserve( FULL_DETAIL_INDICES.size() * 3 / 2 );
+	for( size_t chunkIndex = 0; chunkIndex < chunks.size(); chunkIndex++ )
+	{
+		Chunk & chunk = chunks[chunkIndex];
+		if( chunk.empty )
+		{
+			continue;
+		}
+		float maxNeighbourError = 0.0f;
+		for( int neighbourIndex : chunk.neighbours )
+		{
+			if( neighbourIndex != -1 && !chunks[neighbourIndex].empty )
+			{
+				maxNeighbourError = std::max( maxNeighbourError, chunks[neighbourIndex].levels.back().error );
+			}
+		}
+
+		float maxSkirtDepth = 0.0f;
+		for( int level = 0; level < NUM_TERRAIN_LOD_LEVELS; level++ )
+		{
+			Level & lod = chunk.levels[level];
+			const float SKIRT_DEPTH = lod.error + maxNeighbourError + SKIRT_DEPTH_MARGIN;
+			skirtVertices.clear();
+			auto getSkirtVertex = [&]( GLuint vertexIndex ) -> GLuint
+			{
+				auto skirtVertex = skirtVertices.find( vertexIndex );
+				if( skirtVertex != skirtVertices.end() )
+				{
+					return skirtVertex->second;
+				}
+				PackedTerrainVertex loweredVertex = vertices[vertexIndex];
+				loweredVertex.height -= SKIRT_DEPTH;
+				vertices.push_back( loweredVertex );
+				maxSkirtDepth = std::max( maxSkirtDepth, SKIRT_DEPTH );
+				return skirtVertices.emplace( vertexIndex, (GLuint)( vertices.size() - 1 ) ).first->second;
+			};
+
+			lod.bodyOffset = (GLuint)indices.size();
+			for( const Quad & quad : chunkLevelQuads[chunkIndex * NUM_TERRAIN_LOD_LEVELS + level] )
+			{
+				const std::array<GLuint, UNIQUE_VERTICES_PER_TILE> CORNERS = getQuadCorners( quad );
+				if( quad.size == 1 )
+				{
+					//full detail tile keeps its original triangulation
+					const size_t TILE_INDICES_OFFSET = tileIndices[quad.y * WORLD_WIDTH + quad.x] * VERTICES_PER_QUAD;
+					indices.insert( indices.end(), FULL_DETAIL_INDICES.begin() + TILE_INDICES_OFFSET, FULL_DETAIL_INDICES.begin() + TILE_INDICES_OFFSET + VERTICES_PER_QUAD );
+				}
+				else if( quad.alternativeDiagonal )
+				{
+					indices.insert( indices.end(), { CORNERS[TILE_CORNER_UPPER_LEFT], CORNERS[TILE_CORNER_LOW_LEFT], CORNERS[TILE_CORNER_LOW_RIGHT],
+													 CORNERS[TILE_CORNER_LOW_RIGHT], CORNERS[TILE_CORNER_UPPER_RIGHT], CORNERS[TILE_CORNER_UPPER_LEFT] } );
+				}
+				else
+				{
+					indices.insert( indices.end(), { CORNERS[TILE_CORNER_LOW_LEFT], CORNERS[TILE_CORNER_LOW_RIGHT], CORNERS[TILE_CORNER_UPPER_RIGHT],
+													 CORNERS[TILE_CORNER_UPPER_RIGHT], CORNERS[TILE_CORNER_UPPER_LEFT], CORNERS[TILE_CORNER_LOW_LEFT] } );
+				}
+
+				for( int side = 0; side < NUM_TERRAIN_LOD_SIDES; side++ )
+				{
+					const SKIRT_PLACEMENT PLACEMENT = getSkirtPlacement( quad, side, level, (int)chunkIndex );
+					if( PLACEMENT == SKIRT_NONE )
+					{
+						continue;
+					}
+					//edge goes counter-clockwise around the quad, thus the skirt faces outwards
+					const GLuint EDGE_START = CORNERS[side];
+					const GLuint EDGE_END = CORNERS[( side + 1 ) % UNIQUE_VERTICES_PER_TILE];
+					const GLuint SKIRT_START = getSkirtVertex( EDGE_START );
+					const GLuint SKIRT_END = getSkirtVertex( EDGE_END );
+					std::vector<GLuint> & skirtIndices = PLACEMENT == SKIRT_IN_BODY ? indices : sideIndices[side];
+					skirtIndices.insert( skirtIndices.end(), { SKIRT_START, SKIRT_END, EDGE_END, EDGE_END, EDGE_START, SKIRT_START } );
+				}
+			}
+			lod.bodyCount = (GLuint)indices.size() - lod.bodyOffset;
+
+			for( int side = 0; side < NUM_TERRAIN_LOD_SIDES; side++ )
+			{
+				lod.sideOffsets[side] = (GLuint)indices.size();
+				lod.sideCounts[side] = (GLuint)sideIndices[side].size();
+				indices.insert( indices.end(), sideIndices[side].begin(), sideIndices[side].end() );
+				sideIndices[side].clear();
+			}
+		}
+		chunk.boundsMin.y -= maxSkirtDepth;
+	}
+	indices.shrink_to_fit();
+
+	selectedLevels.assign( chunks.size(), 0 );
+	chunksBounds.clear();
+	chunksBounds.reserve( chunks.size() );
+	for( const Chunk & chunk : chunks )
+	{
+		chunksBounds.push_back( AABB{ chunk.boundsMin, chunk.boundsMax } );
+	}
+	chunksVisibility.assign( chunks.size(), FRUSTUM_OUTSIDE );
+	drawCommands.clear();
+	drawCommands.reserve( getMaxNumDrawCommands() * INDIRECT_DRAW_COMMAND_ARGUMENTS );
+	visibleDrawCommands.clear();
+	visibleDrawCommands.reserve( getMaxNumDrawCommands() * INDIRECT_DRAW_COMMAND_ARGUMENTS / 2 );
+	numDrawCommands = 0;
+	numVisibleDrawCommands = 0;
+	numSelectedTriangles = 0;
+	numVisibleTriangles = 0;
+	numFullDetailTriangles = tiles.size() * 2;
+}
+
+/**
+* @brief selects level of detail for each chunk and prepares indirect draw commands for all chunks and for the visible ones.
+* Makes no OpenGL calls, commands are to be uploaded to the indirect buffer separately
+* @param viewPosition position of the camera
+* @param projectionScale number of pixels a unit long segment takes on the screen at a unit distance from the camera
+* @param pixelError maximum allowed error of the coarse level projected to the screen (in pixels)
+* @param cullingFrustum frustum to test chunks bounding boxes against
+*/
+void TerrainLod::selectLevels( const glm::vec3 & viewPosition,
+							   float projectionScale,
+							   float pixelError,
+							   const Frustum & cullingFrustum )
+{
+	//level fits if error * projectionScale / distance <= pixelError, i.e. the distance to the chunk is long enough
+	const float DISTANCE_PER_ERROR = projectionScale / std::max( pixelError, std::numeric_limits<float>::epsilon() );
+	for( size_t chunkIndex = 0; chunkIndex < chunks.size(); chunkIndex++ )
+	{
+		const Chunk & chunk = chunks[chunkIndex];
+		if( chunk.empty )
+		{
+			continue;
+		}
+		const float DISTANCE = glm::distance( viewPosition, glm::clamp( viewPosition, chunk.boundsMin, chunk.boundsMax ) );
+		unsigned char level = 0;
+		for( int candidateLevel = NUM_TERRAIN_LOD_LEVELS - 1; candidateLevel > 0; candidateLevel-- )
+		{
+			if( chunk.levels[candidateLevel].error * DISTANCE_PER_ERROR <= DISTANCE )
+			{
+				level = (unsigned char)candidateLevel;
+				break;
+			}
+		}
+		selectedLevels[chunkIndex] = level;
+	}
+
+	cullingFrustum.testAABBs( chunksBounds.data(), chunksBounds.size(), chunksVisibility.data() );
+	drawCommands.clear();
+	visibleDrawCommands.clear();
+	numSelectedTriangles = 0;
+	numVisibleTriangles = 0;
+	for( size_t chunkIndex = 0; chunkIndex < chunks.size(); chunkIndex++ )
+	{
+		const Chunk & chunk = chunks[chunkIndex];
+		if( chunk.empty )
+		{
+			continue;
+		}
+		const unsigned char LEVEL = selectedLevels[chunkIndex];
+		const Level & lod = chunk.levels[LEVEL];
+		const bool IS_VISIBLE = chunksVisibility[chunkIndex] != FRUSTUM_OUTSIDE;
+		GLuint numChunkIndices = lod.bodyCount;
+		addDrawCommand( drawCommands, lod.bodyOffset, lod.bodyCount );
+		if( IS_VISIBLE )
+		{
+			addDrawCommand( visibleDrawCommands, lod.bodyOffset, lod.bodyCount );
+		}
+		for( int side = 0; side < NUM_TERRAIN_LOD_SIDES; side++ )
+		{
+			const int NEIGHBOUR_INDEX = chunk.neighbours[side];
+			if( NEIGHBOUR_INDEX != -1 && !chunks[NEIGHBOUR_INDEX].empty && selectedLevels[NEIGHBOUR_INDEX] != LEVEL )
+			{
+				numChunkIndices += lod.sideCounts[side];
+				addDrawCommand( drawCommands, lod.sideOffsets[side], lod.sideCounts[side] );
+				if( IS_VISIBLE )
+				{
+					addDrawCommand( visibleDrawCommands, lod.sideOffsets[side], lod.sideCounts[side] );
+				}
+			}
+		}
+		numSelectedTriangles += numChunkIndices / 3;
+		numVisibleTriangles += IS_VISIBLE ? numChunkIndices / 3 : 0;
+	}
+	numDrawCommands = GLsizei( drawCommands.size() / INDIRECT_DRAW_COMMAND_ARGUMENTS );
+	numVisibleDrawCommands = GLsizei( visibleDrawCommands.size() / INDIRECT_DRAW_COMMAND_ARGUMENTS );
+	drawCommands.insert( drawCommands.end(), visibleDrawCommands.begin(), visibleDrawCommands.end() );
+}
+
+/**
+* @brief draws either all or only visible chunks at their selected levels, VAO of the mesh and indirect buffer
+* with uploaded draw commands should be bound
+* @param primitiveType GL primitive type to use for rendering
+* @param onlyVisible whether to draw only the chunks which passed frustum culling
+*/
+void TerrainLod::draw( GLenum primitiveType,
+					   bool onlyVisible ) const
+{
+	const GLsizei NUM_COMMANDS = onlyVisible ? numVisibleDrawCommands : numDrawCommands;
+	if( NUM_COMMANDS != 0 )
+	{
+		const GLintptr COMMANDS_OFFSET = onlyVisible ? numDrawCommands * INDIRECT_DRAW_COMMAND_BYTE_SIZE : 0;
+		glMultiDrawElementsIndirect( primitiveType, GL_UNSIGNED_INT, (const void*)COMMANDS_OFFSET, NUM_COMMANDS, 0 );
+	}
+}
+
+/**
+* @brief indirect draw commands of the current selection, commands for all chunks followed by commands for visible chunks
+*/
+const std::vector<GLuint> & TerrainLod::getDrawCommands() const noexcept
+{
+	return drawCommands;
+}
+
+/**
+* @brief maximum number of draw commands of a selection: body and all the sides of each chunk, in both lists
+*/
+GLsizei TerrainLod::getMaxNumDrawCommands() const noexcept
+{
+	return GLsizei( 2 * chunks.size() * ( 1 + NUM_TERRAIN_LOD_SIDES ) );
+}
+
+GLsizei TerrainLod::getNumDrawCommands() const noexcept
+{
+	return numDrawCommands;
+}
+
+GLsizei TerrainLod::getNumVisibleDrawCommands() const noexcept
+{
+	return numVisibleDrawCommands;
+}
+
+size_t TerrainLod::getNumSelectedTriangles() const noexcept
+{
+	return numSelectedTriangles;
+}
+
+size_t TerrainLod::getNumVisibleTriangles() const noexcept
+{
+	return numVisibleTriangles;
+}
+
+size_t TerrainLod::getNumFullDetailTriangles() const noexcept
+{
+	return numFullDetailTriangles;
+}
+
+/**
+* @brief appends indirect draw command for the range of indices, extends the previous command instead if the ranges are adjacent
+* @param commands storage of the commands
+* @param firstIndex offset of the first index
+* @param count number of indices
+*/
+void TerrainLod::addDrawCommand( std::vector<GLuint> & commands,
+								 GLuint firstIndex,
+								 GLuint count )
+{
+	if( count == 0 )
+	{
+		return;
+	}
+	// {indicesCount, numInstancesToDraw, firstIndex, baseVertex, baseInstance}
+	if( !commands.empty() )
+	{
+		GLuint * lastCommand = &commands[commands.size() - INDIRECT_DRAW_COMMAND_ARGUMENTS];
+		if( lastCommand[2] + lastCommand[0] == firstIndex )
+		{
+			lastCommand[0] += count;
+			return;
+		}
+	}
+	commands.insert( commands.end(), { count, 1, firstIndex, 0, 0 } );
+}
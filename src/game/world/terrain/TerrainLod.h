@@ -0,0 +1,135 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * TerrainLod.h
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains declaration for TerrainLod class which splits terrain grid meshes into chunks with several levels of detail
+ * @version 0.1.0
+ */
+
+#pragma once
+
+#include "TerrainTile"
+#include "SceneSettings"
+#include "BufferCollection"
+#include "Frustum"
+
+#include <GL/glew.h>
+#include <array>
+#include <vector>
+#include <glm/vec3.hpp>
+
+struct TerrainMeshData;
+
+/** @brief number of tiles along each side of a terrain chunk */
+constexpr int TERRAIN_LOD_CHUNK_SIZE = 32;
+/** @brief number of levels of detail, level N approximates terrain with quads of up to 2^N x 2^N tiles */
+constexpr int NUM_TERRAIN_LOD_LEVELS = 4;
+static_assert( TERRAIN_LOD_CHUNK_SIZE % ( 1 << ( NUM_TERRAIN_LOD_LEVELS - 1 ) ) == 0, "chunk must contain whole number of the coarsest quads" );
+
+enum TERRAIN_LOD_SIDE : int
+{
+	TERRAIN_LOD_SIDE_LOW = 0,   //+Z (greater map Y)
+	TERRAIN_LOD_SIDE_RIGHT = 1, //+X
+	TERRAIN_LOD_SIDE_UPPER = 2, //-Z
+	TERRAIN_LOD_SIDE_LEFT = 3,  //-X
+	NUM_TERRAIN_LOD_SIDES
+};
+
+/**
+* @brief chunked geomipmapping for terrain grid meshes (hills, shore, water).
+* During generation the mesh index buffer is rebuilt so that for each chunk of TERRAIN_LOD_CHUNK_SIZE^2 tiles
+* it contains several contiguous ranges of indices, one per level of detail. Coarser levels merge complete aligned blocks of tiles
+* into single quads reusing the existing corner vertices, each level stores the maximum vertical deviation from the full detail mesh.
+* Cracks between quads of different size are hidden with skirts: vertical strips hanging down from the quad edges,
+* their vertices are copies of the edge vertices with lowered height appended to the mesh vertices.
+* Skirts along the chunk border which are needed only when the neighbour chunk uses another level are kept in separate side ranges.
+* Each frame the coarsest level whose error projected to the screen does not exceed the threshold is selected for every chunk,
+* selected ranges become indirect draw commands. There are two lists of commands: one for all chunks (e.g. for depthmap rendering)
+* and one for the chunks whose bounding boxes intersect the culling frustum, each list is drawn with a single multi-draw indirect call
+*/
+class TerrainLod
+{
+public:
+	TerrainLod() noexcept;
+	void build( const std::vector<TerrainTile> & tiles,
+				TerrainMeshData & meshData,
+				float errorBias );
+	void selectLevels( const glm::vec3 & viewPosition,
+					   float projectionScale,
+					   float pixelError,
+					   const Frustum & cullingFrustum );
+	void draw( GLenum primitiveType,
+			   bool onlyVisible ) const;
+	const std::vector<GLuint> & getDrawCommands() const noexcept;
+	GLsizei getMaxNumDrawCommands() const noexcept;
+	GLsizei getNumDrawCommands() const noexcept;
+	GLsizei getNumVisibleDrawCommands() const noexcept;
+	size_t getNumSelectedTriangles() const noexcept;
+	size_t getNumVisibleTriangles() const noexcept;
+	size_t getNumFullDetailTriangles() const noexcept;
+
+private:
+	/**
+	* @brief index ranges and error of one level of detail of a chunk
+	*/
+	struct Level
+	{
+		GLuint bodyOffset;
+		GLuint bodyCount;
+		std::array<GLuint, NUM_TERRAIN_LOD_SIDES> sideOffsets;
+		std::array<GLuint, NUM_TERRAIN_LOD_SIDES> sideCounts;
+		float error;
+	};
+
+	struct Chunk
+	{
+		glm::vec3 boundsMin;
+		glm::vec3 boundsMax;
+		std::array<Level, NUM_TERRAIN_LOD_LEVELS> levels;
+		std::array<int, NUM_TERRAIN_LOD_SIDES> neighbours;
+		bool empty;
+	};
+
+	/**
+	* @brief square of tiles rendered as a single quad on some level of detail, coordinates are in tiles (mapX - 1, mapY - 1)
+	*/
+	struct Quad
+	{
+		int x;
+		int y;
+		int size;
+		bool alternativeDiagonal;
+	};
+
+	static void addDrawCommand( std::vector<GLuint> & commands,
+								GLuint firstIndex,
+								GLuint count );
+
+	int numChunksX;
+	int numChunksY;
+	std::vector<Chunk> chunks;
+	std::vector<unsigned char> selectedLevels;
+	//chunk bounds copied contiguously for the batch frustum test, and the per chunk test results
+	std::vector<AABB> chunksBounds;
+	std::vector<unsigned char> chunksVisibility;
+	/** @note commands for all chunks are followed by the commands for visible chunks only */
+	std::vector<GLuint> drawCommands;
+	std::vector<GLuint> visibleDrawCommands;
+	GLsizei numDrawCommands;
+	GLsizei numVisibleDrawCommands;
+	size_t numSelectedTriangles;
+	size_t numVisibleTriangles;
+	size_t numFullDetailTriangles;
+};
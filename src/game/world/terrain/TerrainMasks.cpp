@@ -0,0 +1,46 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * TerrainMasks.cpp
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains definitions for TerrainMasks class
+ * @version 0.1.0
+ */
+
+
+#include "TerrainMasks"
+#include "SceneSettings"
+
+/**
+* @brief classifies points of the land and the hills maps and combines the results into cell layers
+* @param landMap map of the land
+* @param hillsMap map of the hills
+*/
+void TerrainMasks::build( const map2D_f & landMap,
+						  const map2D_f & hillsMap )
+{
+	masks[TERRAIN_MASK_FLAT_LAND].build( landMap.view(), []( float value ) { return value == 0; } );
+	masks[TERRAIN_MASK_WATER].build( landMap.view(), []( float value ) { return value == TILE_NO_RENDER_VALUE; } );
+	masks[TERRAIN_MASK_HILLS].build( hillsMap.view(), []( float value ) { return value != 0; } );
+	masks[TERRAIN_MASK_LOW_HILLS].build( hillsMap.view(), []( float value ) { return value <= -HILLS_OFFSET_Y; } );
+
+	TileMask freePoints = masks[TERRAIN_MASK_FLAT_LAND];
+	freePoints &= masks[TERRAIN_MASK_LOW_HILLS];
+	masks[TERRAIN_MASK_FREE_CELLS] = freePoints.createAllCornersMask();
+}
+
+const TileMask & TerrainMasks::get( TERRAIN_MASK mask ) const noexcept
+{
+	return masks[mask];
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * TerrainMasks.h
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains declaration for TerrainMasks class and TERRAIN_MASK enum
+ * @version 0.1.0
+ */
+
+
+#pragma once
+
+#include "TileMask"
+#include "TypeAliases"
+
+#include <array>
+
+enum TERRAIN_MASK : int
+{
+	TERRAIN_MASK_FLAT_LAND = 0,   //points of the land map at zero level
+	TERRAIN_MASK_WATER = 1,       //points of the land map under the water
+	TERRAIN_MASK_HILLS = 2,       //points of the hills map with any hill height
+	TERRAIN_MASK_LOW_HILLS = 3,   //points of the hills map whose hills are hidden under the land
+	TERRAIN_MASK_FREE_CELLS = 4,  //cells with all corners on flat land and low hills, i.e. suitable for buildings and plants
+	NUM_TERRAIN_MASKS
+};
+
+/**
+* @brief set of terrain classification layers built once per generation (or load) of the world.
+* Consumers query bits instead of comparing float values of the maps point by point
+*/
+class TerrainMasks
+{
+public:
+	TerrainMasks() = default;
+	void build( const map2D_f & landMap,
+				const map2D_f & hillsMap );
+	const TileMask & get( TERRAIN_MASK mask ) const noexcept;
+
+private:
+	std::array<TileMask, NUM_TERRAIN_MASKS> masks;
+};
@@ -0,0 +1,326 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * TileMask.cpp
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains definitions for TileMask class
+ * @version 0.1.0
+ */
+
+
+#include "TileMask"
+
+#include <algorithm>
+
+TileMask::TileMask() noexcept
+	: maskWidth( 0 )
+	, maskHeight( 0 )
+	, rowWords( 0 )
+{}
+
+TileMask::TileMask( size_t width,
+					size_t height )
+	: TileMask()
+{
+	assign( width, height );
+}
+
+/**
+* @brief (re)allocates the mask for given dimensions and clears all bits
+* @param width number of columns
+* @param height number of rows
+*/
+void TileMask::assign( size_t width,
+					   size_t height )
+{
+	maskWidth = width;
+	maskHeight = height;
+	rowWords = ( width + 63 ) / 64;
+	words.assign( rowWords * height, 0 );
+}
+
+/**
+* @brief sets or clears the point's bit
+* @param x column of the point
+* @param y row of the point
+* @param value new bit value
+*/
+void TileMask::set( size_t x,
+					size_t y,
+					bool value ) noexcept
+{
+	uint64_t & word = words[y * rowWords + ( x >> 6 )];
+	const uint64_t BIT = (uint64_t)1 << ( x & 63 );
+	word = value ? ( word | BIT ) : ( word & ~BIT );
+}
+
+/**
+* @brief checks whether all points of the rectangle [left, right) x [top, bottom) are set.
+* Tests up to 64 points of a row with a single comparison
+* @param left leftmost column of the rectangle
+* @param top topmost row of the rectangle
+* @param right column next to the rightmost one of the rectangle
+* @param bottom row next to the bottommost one of the rectangle
+*/
+bool TileMask::allSet( size_t left,
+					   size_t top,
+					   size_t right,
+					   size_t bottom ) const noexcept
+{
+	if( left >= right || top >= bottom )
+	{
+		return true;
+	}
+	const size_t FIRST_WORD = left >> 6;
+	const size_t LAST_WORD = ( right - 1 ) >> 6;
+	const uint64_t FIRST_WORD_MASK = ~(uint64_t)0 << ( left & 63 );
+	const uint64_t LAST_WORD_MASK = ~(uint64_t)0 >> ( 63 - ( ( right - 1 ) & 63 ) );
+	for( size_t y = top; y < bottom; y++ )
+	{
+		const uint64_t * row = words.data() + y * rowWords;
+		for( size_t word = FIRST_WORD; word <= LAST_WORD; word++ )
+		{
+			uint64_t mask = ~(uint64_t)0;
+			if( word == FIRST_WORD )
+			{
+				mask &= FIRST_WORD_MASK;
+			}
+			if( word == LAST_WORD )
+			{
+				mask &= LAST_WORD_MASK;
+			}
+			if( ( row[word] & mask ) != mask )
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/**
+* @brief returns number of set points
+*/
+size_t TileMask::count() const noexcept
+{
+	size_t numSet = 0;
+	for( uint64_t word : words )
+	{
+		//SWAR population count
+		word = word - ( ( word >> 1 ) & 0x5555555555555555ULL );
+		word = ( word & 0x3333333333333333ULL ) + ( ( word >> 2 ) & 0x3333333333333333ULL );
+		word = ( word + ( word >> 4 ) ) & 0x0F0F0F0F0F0F0F0FULL;
+		numSet += ( word * 0x0101010101010101ULL ) >> 56;
+	}
+	return numSet;
+}
+
+/**
+* @brief greedily covers set points of the region [left, right) x [top, bottom) with rectangles and clears them.
+* Scanning in row-major order, each still set point starts a rectangle which takes the longest run of set points in its row
+* and then grows downwards while the next row has the whole run set. Rectangles never cross the region borders
+* @param left leftmost column of the region
+* @param top topmost row of the region
+* @param right column next to the rightmost one of the region
+* @param bottom row next to the bottommost one of the region
+* @param rectangles storage to append rectangles to
+*/
+void TileMask::extractRectangles( size_t left,
+								  size_t top,
+								  size_t right,
+								  size_t bottom,
+								  std::vector<TileRectangle> & rectangles )
+{
+	for( size_t y = top; y < bottom; y++ )
+	{
+		for( size_t x = left; x < right; x++ )
+		{
+			if( !test( x, y ) )
+			{
+				continue;
+			}
+			size_t runRight = x + 1;
+			while( runRight < right && test( runRight, y ) )
+			{
+				++runRight;
+			}
+			size_t runBottom = y + 1;
+			while( runBottom < bottom && allSet( x, runBottom, runRight, runBottom + 1 ) )
+			{
+				++runBottom;
+			}
+			for( size_t rectangleY = y; rectangleY < runBottom; rectangleY++ )
+			{
+				for( size_t rectangleX = x; rectangleX < runRight; rectangleX++ )
+				{
+					set( rectangleX, rectangleY, false );
+				}
+			}
+			rectangles.push_back( { (uint32_t)x, (uint32_t)y, (uint32_t)( runRight - x ), (uint32_t)( runBottom - y ) } );
+			x = runRight - 1;
+		}
+	}
+}
+
+/**
+* @brief intersects this mask with another mask of the same dimensions
+* @param rhs other mask
+*/
+TileMask & TileMask::operator&=( const TileMask & rhs ) noexcept
+{
+	for( size_t word = 0; word < words.size(); word++ )
+	{
+		words[word] &= rhs.words[word];
+	}
+	return *this;
+}
+
+/**
+* @brief unites this mask with another mask of the same dimensions
+* @param rhs other mask
+*/
+TileMask & TileMask::operator|=( const TileMask & rhs ) noexcept
+{
+	for( size_t word = 0; word < words.size(); word++ )
+	{
+		words[word] |= rhs.words[word];
+	}
+	return *this;
+}
+
+void TileMask::invert() noexcept
+{
+	for( uint64_t & word : words )
+	{
+		word = ~word;
+	}
+	clearPadding();
+}
+
+/**
+* @brief sets every point that has at least one set point in its 3x3 neighbourhood. Points outside the mask are treated as unset
+*/
+void TileMask::dilate()
+{
+	std::vector<uint64_t> horizontal( words.size() );
+	for( size_t y = 0; y < maskHeight; y++ )
+	{
+		const uint64_t * row = words.data() + y * rowWords;
+		for( size_t word = 0; word < rowWords; word++ )
+		{
+			horizontal[y * rowWords + word] = row[word] | shiftFromNextColumn( row, word, rowWords ) | shiftFromPreviousColumn( row, word );
+		}
+	}
+	for( size_t y = 0; y < maskHeight; y++ )
+	{
+		for( size_t word = 0; word < rowWords; word++ )
+		{
+			uint64_t value = horizontal[y * rowWords + word];
+			if( y > 0 )
+			{
+				value |= horizontal[( y - 1 ) * rowWords + word];
+			}
+			if( y + 1 < maskHeight )
+			{
+				value |= horizontal[( y + 1 ) * rowWords + word];
+			}
+			words[y * rowWords + word] = value;
+		}
+	}
+	clearPadding();
+}
+
+/**
+* @brief keeps only points whose whole 3x3 neighbourhood is set. Points outside the mask are treated as unset
+*/
+void TileMask::erode()
+{
+	std::vector<uint64_t> horizontal( words.size() );
+	for( size_t y = 0; y < maskHeight; y++ )
+	{
+		const uint64_t * row = words.data() + y * rowWords;
+		for( size_t word = 0; word < rowWords; word++ )
+		{
+			horizontal[y * rowWords + word] = row[word] & shiftFromNextColumn( row, word, rowWords ) & shiftFromPreviousColumn( row, word );
+		}
+	}
+	for( size_t y = 0; y < maskHeight; y++ )
+	{
+		for( size_t word = 0; word < rowWords; word++ )
+		{
+			uint64_t value = horizontal[y * rowWords + word];
+			value &= y > 0 ? horizontal[( y - 1 ) * rowWords + word] : 0;
+			value &= y + 1 < maskHeight ? horizontal[( y + 1 ) * rowWords + word] : 0;
+			words[y * rowWords + word] = value;
+		}
+	}
+}
+
+/**
+* @brief creates mask of cells: bit (x, y) of the result is set if all 4 corner points of the cell (x, y) are set in this mask.
+* The last row and column of the result are always unset as there are no cells starting there
+*/
+TileMask TileMask::createAllCornersMask() const
+{
+	TileMask cells( maskWidth, maskHeight );
+	for( size_t y = 0; y + 1 < maskHeight; y++ )
+	{
+		const uint64_t * row = words.data() + y * rowWords;
+		const uint64_t * nextRow = row + rowWords;
+		uint64_t * cellsRow = cells.words.data() + y * rowWords;
+		for( size_t word = 0; word < rowWords; word++ )
+		{
+			const uint64_t BOTH_ROWS = row[word] & nextRow[word];
+			const uint64_t BOTH_ROWS_NEXT_WORD = word + 1 < rowWords ? row[word + 1] & nextRow[word + 1] : 0;
+			cellsRow[word] = BOTH_ROWS & ( ( BOTH_ROWS >> 1 ) | ( BOTH_ROWS_NEXT_WORD << 63 ) );
+		}
+	}
+	return cells;
+}
+
+/**
+* @brief returns word of the row where each bit holds the value of the point in the next column
+*/
+uint64_t TileMask::shiftFromNextColumn( const uint64_t * row,
+										size_t word,
+										size_t numWords ) noexcept
+{
+	return ( row[word] >> 1 ) | ( word + 1 < numWords ? row[word + 1] << 63 : 0 );
+}
+
+/**
+* @brief returns word of the row where each bit holds the value of the point in the previous column
+*/
+uint64_t TileMask::shiftFromPreviousColumn( const uint64_t * row,
+											size_t word ) noexcept
+{
+	return ( row[word] << 1 ) | ( word > 0 ? row[word - 1] >> 63 : 0 );
+}
+
+/**
+* @brief resets bits past the last column so that whole-word operations never see garbage
+*/
+void TileMask::clearPadding() noexcept
+{
+	const size_t TAIL_BITS = maskWidth & 63;
+	if( TAIL_BITS == 0 )
+	{
+		return;
+	}
+	const uint64_t TAIL_MASK = ( (uint64_t)1 << TAIL_BITS ) - 1;
+	for( size_t y = 0; y < maskHeight; y++ )
+	{
+		words[y * rowWords + rowWords - 1] &= TAIL_MASK;
+	}
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * TileMask.h
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains declaration for TileMask class
+ * @version 0.1.0
+ */
+
+
+#pragma once
+
+#include "TypeAliases"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+/**
+* @brief rectangle of points [x, x + width) x [y, y + height) of a mask
+*/
+struct TileRectangle
+{
+	uint32_t x;
+	uint32_t y;
+	uint32_t width;
+	uint32_t height;
+};
+
+/**
+* @brief packed bitset over the points of a 2D map, one bit per point, each row occupies whole number of 64-bit words.
+* Used to classify map points (e.g. "flat land", "water", "low hills") once instead of comparing float values
+* of 4 or 9 neighbours over and over again. Whole-mask operations process 64 points per word operation
+* in plain loops that compilers vectorize. Padding bits past the last column are always zero.
+* Cell queries treat point (x, y) as the upper-left corner of the cell spanning points [x, x + 1] x [y, y + 1]
+*/
+class TileMask
+{
+public:
+	TileMask() noexcept;
+	TileMask( size_t width,
+			  size_t height );
+	void assign( size_t width,
+				 size_t height );
+
+	/**
+	* @brief (re)builds the mask from a map: point's bit is set if the predicate returns true for the point's value
+	* @param map source map
+	* @param predicate function returning whether the point's bit should be set, called as predicate( value )
+	*/
+	template <typename Predicate>
+	void build( Heightfield2DView<const float> map,
+				Predicate predicate )
+	{
+		assign( map.width(), map.height() );
+		for( size_t y = 0; y < maskHeight; y++ )
+		{
+			const float * row = map[y].data();
+			uint64_t * maskRow = words.data() + y * rowWords;
+			//gather each word in a register, the inner loop has fixed trip count and no stores thus is easily vectorized
+			for( size_t word = 0; word < rowWords; word++ )
+			{
+				const size_t WORD_START = word * 64;
+				const size_t WORD_BITS = std::min<size_t>( 64, maskWidth - WORD_START );
+				uint64_t bits = 0;
+				for( size_t bit = 0; bit < WORD_BITS; bit++ )
+				{
+					bits |= (uint64_t)( predicate( row[WORD_START + bit] ) ? 1 : 0 ) << bit;
+				}
+				maskRow[word] = bits;
+			}
+		}
+	}
+
+	/**
+	* @brief checks whether the point's bit is set
+	* @param x column of the point
+	* @param y row of the point
+	*/
+	bool test( size_t x,
+			   size_t y ) const noexcept
+	{
+		return ( words[y * rowWords + ( x >> 6 )] >> ( x & 63 ) ) & 1;
+	}
+
+	/**
+	* @brief checks whether all 4 corner points of the cell are set
+	* @param x column of the upper-left corner of the cell
+	* @param y row of the upper-left corner of the cell
+	*/
+	bool allCornersSet( size_t x,
+						size_t y ) const noexcept
+	{
+		return test( x, y ) && test( x + 1, y ) && test( x, y + 1 ) && test( x + 1, y + 1 );
+	}
+
+	/**
+	* @brief checks whether any of 4 corner points of the cell is set
+	* @param x column of the upper-left corner of the cell
+	* @param y row of the upper-left corner of the cell
+	*/
+	bool anyCornerSet( size_t x,
+					   size_t y ) const noexcept
+	{
+		return test( x, y ) || test( x + 1, y ) || test( x, y + 1 ) || test( x + 1, y + 1 );
+	}
+
+	void set( size_t x,
+			  size_t y,
+			  bool value ) noexcept;
+	bool allSet( size_t left,
+				 size_t top,
+				 size_t right,
+				 size_t bottom ) const noexcept;
+	size_t count() const noexcept;
+	void extractRectangles( size_t left,
+							size_t top,
+							size_t right,
+							size_t bottom,
+							std::vector<TileRectangle> & rectangles );
+	TileMask & operator&=( const TileMask & rhs ) noexcept;
+	TileMask & operator|=( const TileMask & rhs ) noexcept;
+	void invert() noexcept;
+	void dilate();
+	void erode();
+	TileMask createAllCornersMask() const;
+	size_t width() const noexcept { return maskWidth; }
+	size_t height() const noexcept { return maskHeight; }
+
+private:
+	static uint64_t shiftFromNextColumn( const uint64_t * row,
+										 size_t word,
+										 size_t numWords ) noexcept;
+	static uint64_t shiftFromPreviousColumn( const uint64_t * row,
+											 size_t word ) noexcept;
+	void clearPadding() noexcept;
+
+	std::vector<uint64_t> words;
+	size_t maskWidth;
+	size_t maskHeight;
+	size_t rowWords;
+};
@@ -35,37 +35,32 @@ BuildableFacade::BuildableFacade( Shader & buildableRenderShader,
 
 /**
 * @brief delegates map creation to a generator
-* @param landMap map of the land tiles
-* @param hillsMap map of the hill tiles
+* @param freeCells mask of cells lying on flat land without visible hills
 */
-void BuildableFacade::setup( const map2D_f & landMap, 
-							 const map2D_f & hillsMap )
+void BuildableFacade::setup( const TileMask & freeCells )
 {
-	generator.setup( landMap, hillsMap );
+	generator.setup( freeCells );
 }
 
 /**
 * @brief launches buildable tiles rendering routine
-* @param projectionView "projection * view" matrix fed to the shader
 */
-void BuildableFacade::drawBuildable( const glm::mat4 & projectionView )
+void BuildableFacade::drawBuildable()
 {
-	shader.updateBuildable( projectionView );
+	shader.updateBuildable();
 	renderer.renderBuildable();
 }
 
 /**
 * @brief launches selected tile rendering routine
-* @param projectionView "projection * view" matrix fed to the shader
 * @param mouseInput mouse input object used to pick cursor current map coordinates
 */
-void BuildableFacade::drawSelected( const glm::mat4 & projectionView, 
-									MouseInputManager & mouseInput )
+void BuildableFacade::drawSelected( MouseInputManager & mouseInput )
 {
 	if( generator.getMap()[mouseInput.getCursorWorldZ()][mouseInput.getCursorWorldX()] != 0 )
 	{
 		glm::vec4 translationVector( -HALF_WORLD_WIDTH + mouseInput.getCursorWorldX(), 0.01f, -HALF_WORLD_HEIGHT + mouseInput.getCursorWorldZ(), 0.0f );
-		shader.updateSelected( projectionView, translationVector );
+		shader.updateSelected( translationVector );
 		renderer.renderSelected();
 	}
 }
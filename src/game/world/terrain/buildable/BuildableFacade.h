@@ -25,6 +25,7 @@
 #include "BuildableRenderer"
 
 class MouseInputManager;
+class TileMask;
 
 /**
 * @brief facade for buildable and selected tiles on a map.
@@ -35,11 +36,9 @@ class BuildableFacade
 public:
 	BuildableFacade( Shader & buildableRenderShader, 
 					 Shader & selectedRenderShader ) noexcept;
-	void setup( const map2D_f & landMap, 
-				const map2D_f & hillsMap );
-	void drawBuildable( const glm::mat4 & projectionView );
-	void drawSelected( const glm::mat4 & projectionView, 
-					   MouseInputManager & mouseInput );
+	void setup( const TileMask & freeCells );
+	void drawBuildable();
+	void drawSelected( MouseInputManager & mouseInput );
 	const map2D_f & getMap() const noexcept;
 
 private:
@@ -19,47 +19,31 @@
  */
 
 #include "BuildableGenerator"
+#include "TileMask"
+#include "UploadManager"
 
 #include <memory>
 
 /**
-* @brief plain ctor. Adds instance buffer object for inherited buffer collection and creates vao/vbo/ebo collection
-* for selected tile
+* @brief plain ctor
 */
 BuildableGenerator::BuildableGenerator() noexcept
 	: Generator()
-	, selectedBuffers( VAO | VBO | EBO )
-{
-	//this collection already have VAO/VBO/EBO in Generator ctor
-	basicGLBuffers.add( INSTANCE_VBO );
-}
+{}
 
 /**
 * @brief walks through the world map and marks individual tiles as buildable where applicable.
 * Then creates tiles and loads them to OpenGL
-* @param landMap map of the land tiles
-* @param hillsMap map of the hill tiles
+* @param freeCells mask of cells lying on flat land without visible hills
 */
-void BuildableGenerator::setup( const map2D_f & landMap, 
-								const map2D_f & hillsMap )
+void BuildableGenerator::setup( const TileMask & freeCells )
 {
 	for( unsigned int y = UPPER_LEFT_CORNER_START_Y; y < WORLD_HEIGHT; y++ )
 	{
 		for( unsigned int x = UPPER_LEFT_CORNER_START_X; x < WORLD_WIDTH - 1; x++ )
 		{
-			//implicit cast to float! In this case its ok, as we don't need any values except "has something" or "not"
-			map[y][x] = false;
-			if( landMap[y][x] == 0 &&
-				landMap[y - 1][x] == 0 &&
-				landMap[y - 1][x + 1] == 0 &&
-				landMap[y][x + 1] == 0 &&
-				hillsMap[y][x] <= -HILLS_OFFSET_Y &&
-				hillsMap[y - 1][x] <= -HILLS_OFFSET_Y &&
-				hillsMap[y - 1][x + 1] <= -HILLS_OFFSET_Y &&
-				hillsMap[y][x + 1] <= -HILLS_OFFSET_Y )
-			{
-				map[y][x] = true;
-			}
+			//buildable tile at (x, y) covers the cell whose upper-left corner is (x, y - 1)
+			map[y][x] = freeCells.test( x, y - 1 );
 		}
 	}
 	createTiles();
@@ -96,10 +80,13 @@ void BuildableGenerator::createTiles()
 }
 
 /**
-* @brief setup buffer collections, their layouts and buffer data into it
+* @brief setup buffer collections (vao/vbo/ebo for selected tile, with additional instance buffer for buildable tiles),
+* their layouts and buffer data into it
 */
 void BuildableGenerator::fillBufferData()
 {
+	createBuffersOnFirstUse( selectedBuffers, VAO | VBO | EBO );
+	createBuffersOnFirstUse( basicGLBuffers, VAO | VBO | INSTANCE_VBO | EBO );
 	setupAndBindBuffers( selectedBuffers );
 	BufferCollection::bindZero( VAO | VBO | EBO );
 
@@ -113,7 +100,7 @@ void BuildableGenerator::fillBufferData()
 
 	//the only difference of the buildable tiles is their location, thus buffer it as per-instance data
 	basicGLBuffers.bind( INSTANCE_VBO );
-	glBufferData( GL_ARRAY_BUFFER, sizeof( glm::vec4 ) * tiles.size(), &instancesTranslations[0], GL_STATIC_DRAW );
+	UploadManager::getInstance().uploadBufferData( basicGLBuffers.get( INSTANCE_VBO ), sizeof( glm::vec4 ) * tiles.size(), instancesTranslations.get(), GL_STATIC_DRAW );
 	glEnableVertexAttribArray( 1 );
 	glVertexAttribPointer( 1, 4, GL_FLOAT, GL_FALSE, sizeof( glm::vec4 ), 0 );
 	glVertexAttribDivisor( 1, 1 );
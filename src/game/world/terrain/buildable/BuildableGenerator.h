@@ -22,6 +22,8 @@
 
 #include "Generator"
 
+class TileMask;
+
 /**
 * @brief Generator for buildable segments of the world map. Technically, it doesn't "generate" anything,
 * but rather checks which tiles of already created map are available for building on them. Additionally
@@ -32,8 +34,7 @@ class BuildableGenerator : public Generator
 public:
 	BuildableGenerator() noexcept;
 	virtual ~BuildableGenerator() = default;
-	void setup( const map2D_f & landMap, 
-				const map2D_f & hillsMap );
+	void setup( const TileMask & freeCells );
 	void createTiles();
 
 private:
@@ -33,24 +33,19 @@ BuildableShader::BuildableShader( Shader & buildableRenderShader,
 {}
 
 /**
-* @brief updates necessary uniforms in buildable shader
-* @param projectionView "projection * view" matrix
+* @brief activates buildable shader, its only uniform (projectionView) comes from the camera block
 */
-void BuildableShader::updateBuildable( const glm::mat4 & projectionView )
+void BuildableShader::updateBuildable()
 {
 	buildableRenderShader.use();
-	buildableRenderShader.setMat4( "u_projectionView", projectionView );
 }
 
 /**
 * @brief updates necessary uniforms in selected shader
-* @param projectionView "projection * view" matrix
 * @param selectedTranslation translation vector of the selected cell geometry
 */
-void BuildableShader::updateSelected( const glm::mat4 & projectionView, 
-									  const glm::vec4 & selectedTranslation )
+void BuildableShader::updateSelected( const glm::vec4 & selectedTranslation )
 {
 	selectedRenderShader.use();
-	selectedRenderShader.setMat4( "u_projectionView", projectionView );
 	selectedRenderShader.setVec4( "u_translation", selectedTranslation );
 }
@@ -21,7 +21,6 @@
 #pragma once
 
 #include <glm/vec4.hpp>
-#include <glm/mat4x4.hpp>
 
 class Shader;
 
@@ -33,9 +32,8 @@ class BuildableShader
 public:
 	BuildableShader( Shader & buildableRenderShader, 
 					 Shader & selectedRenderShader ) noexcept;
-	void updateBuildable( const glm::mat4 & projectionView );
-	void updateSelected( const glm::mat4 & projectionView, 
-						 const glm::vec4 & selectedTranslation );
+	void updateBuildable();
+	void updateSelected( const glm::vec4 & selectedTranslation );
 
 private:
 	Shader & buildableRenderShader;
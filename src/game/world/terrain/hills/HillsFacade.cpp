@@ -22,26 +22,25 @@
 
 /**
 * @brief plain ctor. Constructs all the member subsystems.
-* @param renderShader shader program used during rendering (no frustum culling)
-* @param cullingShader shader program used during offscreen rendering with frustum culling
+* @param renderShader shader program used during rendering
 * @param normalsShader shader program used during normals visualization rendering
 * @param waterMap map of the water tiles
 */
 HillsFacade::HillsFacade( Shader & renderShader, 
-						  Shader & cullingShader, 
 						  Shader & normalsShader, 
 						  const map2D_f & waterMap )
-	: shaders( renderShader, cullingShader, normalsShader )
-	, generator( shaders, waterMap )
+	: shaders( renderShader, normalsShader )
+	, generator( waterMap )
 	, renderer( shaders, generator )
 {}
 
 /**
-* @brief sends setup command to generator
+* @brief sends setup command to generator and uploads generated mesh to GPU
 */
 void HillsFacade::setup()
 {
 	generator.setup();
+	generator.uploadMeshData();
 }
 
 /**
@@ -52,7 +51,8 @@ void HillsFacade::recreateTilesAndBufferData()
 	generator.updateMaxHeight();
 	generator.createTiles();
 	generator.createAuxiliaryMaps();
-	generator.fillBufferData();
+	generator.prepareMeshData();
+	generator.uploadMeshData();
 }
 
 /**
@@ -73,45 +73,70 @@ void HillsFacade::deserialize( std::ifstream & input )
 	generator.deserialize( input );
 }
 
+/**
+* @brief delegates binary serialization call to generator
+* @param writer world file writer
+*/
+void HillsFacade::serialize( WorldFileWriter & writer ) const
+{
+	generator.serialize( writer );
+}
+
+/**
+* @brief delegates binary section reading call to generator
+* @param section world file section to read data from
+* @param savedMap view of the saved map
+*/
+bool HillsFacade::read( WorldFileSection & section,
+						Heightfield2DView<const float> & savedMap ) const noexcept
+{
+	return generator.read( section, savedMap );
+}
+
+/**
+* @brief delegates binary deserialization call to generator
+* @param savedMap view of the saved map previously read from the world file
+*/
+void HillsFacade::deserialize( Heightfield2DView<const float> savedMap )
+{
+	generator.deserialize( savedMap );
+}
+
+/**
+* @brief selects levels of detail of the hills chunks for the current frame and culls chunks outside the frustum
+* @param viewPosition position of the camera
+* @param projectionScale number of pixels a unit long segment takes on the screen at a unit distance from the camera
+* @param pixelError maximum allowed error of the coarse levels projected to the screen (in pixels)
+* @param cullingFrustum frustum to test hills chunks against
+*/
+void HillsFacade::updateLevelsOfDetail( const glm::vec3 & viewPosition,
+										float projectionScale,
+										float pixelError,
+										const Frustum & cullingFrustum )
+{
+	generator.updateLevelsOfDetail( viewPosition, projectionScale, pixelError, cullingFrustum );
+}
+
 /**
 * @brief handles hill drawing routine: prepares shader and delegates a draw command to renderer
-* @param lightDir sunlight direction vector
-* @param lightSpaceMatrices array of 3 "projection * view" matrices from the Sun point of view
-* @param projectionView "projection * view" matrix
-* @param viewPosition position vector of the camera
-* @param viewAcceleration a pair of camera's acceleration values (on X and Y axis), used for frustum culling
-* @param viewFrustum view frustum of the camera
-* @param useFrustumCulling indicator of whether to use frustum culling when drawing
+* @param useFrustumCulling indicator of whether to draw only the chunks which passed frustum culling
 * @param useShadows indicator of whether shadows should be calculated
 * @param useDebugRender indicator of whether to draw additional details (mesh grid and normals), used for visual debug only
 * @todo remove debug render mode in the release version of the game
 */
-void HillsFacade::draw( const glm::vec3 & lightDir,
-						const std::array<glm::mat4, NUM_SHADOW_LAYERS> & lightSpaceMatrices,
-						const glm::mat4 & projectionView,
-						const glm::vec3 & viewPosition,
-						const glm::vec2 & viewAcceleration,
-						const Frustum & viewFrustum,
-						bool useFrustumCulling,
+void HillsFacade::draw( bool useFrustumCulling,
 						bool useShadows,
 						bool useDebugRender )
 {
-	shaders.update( lightDir,
-					lightSpaceMatrices,
-					projectionView,
-					viewPosition,
-					viewFrustum,
-					generator.maxHeight,
-					useFrustumCulling,
-					useShadows );
+	shaders.update( generator.maxHeight, useShadows );
 	shaders.debugRenderMode( false );
-	renderer.render( useFrustumCulling, viewAcceleration );
+	renderer.render( useFrustumCulling );
 
 	if( useDebugRender )
 	{
 		shaders.debugRenderMode( true );
 		renderer.debugRender( GL_TRIANGLES );
-		shaders.updateNormals( projectionView );
+		shaders.updateNormals();
 		renderer.debugRender( GL_POINTS );
 	}
 }
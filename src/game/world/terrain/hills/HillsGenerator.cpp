@@ -14,39 +14,40 @@
  * GNU General Public License for more details.
  * See <http://www.gnu.org/licenses/>
  *
- * Purpose: contains definitions for HillsGenerator class and HillVertex struct
+ * Purpose: contains definitions for HillsGenerator class
  * @version 0.1.0
  */
 
 #include "HillsGenerator"
-#include "HillsShader"
 #include "SettingsManager"
+#include "StencilEngine"
+#include "ThreadPool"
+#include "RandomStream"
+#include "Logger"
+#include "UploadManager"
 
 #include <chrono>
+#include <limits>
+#include <string>
 
 /**
-* @brief plain ctor, for culled buffer pipeline need only vao+vbo+transform feedback. Initializes randomizer seed.
-* @param shaders hills shader manager
+* @brief plain ctor
 * @param waterMap map of the water tiles
 */
-HillsGenerator::HillsGenerator( HillsShader & shaders, 
-								const map2D_f & waterMap )
+HillsGenerator::HillsGenerator( const map2D_f & waterMap )
 	: Generator()
-	, culledBuffers( VAO | VBO | TFBO )
-	, shaders( shaders )
 	, maxHeight( 1.0f )
 	, waterMap( waterMap )
-{
-	randomizer.seed( std::chrono::system_clock::now().time_since_epoch().count() );
-}
+{}
 
 /**
-* @brief prepares hills maps and buffer collections
+* @brief prepares hills maps, tiles and mesh data. Makes no OpenGL calls, mesh data is to be uploaded separately
 */
 void HillsGenerator::setup()
 {
 	//in case of recreation need to reinit maximum height value
 	maxHeight = 1.0f;
+	waterDistanceField.compute( waterMap.view() );
 	generateMap( SettingsManager::getInt( "HILLS_GENERATOR", "dense_cycles" ), HILL_DENSITY::HILLS_DENSE );
 	generateMap( SettingsManager::getInt( "HILLS_GENERATOR", "thin_cycles" ), HILL_DENSITY::HILLS_THIN );
 	smoothMapSinks();
@@ -61,7 +62,7 @@ void HillsGenerator::setup()
 	updateMaxHeight();
 	createTiles();
 	createAuxiliaryMaps();
-	fillBufferData();
+	prepareMeshData();
 }
 
 /**
@@ -101,30 +102,71 @@ void HillsGenerator::createTiles()
 }
 
 /**
-* @brief creates normal/tangent/bitangent maps used for normal mapping
+* @brief creates normal map used for shading, tangent frame is reconstructed from the normal in shaders
 */
 void HillsGenerator::createAuxiliaryMaps()
 {
 	createNormalMap( normalMap );
-	createTangentMap();
-	createBitangentMap();
 }
 
 /**
-* @brief for each tile creates set of vertices, buffers them to GPU. Prepares buffer collections layouts and bindings
+* @brief creates indexed grid mesh in the CPU side mesh data storage. Each map point that is a corner of any tile
+* is stored as exactly one vertex shared by up to 4 adjacent tiles, tiles reference their corners via the index buffer
 */
-void HillsGenerator::fillBufferData()
+void HillsGenerator::prepareMeshData()
 {
-	const size_t VERTEX_DATA_LENGTH = tiles.size() * UNIQUE_VERTICES_PER_TILE * HillVertex::NUMBER_OF_ELEMENTS;
-	const size_t INDICES_DATA_LENGTH = tiles.size() * VERTICES_PER_QUAD;
-	size_t indicesBufferIndex = 0;
-	std::unique_ptr<GLfloat[]> vertices( new GLfloat[VERTEX_DATA_LENGTH] );
-	std::unique_ptr<GLuint[]> indices( new GLuint[INDICES_DATA_LENGTH] );
+	constexpr GLuint NO_VERTEX = std::numeric_limits<GLuint>::max();
+	const size_t POINTS_PER_ROW = WORLD_WIDTH + 1;
+
+	//mark map points used by tiles
+	std::vector<GLuint> pointVertexIndices( POINTS_PER_ROW * ( WORLD_HEIGHT + 1 ), NO_VERTEX );
+	for( const TerrainTile & tile : tiles )
+	{
+		const size_t LOW_ROW_OFFSET = tile.mapY * POINTS_PER_ROW;
+		const size_t UPPER_ROW_OFFSET = LOW_ROW_OFFSET - POINTS_PER_ROW;
+		pointVertexIndices[LOW_ROW_OFFSET + tile.mapX - 1] = 0;
+		pointVertexIndices[LOW_ROW_OFFSET + tile.mapX] = 0;
+		pointVertexIndices[UPPER_ROW_OFFSET + tile.mapX] = 0;
+		pointVertexIndices[UPPER_ROW_OFFSET + tile.mapX - 1] = 0;
+	}
 
-	for( unsigned int tileIndex = 0; tileIndex < tiles.size(); tileIndex++ )
+	//number vertices in row-major order, thus neighbouring tiles reference nearby vertices
+	GLuint numVertices = 0;
+	for( GLuint & vertexIndex : pointVertexIndices )
+	{
+		if( vertexIndex != NO_VERTEX )
+		{
+			vertexIndex = numVertices++;
+		}
+	}
+
+	meshData.clear();
+	meshData.packedVertices.reserve( numVertices );
+	meshData.indices.resize( tiles.size() * VERTICES_PER_QUAD );
+	GLuint * indices = meshData.indices.data();
+
+	/*
+	 * hill texture covers HILL_TILING_PER_TEXTURE_QUAD^2 tiles and is sampled in repeat mode. Shaders derive texture coordinates
+	 * from the grid position relative to the world center, which gives the same texels as if it was relative to the map origin
+	 * only if the world center lies on the texture quad border
+	 */
+	static_assert( HALF_WORLD_WIDTH % HILL_TILING_PER_TEXTURE_QUAD == 0 && HALF_WORLD_HEIGHT % HILL_TILING_PER_TEXTURE_QUAD == 0,
+				   "world center must be aligned to the hill texture tiling" );
+	//vertices are appended in the same row-major order they have been numbered in
+	for( unsigned int y = 0; y <= WORLD_HEIGHT; y++ )
 	{
-		TerrainTile & tile = tiles[tileIndex];
+		for( unsigned int x = 0; x <= WORLD_WIDTH; x++ )
+		{
+			if( pointVertexIndices[y * POINTS_PER_ROW + x] != NO_VERTEX )
+			{
+				meshData.packedVertices.emplace_back( x, y, map[y][x] + HILLS_OFFSET_Y, normalMap[y][x] );
+			}
+		}
+	}
 
+	size_t indicesBufferIndex = 0;
+	for( const TerrainTile & tile : tiles )
+	{
 		//at some places of map we should set another order of vertices for better looking result
 		bool verticesAlternativeOrder = false;
 		if( tile.lowRight < tile.upperLeft || tile.upperLeft < tile.lowRight )
@@ -132,76 +174,47 @@ void HillsGenerator::fillBufferData()
 			verticesAlternativeOrder = true;
 		}
 
-		int x = tile.mapX; 
-		int y = tile.mapY;
-
-		//map hill texture to cover HILL_TILING_PER_TEXTURE_QUAD^2 tiles instead of one
-		float tilingSizeReciprocal = 1.0f / HILL_TILING_PER_TEXTURE_QUAD;
-		float texCoordXOffset = ( x % HILL_TILING_PER_TEXTURE_QUAD ) * tilingSizeReciprocal;
-		float texCoordYOffset = ( ( WORLD_HEIGHT - y ) % HILL_TILING_PER_TEXTURE_QUAD ) * tilingSizeReciprocal;
-
-		//create set of vertices according to a tile
-		HillVertex lowLeft( glm::vec3( x - 1, tile.lowLeft, y ),
-							glm::vec2( texCoordXOffset, texCoordYOffset ),
-							normalMap[y][x - 1],
-							tangentMap[y][x - 1],
-							bitangentMap[y][x - 1] );
-		HillVertex lowRight( glm::vec3( x, tile.lowRight, y ),
-							 glm::vec2( tilingSizeReciprocal + texCoordXOffset, texCoordYOffset ),
-							 normalMap[y][x],
-							 tangentMap[y][x],
-							 bitangentMap[y][x] );
-		HillVertex upRight( glm::vec3( x, tile.upperRight, y - 1 ),
-							glm::vec2( tilingSizeReciprocal + texCoordXOffset, tilingSizeReciprocal + texCoordYOffset ),
-							normalMap[y - 1][x],
-							tangentMap[y - 1][x],
-							bitangentMap[y - 1][x] );
-		HillVertex upLeft( glm::vec3( x - 1, tile.upperLeft, y - 1 ),
-						   glm::vec2( texCoordXOffset, tilingSizeReciprocal + texCoordYOffset ),
-						   normalMap[y - 1][x - 1],
-						   tangentMap[y - 1][x - 1],
-						   bitangentMap[y - 1][x - 1] );
-
-		//buffer vertices to local storage
-		int vertexBufferOffset = tileIndex * UNIQUE_VERTICES_PER_TILE * HillVertex::NUMBER_OF_ELEMENTS;
-		bufferVertex( vertices.get(), vertexBufferOffset + HillVertex::NUMBER_OF_ELEMENTS * 0, lowLeft );
-		bufferVertex( vertices.get(), vertexBufferOffset + HillVertex::NUMBER_OF_ELEMENTS * 1, lowRight );
-		bufferVertex( vertices.get(), vertexBufferOffset + HillVertex::NUMBER_OF_ELEMENTS * 2, upRight );
-		bufferVertex( vertices.get(), vertexBufferOffset + HillVertex::NUMBER_OF_ELEMENTS * 3, upLeft );
-
-		//buffer indices to local storage
-		GLuint indicesBufferBaseVertex = tileIndex * UNIQUE_VERTICES_PER_TILE;
-		indices[indicesBufferIndex++] = indicesBufferBaseVertex + ( verticesAlternativeOrder ? 3 : 0 );
-		indices[indicesBufferIndex++] = indicesBufferBaseVertex + ( verticesAlternativeOrder ? 0 : 1 );
-		indices[indicesBufferIndex++] = indicesBufferBaseVertex + ( verticesAlternativeOrder ? 1 : 2 );
-		indices[indicesBufferIndex++] = indicesBufferBaseVertex + ( verticesAlternativeOrder ? 1 : 2 );
-		indices[indicesBufferIndex++] = indicesBufferBaseVertex + ( verticesAlternativeOrder ? 2 : 3 );
-		indices[indicesBufferIndex++] = indicesBufferBaseVertex + ( verticesAlternativeOrder ? 3 : 0 );
+		const size_t LOW_ROW_OFFSET = tile.mapY * POINTS_PER_ROW;
+		const size_t UPPER_ROW_OFFSET = LOW_ROW_OFFSET - POINTS_PER_ROW;
+		const GLuint LOW_LEFT = pointVertexIndices[LOW_ROW_OFFSET + tile.mapX - 1];
+		const GLuint LOW_RIGHT = pointVertexIndices[LOW_ROW_OFFSET + tile.mapX];
+		const GLuint UPPER_RIGHT = pointVertexIndices[UPPER_ROW_OFFSET + tile.mapX];
+		const GLuint UPPER_LEFT = pointVertexIndices[UPPER_ROW_OFFSET + tile.mapX - 1];
+
+		//the alternative order splits the tile along another diagonal
+		indices[indicesBufferIndex++] = verticesAlternativeOrder ? UPPER_LEFT : LOW_LEFT;
+		indices[indicesBufferIndex++] = verticesAlternativeOrder ? LOW_LEFT : LOW_RIGHT;
+		indices[indicesBufferIndex++] = verticesAlternativeOrder ? LOW_RIGHT : UPPER_RIGHT;
+		indices[indicesBufferIndex++] = verticesAlternativeOrder ? LOW_RIGHT : UPPER_RIGHT;
+		indices[indicesBufferIndex++] = verticesAlternativeOrder ? UPPER_RIGHT : UPPER_LEFT;
+		indices[indicesBufferIndex++] = verticesAlternativeOrder ? UPPER_LEFT : LOW_LEFT;
 	}
-	//buffer vertices and indices from local storage to GPU
-	basicGLBuffers.bind( VAO | VBO | EBO );
-	glBufferData( GL_ARRAY_BUFFER, sizeof( GLfloat ) * VERTEX_DATA_LENGTH, vertices.get(), GL_STATIC_DRAW );
-	glBufferData( GL_ELEMENT_ARRAY_BUFFER, sizeof( GLuint ) * INDICES_DATA_LENGTH, indices.get(), GL_STATIC_DRAW );
-	setupVBOAttributes();
+	levelsOfDetail.build( tiles, meshData, 0.0f );
+}
 
-	//prepare buffer collection used for frustum culling
-	if( culledBuffers.get( VAO ) != 0 )
-	{
-		culledBuffers.deleteBuffers();
-		culledBuffers.create( VAO | VBO | TFBO );
-	}
-	culledBuffers.bind( VAO | VBO | TFBO );
-	/*
-	 * after transform feedback we have 1.5 times more data to buffer in GL_ARRAY_BUFFER
-	 * (6 indices of 4 vertices transforms into 6 vertices, 2 of them have the same attributes)
-	 * because of duplication of vertices that have same attributes but different indices
-	 */
-	const GLsizeiptr CULLED_DATA_SIZE_BYTES = (GLsizeiptr)( (float)VERTEX_DATA_LENGTH * 1.5f ) * sizeof( GLfloat );
-	glNamedBufferStorage( culledBuffers.get( VBO ), CULLED_DATA_SIZE_BYTES, 0, GL_NONE );
-	setupVBOAttributes();
-	shaders.setupCulling();
-	glTransformFeedbackBufferBase( culledBuffers.get( TFBO ), 0, culledBuffers.get( VBO ) );
+/**
+* @brief buffers previously prepared mesh data to GPU and releases it. Prepares buffer collection layout and bindings,
+* indirect buffer is filled each frame with draw commands of the selected levels of detail
+*/
+void HillsGenerator::uploadMeshData()
+{
+	const auto UPLOAD_START_TIME = std::chrono::steady_clock::now();
+	const size_t VERTEX_DATA_BYTES = sizeof( PackedTerrainVertex ) * meshData.packedVertices.size();
+	const size_t INDEX_DATA_BYTES = sizeof( GLuint ) * meshData.indices.size();
+	createBuffersOnFirstUse( basicGLBuffers, VAO | VBO | EBO | DIBO );
+	basicGLBuffers.bind( VAO | VBO | EBO );
+	UploadManager & uploadManager = UploadManager::getInstance();
+	uploadManager.uploadBufferData( basicGLBuffers.get( VBO ), VERTEX_DATA_BYTES, meshData.packedVertices.data(), GL_STATIC_DRAW );
+	uploadManager.uploadBufferData( basicGLBuffers.get( EBO ), INDEX_DATA_BYTES, meshData.indices.data(), GL_STATIC_DRAW );
+	PackedTerrainVertex::setupAttributes();
 	BufferCollection::bindZero( VAO | VBO | EBO );
+	meshData.clear();
+
+	const auto UPLOAD_DURATION = std::chrono::duration<float, std::milli>( std::chrono::steady_clock::now() - UPLOAD_START_TIME );
+	Logger::log( "hills mesh uploaded in % ms: % KB of vertices, % KB of indices\n",
+				 std::to_string( UPLOAD_DURATION.count() ).c_str(),
+				 std::to_string( VERTEX_DATA_BYTES / 1024 ).c_str(),
+				 std::to_string( INDEX_DATA_BYTES / 1024 ).c_str() );
 }
 
 /**
@@ -213,41 +226,50 @@ void HillsGenerator::generateMap( int cycles,
 								  float density )
 {
 	generateKernel( cycles, density );
-	fattenKernel( cycles );
+	fattenKernel( cycles, density );
 }
 
 /**
 * @brief generates kernel points of the hills which are to be fattened later
 * @param cycles number of times hills fattening would take place, used to limit kernel generation nearby water
 * @param density empiric value defining randomizer's "hit-ratio" during generating process
+* @note each tile has its own random stream, thus rows are processed in parallel
 */
 void HillsGenerator::generateKernel( int cycles, 
 									 float density )
 {
-	for( int y = 1; y < WORLD_HEIGHT - 1; y++ )
+	const uint32_t DENSITY_PASS = (uint32_t)density;
+	ThreadPool::getInstance().parallelFor( 1, WORLD_HEIGHT - 1, [&]( size_t bandBegin, size_t bandEnd )
 	{
-		for( int x = 1; x < WORLD_WIDTH - 1; x++ )
+		for( int y = (int)bandBegin; y < (int)bandEnd; y++ )
 		{
-			if( rand() % (int)density == 0 && !hasWaterNearby( x, y, cycles + 3 ) )
+			for( int x = 1; x < WORLD_WIDTH - 1; x++ )
 			{
-				map[y][x] += 1.0f;
+				RandomStream random( RANDOM_STREAM_HILLS_KERNEL, x, y, DENSITY_PASS );
+				if( random.nextUint( DENSITY_PASS ) == 0 && !hasWaterNearby( x, y, cycles + 3 ) )
+				{
+					map[y][x] += 1.0f;
+				}
 			}
 		}
-	}
+	} );
 }
 
 /**
 * @brief builds up hills for a given number of cycles around previously generated kernel points
 * @param cycles number of times hills fattening would take place
+* @param density density of the kernel, used to distinguish random streams of different generation passes
 */
-void HillsGenerator::fattenKernel( int cycles )
+void HillsGenerator::fattenKernel( int cycles, 
+								   float density )
 {
 	const float CYCLE_FATTENING_DAMPING_FACTOR = 0.05f;
 	const float MIN_FATTENING_HEIGHT = 0.3f;
 	const float MAX_FATTENING_HEIGHT = 0.8f;
 	const int SHORE_SMOOTH_CYCLES = SettingsManager::getInt( "SCENE", "shore_smooth_cycles" );
+	const uint32_t MAX_CYCLES_PER_PASS = 256;
+	const uint32_t DENSITY_PASS = (uint32_t)density * MAX_CYCLES_PER_PASS;
 
-	std::uniform_real_distribution<float> heightDistribution( MIN_FATTENING_HEIGHT, MAX_FATTENING_HEIGHT );
 	for( int cycle = 1; cycle <= cycles; cycle++ )
 	{
 		for( int startY = cycle; startY < WORLD_HEIGHT - cycle; startY++ )
@@ -258,7 +280,12 @@ void HillsGenerator::fattenKernel( int cycles )
 				{
 					break;
 				}
-				if( map[startY][startX] != 0 && ( rand() % ( cycle + 1 ) == cycle ) )
+				if( map[startY][startX] == 0 )
+				{
+					continue;
+				}
+				RandomStream random( RANDOM_STREAM_HILLS_FATTENING, startX, startY, DENSITY_PASS + cycle );
+				if( random.nextUint( cycle + 1 ) == (uint32_t)cycle )
 				{
 					int left = ( startX - cycle <= cycle ? cycle : startX - cycle );
 					int right = ( startX + cycle >= WORLD_WIDTH - cycle - 1 ? WORLD_WIDTH - cycle - 1 : startX + cycle );
@@ -268,7 +295,7 @@ void HillsGenerator::fattenKernel( int cycles )
 					{
 						for( int x = left; x <= right; x++ )
 						{
-							if( rand() % ( cycle + 2 ) > 1 )
+							if( random.nextUint( cycle + 2 ) > 1 )
 							{
 								//shortening the fattening borders to prevent hills generating over the shore and water
 								if( hasWaterNearby( x, y, 4 + SHORE_SMOOTH_CYCLES ) )
@@ -277,7 +304,7 @@ void HillsGenerator::fattenKernel( int cycles )
 									--right;
 									continue;
 								}
-								map[y][x] += 1.0f - CYCLE_FATTENING_DAMPING_FACTOR * cycle + ( heightDistribution( randomizer ) );
+								map[y][x] += 1.0f - CYCLE_FATTENING_DAMPING_FACTOR * cycle + random.nextFloat( MIN_FATTENING_HEIGHT, MAX_FATTENING_HEIGHT );
 								if( map[y][x] > maxHeight )
 								{
 									maxHeight = map[y][x];
@@ -296,74 +323,17 @@ void HillsGenerator::fattenKernel( int cycles )
 }
 
 /**
-* @brief fills given buffer with vertex data
-* @param buffer buffer to be filled
-* @param offset index offset to the buffer
-* @param vertex vertex to be buffered
-*/
-void HillsGenerator::bufferVertex( GLfloat * buffer, 
-								   int offset, 
-								   HillVertex vertex ) noexcept
-{
-	buffer[offset] = vertex.position.x;
-	buffer[offset + 1] = vertex.position.y;
-	buffer[offset + 2] = vertex.position.z;
-	buffer[offset + 3] = vertex.texCoords.x;
-	buffer[offset + 4] = vertex.texCoords.y;
-	buffer[offset + 5] = vertex.normal.x;
-	buffer[offset + 6] = vertex.normal.y;
-	buffer[offset + 7] = vertex.normal.z;
-	buffer[offset + 8] = vertex.tangent.x;
-	buffer[offset + 9] = vertex.tangent.y;
-	buffer[offset + 10] = vertex.tangent.z;
-	buffer[offset + 11] = vertex.bitangent.x;
-	buffer[offset + 12] = vertex.bitangent.y;
-	buffer[offset + 13] = vertex.bitangent.z;
-}
-
-/**
-* @brief setup vertex buffer object attributes and pointers
-*/
-void HillsGenerator::setupVBOAttributes() noexcept
-{
-	const size_t SIZE_OF_HILL_VERTEX = HillVertex::NUMBER_OF_ELEMENTS * sizeof( GLfloat );
-	glEnableVertexAttribArray( 0 );
-	glVertexAttribPointer( 0, 3, GL_FLOAT, GL_FALSE, SIZE_OF_HILL_VERTEX, 0 );
-	glEnableVertexAttribArray( 1 );
-	glVertexAttribPointer( 1, 2, GL_FLOAT, GL_FALSE, SIZE_OF_HILL_VERTEX, (void*)( 3 * sizeof( GLfloat ) ) );
-	glEnableVertexAttribArray( 2 );
-	glVertexAttribPointer( 2, 3, GL_FLOAT, GL_FALSE, SIZE_OF_HILL_VERTEX, (void*)( 5 * sizeof( GLfloat ) ) );
-	glEnableVertexAttribArray( 3 );
-	glVertexAttribPointer( 3, 3, GL_FLOAT, GL_FALSE, SIZE_OF_HILL_VERTEX, (void*)( 8 * sizeof( GLfloat ) ) );
-	glEnableVertexAttribArray( 4 );
-	glVertexAttribPointer( 4, 3, GL_FLOAT, GL_FALSE, SIZE_OF_HILL_VERTEX, (void*)( 11 * sizeof( GLfloat ) ) );
-}
-
-/**
-* @brief checks for any water tiles nearby given coordinates at given radius
+* @brief checks for any water tiles nearby given coordinates at given radius (in a square window around the point).
+* Uses precalculated water distance field, thus takes constant time regardless of the radius
 * @param centerX X coordinate of the point around which test would run
 * @param centerY Y coordinate of the point around which test would run
 * @param radius defines how far from the source coordinate test would run
 */
 bool HillsGenerator::hasWaterNearby( int centerX, 
 									 int centerY, 
-									 int radius )
+									 int radius ) const noexcept
 {
-	int xLeft = ( centerX - radius <= 0 ? 0 : centerX - radius );
-	int xRight = ( centerX + radius >= WORLD_WIDTH ? WORLD_WIDTH : centerX + radius );
-	int yTop = ( centerY - radius <= 0 ? 0 : centerY - radius );
-	int yBottom = ( centerY + radius >= WORLD_HEIGHT ? WORLD_HEIGHT : centerY + radius );
-	for( int x = xLeft; x <= xRight; x++ )
-	{
-		for( int y = yTop; y <= yBottom; y++ )
-		{
-			if( waterMap[y][x] != 0 )
-			{
-				return true;
-			}
-		}
-	}
-	return false;
+	return waterDistanceField.hasFeatureWithin( centerX, centerY, radius );
 }
 
 /**
@@ -374,7 +344,7 @@ bool HillsGenerator::hasWaterNearby( int centerX,
 void HillsGenerator::compressMap( float thresholdAbsValue, 
 								  float ratio )
 {
-	for( auto & row : map )
+	for( auto row : map )
 	{
 		for( auto & height : row )
 		{
@@ -415,42 +385,9 @@ void HillsGenerator::updateMaxHeight()
 */
 void HillsGenerator::removePlateaus( float plateauHeight )
 {
-	unsigned int yTop, yBottom, xLeft, xRight;
-	for( unsigned int y = 1; y < WORLD_HEIGHT - 1; y++ )
-	{
-		for( unsigned int x = 1; x < WORLD_WIDTH - 1; x++ )
-		{
-			if( map[y][x] == 0 )
-			{
-				continue;
-			}
-			unsigned int plateauHeightNeighbourPoints = 0;
-			//define maximum acceptable number of nearby low-level coordinates to keep in map
-			const unsigned int NEIGHBOURS_LIMIT = 6;
-			yTop = y - 1;
-			yBottom = y + 1;
-			xLeft = x - 1;
-			xRight = x + 1;
-			for( auto nY = yTop; nY <= yBottom; nY++ )
-			{
-				for( auto nX = xLeft; nX <= xRight; nX++ )
-				{
-					if( nY == y && nX == x ) //don't need to check itself
-					{
-						continue;
-					}
-					if( map[nY][nX] <= plateauHeight )
-					{
-						++plateauHeightNeighbourPoints;
-					}
-				}
-			}
-			if( plateauHeightNeighbourPoints >= NEIGHBOURS_LIMIT )
-			{
-				map[y][x] = 0;
-			}
-		}
-	}
+	//define maximum acceptable number of nearby low-level coordinates to keep in map
+	const unsigned int NEIGHBOURS_LIMIT = 6;
+	StencilEngine::removePlateaus( map.slice( 1, 1, WORLD_WIDTH - 2, WORLD_HEIGHT - 2 ), plateauHeight, NEIGHBOURS_LIMIT );
 }
 
 /**
@@ -460,22 +397,7 @@ void HillsGenerator::removePlateaus( float plateauHeight )
 */
 void HillsGenerator::removeOrphanHills()
 {
-	for( int y = 1; y < WORLD_HEIGHT; y++ )
-	{
-		for( int x = 1; x < WORLD_WIDTH; x++ )
-		{
-			if( map[y][x] != 0.0f &&
-				map[y - 1][x - 1] == 0 &&
-				map[y - 1][x] == 0 &&
-				map[y - 1][x + 1] == 0 &&
-				map[y][x - 1] == 0 &&
-				map[y][x + 1] == 0 &&
-				map[y + 1][x - 1] == 0 &&
-				map[y + 1][x] == 0 &&
-				map[y + 1][x + 1] == 0 )
-				map[y][x] = 0.0f;
-		}
-	}
+	StencilEngine::removeIsolatedPoints( map.slice( 1, 1, WORLD_WIDTH - 1, WORLD_HEIGHT - 1 ) );
 }
 
 /**
@@ -483,42 +405,9 @@ void HillsGenerator::removeOrphanHills()
 */
 void HillsGenerator::smoothMapSinks()
 {
-	for( unsigned int y = 1; y < WORLD_HEIGHT; y++ )
-	{
-		for( unsigned int x = 1; x < WORLD_WIDTH; x++ )
-		{
-			unsigned int higherNeighbours = 0;
-			const unsigned int NEIGHBOURS_LIMIT = 6;
-
-			//find how many neighbour points are higher...
-			for( int yOffset = -1; yOffset <= 1; yOffset++ )
-			{
-				for( int xOffset = -1; xOffset <= 1; xOffset++ )
-				{
-					if( yOffset == 0 && xOffset == 0 ) //don't need to check itself
-					{
-						continue;
-					}
-					higherNeighbours += ( map[y][x] < map[y + yOffset][x + xOffset] ? 1 : 0 );
-				}
-			}
-			//...if there are too much, level this point's height as average of its neighbours
-			if( higherNeighbours >= NEIGHBOURS_LIMIT )
-			{
-				float avgHeight = map[y - 1][x - 1]
-					+ map[y - 1][x]
-					+ map[y - 1][x + 1]
-					+ map[y][x - 1]
-					+ map[y][x]
-					+ map[y][x + 1]
-					+ map[y + 1][x - 1]
-					+ map[y + 1][x]
-					+ map[y + 1][x + 1];
-				avgHeight /= 9;
-				map[y][x] = avgHeight;
-			}
-		}
-	}
+	//if there are too much higher neighbour points, level point's height as average of its neighbours
+	const unsigned int NEIGHBOURS_LIMIT = 6;
+	StencilEngine::smoothSinks( map.slice( 1, 1, WORLD_WIDTH - 1, WORLD_HEIGHT - 1 ), NEIGHBOURS_LIMIT );
 }
 
 /**
@@ -527,7 +416,9 @@ void HillsGenerator::smoothMapSinks()
 */
 void HillsGenerator::smoothLandTransitionEdges()
 {
-	map2D_f postProcessMap = map;
+	//reuse back buffer storage instead of allocating new map on each call
+	mapBackBuffer = map;
+	map2D_f & postProcessMap = mapBackBuffer;
 	for( unsigned int y = 1; y < WORLD_HEIGHT; y++ )
 	{
 		for( unsigned int x = 1; x < WORLD_WIDTH; x++ )
@@ -553,71 +444,5 @@ void HillsGenerator::smoothLandTransitionEdges()
 			}
 		}
 	}
-	map = postProcessMap;
-}
-
-/**
-* @brief create map of the tangent vectors for each coordinate according to existing normal map
-*/
-void HillsGenerator::createTangentMap()
-{
-	using glm::vec3;
-	//reinitialize in case of recreation
-	tangentMap.clear();
-	tangentMap.reserve( WORLD_HEIGHT + 1 );
-	for( size_t row = 0; row < WORLD_HEIGHT + 1; row++ )
-	{
-		vec3 defaultTangent( 1.0f, 0.0f, 0.0f );
-		std::vector<vec3> emptyVec( WORLD_WIDTH + 1, defaultTangent );
-		tangentMap.emplace_back( emptyVec );
-	}
-
-	for( unsigned int y = 1; y < map.size() - 1; y++ )
-	{
-		for( unsigned int x = 1; x < map[0].size() - 1; x++ )
-		{
-			tangentMap[y][x] = glm::normalize( glm::cross( normalMap[y][x], vec3( 0.0f, 1.0f, 0.0f ) ) );
-		}
-	}
+	map.swap( postProcessMap );
 }
-
-/**
-* @brief create map of the bitangent vectors for each coordinate according to existing normal and tangent maps
-*/
-void HillsGenerator::createBitangentMap()
-{
-	using glm::vec3;
-	//reinitialize in case of recreation
-	bitangentMap.clear();
-	bitangentMap.reserve( WORLD_HEIGHT + 1 );
-	for( size_t row = 0; row < WORLD_HEIGHT + 1; row++ )
-	{
-		vec3 defaultBitangent( 0.0f, 0.0f, 1.0f );
-		std::vector<vec3> emptyVec( WORLD_WIDTH + 1, defaultBitangent );
-		bitangentMap.emplace_back( emptyVec );
-	}
-
-	for( unsigned int y = 1; y < map.size() - 1; y++ )
-	{
-		for( unsigned int x = 1; x < map[0].size() - 1; x++ )
-		{
-			bitangentMap[y][x] = glm::normalize( glm::cross( normalMap[y][x], tangentMap[y][x] ) );
-		}
-	}
-}
-
-/**
-* @brief plain ctor
-* @note positioning is offset on both X and Y axis by the half of the world dimension
-*/
-HillsGenerator::HillVertex::HillVertex( glm::vec3 pos, 
-										glm::vec2 texCoords, 
-										glm::vec3 normal, 
-										glm::vec3 tangent, 
-										glm::vec3 bitangent ) noexcept
-	: position{ pos.x - HALF_WORLD_WIDTH, pos.y, pos.z - HALF_WORLD_HEIGHT }
-	, texCoords{ texCoords.x, texCoords.y }
-	, normal{ normal.x, normal.y, normal.z }
-	, tangent{ tangent.x, tangent.y, tangent.z }
-	, bitangent{ bitangent.x, bitangent.y, bitangent.z }
-{}
@@ -14,17 +14,14 @@
  * GNU General Public License for more details.
  * See <http://www.gnu.org/licenses/>
  *
- * Purpose: contains declaration for HillsGenerator class and HillVertex struct
+ * Purpose: contains declaration for HillsGenerator class
  * @version 0.1.0
  */
 
 #pragma once
 
 #include "Generator"
-
-#include <random>
-
-class HillsShader;
+#include "DistanceField"
 
 namespace HILL_DENSITY
 {
@@ -35,68 +32,31 @@ namespace HILL_DENSITY
 
 /**
 * @brief generator for hill tiles on the world map. Responsible for creating and distributing hills on the world map,
-* making normal/tangent/bitangent auxiliary maps (used for normal mapping), allocating necessary data to OpenGL.
-* In addition, this generator has its own buffer collection holding data after frustum culling
+* making normal auxiliary map (used for shading), preparing packed mesh data with levels of detail and allocating it to OpenGL
 */
 class HillsGenerator : public Generator
 {
 public:
-	HillsGenerator( HillsShader & shaders, 
-					const map2D_f & waterMap );
+	explicit HillsGenerator( const map2D_f & waterMap );
 	void setup();
 	void createTiles();
 	void createAuxiliaryMaps();
+	void prepareMeshData();
+	void uploadMeshData();
 
 private:
 	friend class HillsRenderer;
 	friend class HillsFacade;
 
-	/**
-	* @brief representation of the hill vertex as it is on the OpenGL side
-	*/
-	struct HillVertex
-	{
-		constexpr static unsigned int NUMBER_OF_ELEMENTS = 14;
-		HillVertex( glm::vec3 pos,
-					glm::vec2 texCoords,
-					glm::vec3 normal,
-					glm::vec3 tangent,
-					glm::vec3 bitangent ) noexcept;
-		struct
-		{
-			float x, y, z;
-		} position;
-		struct
-		{
-			float x, y;
-		} texCoords;
-		struct
-		{
-			float x, y, z;
-		} normal;
-		struct
-		{
-			float x, y, z;;
-		} tangent;
-		struct
-		{
-			float x, y, z;
-		} bitangent;
-	};
-
 	void generateMap( int cycles, 
 					  float density );
 	void generateKernel( int cycles, 
 						 float density );
-	void fattenKernel( int cycles );
-	void bufferVertex( GLfloat * vertices, 
-					   int offset, 
-					   HillVertex vertex ) noexcept;
-	void fillBufferData();
-	void setupVBOAttributes() noexcept;
+	void fattenKernel( int cycles, 
+					   float density );
 	bool hasWaterNearby( int centerX, 
 						 int centerY, 
-						 int radius );
+						 int radius ) const noexcept;
 	void compressMap( float thresholdAbsValue, 
 					  float ratio );
 	void updateMaxHeight();
@@ -104,15 +64,10 @@ private:
 	void removeOrphanHills();
 	void smoothMapSinks();
 	void smoothLandTransitionEdges();
-	void createTangentMap();
-	void createBitangentMap();
 
-	BufferCollection culledBuffers;
-	HillsShader & shaders;
 	float maxHeight;
 	const map2D_f & waterMap;
+	/** @note calculated once per generation, water map does not change while hills are generated */
+	DistanceField waterDistanceField;
 	map2D_vec3 normalMap;
-	map2D_vec3 tangentMap;
-	map2D_vec3 bitangentMap;
-	std::default_random_engine randomizer;
 };
@@ -36,68 +36,14 @@ HillsRenderer::HillsRenderer( HillsShader & shaders,
 {}
 
 /**
-* @brief manages draw calls to OpenGL and optionally switches to custom frustum culling mode rendering
-* @param useFrustumCulling indicator of frustum culling mode
-* @param viewAcceleration a pair of camera's acceleration values (on X and Y axis), used for frustum culling
+* @brief manages draw calls to OpenGL, chunks are culled on the CPU side while selecting levels of detail
+* @param useFrustumCulling indicator of whether to draw only the chunks which passed frustum culling
 */
-void HillsRenderer::render( bool useFrustumCulling, 
-							const glm::vec2 & viewAcceleration )
+void HillsRenderer::render( bool useFrustumCulling )
 {
-	if( useFrustumCulling )
-	{
-	    /*
-	    * by default transform feedback rendering takes place every FEEDBACK_UPDATE_FRAMERATE frames,
-	    * but the more acceleration values of the camera are, the more frequent feedback rendering should occur.
-	    * Thus, adjust framerate of feedback rendering depend on camera's current acceleration (max X or Y)
-	    */
-		const unsigned int FEEDBACK_UPDATE_FRAMERATE = 12;
-		float accelerationAbs = glm::max( glm::abs( viewAcceleration.x ), glm::abs( viewAcceleration.y ) );
-		int updateIncrement = 1;
-		if( accelerationAbs > 0.5f && accelerationAbs <= 5.0f )
-		{
-			updateIncrement = 4;
-		}
-		else if( accelerationAbs > 5.0f && accelerationAbs <= 10.0f )
-		{
-			updateIncrement = 5;
-		}
-		else if( accelerationAbs > 10.0f )
-		{
-			updateIncrement = 6;
-		}
-
-		//made static in order to keep this counter value from call to call
-		static unsigned int updateTransformFeedbackCounter = 0;
-		GLuint transformFeedback = generator.culledBuffers.get( TFBO );
-		if( updateTransformFeedbackCounter == 0 )
-		{
-			//render hills offscreen with transform feedback
-			shaders.cullingShader.use();
-			generator.basicGLBuffers.bind( VAO );
-			RendererState::enableState( GL_RASTERIZER_DISCARD );
-			glBindTransformFeedback( GL_TRANSFORM_FEEDBACK, transformFeedback );
-			glBeginTransformFeedback( GL_TRIANGLES );
-			glDrawElements( GL_TRIANGLES, generator.tiles.size() * VERTICES_PER_QUAD, GL_UNSIGNED_INT, 0 );
-			glEndTransformFeedback();
-			RendererState::disableState( GL_RASTERIZER_DISCARD );
-		}
-		updateTransformFeedbackCounter += updateIncrement;
-		if( updateTransformFeedbackCounter >= FEEDBACK_UPDATE_FRAMERATE )
-		{
-			updateTransformFeedbackCounter = 0;
-		}
-		//render feedback onscreen
-		shaders.renderShader.use();
-		generator.culledBuffers.bind( VAO );
-		glDrawTransformFeedback( GL_TRIANGLES, transformFeedback );
-	}
-	else
-	{
-		//plain onscreen rendering
-		shaders.renderShader.use();
-		generator.basicGLBuffers.bind( VAO );
-		glDrawElements( GL_TRIANGLES, generator.tiles.size() * VERTICES_PER_QUAD, GL_UNSIGNED_INT, 0 );
-	}
+	shaders.renderShader.use();
+	generator.basicGLBuffers.bind( VAO | DIBO );
+	generator.levelsOfDetail.draw( GL_TRIANGLES, useFrustumCulling );
 }
 
 /**
@@ -105,8 +51,8 @@ void HillsRenderer::render( bool useFrustumCulling,
 */
 void HillsRenderer::renderDepthmap()
 {
-	generator.basicGLBuffers.bind( VAO );
-	glDrawElements( GL_TRIANGLES, generator.tiles.size() * VERTICES_PER_QUAD, GL_UNSIGNED_INT, 0 );
+	generator.basicGLBuffers.bind( VAO | DIBO );
+	generator.levelsOfDetail.draw( GL_TRIANGLES, false );
 }
 
 /**
@@ -116,12 +62,12 @@ void HillsRenderer::renderDepthmap()
 */
 void HillsRenderer::debugRender( GLenum primitiveType )
 {
-	generator.basicGLBuffers.bind( VAO );
+	generator.basicGLBuffers.bind( VAO | DIBO );
 	glLineWidth( 2.0f );
 	RendererState::disableState( GL_CULL_FACE );
-	glPolygonMode( GL_FRONT_AND_BACK, GL_LINE );
-	glDrawElements( primitiveType, generator.tiles.size() * VERTICES_PER_QUAD, GL_UNSIGNED_INT, 0 );
-	glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
+	RendererState::setPolygonMode( GL_LINE );
+	generator.levelsOfDetail.draw( primitiveType, false );
+	RendererState::setPolygonMode( GL_FILL );
 	RendererState::enableState( GL_CULL_FACE );
 	glLineWidth( 1.0f );
 }
@@ -21,21 +21,19 @@
 #pragma once
 
 #include <GL/glew.h>
-#include <glm/vec2.hpp>
 
 class HillsGenerator;
 class HillsShader;
 
 /**
-* @brief Renderer for hills. Responsible both for onscreen and offscreen (for frustum culling) rendering
+* @brief Renderer for hills. Draws selected levels of detail of either all or only visible chunks with a single indirect call
 */
 class HillsRenderer
 {
 public:
 	HillsRenderer( HillsShader & shaders, 
 				   HillsGenerator & generator ) noexcept;
-	void render( bool useFrustumCulling, 
-				 const glm::vec2 & viewAcceleration );
+	void render( bool useFrustumCulling );
 	void renderDepthmap();
 	void debugRender( GLenum primitiveType );
 
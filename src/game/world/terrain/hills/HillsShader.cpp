@@ -20,84 +20,40 @@
 
 #include "HillsShader"
 #include "Shader"
-#include "Frustum"
 
 /**
 * @brief plain ctor. Binds compiled hills related shader program to local references
 * @param renderShader shader program for onscreen rendering
-* @param cullingShader shader program for offscreen rendering with frustum culling
 * @param normalsShader shader program for additional visual debugging purposes
 * @todo delete normal shader in release version of the game
 */
 HillsShader::HillsShader( Shader & renderShader, 
-						  Shader & cullingShader, 
 						  Shader & normalsShader ) noexcept
 	: renderShader( renderShader )
-	, cullingShader( cullingShader )
 	, normalsShader( normalsShader )
 {}
 
 /**
-* @brief update frustum culling shader program according to transform feedback usage
-* @note it is programmer's responsibility to keep client data matched with shader program itself
-*/
-void HillsShader::setupCulling()
-{
-	const unsigned int TRANSFORM_FEEDBACK_OUTPUT_ATTRIBUTES_COUNT = 5;
-	const GLchar * varyings[TRANSFORM_FEEDBACK_OUTPUT_ATTRIBUTES_COUNT] = { "o_pos", "o_texCoords", "o_normal", "o_tangent", "o_bitangent" };
-	glTransformFeedbackVaryings( cullingShader.getID(), TRANSFORM_FEEDBACK_OUTPUT_ATTRIBUTES_COUNT, varyings, GL_INTERLEAVED_ATTRIBS );
-	cullingShader.link();
-}
-
-/**
-* @brief updates shader programs variables before they are ready to use
-* @param lightDir sunlight direction vector
-* @param lightSpaceMatrices array of 3 "projection * view" matrices from the Sun point of view
-* @param projectionView "projection * view" matrix
-* @param viewPosition position vector of the camera
-* @param viewFrustum view frustum of the camera
+* @brief updates shader programs variables before they are ready to use.
+* Camera, lighting and shadow data come from the frame uniform blocks
 * @param maxHillHeight current maximum height of the hills
-* @param useFrustumCulling indicator of whether to use frustum culling when drawing
 * @param useShadows indicator of whether shadows should be calculated
 */
-void HillsShader::update( const glm::vec3 & lightDir,
-						  const std::array<glm::mat4, NUM_SHADOW_LAYERS> & lightSpaceMatrices,
-						  const glm::mat4 & projectionView,
-						  const glm::vec3 & viewPosition,
-						  const Frustum & viewFrustum,
-						  float maxHillHeight,
-						  bool useFrustumCulling,
+void HillsShader::update( float maxHillHeight,
 						  bool useShadows )
 {
-	if( useFrustumCulling )
-	{
-		cullingShader.use();
-		cullingShader.setVec4( "u_frustumPlanes[0]", viewFrustum.getPlane( FRUSTUM_LEFT ) );
-		cullingShader.setVec4( "u_frustumPlanes[1]", viewFrustum.getPlane( FRUSTUM_RIGHT ) );
-		cullingShader.setVec4( "u_frustumPlanes[2]", viewFrustum.getPlane( FRUSTUM_BOTTOM ) );
-		cullingShader.setVec4( "u_frustumPlanes[3]", viewFrustum.getPlane( FRUSTUM_TOP ) );
-		cullingShader.setVec4( "u_frustumPlanes[4]", viewFrustum.getPlane( FRUSTUM_BACK ) );
-	}
 	renderShader.use();
-	renderShader.setMat4( "u_projectionView", projectionView );
-	renderShader.setVec3( "u_viewPosition", viewPosition );
 	renderShader.setBool( "u_shadowEnable", useShadows );
 	renderShader.setFloat( "u_maxHillHeight", maxHillHeight );
-	renderShader.setVec3( "u_lightDir", -lightDir );
-	renderShader.setMat4( "u_lightSpaceMatrix[0]", lightSpaceMatrices[0] );
-	renderShader.setMat4( "u_lightSpaceMatrix[1]", lightSpaceMatrices[1] );
-	renderShader.setMat4( "u_lightSpaceMatrix[2]", lightSpaceMatrices[2] );
 }
 
 /**
-* @brief updates projectionView matrix for normals shader program
-* @param projectionView "projection * view" matrix
+* @brief prepares normals shader program, its only uniform (projectionView) comes from the camera block
 * @todo remove this function after removing normals shader program
 */
-void HillsShader::updateNormals( const glm::mat4 & projectionView )
+void HillsShader::updateNormals()
 {
 	normalsShader.use();
-	normalsShader.setMat4( "u_projectionView", projectionView );
 }
 
 /**
@@ -20,14 +20,7 @@
 
 #pragma once
 
-#include "GraphicsConstants"
-
-#include <array>
-#include <glm/mat4x4.hpp>
-#include <glm/vec3.hpp>
-
 class Shader;
-class Frustum;
 
 /**
 * @brief shader manager for hills. Responsible for managing different hills related shader programs' settings
@@ -37,25 +30,16 @@ class HillsShader
 {
 public:
 	HillsShader( Shader & renderShader, 
-				 Shader & cullingShader, 
 				 Shader & normalsShader ) noexcept;
-	void setupCulling();
-	void update( const glm::vec3 & lightDir,
-				 const std::array<glm::mat4, NUM_SHADOW_LAYERS> & lightSpaceMatrices,
-				 const glm::mat4 & projectionView,
-				 const glm::vec3 & viewPosition,
-				 const Frustum & viewFrustum,
-				 float maxHillHeight,
-				 bool useFrustumCulling,
+	void update( float maxHillHeight,
 				 bool useShadows );
-	void updateNormals( const glm::mat4 & projectionView );
+	void updateNormals();
 	void debugRenderMode( bool enable );
 
 private:
 	friend class HillsRenderer;
 
 	Shader & renderShader;
-	Shader & cullingShader;
 	/** @todo for visual debugging only, delete this in release version of the game */
 	Shader & normalsShader;
 };
@@ -23,20 +23,24 @@
 /**
 * @brief plain ctor. Creates all the member submodules
 * @param renderShader shader prograsm used during rendering
+* @param indirectCommandRing shared storage of the indirect draw commands
 */
-LandFacade::LandFacade( Shader & renderShader ) noexcept
-	: shader( renderShader )
+LandFacade::LandFacade( Shader & renderShader,
+						IndirectCommandRing & indirectCommandRing ) noexcept
+	: indirectCommandRing( indirectCommandRing )
+	, shader( renderShader )
 	, generator()
 	, renderer( generator )
 {}
 
 /**
-* @brief delegates map generation routine to generator
+* @brief delegates map generation routine to generator and uploads generated mesh to GPU
 * @param shoreMap map of the shore tiles
 */
 void LandFacade::setup( const map2D_f & shoreMap )
 {
 	generator.setup( shoreMap );
+	generator.uploadMeshData();
 }
 
 /**
@@ -57,19 +61,43 @@ void LandFacade::deserialize( std::ifstream & input )
 	generator.deserialize( input );
 }
 
+/**
+* @brief delegates binary serialization call to generator
+* @param writer world file writer
+*/
+void LandFacade::serialize( WorldFileWriter & writer ) const
+{
+	generator.serialize( writer );
+}
+
+/**
+* @brief delegates binary section reading call to generator
+* @param section world file section to read data from
+* @param savedMap view of the saved map
+*/
+bool LandFacade::read( WorldFileSection & section,
+					   Heightfield2DView<const float> & savedMap ) const noexcept
+{
+	return generator.read( section, savedMap );
+}
+
+/**
+* @brief delegates binary deserialization call to generator
+* @param savedMap view of the saved map previously read from the world file
+*/
+void LandFacade::deserialize( Heightfield2DView<const float> savedMap )
+{
+	generator.deserialize( savedMap );
+}
+
 /**
 * @brief handles land drawing routine: prepares shader and delegates draw command to renderer
-* @param lightDir sunlight direction vector
-* @param lightSpaceMatrices array of "projection * view" matrices from the Sun point of view
-* @param projectionView "projection * view" matrix
 * @param useShadows indicator of whether shadows should be calculated
 */
-void LandFacade::draw( const glm::vec3 & lightDir,
-					   const std::array<glm::mat4, NUM_SHADOW_LAYERS> & lightSpaceMatrices,
-					   const glm::mat4 & projectionView,
-					   bool useShadows )
+void LandFacade::draw( bool useShadows )
 {
-	shader.update( lightDir, lightSpaceMatrices, projectionView, useShadows );
+	shader.update( useShadows );
+	indirectCommandRing.bind();
 	renderer.render();
 }
 
@@ -82,7 +110,7 @@ const map2D_f & LandFacade::getMap() const noexcept
 * @brief delegates update indirect buffer command to generator
 * @param frustum view frustum of the camera
 */
-void LandFacade::updateCellsIndirectBuffer( const Frustum & frustum )
+void LandFacade::updateIndirectBuffer( const Frustum & frustum )
 {
-	generator.updateCellsIndirectBuffer( frustum );
+	generator.updateIndirectBuffer( frustum, indirectCommandRing );
 }
@@ -30,18 +30,21 @@
 class LandFacade
 {
 public:
-	LandFacade( Shader & renderShader ) noexcept;
+	LandFacade( Shader & renderShader,
+				IndirectCommandRing & indirectCommandRing ) noexcept;
 	void setup( const map2D_f & shoreMap );
 	void serialize( std::ofstream & output );
 	void deserialize( std::ifstream & input );
-	void draw( const glm::vec3 & lightDir,
-			   const std::array<glm::mat4, NUM_SHADOW_LAYERS> & lightSpaceMatrices,
-			   const glm::mat4 & projectionView,
-			   bool useShadows );
+	void serialize( WorldFileWriter & writer ) const;
+	bool read( WorldFileSection & section,
+			   Heightfield2DView<const float> & savedMap ) const noexcept;
+	void deserialize( Heightfield2DView<const float> savedMap );
+	void draw( bool useShadows );
 	const map2D_f & getMap() const noexcept;
-	void updateCellsIndirectBuffer( const Frustum & frustum );
+	void updateIndirectBuffer( const Frustum & frustum );
 
 private:
+	IndirectCommandRing & indirectCommandRing;
 	LandShader shader;
 	LandGenerator generator;
 	LandRenderer renderer;
@@ -19,34 +19,47 @@
  */
 
 #include "LandGenerator"
+#include "Frustum"
+#include "UploadManager"
 
-#include <chrono>
+#include <algorithm>
 
 /**
-* @brief plain ctor. Explicitly initializes cells buffer collection for indirect buffer usage, initializes randomizer seed
+* @brief plain ctor
 */
 LandGenerator::LandGenerator() noexcept
 	: Generator()
-	, cellBuffers( VAO | VBO | INSTANCE_VBO | EBO | DIBO )
-{
-	randomizer.seed( std::chrono::system_clock::now().time_since_epoch().count() );
-	//this collection already have VAO/VBO/EBO in Generator ctor
-	basicGLBuffers.add( INSTANCE_VBO );
-}
+{}
 
 /**
-* @brief prepares land map and buffer collections
+* @brief prepares land map, chunks and mesh data. Makes no OpenGL calls, mesh data is to be uploaded separately
 * @param shoreMap map of the shore tiles
 */
 void LandGenerator::setup( const map2D_f & shoreMap )
 {
-	initializeMap( chunkMap );
 	generateMap( shoreMap );
-	splitChunks( CHUNK_SIZE );
-	tiles.shrink_to_fit();
-	splitCellChunks( CHUNK_SIZE );
-	fillBufferData();
-	fillCellBufferData();
+	flatPoints.build( map.view(), []( float value ) { return value == 0; } );
+	splitChunks( LAND_CHUNK_SIZE );
+	prepareMeshData();
+}
+
+/**
+* @brief buffers previously prepared mesh data to GPU and releases it. All the instances share the same quad indices
+* thus these are not a part of mesh data, indirect buffer is filled each frame with commands for visible chunks
+*/
+void LandGenerator::uploadMeshData()
+{
+	createBuffersOnFirstUse( basicGLBuffers, VAO | VBO | INSTANCE_VBO | EBO );
+	basicGLBuffers.bind( VAO | VBO | EBO );
+	glBufferData( GL_ELEMENT_ARRAY_BUFFER, sizeof( QUAD_INDICES ), QUAD_INDICES, GL_STATIC_DRAW );
+	UploadManager & uploadManager = UploadManager::getInstance();
+	uploadManager.uploadBufferData( basicGLBuffers.get( VBO ), sizeof( GLfloat ) * meshData.vertices.size(), meshData.vertices.data(), GL_STATIC_DRAW );
+	setupVBOAttributes();
+	basicGLBuffers.bind( INSTANCE_VBO );
+	uploadManager.uploadBufferData( basicGLBuffers.get( INSTANCE_VBO ), sizeof( glm::vec4 ) * meshData.instances.size(), meshData.instances.data(), GL_STATIC_DRAW );
+	setupVBOInstancedAttributes();
+	BufferCollection::bindZero( VAO | VBO | EBO );
+	meshData.clear();
 }
 
 /**
@@ -65,172 +78,66 @@ void LandGenerator::generateMap( const map2D_f & shoreMap )
 }
 
 /**
-* @brief setup square chunks storage
+* @brief splits the map into chunks and covers flat cells of each chunk with rectangles.
+* Rectangles of a chunk are stored contiguously, thus a chunk is drawn as a range of instances
 * @param chunkSize size of one square chunk
 */
 void LandGenerator::splitChunks( int chunkSize )
 {
 	//in case of recreation need to remove old data
 	chunks.clear();
-	tiles.clear();
-	unsigned int chunkOffset = 0;
-	for( int startY = 0; startY < WORLD_HEIGHT - chunkSize + 1; startY += chunkSize )
+	rectangles.clear();
+	//cell is flat if all of its corners are flat
+	TileMask flatCells = flatPoints.createAllCornersMask();
+	for( int startY = 0; startY < WORLD_HEIGHT; startY += chunkSize )
 	{
-		for( int startX = 0; startX < WORLD_WIDTH - chunkSize + 1; startX += chunkSize )
+		for( int startX = 0; startX < WORLD_WIDTH; startX += chunkSize )
 		{
-			//check if region of the map is flat
-			bool chunkIsFlat = true;
-			for( int y = startY; y < startY + chunkSize; y++ )
-			{
-				for( int x = startX; x < startX + chunkSize; x++ )
-				{
-					if( map[y][x] != 0 || map[y + 1][x] != 0 || map[y + 1][x + 1] != 0 || map[y][x + 1] != 0 )
-					{
-						chunkIsFlat = false;
-						break;
-					}
-				}
-				if( !chunkIsFlat )
-				{
-					break;
-				}
-			}
-			if( chunkIsFlat )
-			{
-				for( int noRenderY = startY + 1; noRenderY < startY + chunkSize; noRenderY++ )
-				{
-					for( int noRenderX = startX + 1; noRenderX < startX + chunkSize; noRenderX++ )
-					{
-						map[noRenderY][noRenderX] = 0;
-						chunkMap[noRenderY][noRenderX] = CHUNK_NO_RENDER_VALUE;
-					}
-				}
-				//for square map segments one tile is also one chunk
-				tiles.emplace_back( startX, startY, 0.0f, 0.0f, 0.0f, 0.0f );
-				chunks.emplace_back( startX, startX + chunkSize, startY, startY + chunkSize, chunkOffset, 1 );
-				++chunkOffset;
-			}
-		}
-	}
-}
-
-/**
-* @brief setup cells chunks storage
-* @param chunkSize size of one cells chunk
-*/
-void LandGenerator::splitCellChunks( int chunkSize )
-{
-	//in case of recreation need to remove old data
-	cellTiles.clear();
-	cellChunks.clear();
-	unsigned int chunkOffset = 0;
-	for( int startY = 0; startY < WORLD_HEIGHT - chunkSize + 1; startY += chunkSize )
-	{
-		for( int startX = 0; startX < WORLD_WIDTH - chunkSize + 1; startX += chunkSize )
-		{
-			unsigned int cellInstances = 0;
-			for( int y = startY + 1; y < startY + chunkSize + 1; y++ )
-			{
-				for( int x = startX; x < startX + chunkSize; x++ )
-				{
-					//check if this segment is flat and has not been used in square chunk storage
-					if( map[y][x] == 0 && map[y - 1][x] == 0 && map[y - 1][x + 1] == 0 && map[y][x + 1] == 0 &&
-						chunkMap[y][x] != CHUNK_NO_RENDER_VALUE &&
-						chunkMap[y - 1][x] != CHUNK_NO_RENDER_VALUE &&
-						chunkMap[y - 1][x + 1] != CHUNK_NO_RENDER_VALUE &&
-						chunkMap[y][x + 1] != CHUNK_NO_RENDER_VALUE )
-					{
-						cellTiles.emplace_back( x, y, 0.0f, 0.0f, 0.0f, 0.0f );
-						cellInstances++;
-					}
-				}
-			}
-			if( cellInstances != 0 )
+			const int END_X = std::min( startX + chunkSize, WORLD_WIDTH );
+			const int END_Y = std::min( startY + chunkSize, WORLD_HEIGHT );
+			const size_t INSTANCE_OFFSET = rectangles.size();
+			flatCells.extractRectangles( startX, startY, END_X, END_Y, rectangles );
+			if( rectangles.size() != INSTANCE_OFFSET )
 			{
-				cellChunks.emplace_back( startX, startX + chunkSize, startY, startY + chunkSize, chunkOffset, cellInstances );
+				chunks.emplace_back( startX, END_X, startY, END_Y, (unsigned int)INSTANCE_OFFSET, (unsigned int)( rectangles.size() - INSTANCE_OFFSET ) );
 			}
-			chunkOffset += cellInstances;
 		}
 	}
-}
-
-/**
-* @brief prepares square segments buffer collection
-*/
-void LandGenerator::fillBufferData()
-{
-	//buffer data for exactly one square chunk
-	float halfChunkSize = CHUNK_SIZE / 2;
-	const unsigned int CHUNK_VERTICES_SIZE_FLOATS = 20;
-	GLfloat chunkVertices[CHUNK_VERTICES_SIZE_FLOATS] = {
-		-halfChunkSize, 0.0f,  halfChunkSize, 0.0f,               0.0f,
-		 halfChunkSize, 0.0f,  halfChunkSize, (float)CHUNK_SIZE,  0.0f,
-		 halfChunkSize, 0.0f, -halfChunkSize, (float)CHUNK_SIZE,  (float)CHUNK_SIZE,
-		-halfChunkSize, 0.0f, -halfChunkSize, 0.0f,               (float)CHUNK_SIZE
-	};
-	basicGLBuffers.bind( VAO );
-	bufferData( basicGLBuffers, chunkVertices, CHUNK_VERTICES_SIZE_FLOATS );
-	setupVBOAttributes();
+	rectangles.shrink_to_fit();
 
-	//buffer instances translations data to instance vbo
-	std::unique_ptr<glm::vec4[]> landChunkInstanceTranslations( new glm::vec4[tiles.size()] );
-	for( unsigned int tileIndex = 0; tileIndex < tiles.size(); tileIndex++ )
+	//land is flat, thus chunk boxes have no height
+	chunksTree.clear();
+	chunksTree.reserve( chunks.size() );
+	for( const LandChunk & chunk : chunks )
 	{
-		TerrainTile & tile = tiles[tileIndex];
-		landChunkInstanceTranslations[tileIndex] = glm::vec4( -HALF_WORLD_WIDTH + tile.mapX + halfChunkSize,
-															  0.0f,
-															  -HALF_WORLD_HEIGHT + tile.mapY + halfChunkSize,
-															  0.0f );
+		chunksTree.addChunk( glm::vec3( -HALF_WORLD_WIDTH + (float)chunk.getLeft(), 0.0f, -HALF_WORLD_HEIGHT + (float)chunk.getTop() ),
+							 glm::vec3( -HALF_WORLD_WIDTH + (float)chunk.getRight(), 0.0f, -HALF_WORLD_HEIGHT + (float)chunk.getBottom() ) );
 	}
-	basicGLBuffers.bind( INSTANCE_VBO );
-	glBufferData( GL_ARRAY_BUFFER, sizeof( glm::vec4 ) * tiles.size(), &landChunkInstanceTranslations[0], GL_STATIC_DRAW );
-	setupVBOInstancedAttributes();
-	BufferCollection::bindZero( VAO | VBO | EBO );
+	chunksTree.build();
 }
 
 /**
-* @brief prepares cells chunks buffer collection
+* @brief prepares mesh data: one unit quad and a rectangle (position of its corner and size) of each instance
 */
-void LandGenerator::fillCellBufferData()
+void LandGenerator::prepareMeshData()
 {
-	//buffer data for exactly one cell
-	const unsigned int CELL_VERTICES_SIZE_FLOATS = 20;
-	GLfloat cellVertices[CELL_VERTICES_SIZE_FLOATS] = {
+	//texture coordinates are scaled by the rectangle size as well, thus texture is repeated once per cell as if cells were separate
+	meshData.clear();
+	meshData.vertices = {
 		 0.0f, 0.0f,  1.0f, 0.0f,  0.0f,
 		 1.0f, 0.0f,  1.0f, 1.0f,  0.0f,
 		 1.0f, 0.0f,  0.0f, 1.0f,  1.0f,
 		 0.0f, 0.0f,  0.0f, 0.0f,  1.0f
 	};
-	cellBuffers.bind( VAO | DIBO );
-	bufferData( cellBuffers, cellVertices, CELL_VERTICES_SIZE_FLOATS );
-	setupVBOAttributes();
 
-	//buffer cells instances data to instance vbo
-	std::unique_ptr<glm::vec4[]> cellInstanceTranslations( new glm::vec4[cellTiles.size()] );
-	for( unsigned int tileIndex = 0; tileIndex < cellTiles.size(); tileIndex++ )
+	meshData.instances.reserve( rectangles.size() );
+	for( const TileRectangle & rectangle : rectangles )
 	{
-		TerrainTile & tile = cellTiles[tileIndex];
-		cellInstanceTranslations[tileIndex] = glm::vec4( -HALF_WORLD_WIDTH + tile.mapX, 0.0f, -HALF_WORLD_HEIGHT + tile.mapY - 1, 0.0f );
+		meshData.instances.emplace_back( -HALF_WORLD_WIDTH + (float)rectangle.x,
+										 -HALF_WORLD_HEIGHT + (float)rectangle.y,
+										 (float)rectangle.width,
+										 (float)rectangle.height );
 	}
-	cellBuffers.bind( INSTANCE_VBO );
-	glBufferData( GL_ARRAY_BUFFER, sizeof( glm::vec4 ) * cellTiles.size(), &cellInstanceTranslations[0], GL_STATIC_DRAW );
-	setupVBOInstancedAttributes();
-	BufferCollection::bindZero( VAO | VBO | EBO );
-}
-
-/**
-* @brief helper function to load data from given buffer to buffer collection
-* @param bufferCollection buffer collection to load data to
-* @param buffer client buffer storage
-* @param size number of elements to load
-*/
-void LandGenerator::bufferData( BufferCollection & bufferCollection, 
-								GLfloat * buffer, 
-								size_t size )
-{
-	bufferCollection.bind( VBO | EBO );
-	glBufferData( GL_ELEMENT_ARRAY_BUFFER, sizeof( QUAD_INDICES ), QUAD_INDICES, GL_STATIC_DRAW );
-	glBufferData( GL_ARRAY_BUFFER, sizeof( buffer ) * size, buffer, GL_STATIC_DRAW );
 }
 
 /**
@@ -255,43 +162,45 @@ void LandGenerator::setupVBOInstancedAttributes() noexcept
 }
 
 /**
-* @brief updates indirect buffer data for cells storage
+* @brief collects draw commands for the chunks which are inside the frustum and copies them to the indirect command ring.
+* Commands are merged in a local storage first as the mapped ring memory should not be read back
 * @param frustum camera's view frustum
+* @param indirectCommandRing shared storage of the indirect draw commands for the current frame
 */
-void LandGenerator::updateCellsIndirectBuffer( const Frustum & frustum )
+void LandGenerator::updateIndirectBuffer( const Frustum & frustum,
+										  IndirectCommandRing & indirectCommandRing )
 {
-	cellBuffers.bind( VAO );
-	// {indicesCount, numInstancesToDraw, firstIndex, baseVertex, baseInstance}
-	std::unique_ptr<GLuint[]> indirectBuffer( new GLuint[cellChunks.size() * INDIRECT_DRAW_COMMAND_ARGUMENTS] );
-	GLuint dataOffset = 0;
-	cellPrimitiveCount = 0;
-	for( unsigned int chunkIndex = 0; chunkIndex < cellChunks.size(); chunkIndex++ )
+	indirectBufferData.clear();
+	chunksTree.forEachVisible( frustum, 0.0f, [this]( unsigned int chunkIndex )
 	{
-		if( cellChunks[chunkIndex].isInsideFrustum( frustum, 1.0f ) )
-		{
-			++cellPrimitiveCount;
-			addIndirectBufferData( &indirectBuffer[0], dataOffset, cellChunks[chunkIndex].getNumInstances(), cellChunks[chunkIndex].getInstanceOffset() );
-		}
+		const LandChunk & chunk = chunks[chunkIndex];
+		addIndirectBufferData( chunk.getNumInstances(), chunk.getInstanceOffset() );
+	} );
+	const GLsizei NUM_DRAW_COMMANDS = GLsizei( indirectBufferData.size() / INDIRECT_DRAW_COMMAND_ARGUMENTS );
+	GLuint * commands = indirectCommandRing.allocate( NUM_DRAW_COMMANDS, drawCommands );
+	if( commands )
+	{
+		std::copy( indirectBufferData.begin(), indirectBufferData.end(), commands );
 	}
-	cellBuffers.bind( DIBO );
-	glBufferData( GL_DRAW_INDIRECT_BUFFER, INDIRECT_DRAW_COMMAND_BYTE_SIZE * cellPrimitiveCount, &indirectBuffer[0], GL_STATIC_DRAW );
 }
 
 /**
-* @brief load data of one inderect draw command to indirect buffer
-* @param buffer client buffer storage
-* @param dataOffset offset to storage index
+* @brief appends one indirect draw command to the client side indirect buffer data,
+* extends the previous command instead if its instances are followed by the given ones
 * @param numInstances number of instances for draw call
 * @param instanceOffset instance offset for draw call
 */
-void LandGenerator::addIndirectBufferData( GLuint * buffer, 
-										   GLuint & dataOffset, 
-										   GLuint numInstances, 
-										   GLuint instanceOffset ) noexcept
+void LandGenerator::addIndirectBufferData( GLuint numInstances,
+										   GLuint instanceOffset )
 {
-	buffer[dataOffset++] = VERTICES_PER_QUAD;
-	buffer[dataOffset++] = numInstances;
-	buffer[dataOffset++] = 0;
-	buffer[dataOffset++] = 0;
-	buffer[dataOffset++] = instanceOffset;
+	if( !indirectBufferData.empty() )
+	{
+		GLuint * lastCommand = &indirectBufferData[indirectBufferData.size() - INDIRECT_DRAW_COMMAND_ARGUMENTS];
+		if( lastCommand[4] + lastCommand[1] == instanceOffset )
+		{
+			lastCommand[1] += numInstances;
+			return;
+		}
+	}
+	indirectBufferData.insert( indirectBufferData.end(), { VERTICES_PER_QUAD, numInstances, 0, 0, instanceOffset } );
 }
@@ -22,12 +22,17 @@
 
 #include "Generator"
 #include "LandChunk"
+#include "TileMask"
+#include "IndirectCommandRing"
+#include "ChunkQuadtree"
 
-#include <random>
+/** @brief size of the land chunks, flat rectangles are merged within a chunk and chunks are culled as a whole */
+constexpr int LAND_CHUNK_SIZE = 32;
 
 /**
-* @brief Generator for land terrain data. Has two types of storages: square tile chunks (that are not cut off by shore)
-* and cells chunks (non-square regions nearby shore).
+* @brief Generator for land terrain data. Land is flat, thus flat cells of each chunk are greedily merged into rectangles,
+* each rectangle is an instance of the same unit quad scaled in the vertex shader.
+* Chunks are culled hierarchically with a quadtree, visible chunks are drawn with a single indirect call, its commands are written to the shared indirect command ring
 */
 class LandGenerator : public Generator
 {
@@ -35,7 +40,9 @@ public:
 	LandGenerator() noexcept;
 	virtual ~LandGenerator() = default;
 	void setup( const map2D_f & shoreMap );
-	void updateCellsIndirectBuffer( const Frustum & frustum );
+	void uploadMeshData();
+	void updateIndirectBuffer( const Frustum & frustum,
+							   IndirectCommandRing & indirectCommandRing );
 
 private:
 	friend class LandRenderer;
@@ -43,24 +50,17 @@ private:
 
 	void generateMap( const map2D_f & shoreMap );
 	void splitChunks( int chunkSize );
-	void splitCellChunks( int chunkSize );
-	void fillBufferData();
-	void fillCellBufferData();
-	void bufferData( BufferCollection & bufferCollection, 
-					 GLfloat * buffer, 
-					 size_t size );
+	void prepareMeshData();
 	void setupVBOAttributes() noexcept;
 	void setupVBOInstancedAttributes() noexcept;
-	void addIndirectBufferData( GLuint * buffer, 
-								GLuint & dataOffset, 
-								GLuint numInstances, 
-								GLuint instanceOffset ) noexcept;
+	void addIndirectBufferData( GLuint numInstances,
+								GLuint instanceOffset );
 
-	BufferCollection cellBuffers;
-	map2D_f chunkMap;
-	std::vector<TerrainTile> cellTiles;
-	std::default_random_engine randomizer;
+	TileMask flatPoints;
+	std::vector<TileRectangle> rectangles;
 	std::vector<LandChunk> chunks;
-	std::vector<LandChunk> cellChunks;
-	GLuint cellPrimitiveCount;
+	ChunkQuadtree chunksTree;
+	// {indicesCount, numInstancesToDraw, firstIndex, baseVertex, baseInstance} for each visible chunk
+	std::vector<GLuint> indirectBufferData;
+	IndirectCommandRange drawCommands;
 };
@@ -30,15 +30,16 @@ LandRenderer::LandRenderer( LandGenerator & generator ) noexcept
 {}
 
 /**
-* @brief sends draw calls to OpenGL, instanced for square segments and instanced indirect for cells
+* @brief sends instanced indirect draw call for the visible chunks to OpenGL
+* @note indirect command ring is expected to be bound already
 */
 void LandRenderer::render()
 {
-	//square chunks are better to render without frustum culling
+	const IndirectCommandRange & drawCommands = generator.drawCommands;
+	if( drawCommands.numCommands == 0 )
+	{
+		return;
+	}
 	generator.basicGLBuffers.bind( VAO );
-	glDrawElementsInstanced( GL_TRIANGLES, VERTICES_PER_QUAD, GL_UNSIGNED_BYTE, 0, generator.tiles.size() );
-
-	//these ones should probably be culled with multiDrawIndirect
-	generator.cellBuffers.bind( VAO | DIBO );
-	glMultiDrawElementsIndirect( GL_TRIANGLES, GL_UNSIGNED_BYTE, 0, generator.cellPrimitiveCount, 0 );
+	glMultiDrawElementsIndirect( GL_TRIANGLES, GL_UNSIGNED_BYTE, (void*)drawCommands.byteOffset, drawCommands.numCommands, 0 );
 }
@@ -30,22 +30,11 @@ LandShader::LandShader( Shader & renderShader ) noexcept
 {}
 
 /**
-* @brief updates shader program uniforms
-* @param lightDir sunlight direction vector
-* @param lightSpaceMatrices array of "projection * view" matrices from the Sun point of view
-* @param projectionView "projection * view" matrix
+* @brief updates shader program uniforms, camera, lighting and shadow data come from the frame uniform blocks
 * @param useShadows indicator of whether shadows should be calculated
 */
-void LandShader::update( const glm::vec3 & lightDir,
-						 const std::array<glm::mat4, NUM_SHADOW_LAYERS> & lightSpaceMatrices,
-						 const glm::mat4 & projectionView,
-						 bool useShadows )
+void LandShader::update( bool useShadows )
 {
 	renderShader.use();
-	renderShader.setMat4( "u_projectionView", projectionView );
 	renderShader.setBool( "u_shadowEnable", useShadows );
-	renderShader.setVec3( "u_lightDir", -lightDir );
-	renderShader.setMat4( "u_lightSpaceMatrix[0]", lightSpaceMatrices[0] );
-	renderShader.setMat4( "u_lightSpaceMatrix[1]", lightSpaceMatrices[1] );
-	renderShader.setMat4( "u_lightSpaceMatrix[2]", lightSpaceMatrices[2] );
 }
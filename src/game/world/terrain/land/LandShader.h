@@ -20,12 +20,6 @@
 
 #pragma once
 
-#include "GraphicsConstants"
-
-#include <array>
-#include <glm/mat4x4.hpp>
-#include <glm/vec3.hpp>
-
 class Shader;
 
 /**
@@ -35,10 +29,7 @@ class LandShader
 {
 public:
 	LandShader( Shader & renderShader ) noexcept;
-	void update( const glm::vec3 & lightDir,
-				 const std::array<glm::mat4, NUM_SHADOW_LAYERS> & lightSpaceMatrices,
-				 const glm::mat4 & projectionView,
-				 bool useShadows );
+	void update( bool useShadows );
 
 private:
 	Shader & renderShader;
@@ -36,11 +36,21 @@ ShoreFacade::ShoreFacade( Shader & renderShader,
 {}
 
 /**
-* @brief delegates map generation routine to generator
+* @brief delegates map generation routine to generator and uploads generated mesh to GPU
 */
 void ShoreFacade::setup()
 {
 	generator.setup();
+	generator.uploadMeshData();
+}
+
+/**
+* @brief delegates tiles and buffers creation routine for already loaded map to generator
+*/
+void ShoreFacade::recreateTilesAndBufferData()
+{
+	generator.createTilesAndMeshData();
+	generator.uploadMeshData();
 }
 
 /**
@@ -61,20 +71,59 @@ void ShoreFacade::deserialize( std::ifstream & input )
 	generator.deserialize( input );
 }
 
+/**
+* @brief delegates binary serialization call to generator
+* @param writer world file writer
+*/
+void ShoreFacade::serialize( WorldFileWriter & writer ) const
+{
+	generator.serialize( writer );
+}
+
+/**
+* @brief delegates binary section reading call to generator
+* @param section world file section to read data from
+* @param savedMap view of the saved map
+*/
+bool ShoreFacade::read( WorldFileSection & section,
+						Heightfield2DView<const float> & savedMap ) const noexcept
+{
+	return generator.read( section, savedMap );
+}
+
+/**
+* @brief delegates binary deserialization call to generator
+* @param savedMap view of the saved map previously read from the world file
+*/
+void ShoreFacade::deserialize( Heightfield2DView<const float> savedMap )
+{
+	generator.deserialize( savedMap );
+}
+
+/**
+* @brief selects levels of detail of the shore chunks for the current frame and culls chunks outside the frustum
+* @param viewPosition position of the camera
+* @param projectionScale number of pixels a unit long segment takes on the screen at a unit distance from the camera
+* @param pixelError maximum allowed error of the coarse levels projected to the screen (in pixels)
+* @param cullingFrustum frustum to test shore chunks against
+*/
+void ShoreFacade::updateLevelsOfDetail( const glm::vec3 & viewPosition,
+										float projectionScale,
+										float pixelError,
+										const Frustum & cullingFrustum )
+{
+	generator.updateLevelsOfDetail( viewPosition, projectionScale, pixelError, cullingFrustum );
+}
+
 /**
 * @brief handles shores drawing routine: prepares shader and delegates draw command to renderer
-* @param lightDir sunlight direction vector
-* @param lightSpaceMatrices array of "projection * view" matrices from the Sun point of view
-* @param projectionView "projection * view" matrix
 * @param useShadows indicator of whether shadows should be calculated
 * @param useDebugRender indicator of whether to render additional visualizations for debugging
 * @param useClipDistanceReflection indicator of whether clip distance will be used by OpenGL for reflection rendering
 * @param useClipDistanceRefraction indicator of whether clip distance will be used by OpenGL for refraction rendering
+* @note chunks culled against the camera frustum are not necessarily outside the mirrored view, thus reflection draws all of them
 */
-void ShoreFacade::draw( const glm::vec3 & lightDir,
-						const std::array<glm::mat4, NUM_SHADOW_LAYERS> & lightSpaceMatrices,
-						const glm::mat4 & projectionView,
-						bool useShadows,
+void ShoreFacade::draw( bool useShadows,
 						bool useDebugRender,
 						bool useClipDistanceReflection,
 						bool useClipDistanceRefraction )
@@ -83,20 +132,15 @@ void ShoreFacade::draw( const glm::vec3 & lightDir,
 	{
 		RendererState::enableState( GL_CLIP_DISTANCE0 );
 	}
-	shader.update( lightDir,
-				   lightSpaceMatrices,
-				   projectionView,
-				   useShadows,
-				   useClipDistanceReflection,
-				   useClipDistanceRefraction );
+	shader.update( useShadows, useClipDistanceReflection, useClipDistanceRefraction );
 	shader.debugRenderMode( false );
-	renderer.render();
+	renderer.render( !useClipDistanceReflection );
 
 	if( useDebugRender )
 	{
 		shader.debugRenderMode( true );
 		renderer.debugRender( GL_TRIANGLES );
-		shader.updateNormals( projectionView );
+		shader.updateNormals();
 		renderer.debugRender( GL_POINTS );
 	}
 
@@ -113,7 +157,7 @@ void ShoreFacade::draw( const glm::vec3 & lightDir,
 void ShoreFacade::drawDepthmap()
 {
 	RendererState::disableState( GL_CULL_FACE );
-	renderer.render();
+	renderer.render( false );
 	RendererState::enableState( GL_CULL_FACE );
 }
 
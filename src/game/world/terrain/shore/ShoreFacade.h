@@ -34,12 +34,18 @@ public:
 				 Shader & normalsShader, 
 				 const map2D_f & waterMap );
 	void setup();
+	void recreateTilesAndBufferData();
 	void serialize( std::ofstream & output );
 	void deserialize( std::ifstream & input );
-	void draw( const glm::vec3 & lightDir,
-			   const std::array<glm::mat4, NUM_SHADOW_LAYERS> & lightSpaceMatrices,
-			   const glm::mat4 & projectionView,
-			   bool useShadows,
+	void serialize( WorldFileWriter & writer ) const;
+	bool read( WorldFileSection & section,
+			   Heightfield2DView<const float> & savedMap ) const noexcept;
+	void deserialize( Heightfield2DView<const float> savedMap );
+	void updateLevelsOfDetail( const glm::vec3 & viewPosition,
+							   float projectionScale,
+							   float pixelError,
+							   const Frustum & cullingFrustum );
+	void draw( bool useShadows,
 			   bool useDebugRender,
 			   bool useClipDistanceReflection,
 			   bool useClipDistanceRefraction );
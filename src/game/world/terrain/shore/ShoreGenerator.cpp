@@ -14,15 +14,15 @@
  * GNU General Public License for more details.
  * See <http://www.gnu.org/licenses/>
  *
- * Purpose: contains definitions for ShoreGenerator class and ShoreVertex struct
+ * Purpose: contains definitions for ShoreGenerator class
  * @version 0.1.0
  */
 
 #include "ShoreGenerator"
 #include "SettingsManager"
-
-#include <chrono>
-#include <memory>
+#include "StencilEngine"
+#include "RandomStream"
+#include "UploadManager"
 
 /**
 * @brief plain ctor
@@ -31,12 +31,10 @@
 ShoreGenerator::ShoreGenerator( const map2D_f & waterMap )
 	: Generator()
 	, waterMap( waterMap )
-{
-	randomizer.seed( std::chrono::system_clock::now().time_since_epoch().count() );
-}
+{}
 
 /**
-* @brief prepares shore map and buffer collections
+* @brief prepares shore map, tiles and mesh data. Makes no OpenGL calls, mesh data is to be uploaded separately
 */
 void ShoreGenerator::setup()
 {
@@ -55,9 +53,17 @@ void ShoreGenerator::setup()
 	applySlopeToProfile( 2.0f );
 	correctMapAtEdges();
 	removeUnderwaterTiles( SettingsManager::getFloat( "SCENE", "underwater_level" ) );
+	createTilesAndMeshData();
+}
+
+/**
+* @brief creates tiles, normal map and mesh data based on current map data
+*/
+void ShoreGenerator::createTilesAndMeshData()
+{
 	createTiles();
 	createNormalMap( normalMap );
-	fillBufferData();
+	prepareMeshData();
 }
 
 /**
@@ -68,13 +74,13 @@ void ShoreGenerator::generateMap()
 {
 	const float MIN_HEIGHT_KERNEL_OFFSET = 0.9f;
 	const float MAX_HEIGHT_KERNEL_OFFSET = 1.1f;
-	std::uniform_real_distribution<float> positionDistribution( MIN_HEIGHT_KERNEL_OFFSET, MAX_HEIGHT_KERNEL_OFFSET );
 
 	for( unsigned int y = 0; y <= WORLD_HEIGHT; y++ )
 	{
 		for( unsigned int x = 0; x <= WORLD_WIDTH; x++ )
 		{
-			map[y][x] = waterMap[y][x] * 1.1f * positionDistribution( randomizer );
+			RandomStream random( RANDOM_STREAM_SHORE_KERNEL, x, y );
+			map[y][x] = waterMap[y][x] * 1.1f * random.nextFloat( MIN_HEIGHT_KERNEL_OFFSET, MAX_HEIGHT_KERNEL_OFFSET );
 		}
 	}
 }
@@ -140,7 +146,6 @@ void ShoreGenerator::randomizeShore()
 {
 	const float MIN_HEIGHT_RANDOMIZE_OFFSET = -0.24f;
 	const float MAX_HEIGHT_RANDOMIZE_OFFSET = 0.24f;
-	std::uniform_real_distribution<float> distribution( MIN_HEIGHT_RANDOMIZE_OFFSET, MAX_HEIGHT_RANDOMIZE_OFFSET );
 
 	for( unsigned int y = 0; y < WORLD_HEIGHT; y++ )
 	{
@@ -148,7 +153,8 @@ void ShoreGenerator::randomizeShore()
 		{
 			if( map[y][x] < 0 )
 			{
-				map[y][x] += distribution( randomizer );
+				RandomStream random( RANDOM_STREAM_SHORE_PROFILE, x, y );
+				map[y][x] += random.nextFloat( MIN_HEIGHT_RANDOMIZE_OFFSET, MAX_HEIGHT_RANDOMIZE_OFFSET );
 			}
 		}
 	}
@@ -192,7 +198,7 @@ void ShoreGenerator::correctMapAtEdges()
 */
 void ShoreGenerator::applySlopeToProfile( float ratio ) noexcept
 {
-	for( std::vector<float> & row : map )
+	for( HeightfieldRow<float> row : map )
 	{
 		for( float & height : row )
 		{
@@ -210,28 +216,11 @@ void ShoreGenerator::applySlopeToProfile( float ratio ) noexcept
 */
 void ShoreGenerator::removeUnderwaterTiles( float thresholdValue )
 {
-	for( unsigned int y = 1; y < WORLD_HEIGHT; y++ )
-	{
-		/*
-		* check neighbours also to ensure that there would be no visual gaps between underwater and shore
-		* if we would not create a tile using this coordinate
-		*/
-		for( unsigned int x = 1; x < WORLD_WIDTH; x++ )
-		{
-			if( map[y - 1][x - 1] < thresholdValue &&
-				map[y - 1][x] < thresholdValue &&
-				map[y - 1][x + 1] < thresholdValue &&
-				map[y][x - 1] < thresholdValue &&
-				map[y][x] < thresholdValue &&
-				map[y][x + 1] < thresholdValue &&
-				map[y + 1][x - 1] < thresholdValue &&
-				map[y + 1][x] < thresholdValue &&
-				map[y + 1][x + 1] < thresholdValue )
-			{
-				map[y][x] = TILE_NO_RENDER_VALUE;
-			}
-		}
-	}
+	/*
+	* check neighbours also to ensure that there would be no visual gaps between underwater and shore
+	* if we would not create a tile using this coordinate
+	*/
+	StencilEngine::markSubmergedPoints( map.slice( 1, 1, WORLD_WIDTH - 1, WORLD_HEIGHT - 1 ), thresholdValue, TILE_NO_RENDER_VALUE );
 }
 
 /**
@@ -264,32 +253,26 @@ void ShoreGenerator::createTiles()
 }
 
 /**
-* @brief prepares buffer collection
+* @brief for each tile creates set of vertices and indices in the CPU side mesh data storage
 */
-void ShoreGenerator::fillBufferData()
+void ShoreGenerator::prepareMeshData()
 {
-	using glm::vec2;
-	using glm::vec3;
-	const size_t VERTEX_DATA_LENGTH = tiles.size() * UNIQUE_VERTICES_PER_TILE * ShoreVertex::NUMBER_OF_ELEMENTS;
 	const size_t INDICES_DATA_LENGTH = tiles.size() * VERTICES_PER_QUAD;
 	size_t indicesBufferIndex = 0;
-	std::unique_ptr<GLfloat[]> vertices( new GLfloat[VERTEX_DATA_LENGTH] );
-	std::unique_ptr<GLuint[]> indices( new GLuint[INDICES_DATA_LENGTH] );
+	meshData.clear();
+	meshData.packedVertices.reserve( tiles.size() * UNIQUE_VERTICES_PER_TILE );
+	meshData.indices.resize( INDICES_DATA_LENGTH );
+	GLuint * indices = meshData.indices.data();
 	for( unsigned int tileIndex = 0; tileIndex < tiles.size(); tileIndex++ )
 	{
 		TerrainTile & tile = tiles[tileIndex];
 		int x = tile.mapX, y = tile.mapY;
 
-		ShoreVertex lowLeft( vec3( x - 1, tile.lowLeft, y ), vec2( 0.0f ), normalMap[y][x - 1] );
-		ShoreVertex lowRight( vec3( x, tile.lowRight, y ), vec2( 1.0f, 0.0f ), normalMap[y][x] );
-		ShoreVertex upRight( vec3( x, tile.upperRight, y - 1 ), vec2( 1.0f ), normalMap[y - 1][x] );
-		ShoreVertex upLeft( vec3( x - 1, tile.upperLeft, y - 1 ), vec2( 0.0f, 1.0f ), normalMap[y - 1][x - 1] );
-
-		int vertexBufferOffset = tileIndex * UNIQUE_VERTICES_PER_TILE * ShoreVertex::NUMBER_OF_ELEMENTS;
-		bufferVertex( vertices.get(), vertexBufferOffset + ShoreVertex::NUMBER_OF_ELEMENTS * 0, lowLeft );
-		bufferVertex( vertices.get(), vertexBufferOffset + ShoreVertex::NUMBER_OF_ELEMENTS * 1, lowRight );
-		bufferVertex( vertices.get(), vertexBufferOffset + ShoreVertex::NUMBER_OF_ELEMENTS * 2, upRight );
-		bufferVertex( vertices.get(), vertexBufferOffset + ShoreVertex::NUMBER_OF_ELEMENTS * 3, upLeft );
+		//texture coordinates of a tile (0;0)-(1;1) are derived from the grid position in the shader
+		meshData.packedVertices.emplace_back( x - 1, y, tile.lowLeft, normalMap[y][x - 1] );
+		meshData.packedVertices.emplace_back( x, y, tile.lowRight, normalMap[y][x] );
+		meshData.packedVertices.emplace_back( x, y - 1, tile.upperRight, normalMap[y - 1][x] );
+		meshData.packedVertices.emplace_back( x - 1, y - 1, tile.upperLeft, normalMap[y - 1][x - 1] );
 
 		GLuint indicesBufferBaseVertex = tileIndex * UNIQUE_VERTICES_PER_TILE;
 		indices[indicesBufferIndex++] = indicesBufferBaseVertex + 0;
@@ -299,48 +282,21 @@ void ShoreGenerator::fillBufferData()
 		indices[indicesBufferIndex++] = indicesBufferBaseVertex + 3;
 		indices[indicesBufferIndex++] = indicesBufferBaseVertex + 0;
 	}
-
-	basicGLBuffers.bind( VAO | VBO | EBO );
-	glBufferData( GL_ARRAY_BUFFER, sizeof( GLfloat ) * VERTEX_DATA_LENGTH, vertices.get(), GL_STATIC_DRAW );
-	glBufferData( GL_ELEMENT_ARRAY_BUFFER, sizeof( GLuint ) * INDICES_DATA_LENGTH, indices.get(), GL_STATIC_DRAW );
-
-	const size_t SIZE_OF_SHORE_VERTEX = ShoreVertex::NUMBER_OF_ELEMENTS * sizeof( GLfloat );
-	glEnableVertexAttribArray( 0 );
-	glVertexAttribPointer( 0, 3, GL_FLOAT, GL_FALSE, SIZE_OF_SHORE_VERTEX, 0 );
-	glEnableVertexAttribArray( 1 );
-	glVertexAttribPointer( 1, 2, GL_FLOAT, GL_FALSE, SIZE_OF_SHORE_VERTEX, (void*)( 3 * sizeof( GLfloat ) ) );
-	glEnableVertexAttribArray( 2 );
-	glVertexAttribPointer( 2, 3, GL_FLOAT, GL_FALSE, SIZE_OF_SHORE_VERTEX, (void*)( 5 * sizeof( GLfloat ) ) );
-	BufferCollection::bindZero( VAO | VBO | EBO );
+	levelsOfDetail.build( tiles, meshData, 0.0f );
 }
 
 /**
-* @brief helper function that fills data of a shore vertex to local storage
-* @param vertices vertices local storage
-* @param offset index offset to storage
-* @param vertex shore vertex to be bufferred
+* @brief buffers previously prepared mesh data to GPU and releases it, prepares buffer collection.
+* Indirect buffer is filled each frame with draw commands of the selected levels of detail
 */
-void ShoreGenerator::bufferVertex( GLfloat * vertices, 
-								   int offset, 
-								   ShoreVertex vertex ) noexcept
+void ShoreGenerator::uploadMeshData()
 {
-	vertices[offset + 0] = vertex.position.x;
-	vertices[offset + 1] = vertex.position.y;
-	vertices[offset + 2] = vertex.position.z;
-	vertices[offset + 3] = vertex.texCoords.x;
-	vertices[offset + 4] = vertex.texCoords.y;
-	vertices[offset + 5] = vertex.normal.x;
-	vertices[offset + 6] = vertex.normal.y;
-	vertices[offset + 7] = vertex.normal.z;
+	createBuffersOnFirstUse( basicGLBuffers, VAO | VBO | EBO | DIBO );
+	basicGLBuffers.bind( VAO | VBO | EBO );
+	UploadManager & uploadManager = UploadManager::getInstance();
+	uploadManager.uploadBufferData( basicGLBuffers.get( VBO ), sizeof( PackedTerrainVertex ) * meshData.packedVertices.size(), meshData.packedVertices.data(), GL_STATIC_DRAW );
+	uploadManager.uploadBufferData( basicGLBuffers.get( EBO ), sizeof( GLuint ) * meshData.indices.size(), meshData.indices.data(), GL_STATIC_DRAW );
+	PackedTerrainVertex::setupAttributes();
+	BufferCollection::bindZero( VAO | VBO | EBO );
+	meshData.clear();
 }
-
-/**
-* @brief plain ctor
-*/
-ShoreGenerator::ShoreVertex::ShoreVertex( glm::vec3 position, 
-										  glm::vec2 texCoords, 
-										  glm::vec3 normal ) noexcept
-	: position{ position.x - HALF_WORLD_WIDTH, position.y, position.z - HALF_WORLD_HEIGHT }
-	, texCoords{ texCoords.x, texCoords.y }
-	, normal{ normal.x, normal.y, normal.z }
-{}
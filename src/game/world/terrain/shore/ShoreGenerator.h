@@ -14,7 +14,7 @@
  * GNU General Public License for more details.
  * See <http://www.gnu.org/licenses/>
  *
- * Purpose: contains declaration for ShoreGenerator class and ShoreVertex struct
+ * Purpose: contains declaration for ShoreGenerator class
  * @version 0.1.0
  */
 
@@ -22,8 +22,6 @@
 
 #include "Generator"
 
-#include <random>
-
 /**
 * @brief generator for shore data on world map. This one has additional normal map storage for smooth shading
 */
@@ -32,34 +30,13 @@ class ShoreGenerator : public Generator
 public:
 	ShoreGenerator( const map2D_f & waterMap );
 	void setup();
+	void createTilesAndMeshData();
+	void uploadMeshData();
 
 private:
 	friend class ShoreRenderer;
 	friend class ShoreFacade;
 
-	/**
-	* @brief representation of a shore vertex as it is in the shore shader
-	*/
-	struct ShoreVertex
-	{
-		constexpr static unsigned int NUMBER_OF_ELEMENTS = 8;
-		ShoreVertex( glm::vec3 position, 
-					 glm::vec2 texCoords, 
-					 glm::vec3 normal ) noexcept;
-		struct
-		{
-			float x, y, z;
-		} position;
-		struct
-		{
-			float x, y;
-		} texCoords;
-		struct
-		{
-			float x, y, z;
-		} normal;
-	};
-
 	void generateMap();
 	void shapeShoreProfile();
 	void randomizeShore();
@@ -67,12 +44,8 @@ private:
 	void applySlopeToProfile( float ratio ) noexcept;
 	void removeUnderwaterTiles( float thresholdValue );
 	void createTiles();
-	void fillBufferData();
-	void bufferVertex( GLfloat * vertices, 
-					   int offset, 
-					   ShoreVertex vertex ) noexcept;
+	void prepareMeshData();
 
 	const map2D_f & waterMap;
 	map2D_vec3 normalMap;
-	std::default_random_engine randomizer;
 };
@@ -32,11 +32,12 @@ ShoreRenderer::ShoreRenderer( ShoreGenerator & generator ) noexcept
 
 /**
 * @brief sends draw call to OpenGL
+* @param useFrustumCulling indicator of whether to draw only the chunks which passed frustum culling
 */
-void ShoreRenderer::render()
+void ShoreRenderer::render( bool useFrustumCulling )
 {
-	generator.basicGLBuffers.bind( VAO );
-	glDrawElements( GL_TRIANGLES, generator.tiles.size() * VERTICES_PER_QUAD, GL_UNSIGNED_INT, 0 );
+	generator.basicGLBuffers.bind( VAO | DIBO );
+	generator.levelsOfDetail.draw( GL_TRIANGLES, useFrustumCulling );
 }
 
 /**
@@ -46,12 +47,12 @@ void ShoreRenderer::render()
 */
 void ShoreRenderer::debugRender( GLenum primitiveType )
 {
-	generator.basicGLBuffers.bind( VAO );
+	generator.basicGLBuffers.bind( VAO | DIBO );
 	glLineWidth( 2.0f );
 	RendererState::disableState( GL_CULL_FACE );
-	glPolygonMode( GL_FRONT_AND_BACK, GL_LINE );
-	glDrawElements( primitiveType, generator.tiles.size() * VERTICES_PER_QUAD, GL_UNSIGNED_INT, 0 );
-	glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
+	RendererState::setPolygonMode( GL_LINE );
+	generator.levelsOfDetail.draw( primitiveType, false );
+	RendererState::setPolygonMode( GL_FILL );
 	RendererState::enableState( GL_CULL_FACE );
 	glLineWidth( 1.0f );
 }
@@ -31,7 +31,7 @@ class ShoreRenderer
 {
 public:
 	ShoreRenderer( ShoreGenerator & generator ) noexcept;
-	void render();
+	void render( bool useFrustumCulling );
 	void debugRender( GLenum primitiveType );
 
 private:
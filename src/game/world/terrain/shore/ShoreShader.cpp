@@ -33,41 +33,28 @@ ShoreShader::ShoreShader( Shader & renderShader,
 {}
 
 /**
-* @brief updates shader program uniforms
-* @param lightDir sunlight direction vector
-* @param lightSpaceMatrices array of "projection * view" matrices from the Sun point of view
-* @param projectionView "projection * view" matrix
+* @brief updates shader program uniforms, camera, lighting and shadow data come from the frame uniform blocks
 * @param useShadows indicator of whether shadows should be calculated
 * @param useClipDistanceReflection indicator of whether clip distance will be used by OpenGL for reflection rendering
 * @param useClipDistanceRefraction indicator of whether clip distance will be used by OpenGL for refraction rendering
 */
-void ShoreShader::update( const glm::vec3 & lightDir,
-						  const std::array<glm::mat4, NUM_SHADOW_LAYERS> & lightSpaceMatrices,
-						  const glm::mat4 & projectionView,
-						  bool useShadows,
+void ShoreShader::update( bool useShadows,
 						  bool useClipDistanceReflection,
 						  bool useClipDistanceRefraction )
 {
 	renderShader.use();
-	renderShader.setMat4( "u_projectionView", projectionView );
 	renderShader.setBool( "u_shadowEnable", useShadows );
-	renderShader.setVec3( "u_lightDir", -lightDir );
-	renderShader.setMat4( "u_lightSpaceMatrix[0]", lightSpaceMatrices[0] );
-	renderShader.setMat4( "u_lightSpaceMatrix[1]", lightSpaceMatrices[1] );
-	renderShader.setMat4( "u_lightSpaceMatrix[2]", lightSpaceMatrices[2] );
 	renderShader.setBool( "u_useClipDistanceReflection", useClipDistanceReflection );
 	renderShader.setBool( "u_useClipDistanceRefraction", useClipDistanceRefraction );
 }
 
 /**
-* @brief updates normals shader program uniforms
-* @param projectionView "projection * view" matrix
+* @brief prepares normals shader program, its only uniform (projectionView) comes from the camera block
 * @todo remove this in release version of the game
 */
-void ShoreShader::updateNormals( const glm::mat4 & projectionView )
+void ShoreShader::updateNormals()
 {
 	normalsShader.use();
-	normalsShader.setMat4( "u_projectionView", projectionView );
 }
 
 /**
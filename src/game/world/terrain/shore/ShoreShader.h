@@ -20,12 +20,6 @@
 
 #pragma once
 
-#include "GraphicsConstants"
-
-#include <glm/mat4x4.hpp>
-#include <glm/vec3.hpp>
-#include <array>
-
 class Shader;
 
 /**
@@ -36,13 +30,10 @@ class ShoreShader
 public:
 	ShoreShader( Shader & renderShader, 
 				 Shader & normalsShader ) noexcept;
-	void update( const glm::vec3 & lightDir,
-				 const std::array<glm::mat4, NUM_SHADOW_LAYERS> & lightSpaceMatrices,
-				 const glm::mat4 & projectionView,
-				 bool useShadows,
+	void update( bool useShadows,
 				 bool useClipDistanceReflection,
 				 bool useClipDistanceRefraction );
-	void updateNormals( const glm::mat4 & projectionView );
+	void updateNormals();
 	void debugRenderMode( bool enable );
 
 private:
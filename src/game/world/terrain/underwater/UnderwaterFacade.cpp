@@ -32,14 +32,10 @@ UnderwaterFacade::UnderwaterFacade( Shader & renderShader ) noexcept
 
 /**
 * @brief handles rendering routine
-* @param lightDir sunlight direction vector
-* @param projectionView "projection * view" matrix
 * @param useDesaturation define whether to apply desaturation
 */
-void UnderwaterFacade::draw( const glm::vec3 & lightDir,
-							 const glm::mat4 & projectionView,
-							 bool useDesaturation )
+void UnderwaterFacade::draw( bool useDesaturation )
 {
-	shader.update( lightDir, projectionView, useDesaturation );
+	shader.update( useDesaturation );
 	renderer.render();
 }
@@ -20,9 +20,6 @@
 
 #pragma once
 
-#include <glm/vec3.hpp>
-#include <glm/mat4x4.hpp>
-
 class Shader;
 
 /**
@@ -33,9 +30,7 @@ class UnderwaterShader
 {
 public:
 	UnderwaterShader( Shader & renderShader ) noexcept;
-	void update( const glm::vec3 & lightDir, 
-				 const glm::mat4 & projectionView, 
-				 bool useDesaturation );
+	void update( bool useDesaturation );
 
 private:
 	Shader & renderShader;
@@ -23,14 +23,12 @@
 /**
 * @brief plain ctor
 * @param renderShader shader program used for onscreen rendering
-* @param cullingShader shader program used for offscreen rendering with frustum culling
 * @param normalsShader shader program used for onscreen rendering of water normals
 */
 WaterFacade::WaterFacade( Shader & renderShader, 
-						  Shader & cullingShader, 
 						  Shader & normalsShader )
-	: shaders( renderShader, cullingShader, normalsShader )
-	, generator( shaders )
+	: shaders( renderShader, normalsShader )
+	, generator()
 	, renderer( shaders, generator )
 {}
 
@@ -43,12 +41,13 @@ void WaterFacade::setup()
 }
 
 /**
-* @brief delegates map post-process routine to generator
+* @brief delegates map post-process routine to generator and uploads generated mesh to GPU
 * @param landMap map of the lands
 */
 void WaterFacade::setupConsiderTerrain( const map2D_f & landMap )
 {
 	generator.setupConsiderTerrain( landMap );
+	generator.uploadMeshData();
 }
 
 /**
@@ -69,30 +68,59 @@ void WaterFacade::deserialize( std::ifstream & input )
 	generator.deserialize( input );
 }
 
+/**
+* @brief delegates binary serialization call to generator
+* @param writer world file writer
+*/
+void WaterFacade::serialize( WorldFileWriter & writer ) const
+{
+	generator.serialize( writer );
+}
+
+/**
+* @brief delegates binary section reading call to generator
+* @param section world file section to read data from
+* @param savedMap view of the saved map
+*/
+bool WaterFacade::read( WorldFileSection & section,
+						Heightfield2DView<const float> & savedMap ) const noexcept
+{
+	return generator.read( section, savedMap );
+}
+
+/**
+* @brief delegates binary deserialization call to generator
+* @param savedMap view of the saved map previously read from the world file
+*/
+void WaterFacade::deserialize( Heightfield2DView<const float> savedMap )
+{
+	generator.deserialize( savedMap );
+}
+
+/**
+* @brief selects levels of detail of the water chunks for the current frame and culls chunks outside the frustum
+* @param viewPosition position of the camera
+* @param projectionScale number of pixels a unit long segment takes on the screen at a unit distance from the camera
+* @param pixelError maximum allowed error of the coarse levels projected to the screen (in pixels)
+* @param cullingFrustum frustum to test water chunks against
+*/
+void WaterFacade::updateLevelsOfDetail( const glm::vec3 & viewPosition,
+										float projectionScale,
+										float pixelError,
+										const Frustum & cullingFrustum )
+{
+	generator.updateLevelsOfDetail( viewPosition, projectionScale, pixelError, cullingFrustum );
+}
+
 /**
 * @brief handles water drawing routine: prepares shader and delegates draw command to renderer
-* @param lightDir sunlight direction vector
-* @param lightSpaceMatrices array of "projection * view" matrices from the Sun point of view
-* @param projectionView "projection * view" matrix
-* @param viewPosition player's camera current position
-* @param viewFrustum player's camera view frustum
-* @param useFrustumCulling defines whether frustum culling mode is on
+* @param useFrustumCulling defines whether to draw only the chunks which passed frustum culling
 * @param useDebugRender defines whether debug rendering mode is on
 */
-void WaterFacade::draw( const glm::vec3 & lightDir,
-						const std::array<glm::mat4, NUM_SHADOW_LAYERS> & lightSpaceMatrices,
-						const glm::mat4 & projectionView,
-						const glm::vec3 & viewPosition,
-						const Frustum & viewFrustum,
-						bool useFrustumCulling,
+void WaterFacade::draw( bool useFrustumCulling,
 						bool useDebugRender )
 {
-	shaders.update( lightDir,
-					lightSpaceMatrices,
-					projectionView,
-					viewPosition,
-					viewFrustum,
-					useFrustumCulling );
+	shaders.update();
 	shaders.debugRenderMode( false );
 	renderer.render( useFrustumCulling );
 
@@ -101,7 +129,7 @@ void WaterFacade::draw( const glm::vec3 & lightDir,
 	{
 		shaders.debugRenderMode( true );
 		renderer.debugRender( GL_TRIANGLES );
-		shaders.updateNormals( projectionView );
+		shaders.updateNormals();
 		renderer.debugRender( GL_POINTS );
 	}
 }
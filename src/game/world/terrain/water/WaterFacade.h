@@ -32,18 +32,20 @@ class WaterFacade
 {
 public:
 	WaterFacade( Shader & renderShader, 
-				 Shader & cullingShader, 
 				 Shader & normalsShader );
 	void setup();
 	void setupConsiderTerrain( const map2D_f & landMap );
 	void serialize( std::ofstream & output );
 	void deserialize( std::ifstream & input );
-	void draw( const glm::vec3 & lightDir,
-			   const std::array<glm::mat4, NUM_SHADOW_LAYERS> & lightSpaceMatrices,
-			   const glm::mat4 & projectionView,
-			   const glm::vec3 & viewPosition,
-			   const Frustum & viewFrustum,
-			   bool useFrustumCulling,
+	void serialize( WorldFileWriter & writer ) const;
+	bool read( WorldFileSection & section,
+			   Heightfield2DView<const float> & savedMap ) const noexcept;
+	void deserialize( Heightfield2DView<const float> savedMap );
+	void updateLevelsOfDetail( const glm::vec3 & viewPosition,
+							   float projectionScale,
+							   float pixelError,
+							   const Frustum & cullingFrustum );
+	void draw( bool useFrustumCulling,
 			   bool useDebugRender );
 	const map2D_f & getMap() const noexcept;
 	bool hasWaterInFrame() const noexcept;
@@ -19,17 +19,15 @@
  */
 
 #include "WaterGenerator"
-#include "WaterShader"
 #include "SettingsManager"
+#include "UploadManager"
 
 /**
 * @brief plain ctor
-* @param shaders water shader manager
 */
-WaterGenerator::WaterGenerator( WaterShader & shaders )
+WaterGenerator::WaterGenerator()
 	: Generator()
-	, culledBuffers( VAO | VBO | TFBO )
-	, shaders( shaders )
+	, numTiles( 0 )
 {}
 
 /**
@@ -37,7 +35,8 @@ WaterGenerator::WaterGenerator( WaterShader & shaders )
 */
 void WaterGenerator::setup()
 {
-	generateMap();
+	uint32_t attempt = 0;
+	generateMap( attempt );
 
 	//if there are too little or too much water in the map - try generation again
 	const int RIVER_WIDTH_BASE = SettingsManager::getInt( "SCENE", "river_width_base" );
@@ -45,13 +44,13 @@ void WaterGenerator::setup()
 		   numTiles > WORLD_WIDTH * ( RIVER_WIDTH_BASE + 3 ) * ( RIVER_WIDTH_BASE + 3 ) * 9 )
 	{
 		initializeMap( map );
-		generateMap();
+		generateMap( ++attempt );
 	}
 }
 
 /**
 * @brief additional post-process generation routine. Once we have shores smoothened, we should recalculate water
-* in order to eliminate gaps between water and shores
+* in order to eliminate gaps between water and shores. Makes no OpenGL calls, mesh data is to be uploaded separately
 * @param landMap map of the lands
 */
 void WaterGenerator::setupConsiderTerrain( const map2D_f & landMap )
@@ -78,7 +77,7 @@ void WaterGenerator::setupConsiderTerrain( const map2D_f & landMap )
 	}
 
 	createTiles();
-	fillBufferData();
+	prepareMeshData();
 }
 
 /**
@@ -108,33 +107,29 @@ void WaterGenerator::createTiles()
 }
 
 /**
-* @brief for each tile creates set of vertices, buffers them to GPU. Prepares buffer collections layouts and bindings
+* @brief for each tile creates set of vertices and indices in the CPU side mesh data storage.
+* Water surface is flat, animation offset of a vertex is derived from its grid position in the shader
 */
-void WaterGenerator::fillBufferData()
+void WaterGenerator::prepareMeshData()
 {
-	numVertices = tiles.size() * UNIQUE_VERTICES_PER_TILE * WaterVertex::NUMBER_OF_ELEMENTS;
-	std::unique_ptr<GLfloat[]> vertices( new GLfloat[numVertices] );
+	const glm::vec3 NORMAL_UP( 0.0f, 1.0f, 0.0f );
 	const size_t INDICES_DATA_LENGTH = tiles.size() * VERTICES_PER_QUAD;
-	std::unique_ptr<GLuint[]> indices( new GLuint[INDICES_DATA_LENGTH] );
 	size_t indicesBufferIndex = 0;
+	meshData.clear();
+	meshData.packedVertices.reserve( tiles.size() * UNIQUE_VERTICES_PER_TILE );
+	meshData.indices.resize( INDICES_DATA_LENGTH );
+	GLuint * indices = meshData.indices.data();
 
 	for( unsigned int tileIndex = 0; tileIndex < tiles.size(); tileIndex++ )
 	{
 		TerrainTile & tile = tiles[tileIndex];
 		int x = tile.mapX, y = tile.mapY;
 
-		//create set of vertices according to a tile
-		WaterVertex lowLeft( glm::vec3( x - 1, tile.lowLeft, y ), glm::vec2( x - 1, y ) );
-		WaterVertex lowRight( glm::vec3( x, tile.lowRight, y ), glm::vec2( x, y ) );
-		WaterVertex upRight( glm::vec3( x, tile.upperRight, y - 1 ), glm::vec2( x, y - 1 ) );
-		WaterVertex upLeft( glm::vec3( x - 1, tile.upperLeft, y - 1 ), glm::vec2( x - 1, y - 1 ) );
-
 		//buffer vertices to local storage
-		int vertexBufferOffset = tileIndex * UNIQUE_VERTICES_PER_TILE * WaterVertex::NUMBER_OF_ELEMENTS;
-		bufferVertex( vertices.get(), vertexBufferOffset + WaterVertex::NUMBER_OF_ELEMENTS * 0, lowLeft );
-		bufferVertex( vertices.get(), vertexBufferOffset + WaterVertex::NUMBER_OF_ELEMENTS * 1, lowRight );
-		bufferVertex( vertices.get(), vertexBufferOffset + WaterVertex::NUMBER_OF_ELEMENTS * 2, upRight );
-		bufferVertex( vertices.get(), vertexBufferOffset + WaterVertex::NUMBER_OF_ELEMENTS * 3, upLeft );
+		meshData.packedVertices.emplace_back( x - 1, y, tile.lowLeft, NORMAL_UP );
+		meshData.packedVertices.emplace_back( x, y, tile.lowRight, NORMAL_UP );
+		meshData.packedVertices.emplace_back( x, y - 1, tile.upperRight, NORMAL_UP );
+		meshData.packedVertices.emplace_back( x - 1, y - 1, tile.upperLeft, NORMAL_UP );
 
 		//buffer indices to local storage
 		GLuint indicesBufferBaseVertex = tileIndex * UNIQUE_VERTICES_PER_TILE;
@@ -145,30 +140,24 @@ void WaterGenerator::fillBufferData()
 		indices[indicesBufferIndex++] = indicesBufferBaseVertex + 3;
 		indices[indicesBufferIndex++] = indicesBufferBaseVertex + 0;
 	}
-	//buffer vertices and indices from local storage to GPU
-	basicGLBuffers.bind( VAO | VBO | EBO );
-	glBufferData( GL_ARRAY_BUFFER, numVertices * sizeof( GLfloat ), vertices.get(), GL_STREAM_DRAW );
-	glBufferData( GL_ELEMENT_ARRAY_BUFFER, sizeof( GLuint ) * INDICES_DATA_LENGTH, indices.get(), GL_STATIC_DRAW );
-	setupVBOAttributes();
+	//surface is flat, coarse quads lose only the waves whose neighbouring vertices might move in opposite directions
+	levelsOfDetail.build( tiles, meshData, 2.0f * WAVE_AMPLITUDE );
+}
 
-	//prepare buffer collection used for frustum culling
-	if( culledBuffers.get( VAO ) != 0 )
-	{
-		culledBuffers.deleteBuffers();
-		culledBuffers.create( VAO | VBO | TFBO );
-	}
-	culledBuffers.bind( VAO | VBO | TFBO );
-	/*
-	 * after transform feedback we have 1.5 times more data to buffer in GL_ARRAY_BUFFER
-	 * (6 indices of 4 vertices transforms into 6 vertices, 2 of them have the same attributes)
-	 * because of duplication of vertices that have same attributes but different indices
-	 */
-	const GLsizeiptr CULLED_DATA_SIZE_BYTES = (GLsizeiptr)( (float)numVertices * 1.5f ) * sizeof( GLfloat );
-	glNamedBufferStorage( culledBuffers.get( VBO ), CULLED_DATA_SIZE_BYTES, 0, GL_NONE );
-	setupVBOAttributes();
-	shaders.setupCulling();
-	glTransformFeedbackBufferBase( culledBuffers.get( TFBO ), 0, culledBuffers.get( VBO ) );
+/**
+* @brief buffers previously prepared mesh data to GPU and releases it. Prepares buffer collection layout and bindings,
+* indirect buffer is filled each frame with draw commands of the selected levels of detail
+*/
+void WaterGenerator::uploadMeshData()
+{
+	createBuffersOnFirstUse( basicGLBuffers, VAO | VBO | EBO | DIBO );
+	basicGLBuffers.bind( VAO | VBO | EBO );
+	UploadManager & uploadManager = UploadManager::getInstance();
+	uploadManager.uploadBufferData( basicGLBuffers.get( VBO ), sizeof( PackedTerrainVertex ) * meshData.packedVertices.size(), meshData.packedVertices.data(), GL_STREAM_DRAW );
+	uploadManager.uploadBufferData( basicGLBuffers.get( EBO ), sizeof( GLuint ) * meshData.indices.size(), meshData.indices.data(), GL_STATIC_DRAW );
+	PackedTerrainVertex::setupAttributes();
 	BufferCollection::bindZero( VAO | VBO | EBO );
+	meshData.clear();
 }
 
 /**
@@ -255,17 +244,19 @@ void WaterGenerator::expandWaterArea()
 
 /**
 * @brief generates data for water on the world map
+* @param attempt number of generation attempt, each attempt uses its own random stream to get a different river
 */
-void WaterGenerator::generateMap()
+void WaterGenerator::generateMap( uint32_t attempt )
 {
 	const float WATER_LEVEL = SettingsManager::getFloat( "SCENE", "water_level" );
 	const bool BIZARRE_GENERATION_MODE = SettingsManager::getBool( "SCENE", "river_generation_bizarre_mode" );
 	numTiles = 0;
-	const bool START_FROM_X_AXIS = rand() % 2 == 0;
+	riverRandom = RandomStream( RANDOM_STREAM_WATER, 0, 0, attempt );
+	const bool START_FROM_X_AXIS = riverRandom.nextUint( 2 ) == 0;
 	bool riverEnd = false;
-	unsigned int curveMaxDistance = rand() % RIVER_DIRECTION_CHANGE_DELAY + RIVER_DIRECTION_CHANGE_DELAY;
+	unsigned int curveMaxDistance = riverRandom.nextUint( RIVER_DIRECTION_CHANGE_DELAY ) + RIVER_DIRECTION_CHANGE_DELAY;
 	unsigned int curveDistanceStep = 0;
-	const unsigned int START_COORD = rand() % WORLD_HEIGHT;
+	const unsigned int START_COORD = riverRandom.nextUint( WORLD_HEIGHT );
 	int x = START_FROM_X_AXIS ? START_COORD : 0;
 	int y = START_FROM_X_AXIS ? 0 : START_COORD;
 	DIRECTION riverDirection = START_FROM_X_AXIS ? DOWN : RIGHT;
@@ -294,9 +285,9 @@ void WaterGenerator::generateMap()
 	};
 	auto applyCustomOffset = [&]( int & coord, int coordUpperLimit )
 	{
-		if( rand() % 4 == 0 )
+		if( riverRandom.nextUint( 4 ) == 0 )
 		{
-			coord += rand() % 2 == 0 ? 2 : -2;
+			coord += riverRandom.nextUint( 2 ) == 0 ? 2 : -2;
 			clampRiverCoord( coord, 0, coordUpperLimit );
 		}
 	};
@@ -304,6 +295,9 @@ void WaterGenerator::generateMap()
 	while( !riverEnd )
 	{
 		++curveDistanceStep;
+		//diagonal offsets are drawn beforehand as evaluation order of function arguments is unspecified
+		const int DIAGONAL_OFFSET_X = riverRandom.nextUint( 2 );
+		const int DIAGONAL_OFFSET_Y = riverRandom.nextUint( 2 );
 		switch( riverDirection )
 		{
 		case UP:
@@ -314,7 +308,7 @@ void WaterGenerator::generateMap()
 		}
 		case UP_RIGHT:
 		{
-			coordUpdateFunction( rand() % 2, -( rand() % 2 ) );
+			coordUpdateFunction( DIAGONAL_OFFSET_X, -DIAGONAL_OFFSET_Y );
 			break;
 		}
 		case RIGHT:
@@ -325,7 +319,7 @@ void WaterGenerator::generateMap()
 		}
 		case DOWN_RIGHT:
 		{
-			coordUpdateFunction( rand() % 2, rand() % 2 );
+			coordUpdateFunction( DIAGONAL_OFFSET_X, DIAGONAL_OFFSET_Y );
 			break;
 		}
 		case DOWN:
@@ -336,7 +330,7 @@ void WaterGenerator::generateMap()
 		}
 		case DOWN_LEFT:
 		{
-			coordUpdateFunction( -( rand() % 2 ), rand() % 2 );
+			coordUpdateFunction( -DIAGONAL_OFFSET_X, DIAGONAL_OFFSET_Y );
 			break;
 		}
 		case LEFT:
@@ -347,7 +341,7 @@ void WaterGenerator::generateMap()
 		}
 		case UP_LEFT:
 		{
-			coordUpdateFunction( -( rand() % 2 ), -( rand() % 2 ) );
+			coordUpdateFunction( -DIAGONAL_OFFSET_X, -DIAGONAL_OFFSET_Y );
 			break;
 		}
 		}
@@ -400,8 +394,8 @@ void WaterGenerator::setNewDirection( unsigned int & curveDistanceStep,
 	NEXT_DIRECTIONS nextPossibleDirections = getNextPossibleDirections( currentDirection );
 
 	curveDistanceStep = 0;
-	curveMaxDistance = rand() % RIVER_DIRECTION_CHANGE_DELAY + RIVER_DIRECTION_CHANGE_DELAY;
-	currentDirection = rand() % 2 == 0 ? nextPossibleDirections.first : nextPossibleDirections.second;
+	curveMaxDistance = riverRandom.nextUint( RIVER_DIRECTION_CHANGE_DELAY ) + RIVER_DIRECTION_CHANGE_DELAY;
+	currentDirection = riverRandom.nextUint( 2 ) == 0 ? nextPossibleDirections.first : nextPossibleDirections.second;
 }
 
 /**
@@ -420,10 +414,10 @@ void WaterGenerator::fattenKernel( int x,
 {
 	//calculate area coordinates to add water to
 	const int RIVER_WIDTH_BASE = SettingsManager::getInt( "SCENE", "river_width_base" );
-	int shoreSizeYT = rand() % 2 + RIVER_WIDTH_BASE;
-	int shoreSizeYB = rand() % 2 + RIVER_WIDTH_BASE;
-	int shoreSizeXL = rand() % 2 + RIVER_WIDTH_BASE;
-	int shoreSizeXR = rand() % 2 + RIVER_WIDTH_BASE;
+	int shoreSizeYT = riverRandom.nextUint( 2 ) + RIVER_WIDTH_BASE;
+	int shoreSizeYB = riverRandom.nextUint( 2 ) + RIVER_WIDTH_BASE;
+	int shoreSizeXL = riverRandom.nextUint( 2 ) + RIVER_WIDTH_BASE;
+	int shoreSizeXR = riverRandom.nextUint( 2 ) + RIVER_WIDTH_BASE;
 
 	//check if we need to update width offset 
 	const unsigned int RIVER_SIZE_TO_INCREASE_COUNTER = 19;
@@ -492,40 +486,3 @@ void WaterGenerator::fatternKernelBizarreMode( int x,
 		}
 	}
 }
-
-/**
-* @brief helper function that buffers a vertex to local storage
-* @param vertices local buffer
-* @param offset index offset of buffer
-* @param vertex water vertex to be buffered
-*/
-void WaterGenerator::bufferVertex( GLfloat * vertices, 
-								   int offset, 
-								   WaterVertex vertex ) noexcept
-{
-	vertices[offset + 0] = vertex.position.x;
-	vertices[offset + 1] = vertex.position.y;
-	vertices[offset + 2] = vertex.position.z;
-	vertices[offset + 3] = vertex.animationOffset;
-}
-
-/**
-* @brief helper function that sets appropriate layout for vertex data on the OpenGL side
-*/
-void WaterGenerator::setupVBOAttributes() noexcept
-{
-	const size_t SIZE_OF_WATER_VERTEX = WaterVertex::NUMBER_OF_ELEMENTS * sizeof( GLfloat );
-	glEnableVertexAttribArray( 0 );
-	glVertexAttribPointer( 0, WaterVertex::NUMBER_OF_ELEMENTS, GL_FLOAT, GL_FALSE, SIZE_OF_WATER_VERTEX, 0 );
-}
-
-/**
-* @brief plain ctor
-* @param position water vertex XYZ position
-* @param animOffsetVec pair of XZ position dependent values crunched into an offset value for water animation
-*/
-WaterGenerator::WaterVertex::WaterVertex( glm::vec3 position, 
-										  glm::vec2 animOffsetVec ) noexcept
-	: position{ position.x - HALF_WORLD_WIDTH, position.y, position.z - HALF_WORLD_HEIGHT }
-	, animationOffset( animOffsetVec.x * X_POS_ANIM_MULTIPLIER + animOffsetVec.y * ( animOffsetVec.x + X_POS_ANIM_OFFSET ) )
-{}
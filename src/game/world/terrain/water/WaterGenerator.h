@@ -21,50 +21,35 @@
 #pragma once
 
 #include "Generator"
-
-class WaterShader;
+#include "RandomStream"
 
 /**
 * @brief generator for water on the world map.
-* Responsible for creating water map, preparing buffer collections
+* Responsible for creating water map, preparing mesh data with levels of detail and buffer collections
 */
 class WaterGenerator : public Generator
 {
 public:
-	WaterGenerator( WaterShader & shaders );
+	WaterGenerator();
 	void setup();
 	void setupConsiderTerrain( const map2D_f & landMap );
 	void createTiles();
+	void prepareMeshData();
+	void uploadMeshData();
 
 private:
 	constexpr static unsigned int RIVER_DIRECTION_CHANGE_DELAY = 48;
+	/** @note should match the amplitude of the animation in the water vertex shader */
+	constexpr static float WAVE_AMPLITUDE = 0.0825f;
 
 	friend class WaterRenderer;
 
-	/**
-	* @brief representation of a water vertex as it is in water shader
-	*/
-	struct WaterVertex
-	{
-		constexpr static unsigned int NUMBER_OF_ELEMENTS = 4;
-		constexpr static float X_POS_ANIM_MULTIPLIER = 15.11f;
-		constexpr static float X_POS_ANIM_OFFSET = 121.197f;
-		WaterVertex( glm::vec3 position, 
-					 glm::vec2 animationOffset ) noexcept;
-
-		struct
-		{
-			float x, y, z;
-		} position;
-		float animationOffset;
-	};
-
 	enum DIRECTION : int
 	{
 		UP = 0, UP_RIGHT, RIGHT, DOWN_RIGHT, DOWN, DOWN_LEFT, LEFT, UP_LEFT, NUM_DIRECTIONS
 	};
 
-	void generateMap();
+	void generateMap( uint32_t attempt );
 	void expandWaterArea();
 	void setNewDirection( unsigned int & curveDistanceStep,
 						  unsigned int & curveMaxDistance,
@@ -76,16 +61,9 @@ private:
 					   bool & riverWidthIncrease );
 	void fatternKernelBizarreMode( int x,
 								   int y );
-	void bufferVertex( GLfloat * vertices, 
-					   int offset, 
-					   WaterVertex vertex ) noexcept;
-	void setupVBOAttributes() noexcept;
-	void fillBufferData();
 
-	/** @note additional buffer collection containing data from transform feedback rendering */
-	BufferCollection culledBuffers;
-	WaterShader & shaders;
-	size_t numVertices;
 	size_t numTiles;
 	map2D_f postProcessMap;
+	/** @note river is generated sequentially step by step, so it uses single stream for the whole river */
+	RandomStream riverRandom;
 };
@@ -37,56 +37,24 @@ WaterRenderer::WaterRenderer( WaterShader & shaders,
 {}
 
 /**
-* @brief handles water rendering process
-* @param useFrustumCulling defines whether frustum culling mode of rendering is currently used
+* @brief handles water rendering process, chunks are culled on the CPU side while selecting levels of detail
+* @param useFrustumCulling defines whether to draw only the chunks which passed frustum culling
 */
 void WaterRenderer::render( bool useFrustumCulling )
 {
-	if( useFrustumCulling )
-	{
-		//firstly render plain data offscreen with bound transform feedback object
-		shaders.cullingShader.use();
-		generator.basicGLBuffers.bind( VAO );
-		GLuint transformFeedback = generator.culledBuffers.get( TFBO );
-		RendererState::enableState( GL_RASTERIZER_DISCARD );
-		glBindTransformFeedback( GL_TRANSFORM_FEEDBACK, transformFeedback );
-		glBeginTransformFeedback( GL_TRIANGLES );
-		glDrawElements( GL_TRIANGLES, generator.tiles.size() * VERTICES_PER_QUAD, GL_UNSIGNED_INT, 0 );
-		glEndTransformFeedback();
-		RendererState::disableState( GL_RASTERIZER_DISCARD );
-
-		shaders.renderShader.use();
-		generator.culledBuffers.bind( VAO );
+	shaders.renderShader.use();
+	generator.basicGLBuffers.bind( VAO | DIBO );
 
-		//optionally inject query into rendering process if necessary
-		if( !anySamplesPassedQuery.isInUse() )
-		{
-			anySamplesPassedQuery.start();
-			glDrawTransformFeedback( GL_TRIANGLES, transformFeedback );
-			anySamplesPassedQuery.end();
-		}
-		else
-		{
-			glDrawTransformFeedback( GL_TRIANGLES, transformFeedback );
-		}
+	//optionally inject query into rendering process if necessary
+	if( !anySamplesPassedQuery.isInUse() )
+	{
+		anySamplesPassedQuery.start();
+		generator.levelsOfDetail.draw( GL_TRIANGLES, useFrustumCulling );
+		anySamplesPassedQuery.end();
 	}
 	else
 	{
-		//just plain rendering without transform feedback
-		shaders.renderShader.use();
-		generator.basicGLBuffers.bind( VAO );
-
-		//optionally inject query into rendering process if necessary
-		if( !anySamplesPassedQuery.isInUse() )
-		{
-			anySamplesPassedQuery.start();
-			glDrawElements( GL_TRIANGLES, generator.tiles.size() * VERTICES_PER_QUAD, GL_UNSIGNED_INT, 0 );
-			anySamplesPassedQuery.end();
-		}
-		else
-		{
-			glDrawElements( GL_TRIANGLES, generator.tiles.size() * VERTICES_PER_QUAD, GL_UNSIGNED_INT, 0 );
-		}
+		generator.levelsOfDetail.draw( GL_TRIANGLES, useFrustumCulling );
 	}
 
 	if( anySamplesPassedQuery.isResultAvailable() )
@@ -102,12 +70,12 @@ void WaterRenderer::render( bool useFrustumCulling )
 */
 void WaterRenderer::debugRender( GLenum primitiveType )
 {
-	generator.basicGLBuffers.bind( VAO );
+	generator.basicGLBuffers.bind( VAO | DIBO );
 	glLineWidth( 2.0f );
 	RendererState::disableState( GL_CULL_FACE );
-	glPolygonMode( GL_FRONT_AND_BACK, GL_LINE );
-	glDrawElements( primitiveType, generator.tiles.size() * VERTICES_PER_QUAD, GL_UNSIGNED_INT, 0 );
-	glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
+	RendererState::setPolygonMode( GL_LINE );
+	generator.levelsOfDetail.draw( primitiveType, false );
+	RendererState::setPolygonMode( GL_FILL );
 	RendererState::enableState( GL_CULL_FACE );
 	glLineWidth( 1.0f );
 }
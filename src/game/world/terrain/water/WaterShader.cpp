@@ -19,7 +19,6 @@
  */
 
 #include "WaterShader"
-#include "Frustum"
 #include "Shader"
 
 #include <GLFW/glfw3.h>
@@ -27,64 +26,23 @@
 /**
 * @brief plain ctor
 * @param renderShader shader program used for plain onscreen rendering
-* @param cullingShader shader program used for offscreen rendering with frustum culling
 * @param normalsShader shader program used for onscreen rendering of water normals
 */
 WaterShader::WaterShader( Shader & renderShader, 
-						  Shader & cullingShader, 
 						  Shader & normalsShader ) noexcept
 	: renderShader( renderShader )
-	, cullingShader( cullingShader )
 	, normalsShader( normalsShader )
 {}
 
 /**
-* @brief update frustum culling shader program according to transform feedback usage
-* @note it is programmer's responsibility to keep client data matched with shader program itself
+* @brief updates shader program uniforms, camera, lighting and shadow data come from the frame uniform blocks
 */
-void WaterShader::setupCulling()
-{
-	const unsigned int TRANSFORM_FEEDBACK_OUTPUT_ATTRIBUTES_COUNT = 1;
-	const GLchar * varyings[TRANSFORM_FEEDBACK_OUTPUT_ATTRIBUTES_COUNT] = { "o_pos" };
-	glTransformFeedbackVaryings( cullingShader.getID(), TRANSFORM_FEEDBACK_OUTPUT_ATTRIBUTES_COUNT, varyings, GL_INTERLEAVED_ATTRIBS );
-	cullingShader.link();
-}
-
-/**
-* @brief updates shader program uniforms
-* @param lightDir sunlight direction vector
-* @param lightSpaceMatrices array of "projection * view" matrices from the Sun point of view
-* @param projectionView "projection * view" matrix
-* @param viewPosition position vector of the camera
-* @param viewFrustum view frustum of the camera
-* @param useFrustumCulling indicator of whether to use frustum culling when drawing
-*/
-void WaterShader::update( const glm::vec3 & lightDir,
-						  const std::array<glm::mat4, NUM_SHADOW_LAYERS> & lightSpaceMatrices,
-						  const glm::mat4 & projectionView,
-						  const glm::vec3 & viewPosition,
-						  const Frustum & viewFrustum,
-						  bool useFrustumCulling )
+void WaterShader::update()
 {
 	//declared static because this variable should keep its value from call to call
 	static float dudvMoveOffset = 0.0f;
-	if( useFrustumCulling )
-	{
-		cullingShader.use();
-		cullingShader.setVec4( "u_frustumPlanes[0]", viewFrustum.getPlane( FRUSTUM_LEFT ) );
-		cullingShader.setVec4( "u_frustumPlanes[1]", viewFrustum.getPlane( FRUSTUM_RIGHT ) );
-		cullingShader.setVec4( "u_frustumPlanes[2]", viewFrustum.getPlane( FRUSTUM_BOTTOM ) );
-		cullingShader.setVec4( "u_frustumPlanes[3]", viewFrustum.getPlane( FRUSTUM_TOP ) );
-		cullingShader.setVec4( "u_frustumPlanes[4]", viewFrustum.getPlane( FRUSTUM_BACK ) );
-	}
 	renderShader.use();
 	renderShader.setFloat( "u_time", glfwGetTime() );
-	renderShader.setMat4( "u_projectionView", projectionView );
-	renderShader.setVec3( "u_viewPosition", viewPosition );
-	renderShader.setVec3( "u_lightDir", -lightDir );
-	renderShader.setMat4( "u_lightSpaceMatrix[0]", lightSpaceMatrices[0] );
-	renderShader.setMat4( "u_lightSpaceMatrix[1]", lightSpaceMatrices[1] );
-	renderShader.setMat4( "u_lightSpaceMatrix[2]", lightSpaceMatrices[2] );
 	renderShader.setFloat( "u_dudvMoveOffset", dudvMoveOffset );
 
 	const float DUDV_ANIMATION_SPEED = 0.0004f;
@@ -96,14 +54,12 @@ void WaterShader::update( const glm::vec3 & lightDir,
 }
 
 /**
-* @brief updates uniforms of the shader program for normals rendering
-* @param projectionView "projection * view" matrix
+* @brief prepares normals shader program, its only uniform (projectionView) comes from the camera block
 * @todo remove this in release version of the game
 */
-void WaterShader::updateNormals( const glm::mat4 & projectionView )
+void WaterShader::updateNormals()
 {
 	normalsShader.use();
-	normalsShader.setMat4( "u_projectionView", projectionView );
 }
 
 /**
@@ -20,13 +20,6 @@
 
 #pragma once
 
-#include "GraphicsConstants"
-
-#include <array>
-#include <glm/mat4x4.hpp>
-#include <glm/vec3.hpp>
-
-class Frustum;
 class Shader;
 
 /**
@@ -36,23 +29,15 @@ class WaterShader
 {
 public:
 	WaterShader( Shader & renderShader, 
-				 Shader & cullingShader, 
 				 Shader & normalsShader ) noexcept;
-	void setupCulling();
-	void update( const glm::vec3 & lightDir,
-				 const std::array<glm::mat4, NUM_SHADOW_LAYERS> & lightSpaceMatrices,
-				 const glm::mat4 & projectionView,
-				 const glm::vec3 & viewPosition,
-				 const Frustum & viewFrustum,
-				 bool useFrustumCulling );
-	void updateNormals( const glm::mat4 & projectionView );
+	void update();
+	void updateNormals();
 	void debugRenderMode( bool enable );
 
 private:
 	friend class WaterRenderer;
 
 	Shader & renderShader;
-	Shader & cullingShader;
 	/** @todo remove this in release version of the game */
 	Shader & normalsShader;
 };
@@ -23,6 +23,7 @@
 #include "SceneSettings"
 #include "SettingsManager"
 #include "Timer"
+#include "WorldFile"
 
 #include <iomanip>
 #include <fstream>
@@ -439,6 +440,42 @@ void Camera::deserialize( std::ifstream & input )
 	Logger::log( "camera deserialized successfully\n" );
 }
 
+/**
+* @brief save all important state variables to the binary world file
+* @param writer world file writer
+*/
+void Camera::serialize( WorldFileWriter & writer ) const
+{
+	writer.write( position );
+	writer.write( pitch );
+	writer.write( yaw );
+	Logger::log( "camera serialized successfully\n" );
+}
+
+/**
+* @brief load state variables from the binary world file and update others dependent on them
+* @param section world file section to read data from
+*/
+bool Camera::deserialize( WorldFileSection & section )
+{
+	glm::vec3 savedPosition;
+	float savedPitch;
+	float savedYaw;
+	section.read( savedPosition );
+	section.read( savedPitch );
+	section.read( savedYaw );
+	if( section.isFailed() )
+	{
+		return false;
+	}
+	position = savedPosition;
+	pitch = savedPitch;
+	yaw = savedYaw;
+	updateDirectionVectors();
+	Logger::log( "camera deserialized successfully\n" );
+	return true;
+}
+
 /**
 * @brief calculates new front, right and up vectors based on pitch and yaw values
 */
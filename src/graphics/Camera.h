@@ -24,6 +24,9 @@
 
 #include <glm/gtc/matrix_transform.hpp>
 
+class WorldFileWriter;
+class WorldFileSection;
+
 enum CAMERA_MOVE_DIRECTION
 {
 	FORWARD,
@@ -82,6 +85,8 @@ public:
 	//file saving/loading stuff
 	void serialize( std::ofstream & output );
 	void deserialize( std::ifstream & input );
+	void serialize( WorldFileWriter & writer ) const;
+	bool deserialize( WorldFileSection & section );
 
 private:
 	const glm::vec3 WORLD_UP = glm::vec3( 0.0f, 1.0f, 0.0f );
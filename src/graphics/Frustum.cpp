@@ -19,10 +19,13 @@
  */
 
 #include "Frustum"
+#include "FrustumKernels"
 
 #include <algorithm>
 #include <glm/gtc/type_ptr.hpp>
 
+INSTRUCTION_SET Frustum::instructionSet = CpuFeatures::getInstructionSet();
+
 /**
 * @brief plain ctor. Initializes all the planes to zero vectors
 */
@@ -33,6 +36,7 @@ Frustum::Frustum() noexcept
 	{
 		planes.emplace_back( 0.0f );
 	}
+	planesSoA.fill( 0.0f );
 }
 
 /**
@@ -89,6 +93,14 @@ void Frustum::updateFrustum( const glm::mat4 & projectionView )
 	planes[FRUSTUM_FRONT].z = projectionViewElements[11] + projectionViewElements[10];
 	planes[FRUSTUM_FRONT].w = projectionViewElements[15] + projectionViewElements[14];
 	normalizePlane( FRUSTUM_FRONT );
+
+	for( unsigned int planeIndex = 0; planeIndex < NUMBER_OF_PLANES; planeIndex++ )
+	{
+		planesSoA[planeIndex] = planes[planeIndex].x;
+		planesSoA[NUMBER_OF_PLANES + planeIndex] = planes[planeIndex].y;
+		planesSoA[NUMBER_OF_PLANES * 2 + planeIndex] = planes[planeIndex].z;
+		planesSoA[NUMBER_OF_PLANES * 3 + planeIndex] = planes[planeIndex].w;
+	}
 }
 
 /**
@@ -209,7 +221,102 @@ bool Frustum::isInside( float x,
 	} );
 }
 
+/**
+* @brief checks whether axis aligned box is (at least partially) inside the frustum.
+* For each plane only the box corner lying furthest along the plane normal is tested
+* @param boundsMin minimum corner of the box
+* @param boundsMax maximum corner of the box
+*/
+bool Frustum::isBoxInside( const glm::vec3 & boundsMin,
+						   const glm::vec3 & boundsMax ) const
+{
+	return std::all_of( planes.begin(), planes.end(), [&]( const glm::vec4 & plane ) noexcept
+	{
+		const float FURTHEST_X = plane.x >= 0.0f ? boundsMax.x : boundsMin.x;
+		const float FURTHEST_Y = plane.y >= 0.0f ? boundsMax.y : boundsMin.y;
+		const float FURTHEST_Z = plane.z >= 0.0f ? boundsMax.z : boundsMin.z;
+		return plane.x * FURTHEST_X + plane.y * FURTHEST_Y + plane.z * FURTHEST_Z + plane.w > 0.0f;
+	} );
+}
+
+/**
+* @brief classifies axis aligned box against the frustum. For each plane the box corner lying furthest along the plane normal
+* tells whether the box is outside and the nearest one tells whether the box is completely in front of the plane
+* @param box box to test
+*/
+FRUSTUM_TEST_RESULT Frustum::testAABB( const AABB & box ) const noexcept
+{
+	FRUSTUM_TEST_RESULT result = FRUSTUM_INSIDE;
+	for( const glm::vec4 & plane : planes )
+	{
+		const float FURTHEST_X = plane.x >= 0.0f ? box.boundsMax.x : box.boundsMin.x;
+		const float FURTHEST_Y = plane.y >= 0.0f ? box.boundsMax.y : box.boundsMin.y;
+		const float FURTHEST_Z = plane.z >= 0.0f ? box.boundsMax.z : box.boundsMin.z;
+		if( !( plane.x * FURTHEST_X + plane.y * FURTHEST_Y + plane.z * FURTHEST_Z + plane.w > 0.0f ) )
+		{
+			return FRUSTUM_OUTSIDE;
+		}
+		const float NEAREST_X = plane.x >= 0.0f ? box.boundsMin.x : box.boundsMax.x;
+		const float NEAREST_Y = plane.y >= 0.0f ? box.boundsMin.y : box.boundsMax.y;
+		const float NEAREST_Z = plane.z >= 0.0f ? box.boundsMin.z : box.boundsMax.z;
+		if( !( plane.x * NEAREST_X + plane.y * NEAREST_Y + plane.z * NEAREST_Z + plane.w > 0.0f ) )
+		{
+			result = FRUSTUM_INTERSECTS;
+		}
+	}
+	return result;
+}
+
+/**
+* @brief classifies each of the given boxes against the frustum. Boxes are processed with SIMD kernels chosen at runtime
+* according to the CPU capabilities, leftover boxes (and CPUs without SSE4.1) are processed with the scalar test.
+* Results are exactly the same as the ones of testAABB
+* @param boxes boxes to test
+* @param numBoxes number of boxes
+* @param results output array of FRUSTUM_TEST_RESULT values, one per box
+*/
+void Frustum::testAABBs( const AABB * boxes,
+						 size_t numBoxes,
+						 unsigned char * results ) const noexcept
+{
+	static_assert( sizeof( AABB ) == sizeof( float ) * FrustumKernels::FLOATS_PER_BOX, "boxes must be tightly packed" );
+	size_t boxIndex = 0;
+#if CPU_FEATURES_X86
+	const float * BOXES_DATA = reinterpret_cast<const float*>( boxes );
+	switch( instructionSet )
+	{
+	case ISA_AVX2:
+		boxIndex = FrustumKernels::testAABBsAVX2( planesSoA.data(), BOXES_DATA, boxIndex, numBoxes, results );
+		break;
+	case ISA_SSE4:
+		boxIndex = FrustumKernels::testAABBsSSE4( planesSoA.data(), BOXES_DATA, boxIndex, numBoxes, results );
+		break;
+	default:
+		break;
+	}
+#endif
+	for( ; boxIndex < numBoxes; boxIndex++ )
+	{
+		results[boxIndex] = testAABB( boxes[boxIndex] );
+	}
+}
+
 const glm::vec4 & Frustum::getPlane( FRUSTUM_PLANE plane ) const
 {
 	return planes[plane];
 }
+
+INSTRUCTION_SET Frustum::getInstructionSet() noexcept
+{
+	return instructionSet;
+}
+
+/**
+* @brief restricts instruction set used by the batch box tests (e.g. to compare SIMD results against scalar ones)
+* @param instructionSet desired instruction set, clamped to the one supported by the CPU
+*/
+void Frustum::setInstructionSet( INSTRUCTION_SET instructionSet ) noexcept
+{
+	const INSTRUCTION_SET SUPPORTED_INSTRUCTION_SET = CpuFeatures::getInstructionSet();
+	Frustum::instructionSet = instructionSet < SUPPORTED_INSTRUCTION_SET ? instructionSet : SUPPORTED_INSTRUCTION_SET;
+}
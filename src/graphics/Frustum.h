@@ -23,8 +23,11 @@
 #include <glm/mat4x4.hpp>
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
+#include <array>
 #include <vector>
 
+#include "CpuFeatures"
+
 enum FRUSTUM_PLANE
 {
 	FRUSTUM_RIGHT = 0,
@@ -35,6 +38,25 @@ enum FRUSTUM_PLANE
 	FRUSTUM_TOP = 5
 };
 
+/**
+* @brief axis aligned box given by its minimum and maximum corners
+*/
+struct AABB
+{
+	glm::vec3 boundsMin;
+	glm::vec3 boundsMax;
+};
+
+/**
+* @brief result of a box test against the frustum
+*/
+enum FRUSTUM_TEST_RESULT : unsigned char
+{
+	FRUSTUM_OUTSIDE = 0,
+	FRUSTUM_INTERSECTS = 1,
+	FRUSTUM_INSIDE = 2
+};
+
 /**
 * @brief view frustum representation. Containing information about its planes and their intersection points
 */
@@ -55,7 +77,15 @@ public:
 				   float y, 
 				   float z, 
 				   float radius ) const;
+	bool isBoxInside( const glm::vec3 & boundsMin,
+					  const glm::vec3 & boundsMax ) const;
+	FRUSTUM_TEST_RESULT testAABB( const AABB & box ) const noexcept;
+	void testAABBs( const AABB * boxes,
+					size_t numBoxes,
+					unsigned char * results ) const noexcept;
 	const glm::vec4 & getPlane( FRUSTUM_PLANE plane ) const;
+	static INSTRUCTION_SET getInstructionSet() noexcept;
+	static void setInstructionSet( INSTRUCTION_SET instructionSet ) noexcept;
 
 private:
 	friend class ShadowVolume;
@@ -67,6 +97,9 @@ private:
 								  const glm::vec4 & rightOrLeft );
 
 	std::vector<glm::vec4> planes;
+	//planes coefficients in structure of arrays form (X of all the planes, then Y, Z and W) used by the batch box tests
+	std::array<float, NUMBER_OF_PLANES * 4> planesSoA;
+	static INSTRUCTION_SET instructionSet;
 	//8 vertices defined in the world space represents intersection points of frustum planes
 	//LL - low left (min X, max Z), LR - low right (max X, max Z), UR - up right (max X, min Z), UL - up left (min X, min Z)
 	glm::vec3 nearLL;
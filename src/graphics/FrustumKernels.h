@@ -0,0 +1,48 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * FrustumKernels.h
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains declarations of SIMD kernels of the frustum box tests
+ * @version 0.1.0
+ */
+
+
+#pragma once
+
+#include <cstddef>
+
+/**
+* @brief SIMD kernels of the batch frustum box tests. Planes are given in structure of arrays form
+* (X coefficients of all the planes followed by Y, Z and W ones), boxes are tightly packed minimum and maximum corners (6 floats per box).
+* Each kernel processes boxes starting from the given index while there are enough boxes left to fill the whole SIMD register
+* and returns the first unprocessed index. Results are FRUSTUM_TEST_RESULT values and match the scalar test exactly.
+* Kernels must never be called on CPUs not supporting their instruction set
+*/
+namespace FrustumKernels
+{
+	constexpr size_t FLOATS_PER_BOX = 6;
+
+	size_t testAABBsSSE4( const float * planes,
+						  const float * boxes,
+						  size_t boxIndex,
+						  size_t numBoxes,
+						  unsigned char * results ) noexcept;
+
+	size_t testAABBsAVX2( const float * planes,
+						  const float * boxes,
+						  size_t boxIndex,
+						  size_t numBoxes,
+						  unsigned char * results ) noexcept;
+};
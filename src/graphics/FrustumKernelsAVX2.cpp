@@ -0,0 +1,142 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * FrustumKernelsAVX2.cpp
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains definitions of AVX2 kernels of the frustum box tests
+ * @version 0.1.0
+ */
+
+
+#include "FrustumKernels"
+#include "Frustum"
+#include "CpuFeatures"
+
+#if CPU_FEATURES_X86
+
+#if defined( __GNUC__ ) && !defined( __clang__ )
+#pragma GCC target( "avx2" )
+#elif defined( __clang__ )
+#pragma clang attribute push( __attribute__( ( target( "avx2" ) ) ), apply_to = function )
+#endif
+
+#include <immintrin.h>
+#include <cstring>
+
+namespace FrustumKernels
+{
+	/**
+	* @brief loads first four floats of the given box and of the box four boxes further to the lower and upper halves of the register
+	*/
+	static inline __m256 loadBoxPair( const float * box ) noexcept
+	{
+		return _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_loadu_ps( box ) ), _mm_loadu_ps( box + FLOATS_PER_BOX * 4 ), 1 );
+	}
+
+	/**
+	* @brief transposes 4x4 matrices in the lower and upper halves of the given registers independently
+	*/
+	static inline void transposeHalves( __m256 & row0,
+										__m256 & row1,
+										__m256 & row2,
+										__m256 & row3 ) noexcept
+	{
+		const __m256 LOW01 = _mm256_unpacklo_ps( row0, row1 );
+		const __m256 LOW23 = _mm256_unpacklo_ps( row2, row3 );
+		const __m256 HIGH01 = _mm256_unpackhi_ps( row0, row1 );
+		const __m256 HIGH23 = _mm256_unpackhi_ps( row2, row3 );
+		row0 = _mm256_shuffle_ps( LOW01, LOW23, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+		row1 = _mm256_shuffle_ps( LOW01, LOW23, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+		row2 = _mm256_shuffle_ps( HIGH01, HIGH23, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+		row3 = _mm256_shuffle_ps( HIGH01, HIGH23, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+	}
+
+	/**
+	* @brief AVX2 version of the batch box test, eight boxes are tested at once
+	*/
+	size_t testAABBsAVX2( const float * planes,
+						  const float * boxes,
+						  size_t boxIndex,
+						  size_t numBoxes,
+						  unsigned char * results ) noexcept
+	{
+		constexpr unsigned int NUM_PLANES = Frustum::NUMBER_OF_PLANES;
+		const __m256 ZERO = _mm256_setzero_ps();
+		__m256 coefficients[NUM_PLANES][4];
+		__m256 positiveMasks[NUM_PLANES][3];
+		for( unsigned int planeIndex = 0; planeIndex < NUM_PLANES; planeIndex++ )
+		{
+			for( unsigned int component = 0; component < 4; component++ )
+			{
+				coefficients[planeIndex][component] = _mm256_set1_ps( planes[NUM_PLANES * component + planeIndex] );
+			}
+			for( unsigned int component = 0; component < 3; component++ )
+			{
+				positiveMasks[planeIndex][component] = _mm256_cmp_ps( coefficients[planeIndex][component], ZERO, _CMP_GE_OQ );
+			}
+		}
+		const __m256i INSIDE = _mm256_set1_epi32( FRUSTUM_INSIDE );
+
+		for( ; boxIndex + 8 <= numBoxes; boxIndex += 8 )
+		{
+			//lanes 0-3 hold the first four boxes and lanes 4-7 hold the last four boxes
+			const float * box = boxes + boxIndex * FLOATS_PER_BOX;
+			__m256 minX = loadBoxPair( box );
+			__m256 minY = loadBoxPair( box + FLOATS_PER_BOX );
+			__m256 minZ = loadBoxPair( box + FLOATS_PER_BOX * 2 );
+			__m256 maxX = loadBoxPair( box + FLOATS_PER_BOX * 3 );
+			transposeHalves( minX, minY, minZ, maxX );
+			__m256 unusedMinZ = loadBoxPair( box + 2 );
+			__m256 unusedMaxX = loadBoxPair( box + FLOATS_PER_BOX + 2 );
+			__m256 maxY = loadBoxPair( box + FLOATS_PER_BOX * 2 + 2 );
+			__m256 maxZ = loadBoxPair( box + FLOATS_PER_BOX * 3 + 2 );
+			transposeHalves( unusedMinZ, unusedMaxX, maxY, maxZ );
+
+			__m256 outside = ZERO;
+			__m256 intersects = ZERO;
+			for( unsigned int planeIndex = 0; planeIndex < NUM_PLANES; planeIndex++ )
+			{
+				const __m256 * COEFFICIENTS = coefficients[planeIndex];
+				const __m256 * POSITIVE = positiveMasks[planeIndex];
+				//no FMA here, keep evaluation order of the scalar code to get identical rounding
+				__m256 furthest = _mm256_mul_ps( COEFFICIENTS[0], _mm256_blendv_ps( minX, maxX, POSITIVE[0] ) );
+				furthest = _mm256_add_ps( furthest, _mm256_mul_ps( COEFFICIENTS[1], _mm256_blendv_ps( minY, maxY, POSITIVE[1] ) ) );
+				furthest = _mm256_add_ps( furthest, _mm256_mul_ps( COEFFICIENTS[2], _mm256_blendv_ps( minZ, maxZ, POSITIVE[2] ) ) );
+				furthest = _mm256_add_ps( furthest, COEFFICIENTS[3] );
+				__m256 nearest = _mm256_mul_ps( COEFFICIENTS[0], _mm256_blendv_ps( maxX, minX, POSITIVE[0] ) );
+				nearest = _mm256_add_ps( nearest, _mm256_mul_ps( COEFFICIENTS[1], _mm256_blendv_ps( maxY, minY, POSITIVE[1] ) ) );
+				nearest = _mm256_add_ps( nearest, _mm256_mul_ps( COEFFICIENTS[2], _mm256_blendv_ps( maxZ, minZ, POSITIVE[2] ) ) );
+				nearest = _mm256_add_ps( nearest, COEFFICIENTS[3] );
+				outside = _mm256_or_ps( outside, _mm256_cmp_ps( furthest, ZERO, _CMP_NGT_UQ ) );
+				intersects = _mm256_or_ps( intersects, _mm256_cmp_ps( nearest, ZERO, _CMP_NGT_UQ ) );
+			}
+
+			//packing works within 128-bit halves, thus results of the first and the last four boxes are stored separately
+			const __m256i RESULT = _mm256_andnot_si256( _mm256_castps_si256( outside ), _mm256_add_epi32( INSIDE, _mm256_castps_si256( intersects ) ) );
+			const __m256i RESULT_WORDS = _mm256_packs_epi32( RESULT, RESULT );
+			const __m256i RESULT_BYTES = _mm256_packus_epi16( RESULT_WORDS, RESULT_WORDS );
+			const int LOW_RESULTS = _mm_cvtsi128_si32( _mm256_castsi256_si128( RESULT_BYTES ) );
+			const int HIGH_RESULTS = _mm_cvtsi128_si32( _mm256_extracti128_si256( RESULT_BYTES, 1 ) );
+			std::memcpy( results + boxIndex, &LOW_RESULTS, 4 );
+			std::memcpy( results + boxIndex + 4, &HIGH_RESULTS, 4 );
+		}
+		return boxIndex;
+	}
+};
+
+#if defined( __clang__ )
+#pragma clang attribute pop
+#endif
+
+#endif
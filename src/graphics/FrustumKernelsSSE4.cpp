@@ -0,0 +1,117 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * FrustumKernelsSSE4.cpp
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains definitions of SSE4.1 kernels of the frustum box tests
+ * @version 0.1.0
+ */
+
+
+#include "FrustumKernels"
+#include "Frustum"
+#include "CpuFeatures"
+
+#if CPU_FEATURES_X86
+
+#if defined( __GNUC__ ) && !defined( __clang__ )
+#pragma GCC target( "sse4.1" )
+#elif defined( __clang__ )
+#pragma clang attribute push( __attribute__( ( target( "sse4.1" ) ) ), apply_to = function )
+#endif
+
+#include <smmintrin.h>
+#include <cstring>
+
+namespace FrustumKernels
+{
+	/**
+	* @brief SSE4.1 version of the batch box test, four boxes are tested at once.
+	* For each plane the box corner lying furthest along the plane normal decides whether the box is outside
+	* and the nearest one decides whether the box is completely in front of the plane
+	*/
+	size_t testAABBsSSE4( const float * planes,
+						  const float * boxes,
+						  size_t boxIndex,
+						  size_t numBoxes,
+						  unsigned char * results ) noexcept
+	{
+		//plane coefficients and masks choosing the furthest corner do not depend on the boxes
+		constexpr unsigned int NUM_PLANES = Frustum::NUMBER_OF_PLANES;
+		const __m128 ZERO = _mm_setzero_ps();
+		__m128 coefficients[NUM_PLANES][4];
+		__m128 positiveMasks[NUM_PLANES][3];
+		for( unsigned int planeIndex = 0; planeIndex < NUM_PLANES; planeIndex++ )
+		{
+			for( unsigned int component = 0; component < 4; component++ )
+			{
+				coefficients[planeIndex][component] = _mm_set1_ps( planes[NUM_PLANES * component + planeIndex] );
+			}
+			for( unsigned int component = 0; component < 3; component++ )
+			{
+				positiveMasks[planeIndex][component] = _mm_cmpge_ps( coefficients[planeIndex][component], ZERO );
+			}
+		}
+		const __m128i INSIDE = _mm_set1_epi32( FRUSTUM_INSIDE );
+
+		for( ; boxIndex + 4 <= numBoxes; boxIndex += 4 )
+		{
+			//the first and the last four floats of each box are transposed to get one component of four boxes per register
+			const float * box = boxes + boxIndex * FLOATS_PER_BOX;
+			__m128 minX = _mm_loadu_ps( box );
+			__m128 minY = _mm_loadu_ps( box + FLOATS_PER_BOX );
+			__m128 minZ = _mm_loadu_ps( box + FLOATS_PER_BOX * 2 );
+			__m128 maxX = _mm_loadu_ps( box + FLOATS_PER_BOX * 3 );
+			_MM_TRANSPOSE4_PS( minX, minY, minZ, maxX );
+			__m128 unusedMinZ = _mm_loadu_ps( box + 2 );
+			__m128 unusedMaxX = _mm_loadu_ps( box + FLOATS_PER_BOX + 2 );
+			__m128 maxY = _mm_loadu_ps( box + FLOATS_PER_BOX * 2 + 2 );
+			__m128 maxZ = _mm_loadu_ps( box + FLOATS_PER_BOX * 3 + 2 );
+			_MM_TRANSPOSE4_PS( unusedMinZ, unusedMaxX, maxY, maxZ );
+
+			__m128 outside = ZERO;
+			__m128 intersects = ZERO;
+			for( unsigned int planeIndex = 0; planeIndex < NUM_PLANES; planeIndex++ )
+			{
+				const __m128 * COEFFICIENTS = coefficients[planeIndex];
+				const __m128 * POSITIVE = positiveMasks[planeIndex];
+				//keep evaluation order of the scalar code to get identical rounding
+				__m128 furthest = _mm_mul_ps( COEFFICIENTS[0], _mm_blendv_ps( minX, maxX, POSITIVE[0] ) );
+				furthest = _mm_add_ps( furthest, _mm_mul_ps( COEFFICIENTS[1], _mm_blendv_ps( minY, maxY, POSITIVE[1] ) ) );
+				furthest = _mm_add_ps( furthest, _mm_mul_ps( COEFFICIENTS[2], _mm_blendv_ps( minZ, maxZ, POSITIVE[2] ) ) );
+				furthest = _mm_add_ps( furthest, COEFFICIENTS[3] );
+				__m128 nearest = _mm_mul_ps( COEFFICIENTS[0], _mm_blendv_ps( maxX, minX, POSITIVE[0] ) );
+				nearest = _mm_add_ps( nearest, _mm_mul_ps( COEFFICIENTS[1], _mm_blendv_ps( maxY, minY, POSITIVE[1] ) ) );
+				nearest = _mm_add_ps( nearest, _mm_mul_ps( COEFFICIENTS[2], _mm_blendv_ps( maxZ, minZ, POSITIVE[2] ) ) );
+				nearest = _mm_add_ps( nearest, COEFFICIENTS[3] );
+				outside = _mm_or_ps( outside, _mm_cmpngt_ps( furthest, ZERO ) );
+				intersects = _mm_or_ps( intersects, _mm_cmpngt_ps( nearest, ZERO ) );
+			}
+
+			//inside (2) minus one for intersecting boxes, zero (outside) for the boxes outside, then narrowed to bytes
+			const __m128i RESULT = _mm_andnot_si128( _mm_castps_si128( outside ), _mm_add_epi32( INSIDE, _mm_castps_si128( intersects ) ) );
+			const __m128i RESULT_WORDS = _mm_packs_epi32( RESULT, RESULT );
+			const __m128i RESULT_BYTES = _mm_packus_epi16( RESULT_WORDS, RESULT_WORDS );
+			const int PACKED_RESULTS = _mm_cvtsi128_si32( RESULT_BYTES );
+			std::memcpy( results + boxIndex, &PACKED_RESULTS, 4 );
+		}
+		return boxIndex;
+	}
+};
+
+#if defined( __clang__ )
+#pragma clang attribute pop
+#endif
+
+#endif
@@ -14,14 +14,120 @@
  * GNU General Public License for more details.
  * See <http://www.gnu.org/licenses/>
  *
- * Purpose: contains definitions for OpenGL render related functions
+ * Purpose: contains definitions for OpenGL render related functions and the shadow copy of OpenGL state
  * @version 0.1.0
  */
 
 #include "RendererState"
+#include "BufferCollection"
 
 #include <GL/glew.h>
 
+namespace
+{
+	constexpr GLuint UNKNOWN_STATE_VALUE = ~GLuint( 0 );
+
+	/**
+	* @brief capabilities whose state is kept in the shadow copy, any other capability is sent to OpenGL as is
+	*/
+	constexpr GLenum TRACKED_CAPABILITIES[] = { GL_BLEND, GL_CULL_FACE, GL_DEPTH_TEST, GL_DITHER, GL_MULTISAMPLE, GL_SAMPLE_SHADING, GL_PROGRAM_POINT_SIZE, GL_CLIP_DISTANCE0 };
+	constexpr unsigned int NUM_TRACKED_CAPABILITIES = sizeof( TRACKED_CAPABILITIES ) / sizeof( TRACKED_CAPABILITIES[0] );
+
+	enum CAPABILITY_STATE : unsigned char
+	{
+		CAPABILITY_UNKNOWN,
+		CAPABILITY_ENABLED,
+		CAPABILITY_DISABLED
+	};
+
+	/**
+	* @brief last values sent to OpenGL, everything is unknown until it has been set for the first time
+	*/
+	struct ShadowState
+	{
+		CAPABILITY_STATE capabilities[NUM_TRACKED_CAPABILITIES] = {};
+		GLuint program = UNKNOWN_STATE_VALUE;
+		GLuint readFramebuffer = UNKNOWN_STATE_VALUE;
+		GLuint drawFramebuffer = UNKNOWN_STATE_VALUE;
+		GLint viewport[4] = { -1, -1, -1, -1 };
+		GLenum polygonMode = UNKNOWN_STATE_VALUE;
+		GLenum depthMask = UNKNOWN_STATE_VALUE;
+		GLenum depthFunc = UNKNOWN_STATE_VALUE;
+		GLenum frontFace = UNKNOWN_STATE_VALUE;
+		GLenum blendSourceFactor = UNKNOWN_STATE_VALUE;
+		GLenum blendDestinationFactor = UNKNOWN_STATE_VALUE;
+	};
+
+	constexpr const char * PASS_NAMES[NUM_RENDER_PASSES] = { "Update", "Depthmap", "Reflection", "Refraction", "Main", "Postprocess" };
+
+	ShadowState shadowState;
+	RendererStateStatistics passStatistics[NUM_RENDER_PASSES];
+	RendererStateStatistics lastFramePassStatistics[NUM_RENDER_PASSES];
+	RENDER_PASS currentPass = RENDER_PASS_UPDATE;
+	unsigned int passStartBinds = 0;
+	unsigned int passStartSkippedBinds = 0;
+
+	/**
+	* @brief counts a state call in the current pass
+	* @param isRedundant indicator of whether the call would not change OpenGL state
+	* @return true if the call should be filtered out
+	*/
+	bool filterStateCall( bool isRedundant ) noexcept
+	{
+		if( isRedundant )
+		{
+			++passStatistics[currentPass].filteredStateCalls;
+		}
+		else
+		{
+			++passStatistics[currentPass].issuedStateCalls;
+		}
+		return isRedundant;
+	}
+
+	/**
+	* @brief accounts buffer collection binds made since the current pass has begun
+	*/
+	void closeCurrentPass() noexcept
+	{
+		passStatistics[currentPass].issuedBinds += BufferCollection::getNumBindsThisFrame() - passStartBinds;
+		passStatistics[currentPass].filteredBinds += BufferCollection::getNumSkippedBindsThisFrame() - passStartSkippedBinds;
+		passStartBinds = BufferCollection::getNumBindsThisFrame();
+		passStartSkippedBinds = BufferCollection::getNumSkippedBindsThisFrame();
+	}
+
+	/**
+	* @brief sends enable/disable command for a capability unless the shadow copy says it's already in this state
+	* @param state GL capability
+	* @param isOn whether the capability should be enabled
+	*/
+	void setCapability( GLenum state,
+						bool isOn ) noexcept
+	{
+		const CAPABILITY_STATE NEW_STATE = isOn ? CAPABILITY_ENABLED : CAPABILITY_DISABLED;
+		for( unsigned int capabilityIndex = 0; capabilityIndex < NUM_TRACKED_CAPABILITIES; capabilityIndex++ )
+		{
+			if( TRACKED_CAPABILITIES[capabilityIndex] == state )
+			{
+				if( filterStateCall( shadowState.capabilities[capabilityIndex] == NEW_STATE ) )
+				{
+					return;
+				}
+				shadowState.capabilities[capabilityIndex] = NEW_STATE;
+				break;
+			}
+		}
+		if( isOn )
+		{
+			glEnable( state );
+		}
+		else
+		{
+			glDisable( state );
+		}
+	}
+}
+
 namespace RendererState
 {
 	/**
@@ -31,16 +137,16 @@ namespace RendererState
 	void setInitialRenderingState( bool useMultisample ) noexcept
 	{
 		enableStates( { GL_CULL_FACE, GL_DEPTH_TEST, GL_SAMPLE_SHADING } );
-		glDisable( GL_DITHER );
+		disableState( GL_DITHER );
 		if( useMultisample )
 		{
-			glEnable( GL_MULTISAMPLE );
+			enableState( GL_MULTISAMPLE );
 		}
 		else
 		{
-			glDisable( GL_MULTISAMPLE );
+			disableState( GL_MULTISAMPLE );
 		}
-		glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+		setBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
 	}
 
 	/**
@@ -49,26 +155,26 @@ namespace RendererState
 	*/
 	void setAmbienceRenderingState( bool isOn ) noexcept
 	{
-		glFrontFace( isOn ? GL_CW : GL_CCW );
-		glDepthMask( isOn ? GL_FALSE : GL_TRUE );
-		glDepthFunc( isOn ? GL_LEQUAL : GL_LESS );
+		setFrontFace( isOn ? GL_CW : GL_CCW );
+		setDepthMask( !isOn );
+		setDepthFunc( isOn ? GL_LEQUAL : GL_LESS );
 	}
 
 	void enableState( unsigned int state ) noexcept
 	{
-		glEnable( state );
+		setCapability( state, true );
 	}
 
 	void disableState( unsigned int state ) noexcept
 	{
-		glDisable( state );
+		setCapability( state, false );
 	}
 
 	void enableStates( const std::initializer_list<unsigned int> & states ) noexcept
 	{
 		for( unsigned int state : states )
 		{
-			glEnable( state );
+			setCapability( state, true );
 		}
 	}
 
@@ -76,7 +182,188 @@ namespace RendererState
 	{
 		for( unsigned int state : states )
 		{
-			glDisable( state );
+			setCapability( state, false );
+		}
+	}
+
+	void useProgram( unsigned int program ) noexcept
+	{
+		if( filterStateCall( shadowState.program == program ) )
+		{
+			return;
+		}
+		shadowState.program = program;
+		glUseProgram( program );
+	}
+
+	/**
+	* @brief should be called before a program is deleted, otherwise a new program could get the same ID
+	* while the deleted one is still in use
+	* @param program ID of the program to be deleted
+	*/
+	void forgetProgram( unsigned int program ) noexcept
+	{
+		if( shadowState.program == program )
+		{
+			shadowState.program = UNKNOWN_STATE_VALUE;
 		}
 	}
+
+	/**
+	* @brief sends bind framebuffer command unless the framebuffer is already bound to the target
+	* @param target GL_FRAMEBUFFER, GL_READ_FRAMEBUFFER or GL_DRAW_FRAMEBUFFER
+	* @param framebuffer framebuffer object to bind
+	*/
+	void bindFramebuffer( unsigned int target,
+						  unsigned int framebuffer ) noexcept
+	{
+		const bool BIND_READ = target != GL_DRAW_FRAMEBUFFER;
+		const bool BIND_DRAW = target != GL_READ_FRAMEBUFFER;
+		if( filterStateCall( ( !BIND_READ || shadowState.readFramebuffer == framebuffer ) &&
+							 ( !BIND_DRAW || shadowState.drawFramebuffer == framebuffer ) ) )
+		{
+			return;
+		}
+		if( BIND_READ )
+		{
+			shadowState.readFramebuffer = framebuffer;
+		}
+		if( BIND_DRAW )
+		{
+			shadowState.drawFramebuffer = framebuffer;
+		}
+		glBindFramebuffer( target, framebuffer );
+	}
+
+	/**
+	* @brief should be called before a framebuffer is deleted, OpenGL reverts bindings of the deleted framebuffer to default one
+	* @param framebuffer framebuffer object to be deleted
+	*/
+	void forgetFramebuffer( unsigned int framebuffer ) noexcept
+	{
+		if( shadowState.readFramebuffer == framebuffer )
+		{
+			shadowState.readFramebuffer = 0;
+		}
+		if( shadowState.drawFramebuffer == framebuffer )
+		{
+			shadowState.drawFramebuffer = 0;
+		}
+	}
+
+	void setViewport( int x,
+					  int y,
+					  int width,
+					  int height ) noexcept
+	{
+		GLint * viewport = shadowState.viewport;
+		if( filterStateCall( viewport[0] == x && viewport[1] == y && viewport[2] == width && viewport[3] == height ) )
+		{
+			return;
+		}
+		viewport[0] = x;
+		viewport[1] = y;
+		viewport[2] = width;
+		viewport[3] = height;
+		glViewport( x, y, width, height );
+	}
+
+	/**
+	* @brief sets polygon mode for both front and back faces
+	* @param mode GL_FILL, GL_LINE or GL_POINT
+	*/
+	void setPolygonMode( unsigned int mode ) noexcept
+	{
+		if( filterStateCall( shadowState.polygonMode == mode ) )
+		{
+			return;
+		}
+		shadowState.polygonMode = mode;
+		glPolygonMode( GL_FRONT_AND_BACK, mode );
+	}
+
+	void setDepthMask( bool isOn ) noexcept
+	{
+		const GLenum MASK = isOn ? GL_TRUE : GL_FALSE;
+		if( filterStateCall( shadowState.depthMask == MASK ) )
+		{
+			return;
+		}
+		shadowState.depthMask = MASK;
+		glDepthMask( (GLboolean)MASK );
+	}
+
+	void setDepthFunc( unsigned int func ) noexcept
+	{
+		if( filterStateCall( shadowState.depthFunc == func ) )
+		{
+			return;
+		}
+		shadowState.depthFunc = func;
+		glDepthFunc( func );
+	}
+
+	void setFrontFace( unsigned int mode ) noexcept
+	{
+		if( filterStateCall( shadowState.frontFace == mode ) )
+		{
+			return;
+		}
+		shadowState.frontFace = mode;
+		glFrontFace( mode );
+	}
+
+	void setBlendFunc( unsigned int sourceFactor,
+					   unsigned int destinationFactor ) noexcept
+	{
+		if( filterStateCall( shadowState.blendSourceFactor == sourceFactor && shadowState.blendDestinationFactor == destinationFactor ) )
+		{
+			return;
+		}
+		shadowState.blendSourceFactor = sourceFactor;
+		shadowState.blendDestinationFactor = destinationFactor;
+		glBlendFunc( sourceFactor, destinationFactor );
+	}
+
+	/**
+	* @brief makes all the following calls (including buffer collection binds) to be accounted in the given pass
+	* @param pass rendering pass that is about to begin
+	*/
+	void beginPass( RENDER_PASS pass ) noexcept
+	{
+		closeCurrentPass();
+		currentPass = pass;
+	}
+
+	/**
+	* @brief stores statistics of the finished frame and resets counters for the next one,
+	* calls made before the first pass of the next frame are accounted as updates
+	* @note should be called before BufferCollection::finishFrame as it accounts the binds of the last pass
+	*/
+	void finishFrame() noexcept
+	{
+		closeCurrentPass();
+		currentPass = RENDER_PASS_UPDATE;
+		for( unsigned int passIndex = 0; passIndex < NUM_RENDER_PASSES; passIndex++ )
+		{
+			lastFramePassStatistics[passIndex] = passStatistics[passIndex];
+			passStatistics[passIndex] = RendererStateStatistics();
+		}
+		passStartBinds = 0;
+		passStartSkippedBinds = 0;
+	}
+
+	/**
+	* @brief returns statistics of the given pass gathered during the last complete frame
+	* @param pass rendering pass
+	*/
+	const RendererStateStatistics & getPassStatistics( RENDER_PASS pass ) noexcept
+	{
+		return lastFramePassStatistics[pass];
+	}
+
+	const char * getPassName( RENDER_PASS pass ) noexcept
+	{
+		return PASS_NAMES[pass];
+	}
 }
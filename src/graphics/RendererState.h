@@ -14,7 +14,7 @@
  * GNU General Public License for more details.
  * See <http://www.gnu.org/licenses/>
  *
- * Purpose: contains declarations for OpenGL render related functions
+ * Purpose: contains declarations for OpenGL render related functions and the shadow copy of OpenGL state
  * @version 0.1.0
  */
 
@@ -23,7 +23,36 @@
 #include <initializer_list>
 
 /**
-* @brief contains a bunch of OpenGL render related functions
+* @brief rendering passes of a frame, OpenGL calls statistics is gathered for each pass separately
+*/
+enum RENDER_PASS : unsigned int
+{
+	RENDER_PASS_UPDATE,
+	RENDER_PASS_DEPTHMAP,
+	RENDER_PASS_REFLECTION,
+	RENDER_PASS_REFRACTION,
+	RENDER_PASS_MAIN,
+	RENDER_PASS_POSTPROCESS,
+	NUM_RENDER_PASSES
+};
+
+/**
+* @brief number of OpenGL calls sent and filtered as redundant during one pass
+*/
+struct RendererStateStatistics
+{
+	unsigned int issuedStateCalls = 0;
+	unsigned int filteredStateCalls = 0;
+	unsigned int issuedBinds = 0;
+	unsigned int filteredBinds = 0;
+};
+
+/**
+* @brief contains a bunch of OpenGL render related functions.
+* Keeps shadow copy of the OpenGL state (capabilities, program, framebuffers, polygon mode, viewport etc.)
+* so that calls which would not change the state are not sent to OpenGL.
+* VAO and buffer bindings are tracked by BufferCollection and only accounted in the statistics here
+* @note shadow copy is valid only if all the state changes go through these functions
 */
 namespace RendererState
 {
@@ -33,4 +62,23 @@ namespace RendererState
 	void disableState( unsigned int state ) noexcept;
 	void enableStates( const std::initializer_list<unsigned int> & states ) noexcept;
 	void disableStates( const std::initializer_list<unsigned int> & states ) noexcept;
+	void useProgram( unsigned int program ) noexcept;
+	void forgetProgram( unsigned int program ) noexcept;
+	void bindFramebuffer( unsigned int target,
+						  unsigned int framebuffer ) noexcept;
+	void forgetFramebuffer( unsigned int framebuffer ) noexcept;
+	void setViewport( int x,
+					  int y,
+					  int width,
+					  int height ) noexcept;
+	void setPolygonMode( unsigned int mode ) noexcept;
+	void setDepthMask( bool isOn ) noexcept;
+	void setDepthFunc( unsigned int func ) noexcept;
+	void setFrontFace( unsigned int mode ) noexcept;
+	void setBlendFunc( unsigned int sourceFactor,
+					   unsigned int destinationFactor ) noexcept;
+	void beginPass( RENDER_PASS pass ) noexcept;
+	void finishFrame() noexcept;
+	const RendererStateStatistics & getPassStatistics( RENDER_PASS pass ) noexcept;
+	const char * getPassName( RENDER_PASS pass ) noexcept;
 };
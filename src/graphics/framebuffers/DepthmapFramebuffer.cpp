@@ -20,6 +20,7 @@
 
 #include "DepthmapFramebuffer"
 #include "TextureManager"
+#include "RendererState"
 
 /**
 * @brief plain ctor
@@ -34,10 +35,10 @@ DepthmapFramebuffer::DepthmapFramebuffer( TextureManager & textureManager ) noex
 */
 void DepthmapFramebuffer::setup()
 {
-	glBindFramebuffer( GL_FRAMEBUFFER, fbo );
+	RendererState::bindFramebuffer( GL_FRAMEBUFFER, fbo );
 	glNamedFramebufferTexture( fbo, GL_DEPTH_ATTACHMENT, textureManager.get( TEX_DEPTH_MAP_SUN ), 0 );
 	glDrawBuffer( GL_NONE );
 	glReadBuffer( GL_NONE );
 	checkStatus();
-	glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+	RendererState::bindFramebuffer( GL_FRAMEBUFFER, 0 );
 }
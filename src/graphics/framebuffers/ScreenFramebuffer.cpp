@@ -49,6 +49,7 @@ ScreenFramebuffer::ScreenFramebuffer( TextureManager & textureManager,
 */
 ScreenFramebuffer::~ScreenFramebuffer()
 {
+	RendererState::forgetFramebuffer( multisampleFbo );
 	glDeleteFramebuffers( 1, &multisampleFbo );
 	glDeleteRenderbuffers( 1, &multisampleDepthRbo );
 }
@@ -68,21 +69,21 @@ void ScreenFramebuffer::setup()
 void ScreenFramebuffer::setupFramebuffers()
 {
 	//multisample
-	glBindFramebuffer( GL_FRAMEBUFFER, multisampleFbo );
+	RendererState::bindFramebuffer( GL_FRAMEBUFFER, multisampleFbo );
 	glFramebufferTexture2D( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D_MULTISAMPLE, textureManager.get( TEX_FRAME_MULTISAMPLED ), 0 );
 	glBindRenderbuffer( GL_RENDERBUFFER, multisampleDepthRbo );
 	glRenderbufferStorageMultisample( GL_RENDERBUFFER, SettingsManager::getInt("GRAPHICS", "multisamples"), GL_DEPTH_COMPONENT24, screenResolution.getWidth(), screenResolution.getHeight() );
 	glFramebufferRenderbuffer( GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, multisampleDepthRbo );
 	checkStatus();
-	glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+	RendererState::bindFramebuffer( GL_FRAMEBUFFER, 0 );
 
 	//intermediate FBO (or direct off-screen FBO without multisampling)
-	glBindFramebuffer( GL_FRAMEBUFFER, fbo );
+	RendererState::bindFramebuffer( GL_FRAMEBUFFER, fbo );
 	glFramebufferTexture2D( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
 							SettingsManager::getBool( "GRAPHICS", "hdr" ) ? textureManager.get( TEX_FRAME_HDR ) : textureManager.get( TEX_FRAME ), 0 );
 	glFramebufferTexture2D( GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, textureManager.get( TEX_FRAME_DEPTH ), 0 );
 	checkStatus();
-	glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+	RendererState::bindFramebuffer( GL_FRAMEBUFFER, 0 );
 }
 
 /**
@@ -120,17 +121,17 @@ void ScreenFramebuffer::draw( bool useMultisampling,
 {
 	if( useMultisampling )
 	{
-		glBindFramebuffer( GL_READ_FRAMEBUFFER, multisampleFbo );
-		glBindFramebuffer( GL_DRAW_FRAMEBUFFER, fbo );
+		RendererState::bindFramebuffer( GL_READ_FRAMEBUFFER, multisampleFbo );
+		RendererState::bindFramebuffer( GL_DRAW_FRAMEBUFFER, fbo );
 		glBlitFramebuffer( 0, 0, screenResolution.getWidth(), screenResolution.getHeight(),
 						   0, 0, screenResolution.getWidth(), screenResolution.getHeight(),
 						   GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT, GL_NEAREST );
-		glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+		RendererState::bindFramebuffer( GL_FRAMEBUFFER, 0 );
 	}
 	else
 	{
-		glBindFramebuffer( GL_READ_FRAMEBUFFER, fbo );
-		glBindFramebuffer( GL_DRAW_FRAMEBUFFER, 0 );
+		RendererState::bindFramebuffer( GL_READ_FRAMEBUFFER, fbo );
+		RendererState::bindFramebuffer( GL_DRAW_FRAMEBUFFER, 0 );
 	}
 
 	//activate shader and set DOF uniform state
@@ -152,5 +153,5 @@ void ScreenFramebuffer::draw( bool useMultisampling,
 */
 void ScreenFramebuffer::bindAppropriateFBO( bool enableMultisampling ) noexcept
 {
-	glBindFramebuffer( GL_FRAMEBUFFER, enableMultisampling ? multisampleFbo : fbo );
+	RendererState::bindFramebuffer( GL_FRAMEBUFFER, enableMultisampling ? multisampleFbo : fbo );
 }
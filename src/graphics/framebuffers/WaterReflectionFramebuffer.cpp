@@ -21,6 +21,7 @@
 #include "WaterReflectionFramebuffer"
 #include "TextureManager"
 #include "SettingsManager"
+#include "RendererState"
 
 /**
 * @brief plain ctor, additionally sends create renderbuffer call to OpenGL
@@ -44,7 +45,7 @@ WaterReflectionFramebuffer::~WaterReflectionFramebuffer()
 */
 void WaterReflectionFramebuffer::setup()
 {
-	glBindFramebuffer( GL_FRAMEBUFFER, fbo );
+	RendererState::bindFramebuffer( GL_FRAMEBUFFER, fbo );
 	glFramebufferTexture2D( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textureManager.get( TEX_FRAME_WATER_REFLECTION ), 0 );
 	glBindRenderbuffer( GL_RENDERBUFFER, rbo );
 	glRenderbufferStorage( GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, 
@@ -52,5 +53,5 @@ void WaterReflectionFramebuffer::setup()
 						   SettingsManager::getInt( "GRAPHICS", "frame_water_reflection_height" ) );
 	glFramebufferRenderbuffer( GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, rbo );
 	checkStatus();
-	glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+	RendererState::bindFramebuffer( GL_FRAMEBUFFER, 0 );
 }
@@ -26,6 +26,8 @@
 #include "Shader"
 #include "MouseInputManager"
 #include "RendererState"
+#include "UploadManager"
+#include "ChunkOcclusionCache"
 
 #include <sstream>
 #include <iomanip>
@@ -64,12 +66,15 @@ TextManager::TextManager( const char * fontFile,
 * @param mouseInput mouse input manager instance
 * @param sunPosition sun current position
 * @param fps current FPS value
+* @param modelsUpdateTime duration of the last models indirect buffer update on the coroutine thread (in microseconds)
 */
 void TextManager::addDebugText( const Camera & camera,
 								Options & options,
 								const MouseInputManager & mouseInput,
 								const glm::vec3 & sunPosition,
-								unsigned int fps )
+								unsigned int fps,
+								unsigned int modelsUpdateTime,
+								const ChunkOcclusionStatistics & plantsOcclusionStatistics )
 {
 	float screenHeight = (float)screenResolution.getHeight();
 	glm::vec3 viewPosition = camera.getPosition();
@@ -144,6 +149,38 @@ void TextManager::addDebugText( const Camera & camera,
 	}
 	addString( ss.str(), LEFT_BORDER_OFFSET * resolutionRelativeOffset.x, ( LOWER_BORDER_OFFSET + CROSSLINE_OFFSET_Y * lineCounter++ ) * resolutionRelativeOffset.y, scale );
 
+	ss.str( "" );
+	ss << "Uploaded last frame: " << UploadManager::getInstance().getBytesUploadedLastFrame() / 1024 << " KB";
+	addString( ss.str(), LEFT_BORDER_OFFSET * resolutionRelativeOffset.x, ( LOWER_BORDER_OFFSET + CROSSLINE_OFFSET_Y * lineCounter++ ) * resolutionRelativeOffset.y, scale );
+
+	ss.str( "" );
+	ss << "Uniform calls last frame: " << Shader::getNumUniformCallsLastFrame();
+	addString( ss.str(), LEFT_BORDER_OFFSET * resolutionRelativeOffset.x, ( LOWER_BORDER_OFFSET + CROSSLINE_OFFSET_Y * lineCounter++ ) * resolutionRelativeOffset.y, scale );
+
+	ss.str( "" );
+	ss << "Models indirect update: " << modelsUpdateTime << " us";
+	addString( ss.str(), LEFT_BORDER_OFFSET * resolutionRelativeOffset.x, ( LOWER_BORDER_OFFSET + CROSSLINE_OFFSET_Y * lineCounter++ ) * resolutionRelativeOffset.y, scale );
+
+	ss.str( "" );
+	ss << "Plants occlusion reused/tested/deferred: " << plantsOcclusionStatistics.numReused << "/" << plantsOcclusionStatistics.numTested
+		<< "/" << plantsOcclusionStatistics.numDeferred;
+	addString( ss.str(), LEFT_BORDER_OFFSET * resolutionRelativeOffset.x, ( LOWER_BORDER_OFFSET + CROSSLINE_OFFSET_Y * lineCounter++ ) * resolutionRelativeOffset.y, scale );
+
+	//GL calls statistics of each pass, passes skipped during the last frame are not shown
+	for( unsigned int passIndex = 0; passIndex < NUM_RENDER_PASSES; passIndex++ )
+	{
+		const RENDER_PASS PASS = static_cast<RENDER_PASS>( passIndex );
+		const RendererStateStatistics & STATISTICS = RendererState::getPassStatistics( PASS );
+		if( STATISTICS.issuedStateCalls + STATISTICS.filteredStateCalls + STATISTICS.issuedBinds + STATISTICS.filteredBinds == 0 )
+		{
+			continue;
+		}
+		ss.str( "" );
+		ss << RendererState::getPassName( PASS ) << " issued/filtered: state " << STATISTICS.issuedStateCalls << "/" << STATISTICS.filteredStateCalls
+			<< ", binds " << STATISTICS.issuedBinds << "/" << STATISTICS.filteredBinds;
+		addString( ss.str(), LEFT_BORDER_OFFSET * resolutionRelativeOffset.x, ( LOWER_BORDER_OFFSET + CROSSLINE_OFFSET_Y * lineCounter++ ) * resolutionRelativeOffset.y, scale );
+	}
+
 	ss.str( "" );
 	ss << "Sun position: " << std::setprecision( 3 ) << std::setw( 3 )
 		<< sunPosition.x << ": " << sunPosition.y << ": " << sunPosition.z;
@@ -221,13 +258,16 @@ void TextManager::addString( const std::string & text,
 }
 
 /**
-* @brief buffers text data to GPU and sends draw call to OpenGL with blending enabled
+* @brief buffers text data to GPU and sends draw call to OpenGL with blending enabled.
+* Text is drawn right away, thus its copy is flushed immediately
 */
 void TextManager::drawText()
 {
 	shader.use();
 	basicGLBuffers.bind( VAO | VBO );
-	glBufferData( GL_ARRAY_BUFFER, bufferOffset * sizeof( GLfloat ), vertexData, GL_STATIC_DRAW );
+	UploadManager & uploadManager = UploadManager::getInstance();
+	uploadManager.uploadBufferData( basicGLBuffers.get( VBO ), bufferOffset * sizeof( GLfloat ), vertexData, GL_STREAM_DRAW );
+	uploadManager.flush();
 
 	RendererState::enableState( GL_BLEND );
 	glDrawArrays( GL_TRIANGLES, 0, glyphsCount * VERTICES_PER_QUAD );
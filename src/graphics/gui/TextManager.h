@@ -30,6 +30,7 @@ class ScreenResolution;
 class Options;
 class Shader;
 class MouseInputManager;
+struct ChunkOcclusionStatistics;
 
 /**
 * @brief utility manager class for handling all game text related stuff: updating text on the screen, text rendering etc.
@@ -45,7 +46,9 @@ public:
 					   Options & options,
 					   const MouseInputManager & mouseInput,
 					   const glm::vec3 & sunPosition,
-					   unsigned int fps );
+					   unsigned int fps,
+					   unsigned int modelsUpdateTime,
+					   const ChunkOcclusionStatistics & plantsOcclusionStatistics );
 	void drawText();
 
 private:
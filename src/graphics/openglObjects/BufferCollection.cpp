@@ -20,6 +20,14 @@
 
 #include "BufferCollection"
 
+#include <stdexcept>
+
+GLuint BufferCollection::boundObjects[NUM_BIND_TARGETS] = {};
+unsigned int BufferCollection::numBindsThisFrame = 0;
+unsigned int BufferCollection::numSkippedBindsThisFrame = 0;
+unsigned int BufferCollection::numBindsLastFrame = 0;
+unsigned int BufferCollection::numSkippedBindsLastFrame = 0;
+
 /**
 * @brief creating a preset buffer objects pipeline according to given flags
 * @param flags integer union of individual flags
@@ -34,32 +42,9 @@ BufferCollection::BufferCollection( int flags )
 * @param old collection to be moved
 */
 BufferCollection::BufferCollection( BufferCollection && old ) noexcept
+	: objects( old.objects )
 {
-	if( old.objects[VAO] )
-	{
-		objects[VAO] = old.objects[VAO];
-	}
-	if( old.objects[VBO] )
-	{
-		objects[VBO] = old.objects[VBO];
-	}
-	if( old.objects[INSTANCE_VBO] )
-	{
-		objects[INSTANCE_VBO] = old.objects[INSTANCE_VBO];
-	}
-	if( old.objects[EBO] )
-	{
-		objects[EBO] = old.objects[EBO];
-	}
-	if( old.objects[DIBO] )
-	{
-		objects[DIBO] = old.objects[DIBO];
-	}
-	if( old.objects[TFBO] )
-	{
-		objects[TFBO] = old.objects[TFBO];
-	}
-	old.objects.clear();
+	old.objects.fill( 0 );
 }
 
 /**
@@ -67,32 +52,8 @@ BufferCollection::BufferCollection( BufferCollection && old ) noexcept
 * @param copy collection to be copied from
 */
 BufferCollection::BufferCollection( BufferCollection & copy )
-{
-	if( copy.objects[VAO] )
-	{
-		objects[VAO] = copy.objects[VAO];
-	}
-	if( copy.objects[VBO] )
-	{
-		objects[VBO] = copy.objects[VBO];
-	}
-	if( copy.objects[INSTANCE_VBO] )
-	{
-		objects[INSTANCE_VBO] = copy.objects[INSTANCE_VBO];
-	}
-	if( copy.objects[EBO] )
-	{
-		objects[EBO] = copy.objects[EBO];
-	}
-	if( copy.objects[DIBO] )
-	{
-		objects[DIBO] = copy.objects[DIBO];
-	}
-	if( copy.objects[TFBO] )
-	{
-		objects[TFBO] = copy.objects[TFBO];
-	}
-}
+	: objects( copy.objects )
+{}
 
 BufferCollection::~BufferCollection()
 {
@@ -107,67 +68,70 @@ void BufferCollection::bindZero( int flag ) noexcept
 {
 	if( flag & VAO )
 	{
-		glBindVertexArray( 0 );
+		bindTracked( BIND_TARGET_VERTEX_ARRAY, 0 );
 	}
 	if( flag & VBO || flag & INSTANCE_VBO )
 	{
-		glBindBuffer( GL_ARRAY_BUFFER, 0 );
+		bindTracked( BIND_TARGET_ARRAY_BUFFER, 0 );
 	}
 	if( flag & EBO )
 	{
-		glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
+		bindTracked( BIND_TARGET_ELEMENT_ARRAY_BUFFER, 0 );
 	}
 	if( flag & DIBO )
 	{
-		glBindBuffer( GL_DRAW_INDIRECT_BUFFER, 0 );
+		bindTracked( BIND_TARGET_DRAW_INDIRECT_BUFFER, 0 );
 	}
 	if( flag & TFBO )
 	{
-		glBindTransformFeedback( GL_TRANSFORM_FEEDBACK, 0 );
+		bindTracked( BIND_TARGET_TRANSFORM_FEEDBACK, 0 );
 	}
 }
 
+/**
+* @brief stores bind statistics of the finished frame and resets counters for the next one
+*/
+void BufferCollection::finishFrame() noexcept
+{
+	numBindsLastFrame = numBindsThisFrame;
+	numSkippedBindsLastFrame = numSkippedBindsThisFrame;
+	numBindsThisFrame = 0;
+	numSkippedBindsThisFrame = 0;
+}
+
+unsigned int BufferCollection::getNumBindsThisFrame() noexcept
+{
+	return numBindsThisFrame;
+}
+
+unsigned int BufferCollection::getNumSkippedBindsThisFrame() noexcept
+{
+	return numSkippedBindsThisFrame;
+}
+
+unsigned int BufferCollection::getNumBindsLastFrame() noexcept
+{
+	return numBindsLastFrame;
+}
+
+unsigned int BufferCollection::getNumSkippedBindsLastFrame() noexcept
+{
+	return numSkippedBindsLastFrame;
+}
+
 /**
 * @brief sends create command to OpenGL side and stores object's ID in the storage
 * @param flags integer union of individual flags
 */
 void BufferCollection::create( int flags )
 {
-	if( flags & VAO )
-	{
-		GLuint vao;
-		glCreateVertexArrays( 1, &vao );
-		objects[VAO] = vao;
-	}
-	if( flags & VBO )
-	{
-		GLuint vbo;
-		glCreateBuffers( 1, &vbo );
-		objects[VBO] = vbo;
-	}
-	if( flags & INSTANCE_VBO )
-	{
-		GLuint vbo;
-		glCreateBuffers( 1, &vbo );
-		objects[INSTANCE_VBO] = vbo;
-	}
-	if( flags & EBO )
-	{
-		GLuint ebo;
-		glCreateBuffers( 1, &ebo );
-		objects[EBO] = ebo;
-	}
-	if( flags & DIBO )
-	{
-		GLuint dibo;
-		glCreateBuffers( 1, &dibo );
-		objects[DIBO] = dibo;
-	}
-	if( flags & TFBO )
+	for( unsigned int slot = 0; slot < NUM_OPENGL_OBJECT_SLOTS; slot++ )
 	{
-		GLuint tfbo;
-		glCreateTransformFeedbacks( 1, &tfbo );
-		objects[TFBO] = tfbo;
+		const int FLAG = 1 << ( slot * 4 );
+		if( flags & FLAG )
+		{
+			createObject( FLAG, objects[slot] );
+		}
 	}
 }
 
@@ -176,29 +140,12 @@ void BufferCollection::create( int flags )
 */
 void BufferCollection::deleteBuffers()
 {
-	if( objects[VAO] )
-	{
-		glDeleteVertexArrays( 1, &objects[VAO] );
-	}
-	if( objects[VBO] )
-	{
-		glDeleteBuffers( 1, &objects[VBO] );
-	}
-	if( objects[INSTANCE_VBO] )
-	{
-		glDeleteBuffers( 1, &objects[INSTANCE_VBO] );
-	}
-	if( objects[EBO] )
-	{
-		glDeleteBuffers( 1, &objects[EBO] );
-	}
-	if( objects[DIBO] )
+	for( unsigned int slot = 0; slot < NUM_OPENGL_OBJECT_SLOTS; slot++ )
 	{
-		glDeleteBuffers( 1, &objects[DIBO] );
-	}
-	if( objects[TFBO] )
-	{
-		glDeleteTransformFeedbacks( 1, &objects[TFBO] );
+		if( objects[slot] )
+		{
+			deleteObject( 1 << ( slot * 4 ), objects[slot] );
+		}
 	}
 }
 
@@ -208,33 +155,14 @@ void BufferCollection::deleteBuffers()
 */
 void BufferCollection::deleteBuffer( int flag )
 {
-	if( flag & VAO )
-	{
-		glDeleteVertexArrays( 1, &objects[VAO] );
-	}
-	else if( flag & VBO )
-	{
-		glDeleteBuffers( 1, &objects[VBO] );
-	}
-	else if( flag & INSTANCE_VBO )
-	{
-		glDeleteBuffers( 1, &objects[INSTANCE_VBO] );
-	}
-	else if( flag & EBO )
+	const unsigned int SLOT = openglObjectSlot( flag );
+	if( SLOT == NUM_OPENGL_OBJECT_SLOTS )
 	{
-		glDeleteBuffers( 1, &objects[EBO] );
-	}
-	else if( flag & DIBO )
-	{
-		glDeleteBuffers( 1, &objects[DIBO] );
-	}
-	else if( flag & TFBO )
-	{
-		glDeleteTransformFeedbacks( 1, &objects[TFBO] );
+		throw std::invalid_argument( "Unknown GL object enum flag" );
 	}
-	else
+	if( objects[SLOT] )
 	{
-		throw std::invalid_argument( "Unknown GL object enum flag" );
+		deleteObject( 1 << ( SLOT * 4 ), objects[SLOT] );
 	}
 }
 
@@ -244,112 +172,93 @@ void BufferCollection::deleteBuffer( int flag )
 */
 GLuint & BufferCollection::get( int flag )
 {
-	if( flag & VAO )
-	{
-		return objects[VAO];
-	}
-	else if( flag & VBO )
-	{
-		return objects[VBO];
-	}
-	else if( flag & INSTANCE_VBO )
-	{
-		return objects[INSTANCE_VBO];
-	}
-	else if( flag & EBO )
-	{
-		return objects[EBO];
-	}
-	else if( flag & DIBO )
-	{
-		return objects[DIBO];
-	}
-	else if( flag & TFBO )
-	{
-		return objects[TFBO];
-	}
-	else
+	const unsigned int SLOT = openglObjectSlot( flag );
+	if( SLOT == NUM_OPENGL_OBJECT_SLOTS )
 	{
 		throw std::invalid_argument( "Unknown GL object enum flag" );
 	}
+	return objects[SLOT];
 }
 
 /**
-* @brief sends bind command to OpenGL for a chosen GL objects
-* @param flag indicator of the GL object to be bound
+* @brief similar to create method, but intended to be used after collection has been created and suppose to take one type per call
+* @param flag indicator of the GL object to be created
 */
-void BufferCollection::bind( int flag )
+void BufferCollection::add( int flag )
 {
-	if( flag & VAO )
-	{
-		glBindVertexArray( objects[VAO] );
-	}
-	if( flag & VBO )
-	{
-		glBindBuffer( GL_ARRAY_BUFFER, objects[VBO] );
-	}
-	if( flag & INSTANCE_VBO )
-	{
-		glBindBuffer( GL_ARRAY_BUFFER, objects[INSTANCE_VBO] );
-	}
-	if( flag & EBO )
+	const unsigned int SLOT = openglObjectSlot( flag );
+	if( SLOT == NUM_OPENGL_OBJECT_SLOTS )
 	{
-		glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, objects[EBO] );
-	}
-	if( flag & DIBO )
-	{
-		glBindBuffer( GL_DRAW_INDIRECT_BUFFER, objects[DIBO] );
-	}
-	if( flag & TFBO )
-	{
-		glBindTransformFeedback( GL_TRANSFORM_FEEDBACK, objects[TFBO] );
+		throw std::invalid_argument( "Unknown GL object enum flag" );
 	}
+	createObject( 1 << ( SLOT * 4 ), objects[SLOT] );
 }
 
 /**
-* @brief similar to create method, but intended to be used after collection has been created and suppose to take one type per call
-* @param flag indicator of the GL object to be created
+* @brief resets tracked binding if the object being deleted is bound, OpenGL unbinds deleted objects itself
+* @param target binding point
+* @param object GL object to be deleted
 */
-void BufferCollection::add( int flag )
+void BufferCollection::forgetDeleted( BIND_TARGET target,
+									  GLuint object ) noexcept
 {
-	if( flag & VAO )
+	if( boundObjects[target] == object )
 	{
-		GLuint vao;
-		glCreateVertexArrays( 1, &vao );
-		objects[VAO] = vao;
+		boundObjects[target] = 0;
 	}
-	else if( flag & VBO )
+}
+
+/**
+* @brief sends create command to OpenGL for a single GL object
+* @param flag single flag of the GL object type
+* @param object storage for the created object's ID
+*/
+void BufferCollection::createObject( int flag,
+									 GLuint & object )
+{
+	if( flag == VAO )
 	{
-		GLuint vbo;
-		glCreateBuffers( 1, &vbo );
-		objects[VBO] = vbo;
+		glCreateVertexArrays( 1, &object );
 	}
-	else if( flag & INSTANCE_VBO )
+	else if( flag == TFBO )
 	{
-		GLuint vbo;
-		glCreateBuffers( 1, &vbo );
-		objects[INSTANCE_VBO] = vbo;
+		glCreateTransformFeedbacks( 1, &object );
 	}
-	else if( flag & EBO )
+	else
 	{
-		GLuint ebo;
-		glCreateBuffers( 1, &ebo );
-		objects[EBO] = ebo;
+		glCreateBuffers( 1, &object );
 	}
-	else if( flag & DIBO )
+}
+
+/**
+* @brief sends delete command to OpenGL for a single GL object and zeroes its ID
+* @param flag single flag of the GL object type
+* @param object ID of the object to be deleted
+*/
+void BufferCollection::deleteObject( int flag,
+									 GLuint & object )
+{
+	if( flag == VAO )
 	{
-		GLuint dibo;
-		glCreateBuffers( 1, &dibo );
-		objects[DIBO] = dibo;
+		if( boundObjects[BIND_TARGET_VERTEX_ARRAY] == object )
+		{
+			//OpenGL reverts to the default VAO, whose element array binding is not tracked
+			boundObjects[BIND_TARGET_VERTEX_ARRAY] = 0;
+			boundObjects[BIND_TARGET_ELEMENT_ARRAY_BUFFER] = UNKNOWN_BINDING;
+		}
+		glDeleteVertexArrays( 1, &object );
 	}
-	else if( flag & TFBO )
+	else if( flag == TFBO )
 	{
-		GLuint tfbo;
-		glCreateTransformFeedbacks( 1, &tfbo );
-		objects[TFBO] = tfbo;
+		forgetDeleted( BIND_TARGET_TRANSFORM_FEEDBACK, object );
+		glDeleteTransformFeedbacks( 1, &object );
 	}
 	else
 	{
-		throw std::invalid_argument( "Unknown GL object enum flag" );
+		forgetDeleted( BIND_TARGET_ARRAY_BUFFER, object );
+		forgetDeleted( BIND_TARGET_ELEMENT_ARRAY_BUFFER, object );
+		forgetDeleted( BIND_TARGET_DRAW_INDIRECT_BUFFER, object );
+		glDeleteBuffers( 1, &object );
 	}
+	object = 0;
 }
@@ -21,7 +21,7 @@
 #pragma once
 
 #include <GL/glew.h>
-#include <unordered_map>
+#include <array>
 
 constexpr unsigned char QUAD_INDICES[6] = { 0,1,2,2,3,0 };
 constexpr unsigned int VERTICES_PER_QUAD = 6;
@@ -41,10 +41,33 @@ enum OPENGL_OBJECT : int
 	TFBO = 0x100000
 };
 
+constexpr unsigned int NUM_OPENGL_OBJECT_SLOTS = 6;
+
+/**
+* @brief returns storage slot of the first (in the enum order) GL object of the given flags union,
+* each flag takes its own hex digit thus slot is the index of that digit. Returns NUM_OPENGL_OBJECT_SLOTS for unknown flags
+* @param flags integer union of individual flags
+*/
+constexpr unsigned int openglObjectSlot( int flags ) noexcept
+{
+	unsigned int slot = 0;
+	while( slot < NUM_OPENGL_OBJECT_SLOTS && !( flags & ( 1 << ( slot * 4 ) ) ) )
+	{
+		++slot;
+	}
+	return slot;
+}
+
+static_assert( openglObjectSlot( VAO ) == 0 && openglObjectSlot( TFBO ) == NUM_OPENGL_OBJECT_SLOTS - 1, "GL object flags should map to consecutive slots" );
+static_assert( openglObjectSlot( EBO | VBO ) == openglObjectSlot( VBO ), "first flag in the enum order should be decoded" );
+
 /**
 * @brief a collection of OpenGL buffer objects, which are to be used as a complete buffer pipeline.
 * Responsible for managing all the "glCreate/Bind/Delete" stuff and creating a collection of OpenGL objects
-* using just a set of flags representing each object's type
+* using just a set of flags representing each object's type.
+* Objects are kept in a fixed array indexed by the flag slot. Currently bound objects are tracked for all the collections,
+* thus redundant bind calls are not sent to OpenGL
+* @note tracking relies on all the GL objects bindings going through this class
 */
 class BufferCollection
 {
@@ -55,13 +78,118 @@ public:
 	BufferCollection( BufferCollection & copy );
 	virtual ~BufferCollection();
 	static void bindZero( int flags ) noexcept;
+	static void finishFrame() noexcept;
+	static unsigned int getNumBindsThisFrame() noexcept;
+	static unsigned int getNumSkippedBindsThisFrame() noexcept;
+	static unsigned int getNumBindsLastFrame() noexcept;
+	static unsigned int getNumSkippedBindsLastFrame() noexcept;
 	void create( int flags );
 	void deleteBuffers();
 	void deleteBuffer( int flag );
 	GLuint & get( int flag );
-	void bind( int flag );
+	void bind( int flags ) noexcept;
 	void add( int flag );
 
 private:
-	std::unordered_map<int, GLuint> objects;
+	/**
+	* @brief binding points of GL objects, VBO and instance VBO share the array buffer binding point
+	*/
+	enum BIND_TARGET : unsigned int
+	{
+		BIND_TARGET_VERTEX_ARRAY,
+		BIND_TARGET_ARRAY_BUFFER,
+		BIND_TARGET_ELEMENT_ARRAY_BUFFER,
+		BIND_TARGET_DRAW_INDIRECT_BUFFER,
+		BIND_TARGET_TRANSFORM_FEEDBACK,
+		NUM_BIND_TARGETS
+	};
+
+	/** @brief binding of the element array buffer is a part of VAO state, so it is unknown after VAO switch */
+	constexpr static GLuint UNKNOWN_BINDING = ~GLuint( 0 );
+
+	static void bindTracked( BIND_TARGET target,
+							 GLuint object ) noexcept;
+	static void forgetDeleted( BIND_TARGET target,
+							   GLuint object ) noexcept;
+	static void createObject( int flag,
+							  GLuint & object );
+	static void deleteObject( int flag,
+							  GLuint & object );
+
+	static GLuint boundObjects[NUM_BIND_TARGETS];
+	static unsigned int numBindsThisFrame;
+	static unsigned int numSkippedBindsThisFrame;
+	static unsigned int numBindsLastFrame;
+	static unsigned int numSkippedBindsLastFrame;
+
+	std::array<GLuint, NUM_OPENGL_OBJECT_SLOTS> objects = {};
 };
+
+/**
+* @brief sends bind command to OpenGL for a chosen GL objects unless they are bound already.
+* Defined inline, thus flags known at compile time are decoded by the compiler
+* @param flags integer union of individual flags
+*/
+inline void BufferCollection::bind( int flags ) noexcept
+{
+	if( flags & VAO )
+	{
+		bindTracked( BIND_TARGET_VERTEX_ARRAY, objects[openglObjectSlot( VAO )] );
+	}
+	if( flags & VBO )
+	{
+		bindTracked( BIND_TARGET_ARRAY_BUFFER, objects[openglObjectSlot( VBO )] );
+	}
+	if( flags & INSTANCE_VBO )
+	{
+		bindTracked( BIND_TARGET_ARRAY_BUFFER, objects[openglObjectSlot( INSTANCE_VBO )] );
+	}
+	if( flags & EBO )
+	{
+		bindTracked( BIND_TARGET_ELEMENT_ARRAY_BUFFER, objects[openglObjectSlot( EBO )] );
+	}
+	if( flags & DIBO )
+	{
+		bindTracked( BIND_TARGET_DRAW_INDIRECT_BUFFER, objects[openglObjectSlot( DIBO )] );
+	}
+	if( flags & TFBO )
+	{
+		bindTracked( BIND_TARGET_TRANSFORM_FEEDBACK, objects[openglObjectSlot( TFBO )] );
+	}
+}
+
+/**
+* @brief binds object to the given target if some other object is bound there, counts both sent and skipped binds
+* @param target binding point
+* @param object GL object to bind
+*/
+inline void BufferCollection::bindTracked( BIND_TARGET target,
+										   GLuint object ) noexcept
+{
+	if( boundObjects[target] == object )
+	{
+		++numSkippedBindsThisFrame;
+		return;
+	}
+	boundObjects[target] = object;
+	++numBindsThisFrame;
+	switch( target )
+	{
+	case BIND_TARGET_VERTEX_ARRAY:
+		glBindVertexArray( object );
+		boundObjects[BIND_TARGET_ELEMENT_ARRAY_BUFFER] = UNKNOWN_BINDING;
+		break;
+	case BIND_TARGET_ARRAY_BUFFER:
+		glBindBuffer( GL_ARRAY_BUFFER, object );
+		break;
+	case BIND_TARGET_ELEMENT_ARRAY_BUFFER:
+		glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, object );
+		break;
+	case BIND_TARGET_DRAW_INDIRECT_BUFFER:
+		glBindBuffer( GL_DRAW_INDIRECT_BUFFER, object );
+		break;
+	default:
+		glBindTransformFeedback( GL_TRANSFORM_FEEDBACK, object );
+		break;
+	}
+}
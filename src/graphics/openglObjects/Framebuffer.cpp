@@ -21,6 +21,7 @@
 #include "Framebuffer"
 #include "TextureManager"
 #include "Logger"
+#include "RendererState"
 
 /**
 * @brief plain ctor. Creates a framebuffer object on the OpenGL side
@@ -36,6 +37,7 @@ Framebuffer::Framebuffer( TextureManager & textureManager ) noexcept
 */
 Framebuffer::~Framebuffer()
 {
+	RendererState::forgetFramebuffer( fbo );
 	glDeleteFramebuffers( 1, &fbo );
 }
 
@@ -59,8 +61,8 @@ void Framebuffer::checkStatus()
 void Framebuffer::bindToViewport( int viewportWidth, 
 								  int viewportHeight ) noexcept
 {
-	glBindFramebuffer( GL_FRAMEBUFFER, fbo );
-	glViewport( 0, 0, viewportWidth, viewportHeight );
+	RendererState::bindFramebuffer( GL_FRAMEBUFFER, fbo );
+	RendererState::setViewport( 0, 0, viewportWidth, viewportHeight );
 }
 
 /**
@@ -71,6 +73,6 @@ void Framebuffer::bindToViewport( int viewportWidth,
 void Framebuffer::unbindToViewport( int viewportWidth, 
 									int viewportHeight ) noexcept
 {
-	glBindFramebuffer( GL_FRAMEBUFFER, 0 );
-	glViewport( 0, 0, viewportWidth, viewportHeight );
+	RendererState::bindFramebuffer( GL_FRAMEBUFFER, 0 );
+	RendererState::setViewport( 0, 0, viewportWidth, viewportHeight );
 }
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * IndirectCommandRing.cpp
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains definitions for IndirectCommandRing class
+ * @version 0.1.0
+ */
+
+#include "IndirectCommandRing"
+#include "Logger"
+
+#include <string>
+
+/** @brief time (in nanoseconds) of a single wait for a region fence before retrying */
+constexpr GLuint64 REGION_FENCE_WAIT_TIMEOUT = 1000000;
+
+/**
+* @brief creates immutable storage for all the regions and maps it once for the whole lifetime of the ring
+* @param regionCapacity maximum number of draw commands that could be written during one frame
+*/
+IndirectCommandRing::IndirectCommandRing( GLsizei regionCapacity )
+	: buffers( DIBO )
+	, regionCapacity( regionCapacity )
+	, currentRegion( 0 )
+	, regionFill( 0 )
+	, regionRejectedCommands( 0 )
+	, maxReportedRejectedCommands( 0 )
+	, lastRejectedCommands( 0 )
+	, regionFences{}
+{
+	const GLbitfield MAP_FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	const GLsizeiptr BUFFER_SIZE = INDIRECT_DRAW_COMMAND_BYTE_SIZE * regionCapacity * NUM_REGIONS;
+	glNamedBufferStorage( buffers.get( DIBO ), BUFFER_SIZE, nullptr, MAP_FLAGS );
+	mappedCommands = static_cast<GLuint*>( glMapNamedBufferRange( buffers.get( DIBO ), 0, BUFFER_SIZE, MAP_FLAGS ) );
+}
+
+/**
+* @brief releases fences and the mapping, buffer itself is deleted by its collection
+*/
+IndirectCommandRing::~IndirectCommandRing()
+{
+	for( GLsync & fence : regionFences )
+	{
+		if( fence )
+		{
+			glDeleteSync( fence );
+		}
+	}
+	glUnmapNamedBuffer( buffers.get( DIBO ) );
+}
+
+/**
+* @brief reserves space for a given number of draw commands in the current region. Might be called from any thread
+* @param numCommands number of draw commands to reserve
+* @param range location of reserved commands to draw with
+* @return pointer to the mapped memory to write commands to or nullptr if the region has no room left for all the commands
+* (nothing should be drawn then, rejected commands are counted and reported on advance)
+* @note returned memory is write-only, reading it back might be very slow
+*/
+GLuint * IndirectCommandRing::allocate( GLsizei numCommands,
+										IndirectCommandRange & range ) noexcept
+{
+	range.numCommands = 0;
+	if( numCommands == 0 )
+	{
+		return nullptr;
+	}
+	//fill is only increased if the commands fit, so a rejected request does not starve smaller ones made after it
+	GLsizei firstCommand = regionFill.load();
+	do
+	{
+		if( numCommands > regionCapacity - firstCommand )
+		{
+			regionRejectedCommands.fetch_add( numCommands );
+			return nullptr;
+		}
+	}
+	while( !regionFill.compare_exchange_weak( firstCommand, firstCommand + numCommands ) );
+	const GLsizei COMMAND_INDEX = currentRegion * regionCapacity + firstCommand;
+	range.byteOffset = INDIRECT_DRAW_COMMAND_BYTE_SIZE * COMMAND_INDEX;
+	range.numCommands = numCommands;
+	return mappedCommands + COMMAND_INDEX * INDIRECT_DRAW_COMMAND_ARGUMENTS;
+}
+
+/**
+* @brief protects the current region with a fence and switches to the next one.
+* Should be called from the main thread after all draw calls consuming the current region have been sent
+* and before producers start writing commands for the next frame
+* @note blocks if GPU has not finished with the next region yet (which means GPU is more than two frames behind)
+*/
+void IndirectCommandRing::advance()
+{
+	//report each new maximum of rejected commands only, so that an undersized ring does not flood the log every frame
+	lastRejectedCommands = regionRejectedCommands.exchange( 0 );
+	if( lastRejectedCommands > maxReportedRejectedCommands )
+	{
+		maxReportedRejectedCommands = lastRejectedCommands;
+		Logger::log( "Indirect command ring overflow: % of % commands rejected during a frame, increase indirect_commands_per_frame\n",
+					 std::to_string( lastRejectedCommands ).c_str(),
+					 std::to_string( lastRejectedCommands + regionFill ).c_str() );
+	}
+	regionFences[currentRegion] = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+	currentRegion = ( currentRegion + 1 ) % NUM_REGIONS;
+	GLsync & nextRegionFence = regionFences[currentRegion];
+	if( nextRegionFence )
+	{
+		GLenum waitStatus = glClientWaitSync( nextRegionFence, GL_SYNC_FLUSH_COMMANDS_BIT, REGION_FENCE_WAIT_TIMEOUT );
+		while( waitStatus == GL_TIMEOUT_EXPIRED )
+		{
+			waitStatus = glClientWaitSync( nextRegionFence, 0, REGION_FENCE_WAIT_TIMEOUT );
+		}
+		glDeleteSync( nextRegionFence );
+		nextRegionFence = nullptr;
+	}
+	regionFill = 0;
+}
+
+/**
+* @brief binds ring buffer as the draw indirect buffer, ranges offsets are relative to the buffer start
+*/
+void IndirectCommandRing::bind()
+{
+	buffers.bind( DIBO );
+}
+
+/**
+* @brief returns number of draw commands that did not fit into the region of the previous frame
+*/
+GLsizei IndirectCommandRing::getNumRejectedCommands() const noexcept
+{
+	return lastRejectedCommands;
+}
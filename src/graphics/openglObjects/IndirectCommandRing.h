@@ -0,0 +1,67 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * IndirectCommandRing.h
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains declaration for IndirectCommandRing class and IndirectCommandRange structure
+ * @version 0.1.0
+ */
+
+#pragma once
+
+#include "BufferCollection"
+
+#include <atomic>
+
+/**
+* @brief location of the indirect draw commands written into the ring for the current frame
+*/
+struct IndirectCommandRange
+{
+	GLintptr byteOffset = 0;
+	GLsizei numCommands = 0;
+};
+
+/**
+* @brief shared storage for indirect draw commands of all the indirect renderers.
+* Buffer is persistently and coherently mapped and split into several regions, one region per frame in flight.
+* Producers (including the coroutine thread) write commands straight into the mapped memory of the current region,
+* region is protected by a fence before reusing, thus no explicit buffer uploads are needed
+*/
+class IndirectCommandRing
+{
+public:
+	constexpr static unsigned int NUM_REGIONS = 3;
+
+	explicit IndirectCommandRing( GLsizei regionCapacity );
+	IndirectCommandRing( const IndirectCommandRing & ) = delete;
+	IndirectCommandRing & operator=( const IndirectCommandRing & ) = delete;
+	virtual ~IndirectCommandRing();
+	GLuint * allocate( GLsizei numCommands,
+					   IndirectCommandRange & range ) noexcept;
+	void advance();
+	void bind();
+	GLsizei getNumRejectedCommands() const noexcept;
+
+private:
+	BufferCollection buffers;
+	GLuint * mappedCommands;
+	GLsizei regionCapacity;
+	unsigned int currentRegion;
+	std::atomic<GLsizei> regionFill;
+	std::atomic<GLsizei> regionRejectedCommands;
+	GLsizei maxReportedRejectedCommands;
+	GLsizei lastRejectedCommands;
+	GLsync regionFences[NUM_REGIONS];
+};
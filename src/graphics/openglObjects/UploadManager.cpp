@@ -0,0 +1,276 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * UploadManager.cpp
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains definitions for UploadManager class
+ * @version 0.1.0
+ */
+
+#include "UploadManager"
+#include "SettingsManager"
+
+#include <algorithm>
+#include <cstring>
+
+/** @brief time (in nanoseconds) of a single wait for a staging fence before retrying */
+constexpr GLuint64 STAGING_FENCE_WAIT_TIMEOUT = 1000000;
+
+/**
+* @brief creates staging buffer of the configured size and maps it once for the whole lifetime of the manager
+*/
+UploadManager::UploadManager()
+	: headPosition( 0 )
+	, tailPosition( 0 )
+	, bytesUploadedThisFrame( 0 )
+	, bytesUploadedLastFrame( 0 )
+{
+	const GLsizeiptr CONFIG_CAPACITY = GLsizeiptr( SettingsManager::getInt( "GRAPHICS", "upload_staging_buffer_size" ) ) * 1024 * 1024;
+	stagingCapacity = std::max( CONFIG_CAPACITY / STAGING_ALIGNMENT, GLsizeiptr( 1 ) ) * STAGING_ALIGNMENT;
+	const GLbitfield MAP_FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	glCreateBuffers( 1, &stagingBuffer );
+	glNamedBufferStorage( stagingBuffer, stagingCapacity, nullptr, MAP_FLAGS );
+	mappedStaging = static_cast<char*>( glMapNamedBufferRange( stagingBuffer, 0, stagingCapacity, MAP_FLAGS ) );
+}
+
+/**
+* @brief returns instance of the manager
+*/
+UploadManager & UploadManager::getInstance()
+{
+	static UploadManager instance;
+	return instance;
+}
+
+/**
+* @brief submits pending copies and releases staging buffer. Should be called before the GL context is destroyed
+*/
+void UploadManager::release()
+{
+	flush();
+	for( StagingFence & stagingFence : fences )
+	{
+		glDeleteSync( stagingFence.fence );
+	}
+	fences.clear();
+	if( stagingBuffer != 0 )
+	{
+		glUnmapNamedBuffer( stagingBuffer );
+		glDeleteBuffers( 1, &stagingBuffer );
+		stagingBuffer = 0;
+		mappedStaging = nullptr;
+	}
+}
+
+/**
+* @brief (re)specifies storage of the buffer if its size has changed and uploads whole data through the staging buffer
+* @param buffer destination buffer
+* @param size size of the data in bytes
+* @param data data to upload
+* @param usage usage hint used if the storage should be (re)specified
+*/
+void UploadManager::uploadBufferData( GLuint buffer,
+									  GLsizeiptr size,
+									  const void * data,
+									  GLenum usage )
+{
+	GLint64 currentSize = 0;
+	glGetNamedBufferParameteri64v( buffer, GL_BUFFER_SIZE, &currentSize );
+	if( currentSize != size )
+	{
+		//pending copies to this buffer are still sized for the old storage, so they should be sent before it is replaced
+		flush();
+		glNamedBufferData( buffer, size, nullptr, usage );
+	}
+	uploadBufferSubData( buffer, 0, size, data );
+}
+
+/**
+* @brief copies data to the staging buffer and schedules its copy to the destination buffer.
+* Data larger than the staging buffer is split into parts, if there is no free staging memory
+* pending copies are flushed and the oldest batch is waited for
+* @param buffer destination buffer with allocated storage
+* @param offset offset in the destination buffer
+* @param size size of the data in bytes
+* @param data data to upload
+* @note copies are only sent to OpenGL during flush, thus flush should be called before the data is used
+*/
+void UploadManager::uploadBufferSubData( GLuint buffer,
+										 GLintptr offset,
+										 GLsizeiptr size,
+										 const void * data )
+{
+	const char * source = static_cast<const char*>( data );
+	while( size > 0 )
+	{
+		const GLsizeiptr PART_SIZE = std::min( size, stagingCapacity );
+		StagingRange range;
+		void * stagingMemory = reserve( PART_SIZE, range );
+		while( !stagingMemory )
+		{
+			flush();
+			retireFences( true );
+			stagingMemory = reserve( PART_SIZE, range );
+		}
+		std::memcpy( stagingMemory, source, PART_SIZE );
+		commit( range, buffer, offset );
+		source += PART_SIZE;
+		offset += PART_SIZE;
+		size -= PART_SIZE;
+	}
+}
+
+/**
+* @brief reserves contiguous staging memory. Might be called from any thread
+* @param size number of bytes to reserve
+* @param range location of the reserved memory to commit later
+* @return pointer to the mapped memory to write data to or nullptr if there is no free staging memory at the moment
+* @note reserved memory should be committed as soon as it is filled, until then it is not reused even after flushes
+*/
+void * UploadManager::reserve( GLsizeiptr size,
+							   StagingRange & range )
+{
+	std::lock_guard<std::mutex> lock( stagingMutex );
+	if( !tryReserve( size, range ) )
+	{
+		return nullptr;
+	}
+	openReservations.push_back( range.position );
+	return mappedStaging + range.stagingOffset;
+}
+
+/**
+* @brief schedules copy of the filled staging memory to the destination buffer. Might be called from any thread
+* @param range location of the reserved memory
+* @param buffer destination buffer with allocated storage
+* @param offset offset in the destination buffer
+*/
+void UploadManager::commit( const StagingRange & range,
+							GLuint buffer,
+							GLintptr offset )
+{
+	std::lock_guard<std::mutex> lock( stagingMutex );
+	openReservations.erase( std::find( openReservations.begin(), openReservations.end(), range.position ) );
+	pendingCopies.push_back( { range.stagingOffset, buffer, offset, range.size } );
+	bytesUploadedThisFrame += range.size;
+}
+
+/**
+* @brief sends all the pending copies to OpenGL and protects their staging memory with a fence
+*/
+void UploadManager::flush()
+{
+	uint64_t releasePosition;
+	{
+		std::lock_guard<std::mutex> lock( stagingMutex );
+		if( pendingCopies.empty() )
+		{
+			return;
+		}
+		flushedCopies.swap( pendingCopies );
+		//memory of the reservations which are still being filled should not be released by this batch
+		releasePosition = openReservations.empty() ? headPosition : *std::min_element( openReservations.begin(), openReservations.end() );
+	}
+	for( const PendingCopy & copy : flushedCopies )
+	{
+		glCopyNamedBufferSubData( stagingBuffer, copy.buffer, copy.stagingOffset, copy.bufferOffset, copy.size );
+	}
+	flushedCopies.clear();
+	fences.push_back( { glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 ), releasePosition } );
+}
+
+/**
+* @brief flushes copies of the frame, releases staging memory of the finished batches and updates upload statistics.
+* Should be called once per frame
+*/
+void UploadManager::finishFrame()
+{
+	flush();
+	retireFences( false );
+	std::lock_guard<std::mutex> lock( stagingMutex );
+	bytesUploadedLastFrame = bytesUploadedThisFrame;
+	bytesUploadedThisFrame = 0;
+}
+
+GLsizeiptr UploadManager::getBytesUploadedLastFrame() const noexcept
+{
+	return bytesUploadedLastFrame;
+}
+
+/**
+* @brief tries to reserve contiguous staging memory without waiting, the caller should hold staging mutex
+* @param size number of bytes to reserve
+* @param range location of the reserved memory
+*/
+bool UploadManager::tryReserve( GLsizeiptr size,
+								StagingRange & range ) noexcept
+{
+	const GLsizeiptr ALIGNED_SIZE = ( size + STAGING_ALIGNMENT - 1 ) / STAGING_ALIGNMENT * STAGING_ALIGNMENT;
+	const uint64_t CAPACITY = uint64_t( stagingCapacity );
+	if( size <= 0 || ALIGNED_SIZE > stagingCapacity )
+	{
+		return false;
+	}
+	if( headPosition == tailPosition )
+	{
+		//staging buffer is idle, start from its beginning
+		headPosition = tailPosition = ( headPosition + CAPACITY - 1 ) / CAPACITY * CAPACITY;
+	}
+	uint64_t position = headPosition;
+	GLintptr stagingOffset = GLintptr( position % CAPACITY );
+	if( stagingOffset + ALIGNED_SIZE > stagingCapacity )
+	{
+		//reserved memory should be contiguous, so skip the end of the buffer
+		position += CAPACITY - stagingOffset;
+		stagingOffset = 0;
+	}
+	if( position + ALIGNED_SIZE - tailPosition > CAPACITY )
+	{
+		return false;
+	}
+	headPosition = position + ALIGNED_SIZE;
+	range.stagingOffset = stagingOffset;
+	range.size = size;
+	range.position = position;
+	return true;
+}
+
+/**
+* @brief releases staging memory of the batches the GPU has finished with, main thread only
+* @param waitForOldest whether to block until at least the oldest batch is finished
+*/
+void UploadManager::retireFences( bool waitForOldest )
+{
+	while( !fences.empty() )
+	{
+		StagingFence & oldest = fences.front();
+		const GLenum WAIT_STATUS = waitForOldest ? glClientWaitSync( oldest.fence, GL_SYNC_FLUSH_COMMANDS_BIT, STAGING_FENCE_WAIT_TIMEOUT )
+												 : glClientWaitSync( oldest.fence, 0, 0 );
+		if( WAIT_STATUS == GL_TIMEOUT_EXPIRED )
+		{
+			if( waitForOldest )
+			{
+				continue;
+			}
+			return;
+		}
+		glDeleteSync( oldest.fence );
+		{
+			std::lock_guard<std::mutex> lock( stagingMutex );
+			tailPosition = std::max( tailPosition, oldest.releasePosition );
+		}
+		fences.pop_front();
+		waitForOldest = false;
+	}
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * UploadManager.h
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains declaration for UploadManager class and StagingRange structure
+ * @version 0.1.0
+ */
+
+#pragma once
+
+#include <GL/glew.h>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+/**
+* @brief location of the reserved staging memory
+*/
+struct StagingRange
+{
+	GLintptr stagingOffset = 0;
+	GLsizeiptr size = 0;
+	uint64_t position = 0;
+};
+
+/**
+* @brief manager of all the buffer data transfers. Owns persistently mapped staging buffer used as a ring,
+* data is written to the staging memory and copied to the destination buffers on the GPU side with batches of
+* glCopyNamedBufferSubData calls, each batch is protected by a fence until the GPU has finished reading it.
+* Staging memory might be reserved and filled from any thread, while GL related calls (uploads, flushes)
+* should be done from the rendering thread only. The first call to getInstance should be made from the rendering thread as well
+*/
+class UploadManager final
+{
+public:
+	static UploadManager & getInstance();
+	void release();
+	void uploadBufferData( GLuint buffer,
+						   GLsizeiptr size,
+						   const void * data,
+						   GLenum usage );
+	void uploadBufferSubData( GLuint buffer,
+							  GLintptr offset,
+							  GLsizeiptr size,
+							  const void * data );
+	void * reserve( GLsizeiptr size,
+					StagingRange & range );
+	void commit( const StagingRange & range,
+				 GLuint buffer,
+				 GLintptr offset );
+	void flush();
+	void finishFrame();
+	GLsizeiptr getBytesUploadedLastFrame() const noexcept;
+
+private:
+	/**
+	* @brief copy from the staging buffer waiting for the next flush
+	*/
+	struct PendingCopy
+	{
+		GLintptr stagingOffset;
+		GLuint buffer;
+		GLintptr bufferOffset;
+		GLsizeiptr size;
+	};
+
+	/**
+	* @brief fence of the flushed batch, staging memory before release position is free once the fence is signaled
+	*/
+	struct StagingFence
+	{
+		GLsync fence;
+		uint64_t releasePosition;
+	};
+
+	UploadManager();
+	bool tryReserve( GLsizeiptr size,
+					 StagingRange & range ) noexcept;
+	void retireFences( bool waitForOldest );
+
+	constexpr static GLsizeiptr STAGING_ALIGNMENT = 64;
+
+	GLuint stagingBuffer;
+	char * mappedStaging;
+	GLsizeiptr stagingCapacity;
+
+	//positions only grow, offset in the staging buffer is the position modulo capacity
+	std::mutex stagingMutex;
+	uint64_t headPosition;
+	uint64_t tailPosition;
+	std::vector<uint64_t> openReservations;
+	std::vector<PendingCopy> pendingCopies;
+	std::vector<PendingCopy> flushedCopies;
+	std::deque<StagingFence> fences;
+	GLsizeiptr bytesUploadedThisFrame;
+	GLsizeiptr bytesUploadedLastFrame;
+};
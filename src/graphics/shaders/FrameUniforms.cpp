@@ -0,0 +1,117 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * FrameUniforms.cpp
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains definitions for FrameUniforms class
+ * @version 0.1.0
+ */
+
+#include "FrameUniforms"
+#include "UploadManager"
+
+#include <algorithm>
+
+/**
+* @brief creates zero-initialized storage for all the blocks (one camera block per view)
+* and binds lighting and shadow blocks to their binding points once for the whole lifetime
+*/
+FrameUniforms::FrameUniforms()
+	: buffers( VBO )
+	, boundCameraView( NUM_CAMERA_VIEWS )
+{
+	GLintptr bufferSize = 0;
+	for( GLintptr & cameraOffset : cameraOffsets )
+	{
+		cameraOffset = bufferSize;
+		bufferSize += alignedSize( sizeof( CameraBlock ) );
+	}
+	lightingOffset = bufferSize;
+	bufferSize += alignedSize( sizeof( LightingBlock ) );
+	shadowOffset = bufferSize;
+	bufferSize += alignedSize( sizeof( ShadowBlock ) );
+
+	const GLuint UBO = buffers.get( VBO );
+	glNamedBufferStorage( UBO, bufferSize, nullptr, GL_DYNAMIC_STORAGE_BIT );
+	glClearNamedBufferData( UBO, GL_R8UI, GL_RED_INTEGER, GL_UNSIGNED_BYTE, nullptr );
+	glBindBufferRange( GL_UNIFORM_BUFFER, UNIFORM_BLOCK_LIGHTING, UBO, lightingOffset, sizeof( LightingBlock ) );
+	glBindBufferRange( GL_UNIFORM_BUFFER, UNIFORM_BLOCK_SHADOW, UBO, shadowOffset, sizeof( ShadowBlock ) );
+	bindCamera( CAMERA_VIEW_MAIN );
+}
+
+/**
+* @brief updates camera block of the given view
+* @param view view to update
+* @param projectionView 'projection * view' matrix
+* @param ambienceProjectionView 'projection * view' matrix without translation (for skyboxes, the sun etc.)
+* @param viewPosition position of the camera
+*/
+void FrameUniforms::updateCamera( CAMERA_VIEW view,
+								  const glm::mat4 & projectionView,
+								  const glm::mat4 & ambienceProjectionView,
+								  const glm::vec3 & viewPosition )
+{
+	const CameraBlock BLOCK{ projectionView, ambienceProjectionView, glm::vec4( viewPosition, 1.0f ) };
+	UploadManager::getInstance().uploadBufferSubData( buffers.get( VBO ), cameraOffsets[view], sizeof( BLOCK ), &BLOCK );
+}
+
+/**
+* @brief updates lighting block
+* @param lightDir direction of the sunlight, shaders get the reverse direction (towards the sun)
+*/
+void FrameUniforms::updateLighting( const glm::vec3 & lightDir )
+{
+	const LightingBlock BLOCK{ glm::vec4( -lightDir, 0.0f ) };
+	UploadManager::getInstance().uploadBufferSubData( buffers.get( VBO ), lightingOffset, sizeof( BLOCK ), &BLOCK );
+}
+
+/**
+* @brief updates shadow block
+* @param lightSpaceMatrices 'projection * view' matrices of the shadow layers
+*/
+void FrameUniforms::updateShadows( const std::array<glm::mat4, NUM_SHADOW_LAYERS> & lightSpaceMatrices )
+{
+	ShadowBlock block;
+	std::copy( lightSpaceMatrices.begin(), lightSpaceMatrices.end(), block.lightSpaceMatrices );
+	UploadManager::getInstance().uploadBufferSubData( buffers.get( VBO ), shadowOffset, sizeof( block ), &block );
+}
+
+/**
+* @brief binds camera block range of the given view, does nothing if that view is already bound
+* @param view view to be used by subsequent draw calls
+*/
+void FrameUniforms::bindCamera( CAMERA_VIEW view ) noexcept
+{
+	if( view == boundCameraView )
+	{
+		return;
+	}
+	glBindBufferRange( GL_UNIFORM_BUFFER, UNIFORM_BLOCK_CAMERA, buffers.get( VBO ), cameraOffsets[view], sizeof( CameraBlock ) );
+	boundCameraView = view;
+}
+
+/**
+* @brief rounds size of a block up to the uniform buffer offset alignment so that the next block could be bound as range
+* @param size size of a block in bytes
+*/
+GLintptr FrameUniforms::alignedSize( GLsizeiptr size ) const noexcept
+{
+	GLint offsetAlignment = 0;
+	glGetIntegerv( GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment );
+	if( offsetAlignment <= 0 )
+	{
+		return size;
+	}
+	return ( size + offsetAlignment - 1 ) / offsetAlignment * offsetAlignment;
+}
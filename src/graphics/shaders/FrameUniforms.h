@@ -0,0 +1,97 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * FrameUniforms.h
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains declaration for FrameUniforms class
+ * @version 0.1.0
+ */
+
+#pragma once
+
+#include "BufferCollection"
+#include "GraphicsConstants"
+
+#include <array>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+
+/**
+* @brief uniform block binding points, must match bindings declared in frameUniforms.ivs
+*/
+enum UNIFORM_BLOCK_BINDING : GLuint
+{
+	UNIFORM_BLOCK_CAMERA = 0,
+	UNIFORM_BLOCK_LIGHTING = 1,
+	UNIFORM_BLOCK_SHADOW = 2
+};
+
+/**
+* @brief views the camera block is prepared for during a frame
+*/
+enum CAMERA_VIEW : int
+{
+	CAMERA_VIEW_MAIN = 0,
+	CAMERA_VIEW_REFLECTION,
+	NUM_CAMERA_VIEWS
+};
+
+/**
+* @brief owner of the per-frame uniform data shared by all the shader programs (camera, lighting and shadow matrices).
+* Data is kept in one uniform buffer as std140 blocks, each camera view has its own range of the buffer,
+* thus switching between views during a frame is just a glBindBufferRange call.
+* Updates go through the upload manager, hence should be made before its flush
+*/
+class FrameUniforms
+{
+public:
+	FrameUniforms();
+	FrameUniforms( const FrameUniforms & ) = delete;
+	FrameUniforms & operator=( const FrameUniforms & ) = delete;
+	void updateCamera( CAMERA_VIEW view,
+					   const glm::mat4 & projectionView,
+					   const glm::mat4 & ambienceProjectionView,
+					   const glm::vec3 & viewPosition );
+	void updateLighting( const glm::vec3 & lightDir );
+	void updateShadows( const std::array<glm::mat4, NUM_SHADOW_LAYERS> & lightSpaceMatrices );
+	void bindCamera( CAMERA_VIEW view ) noexcept;
+
+private:
+	/** @note vec3 members are padded to vec4 as std140 requires */
+	struct CameraBlock
+	{
+		glm::mat4 projectionView;
+		glm::mat4 ambienceProjectionView;
+		glm::vec4 viewPosition;
+	};
+
+	struct LightingBlock
+	{
+		glm::vec4 lightDir;
+	};
+
+	struct ShadowBlock
+	{
+		glm::mat4 lightSpaceMatrices[NUM_SHADOW_LAYERS];
+	};
+
+	GLintptr alignedSize( GLsizeiptr size ) const noexcept;
+
+	BufferCollection buffers;
+	GLintptr cameraOffsets[NUM_CAMERA_VIEWS];
+	GLintptr lightingOffset;
+	GLintptr shadowOffset;
+	CAMERA_VIEW boundCameraView;
+};
@@ -22,10 +22,13 @@
 #include "Logger"
 #include "ShaderResourceLoader"
 #include "SettingsManager"
+#include "RendererState"
 
 #include <glm/gtc/type_ptr.hpp>
 
 bool Shader::useCachingOfUniforms = false;
+unsigned int Shader::numUniformCallsThisFrame = 0;
+unsigned int Shader::numUniformCallsLastFrame = 0;
 
 /**
 * @brief sets uniforms caching mode
@@ -36,6 +39,23 @@ void Shader::setCachingOfUniformsMode( bool useCache ) noexcept
 	Shader::useCachingOfUniforms = useCache;
 }
 
+/**
+* @brief closes uniform calls statistics of the current frame, should be called once per frame
+*/
+void Shader::finishFrame() noexcept
+{
+	numUniformCallsLastFrame = numUniformCallsThisFrame;
+	numUniformCallsThisFrame = 0;
+}
+
+/**
+* @brief returns number of glUniform* calls sent by all the shader programs during the last frame
+*/
+unsigned int Shader::getNumUniformCallsLastFrame() noexcept
+{
+	return numUniformCallsLastFrame;
+}
+
 /**
 * @brief plain ctor that creates a program consisting of only vertex shader
 * @param srcFile1 source file
@@ -129,7 +149,7 @@ GLuint Shader::getID() const noexcept
 */
 void Shader::use() const noexcept
 {
-	glUseProgram( ID );
+	RendererState::useProgram( ID );
 }
 
 /**
@@ -154,6 +174,7 @@ GLuint Shader::getUniformLocation( const char * uniformName ) const
 void Shader::setInt( const char * uniformName, 
 					 int value )
 {
+	++numUniformCallsThisFrame;
 	if( Shader::useCachingOfUniforms )
 	{
 		if( uniformCache.find( uniformName ) == uniformCache.end() )
@@ -176,6 +197,7 @@ void Shader::setInt( const char * uniformName,
 void Shader::setUint64( const char * uniformName, 
 						GLuint64 value )
 {
+	++numUniformCallsThisFrame;
 	if( Shader::useCachingOfUniforms )
 	{
 		if( uniformCache.find( uniformName ) == uniformCache.end() )
@@ -198,6 +220,7 @@ void Shader::setUint64( const char * uniformName,
 void Shader::setFloat( const char * uniformName, 
 					   float value )
 {
+	++numUniformCallsThisFrame;
 	if( Shader::useCachingOfUniforms )
 	{
 		if( uniformCache.find( uniformName ) == uniformCache.end() )
@@ -220,6 +243,7 @@ void Shader::setFloat( const char * uniformName,
 void Shader::setBool( const char * uniformName, 
 					  bool value )
 {
+	++numUniformCallsThisFrame;
 	if( Shader::useCachingOfUniforms )
 	{
 		if( uniformCache.find( uniformName ) == uniformCache.end() )
@@ -243,6 +267,7 @@ void Shader::setVec3( const char * uniformName,
 					  float y, 
 					  float z )
 {
+	++numUniformCallsThisFrame;
 	if( Shader::useCachingOfUniforms )
 	{
 		if( uniformCache.find( uniformName ) == uniformCache.end() )
@@ -265,6 +290,7 @@ void Shader::setVec2( const char * uniformName,
 					  float x, 
 					  float y )
 {
+	++numUniformCallsThisFrame;
 	if( Shader::useCachingOfUniforms )
 	{
 		if( uniformCache.find( uniformName ) == uniformCache.end() )
@@ -289,6 +315,7 @@ void Shader::setVec4( const char * uniformName,
 					  float z, 
 					  float w )
 {
+	++numUniformCallsThisFrame;
 	if( Shader::useCachingOfUniforms )
 	{
 		if( uniformCache.find( uniformName ) == uniformCache.end() )
@@ -311,6 +338,7 @@ void Shader::setVec4( const char * uniformName,
 void Shader::setMat3( const char * uniformName, 
 					  const glm::mat3 & mat )
 {
+	++numUniformCallsThisFrame;
 	if( Shader::useCachingOfUniforms )
 	{
 		if( uniformCache.find( uniformName ) == uniformCache.end() )
@@ -333,6 +361,7 @@ void Shader::setMat3( const char * uniformName,
 void Shader::setMat4( const char * uniformName, 
 					  const glm::mat4 & mat )
 {
+	++numUniformCallsThisFrame;
 	if( Shader::useCachingOfUniforms )
 	{
 		if( uniformCache.find( uniformName ) == uniformCache.end() )
@@ -352,6 +381,7 @@ void Shader::setMat4( const char * uniformName,
 */
 void Shader::cleanUp() noexcept
 {
+	RendererState::forgetProgram( ID );
 	glDeleteProgram( ID );
 }
 
@@ -43,6 +43,8 @@ public:
 	using ShaderIncludeList = std::initializer_list<std::pair<GLenum, std::string>>;
 
 	static void setCachingOfUniformsMode( bool useCache ) noexcept;
+	static void finishFrame() noexcept;
+	static unsigned int getNumUniformCallsLastFrame() noexcept;
 
 	Shader() = default;
 	Shader( ShaderSource srcFile1, 
@@ -92,6 +94,8 @@ public:
 
 private:
 	static bool useCachingOfUniforms;
+	static unsigned int numUniformCallsThisFrame;
+	static unsigned int numUniformCallsLastFrame;
 	GLuint createShader( GLenum shaderType, 
 						 const std::string & filename, 
 						 ShaderIncludeList includes );
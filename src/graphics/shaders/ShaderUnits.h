@@ -22,14 +22,12 @@
 
 enum SHADER_UNIT
 {
-	SHADER_HILLS_CULLING = 0,
-	SHADER_HILLS,
+	SHADER_HILLS = 0,
 	SHADER_HILLS_NORMALS,
 	SHADER_SHORE,
 	SHADER_SHORE_NORMALS,
 	SHADER_UNDERWATER,
 	SHADER_LAND,
-	SHADER_WATER_CULLING,
 	SHADER_WATER,
 	SHADER_WATER_NORMALS,
 	SHADER_SKYBOX,
@@ -24,6 +24,12 @@
 #include "Logger"
 #include "TextureResourceLoader"
 #include "SettingsManager"
+#include "SummedAreaTable"
+#include "ThreadPool"
+
+#include <chrono>
+#include <string>
+#include <vector>
 
 /**
 * @brief plain ctor
@@ -255,40 +261,41 @@ GLuint TextureLoader::createUnderwaterReliefTexture( GLuint textureUnit,
 {
 	static bool needStorage = true;
 	static GLuint textureID;
-	GLubyte * textureData = new GLubyte[WORLD_WIDTH * WORLD_HEIGHT];
-	int left;
-	int right;
-	int top;
-	int bottom;
-	float waterCount;
+	std::vector<GLubyte> textureData( WORLD_WIDTH * WORLD_HEIGHT, 0 );
+	const auto START_TIME = std::chrono::steady_clock::now();
+
+	//count of cells fully covered with water is taken from the summed-area table instead of scanning the box around each texel
+	SummedAreaTable waterCells;
+	waterCells.build( WORLD_WIDTH - 1, WORLD_HEIGHT, [&]( size_t x, size_t y )
+	{
+		return y > 0 &&
+			waterMap[y][x] != 0 &&
+			waterMap[y - 1][x] != 0 &&
+			waterMap[y - 1][x + 1] != 0 &&
+			waterMap[y][x + 1] != 0;
+	} );
 
 	//walk through water map and fill texture data accordingly
 	const int RIVER_WIDTH_BASE = SettingsManager::getInt( "SCENE", "river_width_base" );
-	for( int y = 1; y < WORLD_HEIGHT; y++ )
+	const double WATER_CELL_WEIGHT = 1.0 - ( ( RIVER_WIDTH_BASE - 4 ) * 0.25 );
+	ThreadPool::getInstance().parallelFor( 1, WORLD_HEIGHT, [&]( size_t bandBegin, size_t bandEnd )
 	{
-		for( int x = 0; x < WORLD_WIDTH - 1; x++ )
+		for( int y = (int)bandBegin; y < (int)bandEnd; y++ )
 		{
-			left = glm::clamp( x - RIVER_WIDTH_BASE - 3, 0, WORLD_WIDTH - 1 );
-			right = glm::clamp( x + RIVER_WIDTH_BASE + 3, 0, WORLD_WIDTH - 1 );
-			top = glm::clamp( y - RIVER_WIDTH_BASE - 3, 1, WORLD_HEIGHT );
-			bottom = glm::clamp( y + RIVER_WIDTH_BASE + 3, 0, WORLD_HEIGHT );
-			waterCount = 0;
-			for( int y1 = top; y1 < bottom; y1++ )
+			for( int x = 0; x < WORLD_WIDTH - 1; x++ )
 			{
-				for( int x1 = left; x1 < right; x1++ )
-				{
-					if( waterMap[y1][x1] != 0 &&
-						waterMap[y1 - 1][x1] != 0 &&
-						waterMap[y1 - 1][x1 + 1] != 0 &&
-						waterMap[y1][x1 + 1] != 0 )
-					{
-						waterCount += 1.0 - ( ( RIVER_WIDTH_BASE - 4 ) * 0.25 );
-					}
-				}
+				const int LEFT = glm::clamp( x - RIVER_WIDTH_BASE - 3, 0, WORLD_WIDTH - 1 );
+				const int RIGHT = glm::clamp( x + RIVER_WIDTH_BASE + 3, 0, WORLD_WIDTH - 1 );
+				const int TOP = glm::clamp( y - RIVER_WIDTH_BASE - 3, 1, WORLD_HEIGHT );
+				const int BOTTOM = glm::clamp( y + RIVER_WIDTH_BASE + 3, 0, WORLD_HEIGHT );
+				const float WATER_COUNT = (float)( waterCells.getSum( LEFT, TOP, RIGHT, BOTTOM ) * WATER_CELL_WEIGHT );
+				textureData[y * WORLD_WIDTH + x] = (GLubyte)WATER_COUNT;
 			}
-			textureData[y * WORLD_WIDTH + x] = (GLubyte)waterCount;
 		}
-	}
+	} );
+	const auto END_TIME = std::chrono::steady_clock::now();
+	Logger::log( "underwater relief texture data created in % ms\n",
+				 std::to_string( std::chrono::duration<float, std::milli>( END_TIME - START_TIME ).count() ).c_str() );
 
 	//only need to allocate this once even if we need to recreate a texture itself
 	if( needStorage )
@@ -300,9 +307,8 @@ GLuint TextureLoader::createUnderwaterReliefTexture( GLuint textureUnit,
 
 	glActiveTexture( GL_TEXTURE0 + textureUnit );
 	glBindTexture( GL_TEXTURE_2D, textureID );
-	glTextureSubImage2D( textureID, 0, 0, 0, WORLD_WIDTH, WORLD_HEIGHT, GL_RED, GL_UNSIGNED_BYTE, textureData );
+	glTextureSubImage2D( textureID, 0, 0, 0, WORLD_WIDTH, WORLD_HEIGHT, GL_RED, GL_UNSIGNED_BYTE, textureData.data() );
 	setTexture2DParameters( textureID, magFilter, minFilter, GL_REPEAT );
-	delete[] textureData;
 	return textureID;
 }
 
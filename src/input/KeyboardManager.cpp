@@ -80,6 +80,10 @@ void KeyboardManager::processInput( float frameDelta )
 	{
 		options[OPT_LOAD_REQUEST] = true;
 	} );
+	processKey( GLFW_KEY_F12, [&]()
+	{
+		options[OPT_SAVE_BENCHMARK_REQUEST] = true;
+	} );
 	processKey( GLFW_KEY_T, OPT_HILLS_CULLING );
 	processKey( GLFW_KEY_M, [&]()
 	{
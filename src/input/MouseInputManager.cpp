@@ -25,6 +25,7 @@
 #include "Camera"
 #include "ScreenResolution"
 #include "SettingsManager"
+#include "TerrainMasks"
 
 #include <glm/glm.hpp>
 
@@ -183,12 +184,10 @@ void MouseInputManager::cursorClickCallback( GLFWwindow * window,
 
 /**
 * @brief updates map coordinates of the cursor and terrain type that it is pointing on (if cursor is on the screen)
-* @param landMap map of the lands
-* @param hillMap map of the hills
+* @param terrainMasks terrain classification layers
 * @param buildableMap map of the buildable tiles
 */
-void MouseInputManager::updateCursorMappingCoordinates( const map2D_f & landMap, 
-														const map2D_f & hillMap, 
+void MouseInputManager::updateCursorMappingCoordinates( const TerrainMasks & terrainMasks, 
 														const map2D_f & buildableMap )
 {
 	const Camera & camera = *( MouseInputManager::camera );
@@ -220,23 +219,18 @@ void MouseInputManager::updateCursorMappingCoordinates( const map2D_f & landMap,
 		cursorWorldZ = (int)( WORLD_HEIGHT + cursorAbsZ ) - HALF_WORLD_HEIGHT + 1;
 		cursorWorldZ = glm::clamp( cursorWorldZ, 1, WORLD_HEIGHT - 1 );
 
+		//tile at (cursorWorldX, cursorWorldZ) covers the cell whose upper-left corner is (cursorWorldX, cursorWorldZ - 1)
 		if( buildableMap[cursorWorldZ][cursorWorldX] != 0 )
 		{
 			cursorTileName = "Land";
 		}
-		else if( hillMap[cursorWorldZ][cursorWorldX] != 0 ||
-				 hillMap[cursorWorldZ - 1][cursorWorldX] != 0 ||
-				 hillMap[cursorWorldZ - 1][cursorWorldX + 1] != 0 ||
-				 hillMap[cursorWorldZ][cursorWorldX + 1] != 0 )
+		else if( terrainMasks.get( TERRAIN_MASK_HILLS ).anyCornerSet( cursorWorldX, cursorWorldZ - 1 ) )
 		{
 			cursorTileName = "Hills";
 		}
 		else
 		{
-			if( landMap[cursorWorldZ][cursorWorldX] == TILE_NO_RENDER_VALUE ||
-				landMap[cursorWorldZ - 1][cursorWorldX] == TILE_NO_RENDER_VALUE ||
-				landMap[cursorWorldZ - 1][cursorWorldX + 1] == TILE_NO_RENDER_VALUE ||
-				landMap[cursorWorldZ][cursorWorldX + 1] == TILE_NO_RENDER_VALUE )
+			if( terrainMasks.get( TERRAIN_MASK_WATER ).anyCornerSet( cursorWorldX, cursorWorldZ - 1 ) )
 			{
 				cursorTileName = "Water";
 			}
@@ -26,6 +26,7 @@ class Camera;
 class Options;
 class ScreenResolution;
 class GLFWwindow;
+class TerrainMasks;
 
 /**
 * @brief manager for mouse related events. Responsible for handling mouse callbacks and cursor picking.
@@ -41,8 +42,7 @@ public:
 							Camera & camera,
 							Camera & shadowCamera ) noexcept;
 	static void setCallbacks() noexcept;
-	void updateCursorMappingCoordinates( const map2D_f & landMap,
-										 const map2D_f & hillMap,
+	void updateCursorMappingCoordinates( const TerrainMasks & terrainMasks,
 										 const map2D_f & buildableMap );
 	int getCursorWorldX() const noexcept;
 	int getCursorWorldZ() const noexcept;
@@ -0,0 +1,128 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * CpuFeatures.cpp
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains definitions for CPU features detection functions
+ * @version 0.1.0
+ */
+
+#include "CpuFeatures"
+
+#if CPU_FEATURES_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace CpuFeatures
+{
+#if CPU_FEATURES_X86
+	/**
+	* @brief executes cpuid instruction for given leaf and subleaf
+	* @param leaf cpuid function number
+	* @param subleaf cpuid subfunction number
+	* @param registers output array for EAX, EBX, ECX and EDX values
+	*/
+	static void cpuid( unsigned int leaf,
+					   unsigned int subleaf,
+					   unsigned int registers[4] ) noexcept
+	{
+#ifdef _MSC_VER
+		int values[4];
+		__cpuidex( values, leaf, subleaf );
+		for( unsigned int index = 0; index < 4; index++ )
+		{
+			registers[index] = static_cast<unsigned int>( values[index] );
+		}
+#else
+		__cpuid_count( leaf, subleaf, registers[0], registers[1], registers[2], registers[3] );
+#endif
+	}
+
+	/**
+	* @brief reads extended control register 0 which tells what register states OS saves on context switch
+	*/
+	static unsigned long long readXCR0() noexcept
+	{
+#ifdef _MSC_VER
+		return _xgetbv( 0 );
+#else
+		unsigned int eax, edx;
+		__asm__ volatile( "xgetbv" : "=a"( eax ), "=d"( edx ) : "c"( 0 ) );
+		return ( static_cast<unsigned long long>( edx ) << 32 ) | eax;
+#endif
+	}
+
+	/**
+	* @brief queries CPU and OS for the best supported instruction set
+	*/
+	static INSTRUCTION_SET detectInstructionSet() noexcept
+	{
+		unsigned int registers[4];
+		cpuid( 0, 0, registers );
+		const unsigned int MAX_LEAF = registers[0];
+		if( MAX_LEAF < 1 )
+		{
+			return ISA_SCALAR;
+		}
+
+		cpuid( 1, 0, registers );
+		const bool HAS_SSE41 = ( registers[2] & ( 1u << 19 ) ) != 0;
+		const bool HAS_OSXSAVE = ( registers[2] & ( 1u << 27 ) ) != 0;
+		const bool HAS_AVX = ( registers[2] & ( 1u << 28 ) ) != 0;
+		if( !HAS_SSE41 )
+		{
+			return ISA_SCALAR;
+		}
+
+		//AVX registers are usable only if OS preserves both XMM and YMM states
+		if( MAX_LEAF >= 7 && HAS_OSXSAVE && HAS_AVX && ( readXCR0() & 0x6 ) == 0x6 )
+		{
+			cpuid( 7, 0, registers );
+			const bool HAS_AVX2 = ( registers[1] & ( 1u << 5 ) ) != 0;
+			if( HAS_AVX2 )
+			{
+				return ISA_AVX2;
+			}
+		}
+		return ISA_SSE4;
+	}
+#endif
+
+	/**
+	* @brief returns the best instruction set available on this machine. Detection is done only once
+	*/
+	INSTRUCTION_SET getInstructionSet() noexcept
+	{
+#if CPU_FEATURES_X86
+		static const INSTRUCTION_SET DETECTED_INSTRUCTION_SET = detectInstructionSet();
+		return DETECTED_INSTRUCTION_SET;
+#else
+		return ISA_SCALAR;
+#endif
+	}
+
+	const char * getInstructionSetName( INSTRUCTION_SET instructionSet ) noexcept
+	{
+		switch( instructionSet )
+		{
+		case ISA_AVX2:	return "AVX2";
+		case ISA_SSE4:	return "SSE4.1";
+		default:		return "scalar";
+		}
+	}
+};
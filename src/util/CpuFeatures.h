@@ -0,0 +1,47 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * CpuFeatures.h
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains declaration for CPU features detection functions
+ * @version 0.1.0
+ */
+
+#pragma once
+
+//SIMD code paths are compiled only for x86 targets, other platforms always use scalar code
+#if defined( _M_X64 ) || defined( _M_IX86 ) || defined( __x86_64__ ) || defined( __i386__ )
+#define CPU_FEATURES_X86 1
+#else
+#define CPU_FEATURES_X86 0
+#endif
+
+/**
+* @brief instruction set levels which have dedicated code paths in the project
+*/
+enum INSTRUCTION_SET : int
+{
+	ISA_SCALAR = 0,
+	ISA_SSE4 = 1,
+	ISA_AVX2 = 2
+};
+
+/**
+* @brief contains functions for runtime detection of the CPU capabilities
+*/
+namespace CpuFeatures
+{
+	INSTRUCTION_SET getInstructionSet() noexcept;
+	const char * getInstructionSetName( INSTRUCTION_SET instructionSet ) noexcept;
+};
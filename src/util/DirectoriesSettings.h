@@ -26,3 +26,4 @@
 const std::string getResourcesDirectory();
 const std::string RES_DIR = getResourcesDirectory() + "/res/";
 const std::string SAVES_DIR = RES_DIR + "saves/";
+const std::string CACHE_DIR = RES_DIR + "cache/";
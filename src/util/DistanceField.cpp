@@ -0,0 +1,97 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * DistanceField.cpp
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains definitions for DistanceField class
+ * @version 0.1.0
+ */
+
+
+#include "DistanceField"
+
+#include <algorithm>
+
+/**
+* @brief (re)calculates the distance field of the given map. First pass propagates distances from upper-left neighbours,
+* second pass - from lower-right ones, which gives exact chessboard distances for 8-connected neighbourhood
+* @param sourceMap map whose non-zero points are considered as feature points
+*/
+void DistanceField::compute( Heightfield2DView<const float> sourceMap )
+{
+	const int WIDTH = (int)sourceMap.width();
+	const int HEIGHT = (int)sourceMap.height();
+	const int NO_FEATURE_DISTANCE = WIDTH + HEIGHT;
+	distances.assign( WIDTH, HEIGHT, NO_FEATURE_DISTANCE );
+
+	for( int y = 0; y < HEIGHT; y++ )
+	{
+		HeightfieldRow<const float> sourceRow = sourceMap[y];
+		HeightfieldRow<int> row = distances[y];
+		for( int x = 0; x < WIDTH; x++ )
+		{
+			if( sourceRow[x] != 0 )
+			{
+				row[x] = 0;
+				continue;
+			}
+			int distance = row[x];
+			if( x > 0 )
+			{
+				distance = std::min( distance, row[x - 1] + 1 );
+			}
+			if( y > 0 )
+			{
+				HeightfieldRow<int> upperRow = distances[y - 1];
+				distance = std::min( distance, upperRow[x] + 1 );
+				if( x > 0 )
+				{
+					distance = std::min( distance, upperRow[x - 1] + 1 );
+				}
+				if( x < WIDTH - 1 )
+				{
+					distance = std::min( distance, upperRow[x + 1] + 1 );
+				}
+			}
+			row[x] = distance;
+		}
+	}
+
+	for( int y = HEIGHT - 1; y >= 0; y-- )
+	{
+		HeightfieldRow<int> row = distances[y];
+		for( int x = WIDTH - 1; x >= 0; x-- )
+		{
+			int distance = row[x];
+			if( x < WIDTH - 1 )
+			{
+				distance = std::min( distance, row[x + 1] + 1 );
+			}
+			if( y < HEIGHT - 1 )
+			{
+				HeightfieldRow<int> lowerRow = distances[y + 1];
+				distance = std::min( distance, lowerRow[x] + 1 );
+				if( x > 0 )
+				{
+					distance = std::min( distance, lowerRow[x - 1] + 1 );
+				}
+				if( x < WIDTH - 1 )
+				{
+					distance = std::min( distance, lowerRow[x + 1] + 1 );
+				}
+			}
+			row[x] = distance;
+		}
+	}
+}
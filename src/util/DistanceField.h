@@ -0,0 +1,64 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * DistanceField.h
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains declaration for DistanceField class
+ * @version 0.1.0
+ */
+
+
+#pragma once
+
+#include "TypeAliases"
+
+/**
+* @brief Chebyshev (chessboard) distance transform of a 2D map: for each point holds distance to the nearest
+* feature point (point with non-zero value in the source map). Computed once in linear time with two raster passes,
+* after that "is there any feature in (2r+1)x(2r+1) window around the point" test is a single lookup.
+* If the source map has no features at all, every distance is greater than any distance inside the map
+*/
+class DistanceField
+{
+public:
+	DistanceField() = default;
+	void compute( Heightfield2DView<const float> sourceMap );
+
+	/**
+	* @brief returns Chebyshev distance from the given point to the nearest feature point
+	* @param x column of the point
+	* @param y row of the point
+	*/
+	int getDistance( int x,
+					 int y ) const noexcept
+	{
+		return distances[y][x];
+	}
+
+	/**
+	* @brief checks whether there is any feature point in the square window of the given radius around the point
+	* @param x column of the window center
+	* @param y row of the window center
+	* @param radius half size of the window
+	*/
+	bool hasFeatureWithin( int x,
+						   int y,
+						   int radius ) const noexcept
+	{
+		return distances[y][x] <= radius;
+	}
+
+private:
+	map2D_i distances;
+};
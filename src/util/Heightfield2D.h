@@ -0,0 +1,311 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * Heightfield2D.h
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains declaration and definition for Heightfield2D container, its row span and view types
+ * @version 0.1.0
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+/**
+* @brief non-owning span over one row of a 2D map. Performs no bounds checking
+*/
+template <typename T>
+class HeightfieldRow
+{
+public:
+	HeightfieldRow( T * data,
+					size_t width ) noexcept
+		: rowData( data )
+		, rowWidth( width )
+	{}
+	T & operator[]( size_t x ) const noexcept { return rowData[x]; }
+	size_t size() const noexcept { return rowWidth; }
+	T * data() const noexcept { return rowData; }
+	T * begin() const noexcept { return rowData; }
+	T * end() const noexcept { return rowData + rowWidth; }
+
+private:
+	T * rowData;
+	size_t rowWidth;
+};
+
+/**
+* @brief non-owning rectangular view over a 2D map (or its part) with arbitrary row stride
+*/
+template <typename T>
+class Heightfield2DView
+{
+public:
+	Heightfield2DView() noexcept
+		: viewData( nullptr )
+		, viewWidth( 0 )
+		, viewHeight( 0 )
+		, viewStride( 0 )
+	{}
+	Heightfield2DView( T * data,
+					   size_t width,
+					   size_t height,
+					   size_t stride ) noexcept
+		: viewData( data )
+		, viewWidth( width )
+		, viewHeight( height )
+		, viewStride( stride )
+	{}
+
+	/**
+	* @brief implicit conversion from mutable to read-only view
+	*/
+	template <typename U, typename = typename std::enable_if<std::is_same<const U, T>::value>::type>
+	Heightfield2DView( const Heightfield2DView<U> & rhs ) noexcept
+		: viewData( rhs.data() )
+		, viewWidth( rhs.width() )
+		, viewHeight( rhs.height() )
+		, viewStride( rhs.stride() )
+	{}
+	HeightfieldRow<T> operator[]( size_t y ) const noexcept { return HeightfieldRow<T>( viewData + y * viewStride, viewWidth ); }
+	size_t width() const noexcept { return viewWidth; }
+	size_t height() const noexcept { return viewHeight; }
+	size_t stride() const noexcept { return viewStride; }
+	T * data() const noexcept { return viewData; }
+
+	/**
+	* @brief creates subview of this view
+	* @param x leftmost column of the subview
+	* @param y topmost row of the subview
+	* @param width number of columns in the subview
+	* @param height number of rows in the subview
+	*/
+	Heightfield2DView slice( size_t x,
+							 size_t y,
+							 size_t width,
+							 size_t height ) const noexcept
+	{
+		return Heightfield2DView( viewData + y * viewStride + x, width, height, viewStride );
+	}
+
+private:
+	T * viewData;
+	size_t viewWidth;
+	size_t viewHeight;
+	size_t viewStride;
+};
+
+/**
+* @brief contiguous storage for 2D maps (heights, normals, distribution etc.).
+* All rows live in one cache-line aligned allocation, each row is padded so that every row starts at aligned address.
+* Supports map[y][x] access as well as row iteration, thus might be used as a drop-in replacement for vector of vectors
+* @note only trivially copyable types are supported as the storage is copied and filled as plain memory
+*/
+template <typename T>
+class Heightfield2D
+{
+	static_assert( std::is_trivially_copyable<T>::value, "Heightfield2D supports only trivially copyable types" );
+
+public:
+	constexpr static size_t ALIGNMENT = 64;
+
+	/**
+	* @brief random access iterator over the map rows
+	*/
+	template <typename RowT>
+	class RowIterator
+	{
+	public:
+		RowIterator( RowT * data,
+					 size_t width,
+					 size_t stride ) noexcept
+			: iterData( data )
+			, iterWidth( width )
+			, iterStride( stride )
+		{}
+		HeightfieldRow<RowT> operator*() const noexcept { return HeightfieldRow<RowT>( iterData, iterWidth ); }
+		RowIterator & operator++() noexcept { iterData += iterStride; return *this; }
+		bool operator!=( const RowIterator & rhs ) const noexcept { return iterData != rhs.iterData; }
+		bool operator==( const RowIterator & rhs ) const noexcept { return iterData == rhs.iterData; }
+
+	private:
+		RowT * iterData;
+		size_t iterWidth;
+		size_t iterStride;
+	};
+
+	Heightfield2D() noexcept
+		: mapWidth( 0 )
+		, mapHeight( 0 )
+		, mapStride( 0 )
+	{}
+
+	Heightfield2D( size_t width,
+				   size_t height,
+				   const T & value = T() )
+		: Heightfield2D()
+	{
+		assign( width, height, value );
+	}
+
+	Heightfield2D( const Heightfield2D & rhs )
+		: Heightfield2D()
+	{
+		*this = rhs;
+	}
+
+	Heightfield2D( Heightfield2D && rhs ) noexcept
+		: Heightfield2D()
+	{
+		swap( rhs );
+	}
+
+	Heightfield2D & operator=( const Heightfield2D & rhs )
+	{
+		if( this != &rhs )
+		{
+			if( mapStride != rhs.mapStride || mapHeight != rhs.mapHeight )
+			{
+				storage = allocate( rhs.mapStride * rhs.mapHeight );
+			}
+			mapWidth = rhs.mapWidth;
+			mapHeight = rhs.mapHeight;
+			mapStride = rhs.mapStride;
+			std::copy( rhs.storage.get(), rhs.storage.get() + mapStride * mapHeight, storage.get() );
+		}
+		return *this;
+	}
+
+	Heightfield2D & operator=( Heightfield2D && rhs ) noexcept
+	{
+		swap( rhs );
+		return *this;
+	}
+
+	/**
+	* @brief (re)allocates storage if dimensions have changed and fills whole map with the given value
+	* @param width number of columns
+	* @param height number of rows
+	* @param value value to fill map with
+	*/
+	void assign( size_t width,
+				 size_t height,
+				 const T & value )
+	{
+		const size_t NEW_STRIDE = paddedStride( width );
+		if( NEW_STRIDE != mapStride || height != mapHeight )
+		{
+			storage = allocate( NEW_STRIDE * height );
+		}
+		mapWidth = width;
+		mapHeight = height;
+		mapStride = NEW_STRIDE;
+		fill( value );
+	}
+
+	/**
+	* @brief fills whole map (including padding) with the given value
+	* @param value value to fill map with
+	*/
+	void fill( const T & value )
+	{
+		std::fill( storage.get(), storage.get() + mapStride * mapHeight, value );
+	}
+
+	void swap( Heightfield2D & rhs ) noexcept
+	{
+		std::swap( storage, rhs.storage );
+		std::swap( mapWidth, rhs.mapWidth );
+		std::swap( mapHeight, rhs.mapHeight );
+		std::swap( mapStride, rhs.mapStride );
+	}
+
+	HeightfieldRow<T> operator[]( size_t y ) noexcept { return HeightfieldRow<T>( storage.get() + y * mapStride, mapWidth ); }
+	HeightfieldRow<const T> operator[]( size_t y ) const noexcept { return HeightfieldRow<const T>( storage.get() + y * mapStride, mapWidth ); }
+	RowIterator<T> begin() noexcept { return RowIterator<T>( storage.get(), mapWidth, mapStride ); }
+	RowIterator<T> end() noexcept { return RowIterator<T>( storage.get() + mapHeight * mapStride, mapWidth, mapStride ); }
+	RowIterator<const T> begin() const noexcept { return RowIterator<const T>( storage.get(), mapWidth, mapStride ); }
+	RowIterator<const T> end() const noexcept { return RowIterator<const T>( storage.get() + mapHeight * mapStride, mapWidth, mapStride ); }
+
+	/** @brief number of rows, kept for compatibility with vector-like row containers */
+	size_t size() const noexcept { return mapHeight; }
+	size_t width() const noexcept { return mapWidth; }
+	size_t height() const noexcept { return mapHeight; }
+	size_t stride() const noexcept { return mapStride; }
+	bool empty() const noexcept { return mapHeight == 0; }
+	T * data() noexcept { return storage.get(); }
+	const T * data() const noexcept { return storage.get(); }
+
+	Heightfield2DView<T> view() noexcept { return Heightfield2DView<T>( storage.get(), mapWidth, mapHeight, mapStride ); }
+	Heightfield2DView<const T> view() const noexcept { return Heightfield2DView<const T>( storage.get(), mapWidth, mapHeight, mapStride ); }
+
+	Heightfield2DView<T> slice( size_t x,
+								size_t y,
+								size_t width,
+								size_t height ) noexcept
+	{
+		return view().slice( x, y, width, height );
+	}
+
+	Heightfield2DView<const T> slice( size_t x,
+									  size_t y,
+									  size_t width,
+									  size_t height ) const noexcept
+	{
+		return view().slice( x, y, width, height );
+	}
+
+private:
+	struct AlignedDeleter
+	{
+		void operator()( T * ptr ) const noexcept
+		{
+			::operator delete( ptr, std::align_val_t( ALIGNMENT ) );
+		}
+	};
+
+	/**
+	* @brief calculates number of elements in a row so that each row starts at ALIGNMENT boundary
+	* @param width number of meaningful elements in a row
+	*/
+	constexpr static size_t paddedStride( size_t width ) noexcept
+	{
+		//number of elements whose total size is a multiple of the alignment
+		size_t step = 1;
+		while( ( step * sizeof( T ) ) % ALIGNMENT != 0 )
+		{
+			++step;
+		}
+		return ( width + step - 1 ) / step * step;
+	}
+
+	static std::unique_ptr<T[], AlignedDeleter> allocate( size_t numElements )
+	{
+		if( numElements == 0 )
+		{
+			return std::unique_ptr<T[], AlignedDeleter>();
+		}
+		void * memory = ::operator new( numElements * sizeof( T ), std::align_val_t( ALIGNMENT ) );
+		return std::unique_ptr<T[], AlignedDeleter>( static_cast<T*>( memory ) );
+	}
+
+	std::unique_ptr<T[], AlignedDeleter> storage;
+	size_t mapWidth;
+	size_t mapHeight;
+	size_t mapStride;
+};
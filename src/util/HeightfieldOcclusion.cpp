@@ -0,0 +1,370 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * HeightfieldOcclusion.cpp
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains definition for HeightfieldOcclusion class
+ * @version 0.1.0
+ */
+
+
+#include "HeightfieldOcclusion"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <glm/common.hpp>
+
+/**
+* @brief allocates the pyramid for the given map and fills it entirely. The map is referenced, not copied,
+* thus it must outlive the pyramid, and after any changes of the map the pyramid must be updated
+* @param heightMap map of the surface heights, it has one more point than cells in each dimension
+* @param offsetY vertical offset applied to the map heights to get the surface heights
+*/
+void HeightfieldOcclusion::build( const map2D_f & heightMap,
+								  float offsetY )
+{
+	this->heightMap = &heightMap;
+	this->offsetY = offsetY;
+	maxSlope = 0.0f;
+	levels.clear();
+	size_t width = heightMap.width() - 1;
+	size_t height = heightMap.height() - 1;
+	levels.emplace_back( width, height );
+	while( width > 1 || height > 1 )
+	{
+		width = ( width + 1 ) / 2;
+		height = ( height + 1 ) / 2;
+		levels.emplace_back( width, height );
+	}
+	update( 0, 0, (unsigned int)heightMap.width() - 1, (unsigned int)heightMap.height() - 1 );
+}
+
+/**
+* @brief recalculates maximum heights of the cells touching the changed rectangle of the map, on each level of the pyramid
+* @param left leftmost changed column of the map
+* @param top topmost changed row of the map
+* @param right rightmost changed column of the map
+* @param bottom bottommost changed row of the map
+*/
+void HeightfieldOcclusion::update( unsigned int left,
+								   unsigned int top,
+								   unsigned int right,
+								   unsigned int bottom )
+{
+	//each map point is a corner of up to four cells of the first level
+	map2D_f & firstLevel = levels[0];
+	unsigned int cellLeft = left > 0 ? left - 1 : 0;
+	unsigned int cellTop = top > 0 ? top - 1 : 0;
+	unsigned int cellRight = std::min( right, (unsigned int)firstLevel.width() - 1 );
+	unsigned int cellBottom = std::min( bottom, (unsigned int)firstLevel.height() - 1 );
+	const map2D_f & map = *heightMap;
+	for( unsigned int y = cellTop; y <= cellBottom; y++ )
+	{
+		for( unsigned int x = cellLeft; x <= cellRight; x++ )
+		{
+			firstLevel[y][x] = std::max( { map[y][x], map[y][x + 1], map[y + 1][x], map[y + 1][x + 1] } ) + offsetY;
+			maxSlope = std::max( { maxSlope, std::abs( map[y][x + 1] - map[y][x] ), std::abs( map[y + 1][x] - map[y][x] ),
+								   std::abs( map[y + 1][x + 1] - map[y + 1][x] ), std::abs( map[y + 1][x + 1] - map[y][x + 1] ) } );
+		}
+	}
+
+	for( size_t levelIndex = 1; levelIndex < levels.size(); levelIndex++ )
+	{
+		const map2D_f & finerLevel = levels[levelIndex - 1];
+		map2D_f & level = levels[levelIndex];
+		cellLeft /= 2;
+		cellTop /= 2;
+		cellRight /= 2;
+		cellBottom /= 2;
+		for( unsigned int y = cellTop; y <= cellBottom; y++ )
+		{
+			const unsigned int FINER_BOTTOM = std::min( y * 2 + 1, (unsigned int)finerLevel.height() - 1 );
+			for( unsigned int x = cellLeft; x <= cellRight; x++ )
+			{
+				const unsigned int FINER_RIGHT = std::min( x * 2 + 1, (unsigned int)finerLevel.width() - 1 );
+				level[y][x] = std::max( { finerLevel[y * 2][x * 2], finerLevel[y * 2][FINER_RIGHT],
+										  finerLevel[FINER_BOTTOM][x * 2], finerLevel[FINER_BOTTOM][FINER_RIGHT] } );
+			}
+		}
+	}
+}
+
+/**
+* @brief checks whether the surface blocks the line of sight from the view position to the point
+* @param viewPosition position of the viewer
+* @param point point to test
+*/
+bool HeightfieldOcclusion::isOccluded( const glm::vec3 & viewPosition,
+									   const glm::vec3 & point ) const noexcept
+{
+	return getViewTolerance( viewPosition, point ) < 0.0f;
+}
+
+/**
+* @brief traces the line of sight from the view position to the point.
+* The surface is sampled at the same grid lines crossings as in the marching test, but only in the first level cells
+* which are not proven to lie below the segment by the coarser levels.
+* When the viewer moves, a point of the segment at parameter t moves by (1 - t) of that distance, thus its height above the surface
+* changes by no more than (1 - t) * (1 + 2 * maxSlope) per unit of the viewer movement. Dividing the height difference by this
+* gives the distance the viewer might move before the sample could change its answer
+* @param viewPosition position of the viewer
+* @param point point to test
+* @return if the view is blocked - negative distance for the first sample found below the surface,
+* otherwise - the smallest distance over the traversed cells (maximum float if nothing was sampled)
+*/
+float HeightfieldOcclusion::getViewTolerance( const glm::vec3 & viewPosition,
+											  const glm::vec3 & point ) const noexcept
+{
+	constexpr float NO_EXIT = std::numeric_limits<float>::max();
+	const glm::vec3 DIRECTION( point - viewPosition );
+	if( levels.empty() || ( DIRECTION.x == 0.0f && DIRECTION.z == 0.0f ) )
+	{
+		return NO_EXIT;
+	}
+	const int WIDTH = (int)levels[0].width();
+	const int HEIGHT = (int)levels[0].height();
+
+	//grid lines crossings sampled by the marching test: in positive direction it goes one line past the point, in negative - it does not
+	const int LAST_LINE_X = DIRECTION.x > 0.0f ? (int)std::ceil( point.x ) : std::min( (int)std::floor( viewPosition.x ), (int)std::floor( point.x ) + 1 );
+	const int LAST_LINE_Z = DIRECTION.z > 0.0f ? (int)std::ceil( point.z ) : std::min( (int)std::floor( viewPosition.z ), (int)std::floor( point.z ) + 1 );
+	const float T_LAST_X = DIRECTION.x != 0.0f ? ( LAST_LINE_X - viewPosition.x ) / DIRECTION.x : 0.0f;
+	const float T_LAST_Z = DIRECTION.z != 0.0f ? ( LAST_LINE_Z - viewPosition.z ) / DIRECTION.z : 0.0f;
+	const float T_END = std::max( T_LAST_X, T_LAST_Z );
+
+	//start from the point where the segment enters the map, there is nothing to block the view outside of it
+	float t = 0.0f;
+	float tMapExit = NO_EXIT;
+	for( int axis = 0; axis < 3; axis += 2 )
+	{
+		const float MAP_SIZE = axis == 0 ? WIDTH : HEIGHT;
+		if( DIRECTION[axis] == 0.0f )
+		{
+			if( viewPosition[axis] < 0.0f || viewPosition[axis] > MAP_SIZE )
+			{
+				return NO_EXIT;
+			}
+			continue;
+		}
+		const float T_LOW = ( 0.0f - viewPosition[axis] ) / DIRECTION[axis];
+		const float T_HIGH = ( MAP_SIZE - viewPosition[axis] ) / DIRECTION[axis];
+		t = std::max( t, std::min( T_LOW, T_HIGH ) );
+		tMapExit = std::min( tMapExit, std::max( T_LOW, T_HIGH ) );
+	}
+	if( t > T_END || t > tMapExit )
+	{
+		return NO_EXIT;
+	}
+	int cellX = glm::clamp( (int)std::floor( viewPosition.x + DIRECTION.x * t ), 0, WIDTH - 1 );
+	int cellZ = glm::clamp( (int)std::floor( viewPosition.z + DIRECTION.z * t ), 0, HEIGHT - 1 );
+
+	const int TOP_LEVEL = (int)levels.size() - 1;
+	int level = TOP_LEVEL;
+	float tolerance = NO_EXIT;
+	const float HEIGHT_CHANGE_RATE = 1.0f + 2.0f * maxSlope;
+	auto toleranceOf = [HEIGHT_CHANGE_RATE]( float heightDifference,
+											 float maxPointMovementRatio ) noexcept
+	{
+		return heightDifference / ( std::max( maxPointMovementRatio, std::numeric_limits<float>::epsilon() ) * HEIGHT_CHANGE_RATE );
+	};
+	while( true )
+	{
+		const int LEFT = ( cellX >> level ) << level;
+		const int RIGHT = std::min( LEFT + ( 1 << level ), WIDTH );
+		const int TOP = ( cellZ >> level ) << level;
+		const int BOTTOM = std::min( TOP + ( 1 << level ), HEIGHT );
+		const float EXIT_X = DIRECTION.x > 0.0f ? ( RIGHT - viewPosition.x ) / DIRECTION.x :
+							 DIRECTION.x < 0.0f ? ( LEFT - viewPosition.x ) / DIRECTION.x : NO_EXIT;
+		const float EXIT_Z = DIRECTION.z > 0.0f ? ( BOTTOM - viewPosition.z ) / DIRECTION.z :
+							 DIRECTION.z < 0.0f ? ( TOP - viewPosition.z ) / DIRECTION.z : NO_EXIT;
+		const bool EXITS_THROUGH_X = EXIT_X <= EXIT_Z;
+		const float EXIT = std::max( std::min( EXIT_X, EXIT_Z ), t );
+
+		//height along the segment changes linearly, thus its lowest point within the cell is either the entry or the exit one
+		const float LOWEST_HEIGHT = viewPosition.y + DIRECTION.y * ( DIRECTION.y < 0.0f ? EXIT : t );
+		const float CELL_MAX_HEIGHT = levels[level][cellZ >> level][cellX >> level];
+		if( LOWEST_HEIGHT >= CELL_MAX_HEIGHT )
+		{
+			tolerance = std::min( tolerance, toleranceOf( LOWEST_HEIGHT - CELL_MAX_HEIGHT, std::max( std::abs( 1.0f - t ), std::abs( 1.0f - EXIT ) ) ) );
+		}
+		else
+		{
+			if( level > 0 )
+			{
+				level--;
+				continue;
+			}
+			//sample the surface where the segment leaves the cell, unless the marching test would not sample that crossing
+			const int LINE_X = DIRECTION.x > 0.0f ? RIGHT : LEFT;
+			const int LINE_Z = DIRECTION.z > 0.0f ? BOTTOM : TOP;
+			const bool SAMPLES_LINE_X = EXITS_THROUGH_X && ( DIRECTION.x > 0.0f ? LINE_X <= LAST_LINE_X : LINE_X >= LAST_LINE_X );
+			const bool SAMPLES_LINE_Z = EXIT_Z <= EXIT_X && ( DIRECTION.z > 0.0f ? LINE_Z <= LAST_LINE_Z : LINE_Z >= LAST_LINE_Z );
+			if( SAMPLES_LINE_X || SAMPLES_LINE_Z )
+			{
+				const float EXIT_HEIGHT = viewPosition.y + DIRECTION.y * EXIT;
+				const float SURFACE_HEIGHT = SAMPLES_LINE_X ?
+					surfaceHeightAt( viewPosition.z + DIRECTION.z * EXIT, LINE_X, true ) :
+					surfaceHeightAt( viewPosition.x + DIRECTION.x * EXIT, LINE_Z, false );
+				const float SAMPLE_TOLERANCE = toleranceOf( EXIT_HEIGHT - SURFACE_HEIGHT, std::abs( 1.0f - EXIT ) );
+				if( EXIT_HEIGHT < SURFACE_HEIGHT )
+				{
+					return SAMPLE_TOLERANCE;
+				}
+				tolerance = std::min( tolerance, SAMPLE_TOLERANCE );
+			}
+		}
+		if( EXIT >= T_END )
+		{
+			return tolerance;
+		}
+
+		//step to the neighbour cell through the side the segment leaves the current one and try coarser level again
+		if( EXITS_THROUGH_X )
+		{
+			cellX = DIRECTION.x > 0.0f ? RIGHT : LEFT - 1;
+			cellZ = glm::clamp( (int)std::floor( viewPosition.z + DIRECTION.z * EXIT ), TOP, BOTTOM - 1 );
+		}
+		else
+		{
+			cellZ = DIRECTION.z > 0.0f ? BOTTOM : TOP - 1;
+			cellX = glm::clamp( (int)std::floor( viewPosition.x + DIRECTION.x * EXIT ), LEFT, RIGHT - 1 );
+		}
+		if( cellX < 0 || cellX >= WIDTH || cellZ < 0 || cellZ >= HEIGHT )
+		{
+			return tolerance;
+		}
+		t = EXIT;
+		level = std::min( level + 1, TOP_LEVEL );
+	}
+}
+
+/**
+* @brief reference occlusion test, marches the segment through each of the map grid lines it crosses.
+* Kept for comparisons with the pyramid based test
+* @param viewPosition position of the viewer
+* @param point point to test
+*/
+bool HeightfieldOcclusion::isOccludedMarching( const glm::vec3 & viewPosition,
+											   const glm::vec3 & point ) const noexcept
+{
+	const glm::vec3 VIEW_DIRECTION( point - viewPosition );
+
+	//culling based on crossing map vertical lines
+	if( VIEW_DIRECTION.x > 0 )
+	{
+		float xPosition = viewPosition.x;
+		while( xPosition < point.x )
+		{
+			xPosition = std::trunc( xPosition + 1.0f );
+			float dx = ( xPosition - viewPosition.x ) / VIEW_DIRECTION.x;
+			float zPosition = viewPosition.z + VIEW_DIRECTION.z * dx;
+			float yPosition = viewPosition.y + VIEW_DIRECTION.y * dx;
+
+			if( yPosition < surfaceHeightAt( zPosition, (int)xPosition, true ) )
+			{
+				return true;
+			}
+		}
+	}
+	else
+	{
+		float xPosition = viewPosition.x;
+		while( xPosition > point.x )
+		{
+			xPosition = std::trunc( xPosition );
+			float dx = std::abs( ( viewPosition.x - xPosition ) / VIEW_DIRECTION.x );
+			float zPosition = viewPosition.z + VIEW_DIRECTION.z * dx;
+			float yPosition = viewPosition.y + VIEW_DIRECTION.y * dx;
+
+			if( yPosition < surfaceHeightAt( zPosition, (int)xPosition, true ) )
+			{
+				return true;
+			}
+			xPosition -= 1.0f;
+		}
+	}
+
+	//culling based on crossing map horizontal lines
+	if( VIEW_DIRECTION.z > 0 )
+	{
+		float zPosition = viewPosition.z;
+		while( zPosition < point.z )
+		{
+			zPosition = std::trunc( zPosition + 1.0f );
+			float dz = ( zPosition - viewPosition.z ) / VIEW_DIRECTION.z;
+			float xPosition = viewPosition.x + VIEW_DIRECTION.x * dz;
+			float yPosition = viewPosition.y + VIEW_DIRECTION.y * dz;
+
+			if( yPosition < surfaceHeightAt( xPosition, (int)zPosition, false ) )
+			{
+				return true;
+			}
+		}
+	}
+	else
+	{
+		float zPosition = viewPosition.z;
+		while( zPosition > point.z )
+		{
+			zPosition = std::trunc( zPosition );
+			float dz = std::abs( ( viewPosition.z - zPosition ) / VIEW_DIRECTION.z );
+			float xPosition = viewPosition.x + VIEW_DIRECTION.x * dz;
+			float yPosition = viewPosition.y + VIEW_DIRECTION.y * dz;
+
+			if( yPosition < surfaceHeightAt( xPosition, (int)zPosition, false ) )
+			{
+				return true;
+			}
+			zPosition -= 1.0f;
+		}
+	}
+
+	return false;
+}
+
+unsigned int HeightfieldOcclusion::getNumLevels() const noexcept
+{
+	return (unsigned int)levels.size();
+}
+
+/**
+* @brief returns maximum height difference of two neighbour points of the map, i.e. maximum slope of the surface along the grid lines
+*/
+float HeightfieldOcclusion::getMaxSlope() const noexcept
+{
+	return maxSlope;
+}
+
+/**
+* @brief returns surface height on the map grid line, interpolated between two neighbour points of the line.
+* Coordinates outside of the map are clamped to its border
+* @param interpolantCoord coordinate along the grid line
+* @param fixedCoord coordinate of the grid line itself
+* @param fixedCoordIsX define whether the grid line is a column (otherwise it is a row)
+*/
+float HeightfieldOcclusion::surfaceHeightAt( float interpolantCoord,
+											 int fixedCoord,
+											 bool fixedCoordIsX ) const noexcept
+{
+	const map2D_f & map = *heightMap;
+	const int MAX_INTERPOLANT = (int)( fixedCoordIsX ? map.height() : map.width() ) - 1;
+	const int MAX_FIXED = (int)( fixedCoordIsX ? map.width() : map.height() ) - 1;
+	const int FIXED = glm::clamp( fixedCoord, 0, MAX_FIXED );
+	const int MAP_COORD_1 = glm::clamp( (int)std::floor( interpolantCoord ), 0, MAX_INTERPOLANT );
+	const int MAP_COORD_2 = glm::clamp( (int)std::ceil( interpolantCoord ), 0, MAX_INTERPOLANT );
+	const float INTERPOLATION = glm::fract( std::abs( interpolantCoord ) );
+	const float HEIGHT_1 = fixedCoordIsX ? map[MAP_COORD_1][FIXED] : map[FIXED][MAP_COORD_1];
+	const float HEIGHT_2 = fixedCoordIsX ? map[MAP_COORD_2][FIXED] : map[FIXED][MAP_COORD_2];
+	return glm::mix( HEIGHT_1, HEIGHT_2, INTERPOLATION ) + offsetY;
+}
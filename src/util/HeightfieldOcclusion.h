@@ -0,0 +1,67 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * HeightfieldOcclusion.h
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains declaration for HeightfieldOcclusion class
+ * @version 0.1.0
+ */
+
+
+#pragma once
+
+#include "TypeAliases"
+
+#include <vector>
+#include <glm/vec3.hpp>
+
+/**
+* @brief occlusion queries of line segments against a height map. Holds a pyramid of maximum heights:
+* each cell of the first level keeps the maximum of its four corner points (plus vertical offset of the surface),
+* each cell of the next levels keeps the maximum of 2x2 cells of the previous one.
+* A segment is traversed from coarse to fine cells, cells which the segment passes above entirely are skipped at once,
+* only the cells of the first level that might block the view are tested against the surface itself.
+* Besides the yes/no answer the test might tell how far the viewer might move before the answer could change.
+* Coordinates are given in map space: X is a column, Z is a row and Y is a height
+*/
+class HeightfieldOcclusion
+{
+public:
+	HeightfieldOcclusion() = default;
+	void build( const map2D_f & heightMap,
+				float offsetY );
+	void update( unsigned int left,
+				 unsigned int top,
+				 unsigned int right,
+				 unsigned int bottom );
+	bool isOccluded( const glm::vec3 & viewPosition,
+					 const glm::vec3 & point ) const noexcept;
+	float getViewTolerance( const glm::vec3 & viewPosition,
+							const glm::vec3 & point ) const noexcept;
+	bool isOccludedMarching( const glm::vec3 & viewPosition,
+							 const glm::vec3 & point ) const noexcept;
+	unsigned int getNumLevels() const noexcept;
+	float getMaxSlope() const noexcept;
+
+private:
+	float surfaceHeightAt( float interpolantCoord,
+						   int fixedCoord,
+						   bool fixedCoordIsX ) const noexcept;
+
+	const map2D_f * heightMap = nullptr;
+	float offsetY = 0.0f;
+	//maximum height difference of neighbour points, never decreases on updates
+	float maxSlope = 0.0f;
+	std::vector<map2D_f> levels;
+};
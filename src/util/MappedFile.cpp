@@ -0,0 +1,142 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * MappedFile.cpp
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains definition for MappedFile class
+ * @version 0.1.0
+ */
+
+#include "MappedFile"
+#include "Logger"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() noexcept
+	: mappedData( nullptr )
+	, mappedSize( 0 )
+#ifdef _WIN32
+	, fileHandle( INVALID_HANDLE_VALUE )
+	, mappingHandle( nullptr )
+#endif
+{}
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+/**
+* @brief maps the whole file into memory for reading, previously opened file (if any) is closed
+* @param filename name of the file to map
+* @return true if the file has been mapped successfully
+*/
+bool MappedFile::open( const char * filename )
+{
+	close();
+#ifdef _WIN32
+	fileHandle = CreateFileA( filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr );
+	if( fileHandle == INVALID_HANDLE_VALUE )
+	{
+		Logger::log( "Could not open file for mapping: %\n", filename );
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if( !GetFileSizeEx( fileHandle, &fileSize ) || fileSize.QuadPart == 0 )
+	{
+		Logger::log( "Could not map empty file: %\n", filename );
+		close();
+		return false;
+	}
+	mappingHandle = CreateFileMappingA( fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr );
+	if( mappingHandle == nullptr )
+	{
+		Logger::log( "Could not create file mapping: %\n", filename );
+		close();
+		return false;
+	}
+	mappedData = static_cast<const unsigned char*>( MapViewOfFile( mappingHandle, FILE_MAP_READ, 0, 0, 0 ) );
+	if( mappedData == nullptr )
+	{
+		Logger::log( "Could not map view of file: %\n", filename );
+		close();
+		return false;
+	}
+	mappedSize = (size_t)fileSize.QuadPart;
+#else
+	const int FILE_DESCRIPTOR = ::open( filename, O_RDONLY );
+	if( FILE_DESCRIPTOR == -1 )
+	{
+		Logger::log( "Could not open file for mapping: %\n", filename );
+		return false;
+	}
+	struct stat fileStatus;
+	if( fstat( FILE_DESCRIPTOR, &fileStatus ) != 0 || fileStatus.st_size == 0 )
+	{
+		Logger::log( "Could not map empty file: %\n", filename );
+		::close( FILE_DESCRIPTOR );
+		return false;
+	}
+	void * mapping = mmap( nullptr, (size_t)fileStatus.st_size, PROT_READ, MAP_PRIVATE, FILE_DESCRIPTOR, 0 );
+	//mapping stays valid after the descriptor is closed
+	::close( FILE_DESCRIPTOR );
+	if( mapping == MAP_FAILED )
+	{
+		Logger::log( "Could not map file: %\n", filename );
+		return false;
+	}
+	mappedData = static_cast<const unsigned char*>( mapping );
+	mappedSize = (size_t)fileStatus.st_size;
+#endif
+	return true;
+}
+
+/**
+* @brief unmaps the file, all pointers to mapped data become invalid
+*/
+void MappedFile::close() noexcept
+{
+#ifdef _WIN32
+	if( mappedData )
+	{
+		UnmapViewOfFile( mappedData );
+	}
+	if( mappingHandle )
+	{
+		CloseHandle( mappingHandle );
+		mappingHandle = nullptr;
+	}
+	if( fileHandle != INVALID_HANDLE_VALUE )
+	{
+		CloseHandle( fileHandle );
+		fileHandle = INVALID_HANDLE_VALUE;
+	}
+#else
+	if( mappedData )
+	{
+		munmap( const_cast<unsigned char*>( mappedData ), mappedSize );
+	}
+#endif
+	mappedData = nullptr;
+	mappedSize = 0;
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * MappedFile.h
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains declaration for MappedFile class
+ * @version 0.1.0
+ */
+
+#pragma once
+
+#include <cstddef>
+
+/**
+* @brief read-only memory mapping of a whole file. Mapped data remains valid until the file is closed or the object is destroyed
+*/
+class MappedFile final
+{
+public:
+	MappedFile() noexcept;
+	~MappedFile();
+	MappedFile( const MappedFile & ) = delete;
+	MappedFile & operator=( const MappedFile & ) = delete;
+	bool open( const char * filename );
+	void close() noexcept;
+	const unsigned char * data() const noexcept;
+	size_t size() const noexcept;
+
+private:
+	const unsigned char * mappedData;
+	size_t mappedSize;
+#ifdef _WIN32
+	void * fileHandle;
+	void * mappingHandle;
+#endif
+};
+
+inline const unsigned char * MappedFile::data() const noexcept
+{
+	return mappedData;
+}
+
+inline size_t MappedFile::size() const noexcept
+{
+	return mappedSize;
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * RandomStream.cpp
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains definition for RandomStream class
+ * @version 0.1.0
+ */
+
+#include "RandomStream"
+
+#include <chrono>
+#include <random>
+
+uint64_t RandomStream::worldSeed = 0;
+
+/**
+* @brief creates stream of the first subsystem at origin with current world seed
+*/
+RandomStream::RandomStream() noexcept
+	: RandomStream( worldSeed, RANDOM_STREAM_WATER, 0, 0, 0 )
+{}
+
+/**
+* @brief creates stream with current world seed
+* @param stream subsystem identifier
+* @param x X coordinate (tile, chunk etc.) the stream belongs to
+* @param y Y coordinate (tile, chunk etc.) the stream belongs to
+* @param pass number of the generation pass for subsystems processing the same coordinates multiple times
+*/
+RandomStream::RandomStream( RANDOM_STREAM stream,
+							uint32_t x,
+							uint32_t y,
+							uint32_t pass ) noexcept
+	: RandomStream( worldSeed, stream, x, y, pass )
+{}
+
+/**
+* @brief creates stream with explicitly given seed
+* @param seed seed of the world
+* @param stream subsystem identifier
+* @param x X coordinate (tile, chunk etc.) the stream belongs to
+* @param y Y coordinate (tile, chunk etc.) the stream belongs to
+* @param pass number of the generation pass for subsystems processing the same coordinates multiple times
+*/
+RandomStream::RandomStream( uint64_t seed,
+							RANDOM_STREAM stream,
+							uint32_t x,
+							uint32_t y,
+							uint32_t pass ) noexcept
+	: counter{ x, y, pass, (uint32_t)stream << STREAM_ID_SHIFT }
+	, key{ (uint32_t)seed, (uint32_t)( seed >> 32 ) }
+	, block{}
+	, blockPosition( BLOCK_SIZE )
+{}
+
+/**
+* @brief sets seed used by all subsequently created streams
+* @param seed seed of the world
+*/
+void RandomStream::setWorldSeed( uint64_t seed ) noexcept
+{
+	worldSeed = seed;
+}
+
+uint64_t RandomStream::getWorldSeed() noexcept
+{
+	return worldSeed;
+}
+
+/**
+* @brief creates non-deterministic seed for a new world
+*/
+uint64_t RandomStream::generateWorldSeed()
+{
+	std::random_device device;
+	const uint64_t TIME_ENTROPY = (uint64_t)std::chrono::high_resolution_clock::now().time_since_epoch().count();
+	return ( ( (uint64_t)device() << 32 ) | device() ) ^ TIME_ENTROPY;
+}
+
+/**
+* @brief encrypts current counter value with 10 Philox rounds and advances the counter
+*/
+void RandomStream::generateBlock() noexcept
+{
+	const uint32_t MULTIPLIER_0 = 0xD2511F53u;
+	const uint32_t MULTIPLIER_1 = 0xCD9E8D57u;
+	const uint32_t KEY_INCREMENT_0 = 0x9E3779B9u;
+	const uint32_t KEY_INCREMENT_1 = 0xBB67AE85u;
+	const unsigned int NUM_ROUNDS = 10;
+
+	uint32_t value[BLOCK_SIZE] = { counter[0], counter[1], counter[2], counter[3] };
+	uint32_t roundKey[2] = { key[0], key[1] };
+	for( unsigned int round = 0; round < NUM_ROUNDS; round++ )
+	{
+		const uint64_t PRODUCT_0 = (uint64_t)MULTIPLIER_0 * value[0];
+		const uint64_t PRODUCT_1 = (uint64_t)MULTIPLIER_1 * value[2];
+		const uint32_t NEW_VALUE[BLOCK_SIZE] = { (uint32_t)( PRODUCT_1 >> 32 ) ^ value[1] ^ roundKey[0],
+												 (uint32_t)PRODUCT_1,
+												 (uint32_t)( PRODUCT_0 >> 32 ) ^ value[3] ^ roundKey[1],
+												 (uint32_t)PRODUCT_0 };
+		for( unsigned int word = 0; word < BLOCK_SIZE; word++ )
+		{
+			value[word] = NEW_VALUE[word];
+		}
+		roundKey[0] += KEY_INCREMENT_0;
+		roundKey[1] += KEY_INCREMENT_1;
+	}
+	for( unsigned int word = 0; word < BLOCK_SIZE; word++ )
+	{
+		block[word] = value[word];
+	}
+	blockPosition = 0;
+	//lower bits of the last counter word enumerate blocks within the stream, they wrap without touching the subsystem identifier
+	counter[3] = ( counter[3] & ~BLOCK_INDEX_MASK ) | ( ( counter[3] + 1 ) & BLOCK_INDEX_MASK );
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * RandomStream.h
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains declaration for RandomStream class and random stream identifiers
+ * @version 0.1.0
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/**
+* @brief identifiers of the subsystems consuming random values, each subsystem gets its own independent random streams
+* @note values are part of the world seed contract - changing them changes worlds generated from the same seed
+*/
+enum RANDOM_STREAM : uint32_t
+{
+	RANDOM_STREAM_WATER = 0,
+	RANDOM_STREAM_HILLS_KERNEL = 1,
+	RANDOM_STREAM_HILLS_FATTENING = 2,
+	RANDOM_STREAM_SHORE_KERNEL = 3,
+	RANDOM_STREAM_SHORE_PROFILE = 4,
+	RANDOM_STREAM_PLANTS_DISTRIBUTION = 5,
+	RANDOM_STREAM_LAND_PLANTS = 6,
+	RANDOM_STREAM_GRASS = 7,
+	RANDOM_STREAM_HILL_TREES = 8
+};
+
+/**
+* @brief counter-based pseudo-random generator (Philox4x32-10). Stream is fully defined by the world seed,
+* subsystem identifier, 2D coordinate and pass number, so random values of any tile might be calculated
+* independently of others (and thus in any order and by any thread) while the whole world remains reproducible.
+* Each stream yields 2^26 values (2^24 blocks of 4) before wrapping to its first value
+*/
+class RandomStream
+{
+public:
+	RandomStream() noexcept;
+	RandomStream( RANDOM_STREAM stream,
+				  uint32_t x = 0,
+				  uint32_t y = 0,
+				  uint32_t pass = 0 ) noexcept;
+	RandomStream( uint64_t seed,
+				  RANDOM_STREAM stream,
+				  uint32_t x,
+				  uint32_t y,
+				  uint32_t pass ) noexcept;
+	uint32_t nextUint() noexcept;
+	uint32_t nextUint( uint32_t bound ) noexcept;
+	float nextFloat() noexcept;
+	float nextFloat( float min,
+					 float max ) noexcept;
+
+	static void setWorldSeed( uint64_t seed ) noexcept;
+	static uint64_t getWorldSeed() noexcept;
+	static uint64_t generateWorldSeed();
+
+private:
+	constexpr static unsigned int BLOCK_SIZE = 4;
+	constexpr static unsigned int STREAM_ID_SHIFT = 24;
+	constexpr static uint32_t BLOCK_INDEX_MASK = ( 1u << STREAM_ID_SHIFT ) - 1;
+	void generateBlock() noexcept;
+
+	uint32_t counter[BLOCK_SIZE];
+	uint32_t key[2];
+	uint32_t block[BLOCK_SIZE];
+	unsigned int blockPosition;
+
+	static uint64_t worldSeed;
+};
+
+/**
+* @brief returns next 32-bit random value of the stream
+*/
+inline uint32_t RandomStream::nextUint() noexcept
+{
+	if( blockPosition == BLOCK_SIZE )
+	{
+		generateBlock();
+	}
+	return block[blockPosition++];
+}
+
+/**
+* @brief returns random value in range [0; bound), a drop-in replacement for "rand() % bound"
+* @param bound upper bound of the range (must be positive)
+*/
+inline uint32_t RandomStream::nextUint( uint32_t bound ) noexcept
+{
+	return nextUint() % bound;
+}
+
+/**
+* @brief returns random value in range [0; 1) with 24 bits of precision
+*/
+inline float RandomStream::nextFloat() noexcept
+{
+	return ( nextUint() >> 8 ) * ( 1.0f / 16777216.0f );
+}
+
+/**
+* @brief returns random value in range [min; max)
+* @param min lower bound of the range
+* @param max upper bound of the range
+*/
+inline float RandomStream::nextFloat( float min,
+									  float max ) noexcept
+{
+	return min + ( max - min ) * nextFloat();
+}
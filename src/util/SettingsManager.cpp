@@ -65,3 +65,12 @@ bool SettingsManager::getBool( const char * category,
 {
 	return impl->getBool( category, settingKey );
 }
+
+/**
+* @brief returns hash of all the keys and values of a given settings category from implementation
+* @param category settings category
+*/
+uint64_t SettingsManager::getCategoryHash( const char * category )
+{
+	return impl->getCategoryHash( category );
+}
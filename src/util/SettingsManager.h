@@ -20,6 +20,7 @@
 #pragma once
 
 #include <memory>
+#include <cstdint>
 
 class SettingsManagerImpl;
 
@@ -37,6 +38,7 @@ public:
 						   const char * settingKey );
 	static bool getBool( const char * category,
 						 const char * settingKey );
+	static uint64_t getCategoryHash( const char * category );
 
 private:
 	static std::unique_ptr<SettingsManagerImpl> impl;
@@ -23,6 +23,7 @@
 
 #include <fstream>
 #include <filesystem>
+#include <map>
 
 /**
 * @param ctor that parses settings file
@@ -167,3 +168,44 @@ bool SettingsManagerImpl::getBool( const char * category,
 	}
 	return result;
 }
+
+/**
+* @brief calculates FNV-1a hash of all the keys and values of a given category.
+* Keys are hashed in sorted order, so the result does not depend on the storage layout nor on the config file lines order
+* @param category settings category
+*/
+uint64_t SettingsManagerImpl::getCategoryHash( const char * category )
+{
+	const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+	const uint64_t FNV_PRIME = 1099511628211ull;
+	uint64_t hash = FNV_OFFSET_BASIS;
+	auto hashBytes = [&]( const void * data, size_t size )
+	{
+		const unsigned char * bytes = static_cast<const unsigned char*>( data );
+		for( size_t byteIndex = 0; byteIndex < size; byteIndex++ )
+		{
+			hash = ( hash ^ bytes[byteIndex] ) * FNV_PRIME;
+		}
+	};
+
+	const std::map<std::string, std::any> SORTED_SETTINGS( settings[category].begin(), settings[category].end() );
+	for( const auto & setting : SORTED_SETTINGS )
+	{
+		//include terminating zero to separate keys from values
+		hashBytes( setting.first.c_str(), setting.first.size() + 1 );
+		if( const int * intValue = std::any_cast<int>( &setting.second ) )
+		{
+			hashBytes( intValue, sizeof( int ) );
+		}
+		else if( const float * floatValue = std::any_cast<float>( &setting.second ) )
+		{
+			hashBytes( floatValue, sizeof( float ) );
+		}
+		else if( const bool * boolValue = std::any_cast<bool>( &setting.second ) )
+		{
+			const unsigned char BOOL_BYTE = *boolValue ? 1 : 0;
+			hashBytes( &BOOL_BYTE, 1 );
+		}
+	}
+	return hash;
+}
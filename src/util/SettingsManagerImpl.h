@@ -21,6 +21,7 @@
 
 #include <unordered_map>
 #include <any>
+#include <cstdint>
 
 typedef std::unordered_map<std::string, std::any> settingsStorage;
 typedef std::string settingsCategoryName;
@@ -39,6 +40,7 @@ public:
 					const char * settingKey );
 	bool getBool( const char * category,
 				  const char * settingKey );
+	uint64_t getCategoryHash( const char * category );
 
 private:
 	std::unordered_map < settingsCategoryName, settingsStorage > settings;
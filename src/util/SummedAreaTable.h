@@ -0,0 +1,92 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * SummedAreaTable.h
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains declaration and definition for SummedAreaTable class
+ * @version 0.1.0
+ */
+
+
+#pragma once
+
+#include "TypeAliases"
+#include "ThreadPool"
+
+/**
+* @brief summed-area table (integral image) over a 2D map. Built once from a per-point value function (e.g. a predicate
+* over map values) after which sum of values over any rectangle is taken in constant time with four lookups.
+* The table has one extra zero row and column, so that table[y][x] holds sum of values over [0, x) x [0, y)
+*/
+class SummedAreaTable
+{
+public:
+	SummedAreaTable() = default;
+
+	/**
+	* @brief (re)builds the table. Rows prefix sums and then columns accumulation are processed in parallel
+	* @param width number of columns of the source map
+	* @param height number of rows of the source map
+	* @param value function returning value (or predicate result) of the source map point, called as value( x, y ),
+	* must be safe to call concurrently
+	*/
+	template <typename ValueFunction>
+	void build( size_t width,
+				size_t height,
+				ValueFunction value )
+	{
+		table.assign( width + 1, height + 1, 0 );
+		ThreadPool & threadPool = ThreadPool::getInstance();
+		threadPool.parallelFor( 0, height, [&]( size_t bandBegin, size_t bandEnd )
+		{
+			for( size_t y = bandBegin; y < bandEnd; y++ )
+			{
+				HeightfieldRow<int> row = table[y + 1];
+				int rowSum = 0;
+				for( size_t x = 0; x < width; x++ )
+				{
+					rowSum += (int)value( x, y );
+					row[x + 1] = rowSum;
+				}
+			}
+		} );
+		threadPool.parallelFor( 1, width + 1, [&]( size_t bandBegin, size_t bandEnd )
+		{
+			for( size_t y = 2; y <= height; y++ )
+			{
+				HeightfieldRow<const int> upperRow = static_cast<const map2D_i&>( table )[y - 1];
+				HeightfieldRow<int> row = table[y];
+				for( size_t x = bandBegin; x < bandEnd; x++ )
+				{
+					row[x] += upperRow[x];
+				}
+			}
+		} );
+	}
+
+	/**
+	* @brief returns sum of values over rectangle [left, right) x [top, bottom) of the source map
+	* @note it is the caller's responsibility to make sure that left <= right <= width and top <= bottom <= height
+	*/
+	int getSum( size_t left,
+				size_t top,
+				size_t right,
+				size_t bottom ) const noexcept
+	{
+		return table[bottom][right] - table[top][right] - table[bottom][left] + table[top][left];
+	}
+
+private:
+	map2D_i table;
+};
@@ -0,0 +1,202 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * ThreadPool.cpp
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains definition for ThreadPool class
+ * @version 0.1.0
+ */
+
+#include "ThreadPool"
+#include "SettingsManager"
+#include "Logger"
+
+#include <string>
+
+/**
+* @brief spawns worker threads, number of threads is read from the config
+*/
+ThreadPool::ThreadPool()
+	: currentJob( nullptr )
+	, jobBegin( 0 )
+	, jobEnd( 0 )
+	, numBands( 0 )
+	, bandsRemaining( 0 )
+	, jobGeneration( 0 )
+	, stopping( false )
+{
+	int numThreads = SettingsManager::getInt( "SCENE", "generator_threads" );
+	if( numThreads <= 0 )
+	{
+		numThreads = (int)std::thread::hardware_concurrency();
+	}
+	if( numThreads <= 0 )
+	{
+		numThreads = 1;
+	}
+
+	startWorkers( (unsigned int)numThreads );
+	Logger::log( "thread pool started with % threads\n", std::to_string( numThreads ).c_str() );
+}
+
+/**
+* @brief returns instance of the pool, pool is created on first use
+*/
+ThreadPool & ThreadPool::getInstance()
+{
+	static ThreadPool instance;
+	return instance;
+}
+
+/**
+* @brief stops all the workers
+*/
+ThreadPool::~ThreadPool()
+{
+	stopWorkers();
+}
+
+unsigned int ThreadPool::getNumThreads() const noexcept
+{
+	return (unsigned int)workers.size() + 1;
+}
+
+/**
+* @brief stops current workers and spawns new ones. Waits for the job in progress (if any) to finish
+* @param numThreads total number of threads processing jobs including the calling one, zero is treated as one
+*/
+void ThreadPool::setNumThreads( unsigned int numThreads )
+{
+	std::lock_guard<std::mutex> submitLock( submitMutex );
+	stopWorkers();
+	startWorkers( numThreads );
+}
+
+/**
+* @brief spawns workers, the calling thread always takes part in the job, so it does not need a worker
+* @param numThreads total number of threads processing jobs including the calling one
+*/
+void ThreadPool::startWorkers( unsigned int numThreads )
+{
+	stopping = false;
+	for( unsigned int bandIndex = 1; bandIndex < numThreads; bandIndex++ )
+	{
+		//workers are given current generation, so that they do not mistake already finished job for a new one
+		workers.emplace_back( &ThreadPool::workerLoop, this, bandIndex, jobGeneration );
+	}
+}
+
+/**
+* @brief notifies all the workers to stop and waits for them to finish
+*/
+void ThreadPool::stopWorkers()
+{
+	{
+		std::lock_guard<std::mutex> lock( stateMutex );
+		stopping = true;
+	}
+	jobReadyCV.notify_all();
+	for( std::thread & worker : workers )
+	{
+		worker.join();
+	}
+	workers.clear();
+}
+
+/**
+* @brief splits range [begin; end) into contiguous bands and processes them in parallel. Blocks until all bands are done
+* @param begin first index of the range
+* @param end index after the last one of the range
+* @param bandJob function processing band [bandBegin; bandEnd), must be safe to call concurrently for different bands
+*/
+void ThreadPool::parallelFor( size_t begin,
+							  size_t end,
+							  const std::function<void( size_t, size_t )> & bandJob )
+{
+	if( begin >= end )
+	{
+		return;
+	}
+	const size_t RANGE_SIZE = end - begin;
+	if( workers.empty() || RANGE_SIZE == 1 )
+	{
+		bandJob( begin, end );
+		return;
+	}
+
+	std::lock_guard<std::mutex> submitLock( submitMutex );
+	{
+		std::lock_guard<std::mutex> lock( stateMutex );
+		currentJob = &bandJob;
+		jobBegin = begin;
+		jobEnd = end;
+		numBands = RANGE_SIZE < getNumThreads() ? (unsigned int)RANGE_SIZE : getNumThreads();
+		bandsRemaining = numBands - 1;
+		jobGeneration++;
+	}
+	jobReadyCV.notify_all();
+
+	runBand( 0 );
+
+	std::unique_lock<std::mutex> lock( stateMutex );
+	jobDoneCV.wait( lock, [this]() noexcept { return bandsRemaining == 0; } );
+	currentJob = nullptr;
+}
+
+/**
+* @brief waits for a new job and processes the band assigned to this worker
+* @param bandIndex index of the band this worker is responsible for
+* @param lastGeneration generation of the last job seen before the worker has started
+*/
+void ThreadPool::workerLoop( unsigned int bandIndex,
+							 unsigned int lastGeneration )
+{
+	while( true )
+	{
+		std::unique_lock<std::mutex> lock( stateMutex );
+		jobReadyCV.wait( lock, [this, lastGeneration]() noexcept { return stopping || jobGeneration != lastGeneration; } );
+		if( stopping )
+		{
+			return;
+		}
+		lastGeneration = jobGeneration;
+		//job might need less bands than there are threads
+		if( bandIndex >= numBands )
+		{
+			continue;
+		}
+		lock.unlock();
+
+		runBand( bandIndex );
+
+		lock.lock();
+		if( --bandsRemaining == 0 )
+		{
+			lock.unlock();
+			jobDoneCV.notify_one();
+		}
+	}
+}
+
+/**
+* @brief processes one band of the current job, bands are distributed as evenly as possible
+* @param bandIndex index of the band to process
+*/
+void ThreadPool::runBand( unsigned int bandIndex ) const
+{
+	const size_t RANGE_SIZE = jobEnd - jobBegin;
+	const size_t BAND_BEGIN = jobBegin + RANGE_SIZE * bandIndex / numBands;
+	const size_t BAND_END = jobBegin + RANGE_SIZE * ( bandIndex + 1 ) / numBands;
+	( *currentJob )( BAND_BEGIN, BAND_END );
+}
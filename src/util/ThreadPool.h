@@ -0,0 +1,66 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * ThreadPool.h
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains declaration for ThreadPool class
+ * @version 0.1.0
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+* @brief pool of persistent worker threads for data-parallel CPU work (e.g. per-row processing of terrain maps).
+* Each job is split into contiguous bands, one band per thread, the calling thread processes the first band itself.
+* Number of threads is taken from the config, zero value means as many threads as the hardware supports. It might be changed later on
+*/
+class ThreadPool final
+{
+public:
+	static ThreadPool & getInstance();
+	~ThreadPool();
+	unsigned int getNumThreads() const noexcept;
+	void setNumThreads( unsigned int numThreads );
+	void parallelFor( size_t begin,
+					  size_t end,
+					  const std::function<void( size_t, size_t )> & bandJob );
+
+private:
+	ThreadPool();
+	void startWorkers( unsigned int numThreads );
+	void stopWorkers();
+	void workerLoop( unsigned int bandIndex,
+					 unsigned int lastGeneration );
+	void runBand( unsigned int bandIndex ) const;
+
+	std::vector<std::thread> workers;
+	//only one job might be in progress at a time
+	std::mutex submitMutex;
+	std::mutex stateMutex;
+	std::condition_variable jobReadyCV;
+	std::condition_variable jobDoneCV;
+	const std::function<void( size_t, size_t )> * currentJob;
+	size_t jobBegin;
+	size_t jobEnd;
+	unsigned int numBands;
+	unsigned int bandsRemaining;
+	unsigned int jobGeneration;
+	bool stopping;
+};
@@ -34,6 +34,12 @@ frame_water_refraction_height<i>=900
 shadow_distance_layer1<f>=20.0
 # default = 60.0
 shadow_distance_layer2<f>=60.0
+# maximum screen space error (in pixels) of the coarse terrain levels of detail, 0 allows only lossless simplification, default = 2.0
+terrain_lod_pixel_error<f>=2.0
+# maximum number of indirect draw commands (land and models) written during one frame, default = 131072
+indirect_commands_per_frame<i>=131072
+# size (in megabytes) of the staging buffer all the buffer data uploads go through, default = 16
+upload_staging_buffer_size<i>=16
 
 # settings applied to scene configuration and terrain generating algorithms
 # IMPORTANT: changing some of these values may lead to visual discrepancies, so make sure you understand what you do
@@ -52,6 +58,12 @@ planet_move_speed<f>=0.045
 plants_distribution_freq<i>=8
 # this one supposed to make shore more smooth, but in practice it only makes the river wider, so keep it 5 by default
 shore_smooth_cycles<i>=5
+# number of threads used for world generation, 0 means as many as the hardware supports, default = 0
+generator_threads<i>=0
+# seed of the initially generated world, the same seed always produces the same world, 0 means random seed, default = 0
+world_seed<i>=0
+# whether generated world should be cached to skip generation on subsequent launches (works only with non-zero world_seed), default = true
+world_cache<b>=true
 
 # camera settings that supposed to be not strictly constant, but should not be changed during game loop
 [CAMERA]
@@ -123,6 +135,8 @@ loading_distance_chunks<i>=8
 loading_distance_chunks_lowpoly<i>=32
 # number of chunks nearby camera that contain shadow casters data, default = 16
 loading_distance_chunks_shadow<i>=16
+# time (in microseconds) each plants generator might spend per update on retesting hills occlusion of chunks whose cached results expired, 0 = unlimited, default = 500
+occlusion_test_budget_us<i>=500
 
 # settings for hills generating process
 [HILLS_GENERATOR]
@@ -0,0 +1,169 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * bufferbench.cpp
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains entry point of the buffer collection lookup and bind microbenchmark
+ * @version 0.1.0
+ */
+
+
+#include "BufferCollection"
+#include "Logger"
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+	constexpr int NUM_COLLECTIONS = 64;
+	constexpr int NUM_FRAMES = 2000;
+	constexpr int DRAWS_PER_COLLECTION = 4;
+
+	GLuint nextObjectName = 1;
+	unsigned long long numGLCalls = 0;
+
+	//GL entry points are replaced with no-ops, thus only CPU side overhead of the lookups and binds is measured
+	void APIENTRY createObjects( GLsizei n, GLuint * objects )
+	{
+		for( GLsizei i = 0; i < n; i++ )
+		{
+			objects[i] = nextObjectName++;
+		}
+	}
+	void APIENTRY deleteObjects( GLsizei, const GLuint * ) {}
+	void APIENTRY bindBuffer( GLenum, GLuint ) { ++numGLCalls; }
+	void APIENTRY bindObject( GLuint ) { ++numGLCalls; }
+	void APIENTRY bindTransformFeedback( GLenum, GLuint ) { ++numGLCalls; }
+
+	/**
+	* @brief reproduces the former hash map storage of the buffer collection, used as a baseline
+	*/
+	class MapBufferCollection
+	{
+	public:
+		explicit MapBufferCollection( int flags )
+		{
+			for( int flag = VAO; flag <= TFBO; flag <<= 4 )
+			{
+				if( flags & flag )
+				{
+					objects[flag] = nextObjectName++;
+				}
+			}
+		}
+
+		void bind( int flag )
+		{
+			if( flag & VAO )
+			{
+				glBindVertexArray( objects[VAO] );
+			}
+			if( flag & VBO )
+			{
+				glBindBuffer( GL_ARRAY_BUFFER, objects[VBO] );
+			}
+			if( flag & INSTANCE_VBO )
+			{
+				glBindBuffer( GL_ARRAY_BUFFER, objects[INSTANCE_VBO] );
+			}
+			if( flag & EBO )
+			{
+				glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, objects[EBO] );
+			}
+			if( flag & DIBO )
+			{
+				glBindBuffer( GL_DRAW_INDIRECT_BUFFER, objects[DIBO] );
+			}
+			if( flag & TFBO )
+			{
+				glBindTransformFeedback( GL_TRANSFORM_FEEDBACK, objects[TFBO] );
+			}
+		}
+
+		GLuint & get( int flag )
+		{
+			return objects[flag];
+		}
+
+	private:
+		std::unordered_map<int, GLuint> objects;
+	};
+
+	/**
+	* @brief imitates frame of the renderers: each collection is bound for a few consecutive draw calls
+	* and one of its buffers is looked up per draw call
+	* @param collections collections to be bound
+	* @param name name of the run to be logged
+	*/
+	template <typename CollectionT>
+	void runFrames( std::vector<CollectionT> & collections,
+					const char * name )
+	{
+		numGLCalls = 0;
+		unsigned long long checksum = 0;
+		auto startTime = std::chrono::steady_clock::now();
+		for( int frame = 0; frame < NUM_FRAMES; frame++ )
+		{
+			for( CollectionT & collection : collections )
+			{
+				for( int draw = 0; draw < DRAWS_PER_COLLECTION; draw++ )
+				{
+					collection.bind( VAO | DIBO );
+					checksum += collection.get( VBO );
+				}
+			}
+			BufferCollection::finishFrame();
+		}
+		auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - startTime );
+		const long long NUM_DRAWS = (long long)NUM_FRAMES * NUM_COLLECTIONS * DRAWS_PER_COLLECTION;
+		Logger::log( "%: % ns per draw, % GL bind calls per frame (checksum %)\n",
+					 name,
+					 std::to_string( (double)duration.count() / NUM_DRAWS ).c_str(),
+					 std::to_string( numGLCalls / NUM_FRAMES ).c_str(),
+					 std::to_string( checksum ).c_str() );
+	}
+}
+
+int main()
+{
+	glCreateVertexArrays = createObjects;
+	glCreateBuffers = createObjects;
+	glCreateTransformFeedbacks = createObjects;
+	glDeleteVertexArrays = deleteObjects;
+	glDeleteBuffers = deleteObjects;
+	glDeleteTransformFeedbacks = deleteObjects;
+	glBindVertexArray = bindObject;
+	glBindBuffer = bindBuffer;
+	glBindTransformFeedback = bindTransformFeedback;
+
+	std::vector<MapBufferCollection> mapCollections;
+	std::vector<BufferCollection> slotCollections;
+	mapCollections.reserve( NUM_COLLECTIONS );
+	slotCollections.reserve( NUM_COLLECTIONS );
+	for( int collectionIndex = 0; collectionIndex < NUM_COLLECTIONS; collectionIndex++ )
+	{
+		mapCollections.emplace_back( VAO | VBO | EBO | DIBO );
+		slotCollections.emplace_back( VAO | VBO | EBO | DIBO );
+	}
+
+	runFrames( mapCollections, "unordered map storage" );
+	runFrames( slotCollections, "slot array storage with bind tracking" );
+	Logger::log( "binds sent: %, skipped: % (last frame)\n",
+				 std::to_string( BufferCollection::getNumBindsLastFrame() ).c_str(),
+				 std::to_string( BufferCollection::getNumSkippedBindsLastFrame() ).c_str() );
+	return 0;
+}
@@ -0,0 +1,265 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * frameallocs.cpp
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains entry point of the plants indirect buffer preparation allocations check
+ * @version 0.1.0
+ */
+
+
+#include "PlantGenerator"
+#include "Model"
+#include "ModelGPUDataManager"
+#include "IndirectCommandRing"
+#include "HeightfieldOcclusion"
+#include "Camera"
+#include "Frustum"
+#include "SettingsManager"
+#include "Logger"
+
+#include <GLFW/glfw3.h>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+
+/**
+* replaces global operator new with a counting one and runs the per-frame plants path (chunks culling,
+* hills occlusion cache update and indirect draw commands preparation of every model) along a camera flight.
+* The first frame is allowed to grow the reusable storages, every following frame must not allocate at all.
+* Returns non-zero exit code if any frame after the first one allocates.
+* @note models are not loaded from files here, their GPU data managers are driven directly instead,
+* a hidden window is created as the managers and the command ring need OpenGL context
+*/
+
+namespace
+{
+	std::atomic<size_t> numAllocations( 0 );
+
+	constexpr unsigned int NUM_MODELS = 8;
+	constexpr unsigned int NUM_FRAMES = 360;
+	constexpr float FLIGHT_RADIUS = 120.0f;
+	constexpr float FLIGHT_HEIGHT = 8.0f;
+
+	/**
+	* @brief plant generator with random instances distribution over synthetic terrain, its models are not loaded
+	* thus the generator only culls chunks and the caller prepares the draw commands from its visible chunks
+	*/
+	class TestPlantGenerator : public PlantGenerator
+	{
+	public:
+		/**
+		* @brief fills chunks with random number of instances of each model and initializes render chunks
+		* @param map terrain map the plants are placed on
+		* @param randomizer random numbers generator
+		*/
+		void setup( const map2D_f & map,
+					std::mt19937 & randomizer )
+		{
+			std::uniform_int_distribution<unsigned int> numInstancesDistribution( 0, 3 );
+			initializeModelChunks( map );
+			std::vector<unsigned int> modelsNumInstances( NUM_MODELS, 0 );
+			for( ModelChunk & chunk : chunks )
+			{
+				std::vector<unsigned int> numInstances( NUM_MODELS );
+				std::vector<unsigned int> instanceOffsets( NUM_MODELS );
+				for( unsigned int modelIndex = 0; modelIndex < NUM_MODELS; modelIndex++ )
+				{
+					numInstances[modelIndex] = numInstancesDistribution( randomizer );
+					instanceOffsets[modelIndex] = modelsNumInstances[modelIndex];
+					modelsNumInstances[modelIndex] += numInstances[modelIndex];
+				}
+				chunk.setNumInstancesVector( numInstances );
+				chunk.setInstanceOffsetsVector( instanceOffsets );
+			}
+			cullingOffset = FRUSTUM_CULLING_DISTANCE_OFFSET;
+			initializeModelRenderChunks( map, 2.0f );
+		}
+
+		const ModelRenderChunks & getRenderChunks() const noexcept { return renderChunks; }
+		const VisibleModelChunks & getVisibleChunks() const noexcept { return visibleChunks; }
+	};
+
+	/**
+	* @brief generates hills-like height map of the world size
+	*/
+	map2D_f generateHillsMap()
+	{
+		map2D_f hillsMap( WORLD_WIDTH + 1, WORLD_HEIGHT + 1 );
+		for( unsigned int y = 0; y <= WORLD_HEIGHT; y++ )
+		{
+			for( unsigned int x = 0; x <= WORLD_WIDTH; x++ )
+			{
+				hillsMap[y][x] = glm::max( 0.0f, 6.0f * glm::sin( x * 0.05f ) * glm::cos( y * 0.07f ) + 2.0f * glm::sin( ( x + y ) * 0.13f ) );
+			}
+		}
+		return hillsMap;
+	}
+
+	/**
+	* @brief creates hidden window with OpenGL context of the same version the game uses
+	* @return true if the context has been created
+	*/
+	bool createContext()
+	{
+		if( !glfwInit() )
+		{
+			return false;
+		}
+		glfwWindowHint( GLFW_CONTEXT_VERSION_MAJOR, 4 );
+		glfwWindowHint( GLFW_CONTEXT_VERSION_MINOR, 5 );
+		glfwWindowHint( GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE );
+		glfwWindowHint( GLFW_VISIBLE, GLFW_FALSE );
+		GLFWwindow * window = glfwCreateWindow( 64, 64, "frameallocs", nullptr, nullptr );
+		if( !window )
+		{
+			return false;
+		}
+		glfwMakeContextCurrent( window );
+		glewExperimental = GL_TRUE;
+		return glewInit() == GLEW_OK;
+	}
+}
+
+void * operator new( size_t size )
+{
+	numAllocations++;
+	void * memory = std::malloc( size != 0 ? size : 1 );
+	if( !memory )
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void * operator new[]( size_t size )
+{
+	return operator new( size );
+}
+
+void operator delete( void * memory ) noexcept
+{
+	std::free( memory );
+}
+
+void operator delete[]( void * memory ) noexcept
+{
+	std::free( memory );
+}
+
+void operator delete( void * memory,
+					  size_t ) noexcept
+{
+	operator delete( memory );
+}
+
+void operator delete[]( void * memory,
+						size_t ) noexcept
+{
+	operator delete( memory );
+}
+
+int main()
+{
+	if( !createContext() )
+	{
+		Logger::log( "unable to create OpenGL context\n" );
+		return 1;
+	}
+	SettingsManager::init( "config.ini" );
+	const unsigned int LOADING_DISTANCE_UNITS = CHUNK_SIZE * SettingsManager::getInt( "PLANT_GENERATOR", "loading_distance_chunks" );
+	const unsigned int LOADING_DISTANCE_UNITS_SHADOW = CHUNK_SIZE * SettingsManager::getInt( "PLANT_GENERATOR", "loading_distance_chunks_shadow" );
+	const float NEAR_PLANE = SettingsManager::getFloat( "GRAPHICS", "near_plane" );
+	const float FAR_PLANE = SettingsManager::getFloat( "GRAPHICS", "far_plane" );
+	IndirectCommandRing indirectCommandRing( SettingsManager::getInt( "GRAPHICS", "indirect_commands_per_frame" ) );
+
+	std::mt19937 randomizer( 12345 );
+	const map2D_f LAND_MAP( WORLD_WIDTH + 1, WORLD_HEIGHT + 1, 0.0f );
+	const map2D_f HILLS_MAP = generateHillsMap();
+	HeightfieldOcclusion hillsOcclusion;
+	hillsOcclusion.build( HILLS_MAP, HILLS_OFFSET_Y );
+	TestPlantGenerator generator;
+	generator.setup( LAND_MAP, randomizer );
+
+	//full-poly and low-poly data managers of each model
+	std::vector<ModelGPUDataManager> dataManagers;
+	dataManagers.reserve( NUM_MODELS * 2 );
+	for( unsigned int modelIndex = 0; modelIndex < NUM_MODELS; modelIndex++ )
+	{
+		dataManagers.emplace_back( false );
+		dataManagers.emplace_back( true );
+	}
+
+	//cameras are created beforehand as their construction reads settings, camera flies in a circle looking around
+	std::vector<std::unique_ptr<Camera>> cameras;
+	cameras.reserve( NUM_FRAMES );
+	for( unsigned int frame = 0; frame < NUM_FRAMES; frame++ )
+	{
+		const float ANGLE = glm::radians( (float)frame );
+		cameras.emplace_back( new Camera( FLIGHT_RADIUS * glm::cos( ANGLE ), FLIGHT_HEIGHT, FLIGHT_RADIUS * glm::sin( ANGLE ) ) );
+		cameras.back()->setYaw( frame * 3.0f );
+		cameras.back()->setPitch( -10.0f );
+	}
+	Logger::log( "render chunks: %, models: %\n", std::to_string( generator.getRenderChunks().size() ).c_str(), std::to_string( NUM_MODELS ).c_str() );
+
+	size_t numFirstFrameAllocations = 0;
+	size_t numAllocatingFrames = 0;
+	size_t maxFrameAllocations = 0;
+	size_t maxVisibleChunks = 0;
+	Frustum viewFrustum;
+	for( unsigned int frame = 0; frame < NUM_FRAMES; frame++ )
+	{
+		const Camera & camera = *cameras[frame];
+		const size_t FRAME_START_ALLOCATIONS = numAllocations;
+
+		const glm::mat4 PROJECTION = glm::perspective( glm::radians( camera.getZoom() + 10.0f ), 16.0f / 9.0f, NEAR_PLANE, FAR_PLANE );
+		viewFrustum.updateFrustum( PROJECTION * camera.getViewMatrix() );
+		generator.prepareIndirectBufferData( camera, viewFrustum, hillsOcclusion, indirectCommandRing );
+		for( unsigned int managerIndex = 0; managerIndex < dataManagers.size(); managerIndex++ )
+		{
+			dataManagers[managerIndex].prepareIndirectBufferData( generator.getRenderChunks(),
+																  generator.getVisibleChunks(),
+																  managerIndex / 2,
+																  (float)( LOADING_DISTANCE_UNITS * LOADING_DISTANCE_UNITS ),
+																  (float)( LOADING_DISTANCE_UNITS_SHADOW * LOADING_DISTANCE_UNITS_SHADOW ),
+																  indirectCommandRing );
+		}
+		indirectCommandRing.advance();
+
+		const size_t FRAME_ALLOCATIONS = numAllocations - FRAME_START_ALLOCATIONS;
+		maxVisibleChunks = glm::max( maxVisibleChunks, generator.getVisibleChunks().size() );
+		if( frame == 0 )
+		{
+			numFirstFrameAllocations = FRAME_ALLOCATIONS;
+		}
+		else if( FRAME_ALLOCATIONS != 0 )
+		{
+			numAllocatingFrames++;
+			maxFrameAllocations = glm::max( maxFrameAllocations, FRAME_ALLOCATIONS );
+		}
+	}
+
+	Logger::log( "visible chunks per frame: up to %\n", std::to_string( maxVisibleChunks ).c_str() );
+	Logger::log( "first frame allocations: %\n", std::to_string( numFirstFrameAllocations ).c_str() );
+	Logger::log( "frames allocating after the first one: % of %, up to % allocations per frame\n",
+				 std::to_string( numAllocatingFrames ).c_str(),
+				 std::to_string( NUM_FRAMES - 1 ).c_str(),
+				 std::to_string( maxFrameAllocations ).c_str() );
+	return numAllocatingFrames == 0 ? 0 : 1;
+}
@@ -0,0 +1,197 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * frustumbench.cpp
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains entry point of the batch frustum box test check and microbenchmark
+ * @version 0.1.0
+ */
+
+
+#include "Frustum"
+#include "CpuFeatures"
+#include "Logger"
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+
+/**
+* checks batch frustum box tests of every instruction set supported by the CPU against the scalar test
+* and measures their speed along with the point based test previously used for chunks.
+* Returns non-zero exit code if any batch result differs from the scalar one
+*/
+
+namespace
+{
+	constexpr int NUM_BOXES = 9216;
+	constexpr int NUM_FRUSTUMS = 256;
+	constexpr float WORLD_EXTENT = 192.0f;
+
+	/**
+	* @brief generates random boxes spread over the world, every 16th box is degenerate (its corners coincide)
+	* @param randomizer random numbers generator
+	*/
+	std::vector<AABB> generateBoxes( std::mt19937 & randomizer )
+	{
+		std::uniform_real_distribution<float> position( -WORLD_EXTENT, WORLD_EXTENT );
+		std::uniform_real_distribution<float> size( 0.0f, 8.0f );
+		std::vector<AABB> boxes( NUM_BOXES );
+		for( int boxIndex = 0; boxIndex < NUM_BOXES; boxIndex++ )
+		{
+			AABB & box = boxes[boxIndex];
+			box.boundsMin = glm::vec3( position( randomizer ), size( randomizer ) - 4.0f, position( randomizer ) );
+			box.boundsMax = boxIndex % 16 == 0 ? box.boundsMin : box.boundsMin + glm::vec3( size( randomizer ), size( randomizer ), size( randomizer ) );
+		}
+		return boxes;
+	}
+
+	/**
+	* @brief generates frustums of cameras with random position, direction, field of view and far plane
+	* @param randomizer random numbers generator
+	*/
+	std::vector<Frustum> generateFrustums( std::mt19937 & randomizer )
+	{
+		std::uniform_real_distribution<float> position( -WORLD_EXTENT, WORLD_EXTENT );
+		std::uniform_real_distribution<float> unit( 0.0f, 1.0f );
+		std::vector<Frustum> frustums( NUM_FRUSTUMS );
+		for( Frustum & frustum : frustums )
+		{
+			const glm::vec3 VIEW_POSITION( position( randomizer ), unit( randomizer ) * 30.0f, position( randomizer ) );
+			const glm::vec3 VIEW_DIRECTION( unit( randomizer ) - 0.5f, unit( randomizer ) - 0.8f, unit( randomizer ) - 0.5f );
+			const glm::mat4 PROJECTION = glm::perspective( glm::radians( 30.0f + unit( randomizer ) * 60.0f ), 16.0f / 9.0f, 0.1f, 50.0f + unit( randomizer ) * 350.0f );
+			frustum.updateFrustum( PROJECTION * glm::lookAt( VIEW_POSITION, VIEW_POSITION + VIEW_DIRECTION, glm::vec3( 0.0f, 1.0f, 0.0f ) ) );
+		}
+		return frustums;
+	}
+
+	/**
+	* @brief runs given test over all the frustums and prints time per box
+	* @param name name of the run to be logged
+	* @param frustums frustums to test boxes against
+	* @param test routine testing all the boxes against a frustum and returning number of boxes not outside of it
+	*/
+	template <typename Test>
+	void runBenchmark( const char * name,
+					   const std::vector<Frustum> & frustums,
+					   Test test )
+	{
+		size_t numVisible = 0;
+		auto startTime = std::chrono::steady_clock::now();
+		for( const Frustum & frustum : frustums )
+		{
+			numVisible += test( frustum );
+		}
+		auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - startTime );
+		Logger::log( "%: % ns per box, % us per % boxes (% visible)\n",
+					 name,
+					 std::to_string( (double)duration.count() / ( (double)NUM_FRUSTUMS * NUM_BOXES ) ).c_str(),
+					 std::to_string( duration.count() / 1000.0 / NUM_FRUSTUMS ).c_str(),
+					 std::to_string( NUM_BOXES ).c_str(),
+					 std::to_string( numVisible ).c_str() );
+	}
+
+	/**
+	* @brief point based test of the box corners previously used for chunks, the box is visible if any of its corners is inside
+	*/
+	bool isAnyCornerInside( const Frustum & frustum,
+							const AABB & box )
+	{
+		const glm::vec3 & MIN = box.boundsMin;
+		const glm::vec3 & MAX = box.boundsMax;
+		return frustum.isInside( MIN.x, MAX.y, MAX.z, 0.0f ) ||
+			   frustum.isInside( MAX.x, MAX.y, MAX.z, 0.0f ) ||
+			   frustum.isInside( MAX.x, MAX.y, MIN.z, 0.0f ) ||
+			   frustum.isInside( MIN.x, MAX.y, MIN.z, 0.0f ) ||
+			   frustum.isInside( MIN.x, MIN.y, MAX.z, 0.0f ) ||
+			   frustum.isInside( MAX.x, MIN.y, MAX.z, 0.0f ) ||
+			   frustum.isInside( MAX.x, MIN.y, MIN.z, 0.0f ) ||
+			   frustum.isInside( MIN.x, MIN.y, MIN.z, 0.0f );
+	}
+}
+
+int main()
+{
+	std::mt19937 randomizer( 12345 );
+	const std::vector<AABB> BOXES = generateBoxes( randomizer );
+	const std::vector<Frustum> FRUSTUMS = generateFrustums( randomizer );
+	const INSTRUCTION_SET SUPPORTED_INSTRUCTION_SET = CpuFeatures::getInstructionSet();
+	Logger::log( "CPU instruction set: %\n", CpuFeatures::getInstructionSetName( SUPPORTED_INSTRUCTION_SET ) );
+
+	//correctness: every batch result must match the scalar test, the scalar test must agree with isBoxInside
+	std::vector<unsigned char> results( NUM_BOXES );
+	size_t numMismatches = 0;
+	for( int instructionSet = ISA_SCALAR; instructionSet <= SUPPORTED_INSTRUCTION_SET; instructionSet++ )
+	{
+		Frustum::setInstructionSet( (INSTRUCTION_SET)instructionSet );
+		std::array<size_t, 3> numResults = { 0, 0, 0 };
+		for( const Frustum & frustum : FRUSTUMS )
+		{
+			frustum.testAABBs( BOXES.data(), BOXES.size(), results.data() );
+			for( int boxIndex = 0; boxIndex < NUM_BOXES; boxIndex++ )
+			{
+				const FRUSTUM_TEST_RESULT EXPECTED = frustum.testAABB( BOXES[boxIndex] );
+				const bool IS_BOX_INSIDE = frustum.isBoxInside( BOXES[boxIndex].boundsMin, BOXES[boxIndex].boundsMax );
+				if( results[boxIndex] != EXPECTED || IS_BOX_INSIDE != ( EXPECTED != FRUSTUM_OUTSIDE ) )
+				{
+					numMismatches++;
+				}
+				numResults[results[boxIndex]]++;
+			}
+		}
+		Logger::log( "% batch test: % outside, % intersecting, % inside\n",
+					 CpuFeatures::getInstructionSetName( (INSTRUCTION_SET)instructionSet ),
+					 std::to_string( numResults[FRUSTUM_OUTSIDE] ).c_str(),
+					 std::to_string( numResults[FRUSTUM_INTERSECTS] ).c_str(),
+					 std::to_string( numResults[FRUSTUM_INSIDE] ).c_str() );
+	}
+	Logger::log( "mismatches against the scalar test: %\n", std::to_string( numMismatches ).c_str() );
+
+	runBenchmark( "any corner inside (point tests)", FRUSTUMS, [&]( const Frustum & frustum )
+	{
+		size_t numVisible = 0;
+		for( const AABB & box : BOXES )
+		{
+			numVisible += isAnyCornerInside( frustum, box ) ? 1 : 0;
+		}
+		return numVisible;
+	} );
+	runBenchmark( "isBoxInside", FRUSTUMS, [&]( const Frustum & frustum )
+	{
+		size_t numVisible = 0;
+		for( const AABB & box : BOXES )
+		{
+			numVisible += frustum.isBoxInside( box.boundsMin, box.boundsMax ) ? 1 : 0;
+		}
+		return numVisible;
+	} );
+	for( int instructionSet = ISA_SCALAR; instructionSet <= SUPPORTED_INSTRUCTION_SET; instructionSet++ )
+	{
+		Frustum::setInstructionSet( (INSTRUCTION_SET)instructionSet );
+		const std::string NAME = std::string( "testAABBs " ) + CpuFeatures::getInstructionSetName( (INSTRUCTION_SET)instructionSet );
+		runBenchmark( NAME.c_str(), FRUSTUMS, [&]( const Frustum & frustum )
+		{
+			frustum.testAABBs( BOXES.data(), BOXES.size(), results.data() );
+			size_t numVisible = 0;
+			for( unsigned char result : results )
+			{
+				numVisible += result != FRUSTUM_OUTSIDE ? 1 : 0;
+			}
+			return numVisible;
+		} );
+	}
+	return numMismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * gendeterminism.cpp
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains entry point of the world generation determinism check
+ * @version 0.1.0
+ */
+
+
+#include "WaterGenerator"
+#include "HillsGenerator"
+#include "ShoreGenerator"
+#include "LandGenerator"
+#include "RandomStream"
+#include "SettingsManager"
+#include "ThreadPool"
+#include "Logger"
+
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+* generates terrain (water, hills, shore, land) from the same seed with different numbers of thread pool threads
+* and checks that maps and mesh data are byte-identical to the ones generated on a single thread.
+* Usage: gendeterminism [seed] [max threads]
+* If the seed is not given (or is zero) - fixed one is used. Thread counts are 1, 2 and the maximum one
+* (hardware concurrency by default). Returns non-zero exit code if any run differs from the single threaded one
+* @note plants are not checked here as their models loading requires OpenGL
+*/
+
+namespace
+{
+	constexpr uint64_t DEFAULT_SEED = 20190101;
+
+	/**
+	* @brief appends bytes of each map row to the snapshot, rows padding is skipped
+	* @param snapshot storage of the generated data bytes
+	* @param map map to append
+	*/
+	template <typename T>
+	void appendMap( std::vector<unsigned char> & snapshot,
+					const Heightfield2D<T> & map )
+	{
+		for( size_t y = 0; y < map.size(); y++ )
+		{
+			const unsigned char * rowBytes = reinterpret_cast<const unsigned char*>( map[y].data() );
+			snapshot.insert( snapshot.end(), rowBytes, rowBytes + map.width() * sizeof( T ) );
+		}
+	}
+
+	/**
+	* @brief appends bytes of the given array to the snapshot
+	* @param snapshot storage of the generated data bytes
+	* @param data array to append
+	*/
+	template <typename T>
+	void appendArray( std::vector<unsigned char> & snapshot,
+					  const std::vector<T> & data )
+	{
+		const unsigned char * dataBytes = reinterpret_cast<const unsigned char*>( data.data() );
+		snapshot.insert( snapshot.end(), dataBytes, dataBytes + data.size() * sizeof( T ) );
+	}
+
+	/**
+	* @brief appends maps and CPU side mesh data of the generator to the snapshot
+	* @param snapshot storage of the generated data bytes
+	* @param generator generator to append
+	*/
+	void appendGenerator( std::vector<unsigned char> & snapshot,
+						  const Generator & generator )
+	{
+		appendMap( snapshot, generator.getMap() );
+		const TerrainMeshData & meshData = generator.getMeshData();
+		appendArray( snapshot, meshData.vertices );
+		appendArray( snapshot, meshData.packedVertices );
+		appendArray( snapshot, meshData.indices );
+		appendArray( snapshot, meshData.instances );
+	}
+
+	/**
+	* @brief runs terrain generation pipeline with the current world seed and number of pool threads
+	* @return bytes of all the generated maps and mesh data
+	*/
+	std::vector<unsigned char> generateSnapshot()
+	{
+		WaterGenerator water;
+		HillsGenerator hills( water.getMap() );
+		ShoreGenerator shore( water.getMap() );
+		LandGenerator land;
+		water.setup();
+		hills.setup();
+		shore.setup();
+		land.setup( shore.getMap() );
+		water.setupConsiderTerrain( land.getMap() );
+
+		std::vector<unsigned char> snapshot;
+		appendGenerator( snapshot, water );
+		appendGenerator( snapshot, hills );
+		appendGenerator( snapshot, shore );
+		appendGenerator( snapshot, land );
+		return snapshot;
+	}
+}
+
+int main( int argc,
+		  char ** argv )
+{
+	SettingsManager::init( "config.ini" );
+
+	const uint64_t SEED = argc > 1 ? std::stoull( argv[1] ) : 0;
+	RandomStream::setWorldSeed( SEED != 0 ? SEED : DEFAULT_SEED );
+	unsigned int maxThreads = argc > 2 ? (unsigned int)std::stoul( argv[2] ) : std::thread::hardware_concurrency();
+	if( maxThreads < 2 )
+	{
+		maxThreads = 2;
+	}
+	Logger::log( "world seed: %\n", std::to_string( RandomStream::getWorldSeed() ).c_str() );
+
+	ThreadPool & threadPool = ThreadPool::getInstance();
+	threadPool.setNumThreads( 1 );
+	const std::vector<unsigned char> REFERENCE = generateSnapshot();
+	Logger::log( "1 thread: % bytes generated\n", std::to_string( REFERENCE.size() ).c_str() );
+
+	size_t numMismatchedRuns = 0;
+	const unsigned int THREAD_COUNTS[] = { 2, maxThreads };
+	for( unsigned int numThreads : THREAD_COUNTS )
+	{
+		threadPool.setNumThreads( numThreads );
+		const std::vector<unsigned char> SNAPSHOT = generateSnapshot();
+		const bool IS_IDENTICAL = SNAPSHOT.size() == REFERENCE.size() &&
+								  std::memcmp( SNAPSHOT.data(), REFERENCE.data(), REFERENCE.size() ) == 0;
+		Logger::log( "% threads: % bytes generated, %\n",
+					 std::to_string( numThreads ).c_str(),
+					 std::to_string( SNAPSHOT.size() ).c_str(),
+					 IS_IDENTICAL ? "identical" : "DIFFERS from single threaded run" );
+		numMismatchedRuns += IS_IDENTICAL ? 0 : 1;
+	}
+	return numMismatchedRuns == 0 ? 0 : 1;
+}
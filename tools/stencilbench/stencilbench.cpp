@@ -0,0 +1,171 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * stencilbench.cpp
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains entry point of the stencil engine SIMD kernels check and microbenchmark
+ * @version 0.1.0
+ */
+
+
+#include "StencilEngine"
+#include "CpuFeatures"
+#include "Logger"
+
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+
+/**
+* runs every stencil engine filter with every instruction set supported by the CPU and checks that the result
+* is bit for bit identical to the scalar one, then measures time of each filter per instruction set.
+* Maps are given odd sizes, so that leftover columns of each SIMD width are processed as well.
+* Returns non-zero exit code if any SIMD result differs from the scalar one
+*/
+
+namespace
+{
+	constexpr size_t MAP_WIDTH = 387;
+	constexpr size_t MAP_HEIGHT = 261;
+	constexpr int BENCHMARK_RUNS = 50;
+
+	/**
+	* @brief generates height map with heights quantized to quarters, so that equal neighbours are frequent
+	* and comparison based filters take both of their branches, every 8th point is zero (flat land) and some are negative
+	* @param randomizer random numbers generator
+	*/
+	map2D_f generateHeightMap( std::mt19937 & randomizer )
+	{
+		std::uniform_int_distribution<int> step( -4, 12 );
+		map2D_f heightMap( MAP_WIDTH, MAP_HEIGHT );
+		for( size_t y = 0; y < MAP_HEIGHT; y++ )
+		{
+			for( size_t x = 0; x < MAP_WIDTH; x++ )
+			{
+				heightMap[y][x] = ( x * 7 + y ) % 8 == 0 ? 0.0f : step( randomizer ) * 0.25f;
+			}
+		}
+		return heightMap;
+	}
+
+	/**
+	* @brief checks whether rows of two maps are bit for bit identical, rows padding is not compared
+	*/
+	template <typename T>
+	bool isIdentical( const Heightfield2D<T> & lhs,
+					  const Heightfield2D<T> & rhs )
+	{
+		for( size_t y = 0; y < lhs.size(); y++ )
+		{
+			if( std::memcmp( lhs[y].data(), rhs[y].data(), lhs.width() * sizeof( T ) ) != 0 )
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/**
+	* @brief description of one filter check: filter is applied to copies of the source maps
+	*/
+	struct FilterRun
+	{
+		const char * name;
+		std::function<void( map2D_f & heightMap, map2D_vec3 & normals )> filter;
+	};
+}
+
+int main()
+{
+	std::mt19937 randomizer( 12345 );
+	const map2D_f SOURCE_MAP = generateHeightMap( randomizer );
+	const map2D_vec3 SOURCE_NORMALS( MAP_WIDTH, MAP_HEIGHT, glm::vec3( 0.0f, 1.0f, 0.0f ) );
+	const INSTRUCTION_SET SUPPORTED_INSTRUCTION_SET = CpuFeatures::getInstructionSet();
+	Logger::log( "CPU instruction set: %\n", CpuFeatures::getInstructionSetName( SUPPORTED_INSTRUCTION_SET ) );
+
+	const FilterRun FILTERS[] =
+	{
+		{ "smoothWeighted", []( map2D_f & heightMap, map2D_vec3 & )
+		{
+			map2D_f destination( heightMap );
+			StencilEngine::smoothWeighted( heightMap.slice( 1, 1, MAP_WIDTH - 2, MAP_HEIGHT - 2 ), destination.slice( 1, 1, MAP_WIDTH - 2, MAP_HEIGHT - 2 ), 0.5f, 0.0625f, 0.0625f );
+			heightMap.swap( destination );
+		} },
+		{ "removePlateaus", []( map2D_f & heightMap, map2D_vec3 & )
+		{
+			StencilEngine::removePlateaus( heightMap.slice( 1, 1, MAP_WIDTH - 2, MAP_HEIGHT - 2 ), 0.5f, 6 );
+		} },
+		{ "smoothSinks", []( map2D_f & heightMap, map2D_vec3 & )
+		{
+			StencilEngine::smoothSinks( heightMap.slice( 1, 1, MAP_WIDTH - 2, MAP_HEIGHT - 2 ), 6 );
+		} },
+		{ "removeIsolatedPoints", []( map2D_f & heightMap, map2D_vec3 & )
+		{
+			StencilEngine::removeIsolatedPoints( heightMap.slice( 1, 1, MAP_WIDTH - 2, MAP_HEIGHT - 2 ) );
+		} },
+		{ "markSubmergedPoints", []( map2D_f & heightMap, map2D_vec3 & )
+		{
+			StencilEngine::markSubmergedPoints( heightMap.slice( 1, 1, MAP_WIDTH - 2, MAP_HEIGHT - 2 ), 0.0f, -10.0f );
+		} },
+		{ "computeNormals", []( map2D_f & heightMap, map2D_vec3 & normals )
+		{
+			StencilEngine::computeNormals( heightMap.slice( 1, 1, MAP_WIDTH - 2, MAP_HEIGHT - 2 ), normals.slice( 1, 1, MAP_WIDTH - 2, MAP_HEIGHT - 2 ) );
+		} }
+	};
+
+	size_t numMismatches = 0;
+	for( const FilterRun & filterRun : FILTERS )
+	{
+		map2D_f referenceMap;
+		map2D_vec3 referenceNormals;
+		for( int instructionSet = ISA_SCALAR; instructionSet <= SUPPORTED_INSTRUCTION_SET; instructionSet++ )
+		{
+			StencilEngine::setInstructionSet( (INSTRUCTION_SET)instructionSet );
+			map2D_f heightMap;
+			map2D_vec3 normals;
+			long long bestTime = 0;
+			for( int run = 0; run < BENCHMARK_RUNS; run++ )
+			{
+				heightMap = SOURCE_MAP;
+				normals = SOURCE_NORMALS;
+				auto startTime = std::chrono::steady_clock::now();
+				filterRun.filter( heightMap, normals );
+				const long long DURATION = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - startTime ).count();
+				bestTime = run == 0 ? DURATION : std::min( bestTime, DURATION );
+			}
+
+			bool isMatching = true;
+			if( instructionSet == ISA_SCALAR )
+			{
+				referenceMap = heightMap;
+				referenceNormals = normals;
+			}
+			else
+			{
+				isMatching = isIdentical( heightMap, referenceMap ) &&
+							 isIdentical( normals, referenceNormals );
+				numMismatches += isMatching ? 0 : 1;
+			}
+			Logger::log( "% %: % us%\n",
+						 filterRun.name,
+						 CpuFeatures::getInstructionSetName( (INSTRUCTION_SET)instructionSet ),
+						 std::to_string( bestTime / 1000.0 ).c_str(),
+						 isMatching ? "" : ", DIFFERS from scalar result" );
+		}
+	}
+	Logger::log( "filters differing from the scalar ones: %\n", std::to_string( numMismatches ).c_str() );
+	return numMismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,490 @@
+/*
+ * Copyright 2019 Ilya Malgin
+ * worldgen.cpp
+ * This file is part of The Sugarpunky Chocolate Disaster project
+ *
+ * The Sugarpunky Chocolate Disaster project is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Sugarpunky Chocolate Disaster project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * See <http://www.gnu.org/licenses/>
+ *
+ * Purpose: contains entry point of the headless world generation tool
+ * @version 0.1.0
+ */
+
+
+#include "WaterGenerator"
+#include "HillsGenerator"
+#include "ShoreGenerator"
+#include "LandGenerator"
+#include "TerrainMasks"
+#include "RandomStream"
+#include "SettingsManager"
+#include "WorldFile"
+#include "Logger"
+#include "Frustum"
+#include "Chunk"
+#include "ChunkQuadtree"
+#include "HeightfieldOcclusion"
+#include "ChunkOcclusionCache"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <glm/common.hpp>
+#include <glm/trigonometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+/**
+* headless world generator: runs terrain generation pipeline (water, hills, shore, land, terrain masks) on CPU only,
+* without creating window or OpenGL context, thus might be used for profiling and regression checks of the generators.
+* Usage: worldgen [seed] [output world file] [hills benchmark runs]
+* If the seed is not given (or is zero) - the one from config is used, if that one is zero as well - random seed is used.
+* Generated maps are dumped to the world file (game's binary save format, terrain sections only).
+* If the number of benchmark runs is given, hills generation is additionally repeated that many times on the same water map
+* and its best and average times are printed. To benchmark larger worlds build the tool with WORLD_SIZE_OVERRIDE defined
+* (e.g. 768 for 4 times more tiles than default).
+* Terrain levels of detail are checked with a simulated camera fly-through, numbers of selected triangles are printed.
+* The same fly-through measures frustum culling time of a full grid of plant sized chunks, tested one by one and with a quadtree,
+* and hills occlusion of the chunks corners, tested with the grid lines marching and with the maximum heights pyramid
+* @note plants are not generated here as their models loading requires OpenGL
+*/
+
+namespace
+{
+	constexpr int FLY_THROUGH_FRAMES = 240;
+	constexpr float FLY_THROUGH_ALTITUDE = 8.0f;
+	constexpr float SCREEN_WIDTH = 1920.0f;
+	constexpr float SCREEN_HEIGHT = 1080.0f;
+
+	/**
+	* @brief runs given generation stage and prints its duration
+	* @param stageName name of the stage to print
+	* @param stage generation routine
+	*/
+	template <typename Stage>
+	void runStage( const char * stageName,
+				   Stage stage )
+	{
+		auto startTime = std::chrono::steady_clock::now();
+		stage();
+		auto duration = std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now() - startTime );
+		Logger::log( "%: % ms\n", stageName, std::to_string( duration.count() / 1000.0f ).c_str() );
+	}
+
+	/**
+	* @brief prints statistics of the generator's tiles and mesh data
+	* @param name name of the terrain type
+	* @param numTiles number of tiles of the generator
+	* @param meshData mesh data of the generator
+	*/
+	void printMeshStatistics( const char * name,
+							  size_t numTiles,
+							  const TerrainMeshData & meshData )
+	{
+		Logger::log( "%: % tiles, % floats of vertices, % packed vertices, % indices, % instances, % KB\n",
+					 name,
+					 std::to_string( numTiles ).c_str(),
+					 std::to_string( meshData.vertices.size() ).c_str(),
+					 std::to_string( meshData.packedVertices.size() ).c_str(),
+					 std::to_string( meshData.indices.size() ).c_str(),
+					 std::to_string( meshData.instances.size() ).c_str(),
+					 std::to_string( meshData.getByteSize() / 1024 ).c_str() );
+	}
+
+	/**
+	* @brief returns projection matrix of the fly-through camera, field of view and planes are taken from config
+	*/
+	glm::mat4 getFlyThroughProjection()
+	{
+		return glm::perspective( glm::radians( SettingsManager::getFloat( "CAMERA", "fov" ) ), SCREEN_WIDTH / SCREEN_HEIGHT,
+								 SettingsManager::getFloat( "GRAPHICS", "near_plane" ),
+								 SettingsManager::getFloat( "GRAPHICS", "far_plane" ) );
+	}
+
+	/**
+	* @brief moves the fly-through camera along the world diagonal, the camera looks along the path slightly downwards
+	* @param frame index of the frame
+	* @param projection projection matrix of the camera
+	* @param frustum frustum to update
+	* @return position of the camera
+	*/
+	glm::vec3 updateFlyThroughFrustum( int frame,
+									   const glm::mat4 & projection,
+									   Frustum & frustum )
+	{
+		const glm::vec3 PATH_START( -0.9f * HALF_WORLD_WIDTH_F, FLY_THROUGH_ALTITUDE, -0.9f * HALF_WORLD_HEIGHT_F );
+		const glm::vec3 PATH_END( 0.9f * HALF_WORLD_WIDTH_F, FLY_THROUGH_ALTITUDE, 0.9f * HALF_WORLD_HEIGHT_F );
+		const glm::vec3 VIEW_DIRECTION = glm::normalize( PATH_END - PATH_START ) + glm::vec3( 0.0f, -0.3f, 0.0f );
+		const glm::vec3 VIEW_POSITION = glm::mix( PATH_START, PATH_END, frame / float( FLY_THROUGH_FRAMES - 1 ) );
+		frustum.updateFrustum( projection * glm::lookAt( VIEW_POSITION, VIEW_POSITION + VIEW_DIRECTION, glm::vec3( 0.0f, 1.0f, 0.0f ) ) );
+		return VIEW_POSITION;
+	}
+
+	/**
+	* @brief flies the camera along the world diagonal selecting levels of detail each frame,
+	* prints full detail, selected (minimum/average/maximum over the path) number of triangles and average selection time.
+	* Screen is assumed to be 1080 pixels high, field of view and allowed pixel error are taken from config
+	* @param name name of the terrain type
+	* @param levelsOfDetail levels of detail of the terrain type
+	*/
+	void flyThroughLevelsOfDetail( const char * name,
+								   TerrainLod & levelsOfDetail )
+	{
+		const float FOV = SettingsManager::getFloat( "CAMERA", "fov" );
+		const float PROJECTION_SCALE = SCREEN_HEIGHT / ( 2.0f * std::tan( glm::radians( FOV ) * 0.5f ) );
+		const glm::mat4 PROJECTION = getFlyThroughProjection();
+		const float PIXEL_ERROR = SettingsManager::getFloat( "GRAPHICS", "terrain_lod_pixel_error" );
+		Frustum viewFrustum;
+		size_t minTriangles = levelsOfDetail.getNumFullDetailTriangles(), maxTriangles = 0, totalTriangles = 0, totalVisibleTriangles = 0;
+		size_t totalCommands = 0, totalVisibleCommands = 0;
+		long long totalTime = 0;
+		for( int frame = 0; frame < FLY_THROUGH_FRAMES; frame++ )
+		{
+			const glm::vec3 VIEW_POSITION = updateFlyThroughFrustum( frame, PROJECTION, viewFrustum );
+			auto startTime = std::chrono::steady_clock::now();
+			levelsOfDetail.selectLevels( VIEW_POSITION, PROJECTION_SCALE, PIXEL_ERROR, viewFrustum );
+			totalTime += std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - startTime ).count();
+			const size_t NUM_TRIANGLES = levelsOfDetail.getNumSelectedTriangles();
+			minTriangles = std::min( minTriangles, NUM_TRIANGLES );
+			maxTriangles = std::max( maxTriangles, NUM_TRIANGLES );
+			totalTriangles += NUM_TRIANGLES;
+			totalVisibleTriangles += levelsOfDetail.getNumVisibleTriangles();
+			totalCommands += levelsOfDetail.getNumDrawCommands();
+			totalVisibleCommands += levelsOfDetail.getNumVisibleDrawCommands();
+		}
+		Logger::log( "% levels of detail fly-through: % full detail triangles, selected min % / avg % / max %, visible avg %, "
+					 "draw commands avg % (visible %), selection and culling % us per frame\n",
+					 name,
+					 std::to_string( levelsOfDetail.getNumFullDetailTriangles() ).c_str(),
+					 std::to_string( minTriangles ).c_str(),
+					 std::to_string( totalTriangles / FLY_THROUGH_FRAMES ).c_str(),
+					 std::to_string( maxTriangles ).c_str(),
+					 std::to_string( totalVisibleTriangles / FLY_THROUGH_FRAMES ).c_str(),
+					 std::to_string( totalCommands / FLY_THROUGH_FRAMES ).c_str(),
+					 std::to_string( totalVisibleCommands / FLY_THROUGH_FRAMES ).c_str(),
+					 std::to_string( totalTime / 1000.0f / FLY_THROUGH_FRAMES ).c_str() );
+	}
+
+	/**
+	* @brief flies the camera along the world diagonal culling a full grid of plant chunks each frame,
+	* chunks are as high as hill plants over the given map. Prints average culling time and number of visible chunks
+	* of the chunk by chunk test and of the quadtree
+	* @param hillsMap map of the hills
+	*/
+	void flyThroughChunkCulling( const map2D_f & hillsMap )
+	{
+		std::vector<Chunk> chunks;
+		chunks.reserve( NUM_CHUNKS );
+		ChunkQuadtree chunksTree;
+		chunksTree.reserve( NUM_CHUNKS );
+		for( unsigned int top = 0; top < WORLD_HEIGHT; top += CHUNK_SIZE )
+		{
+			for( unsigned int left = 0; left < WORLD_WIDTH; left += CHUNK_SIZE )
+			{
+				const unsigned int RIGHT = left + CHUNK_SIZE;
+				const unsigned int BOTTOM = top + CHUNK_SIZE;
+				const float HEIGHT = std::max( { hillsMap[top][left], hillsMap[top][RIGHT], hillsMap[BOTTOM][left], hillsMap[BOTTOM][RIGHT] } ) +
+									 APPROXIMATE_HILL_PLANTS_CHUNK_HEIGHT;
+				chunks.emplace_back( left, RIGHT, top, BOTTOM, HEIGHT );
+				const glm::vec2 MID_POINT = chunks.back().getMidPoint();
+				chunksTree.addChunk( glm::vec3( MID_POINT.x - HALF_CHUNK_SIZE, 0.0f, MID_POINT.y - HALF_CHUNK_SIZE ),
+									 glm::vec3( MID_POINT.x + HALF_CHUNK_SIZE, HEIGHT, MID_POINT.y + HALF_CHUNK_SIZE ) );
+			}
+		}
+		chunksTree.build();
+
+		const glm::mat4 PROJECTION = getFlyThroughProjection();
+		Frustum viewFrustum;
+		size_t totalVisible = 0, totalTreeVisible = 0;
+		long long totalTime = 0, totalTreeTime = 0;
+		for( int frame = 0; frame < FLY_THROUGH_FRAMES; frame++ )
+		{
+			updateFlyThroughFrustum( frame, PROJECTION, viewFrustum );
+			auto startTime = std::chrono::steady_clock::now();
+			for( const Chunk & chunk : chunks )
+			{
+				totalVisible += chunk.isInsideFrustum( viewFrustum, FRUSTUM_CULLING_DISTANCE_OFFSET ) ? 1 : 0;
+			}
+			auto treeStartTime = std::chrono::steady_clock::now();
+			chunksTree.forEachVisible( viewFrustum, FRUSTUM_CULLING_DISTANCE_OFFSET, [&totalTreeVisible]( unsigned int )
+			{
+				totalTreeVisible++;
+			} );
+			auto endTime = std::chrono::steady_clock::now();
+			totalTime += std::chrono::duration_cast<std::chrono::nanoseconds>( treeStartTime - startTime ).count();
+			totalTreeTime += std::chrono::duration_cast<std::chrono::nanoseconds>( endTime - treeStartTime ).count();
+		}
+		Logger::log( "chunk culling fly-through (% chunks, % tree nodes): chunk by chunk % us, % visible avg; quadtree % us, % visible avg per frame\n",
+					 std::to_string( chunks.size() ).c_str(),
+					 std::to_string( chunksTree.getNumNodes() ).c_str(),
+					 std::to_string( totalTime / 1000.0f / FLY_THROUGH_FRAMES ).c_str(),
+					 std::to_string( totalVisible / FLY_THROUGH_FRAMES ).c_str(),
+					 std::to_string( totalTreeTime / 1000.0f / FLY_THROUGH_FRAMES ).c_str(),
+					 std::to_string( totalTreeVisible / FLY_THROUGH_FRAMES ).c_str() );
+	}
+
+	/**
+	* @brief flies the camera along the world diagonal testing hills occlusion of the corners of a full grid of plant chunks
+	* (a chunk is occluded if all its corners are) with both marching and pyramid based tests.
+	* Prints average testing time per frame, numbers of occluded chunks and number of chunks the tests disagree on
+	* @param hillsMap map of the hills
+	* @param hillsOcclusion occlusion queries built over the hills map
+	*/
+	void flyThroughHillsOcclusion( const map2D_f & hillsMap,
+								   const HeightfieldOcclusion & hillsOcclusion )
+	{
+		std::vector<glm::vec3> corners;
+		corners.reserve( NUM_CHUNKS * 4 );
+		for( unsigned int top = 0; top < WORLD_HEIGHT; top += CHUNK_SIZE )
+		{
+			for( unsigned int left = 0; left < WORLD_WIDTH; left += CHUNK_SIZE )
+			{
+				const float RIGHT = float( left + CHUNK_SIZE );
+				const float BOTTOM = float( top + CHUNK_SIZE );
+				const float HEIGHT = std::max( { hillsMap[top][left], hillsMap[top][left + CHUNK_SIZE],
+												 hillsMap[top + CHUNK_SIZE][left], hillsMap[top + CHUNK_SIZE][left + CHUNK_SIZE] } ) +
+									 APPROXIMATE_HILL_PLANTS_CHUNK_HEIGHT;
+				corners.emplace_back( (float)left, HEIGHT, BOTTOM );
+				corners.emplace_back( RIGHT, HEIGHT, BOTTOM );
+				corners.emplace_back( (float)left, HEIGHT, (float)top );
+				corners.emplace_back( RIGHT, HEIGHT, (float)top );
+			}
+		}
+
+		const glm::mat4 PROJECTION = getFlyThroughProjection();
+		Frustum viewFrustum;
+		size_t totalOccluded = 0, totalPyramidOccluded = 0, numMismatches = 0;
+		long long totalTime = 0, totalPyramidTime = 0;
+		std::vector<unsigned char> occluded( corners.size() / 4 );
+		for( int frame = 0; frame < FLY_THROUGH_FRAMES; frame++ )
+		{
+			const glm::vec3 VIEW_POSITION_ON_MAP = updateFlyThroughFrustum( frame, PROJECTION, viewFrustum ) +
+												   glm::vec3( HALF_WORLD_WIDTH_F, 0.0f, HALF_WORLD_HEIGHT_F );
+			auto startTime = std::chrono::steady_clock::now();
+			for( size_t chunkIndex = 0; chunkIndex < occluded.size(); chunkIndex++ )
+			{
+				const glm::vec3 * CHUNK_CORNERS = &corners[chunkIndex * 4];
+				occluded[chunkIndex] = hillsOcclusion.isOccludedMarching( VIEW_POSITION_ON_MAP, CHUNK_CORNERS[0] ) &&
+									   hillsOcclusion.isOccludedMarching( VIEW_POSITION_ON_MAP, CHUNK_CORNERS[1] ) &&
+									   hillsOcclusion.isOccludedMarching( VIEW_POSITION_ON_MAP, CHUNK_CORNERS[2] ) &&
+									   hillsOcclusion.isOccludedMarching( VIEW_POSITION_ON_MAP, CHUNK_CORNERS[3] );
+			}
+			auto pyramidStartTime = std::chrono::steady_clock::now();
+			for( size_t chunkIndex = 0; chunkIndex < occluded.size(); chunkIndex++ )
+			{
+				const glm::vec3 * CHUNK_CORNERS = &corners[chunkIndex * 4];
+				const bool IS_OCCLUDED = hillsOcclusion.isOccluded( VIEW_POSITION_ON_MAP, CHUNK_CORNERS[0] ) &&
+										 hillsOcclusion.isOccluded( VIEW_POSITION_ON_MAP, CHUNK_CORNERS[1] ) &&
+										 hillsOcclusion.isOccluded( VIEW_POSITION_ON_MAP, CHUNK_CORNERS[2] ) &&
+										 hillsOcclusion.isOccluded( VIEW_POSITION_ON_MAP, CHUNK_CORNERS[3] );
+				totalOccluded += occluded[chunkIndex];
+				totalPyramidOccluded += IS_OCCLUDED ? 1 : 0;
+				numMismatches += ( occluded[chunkIndex] != 0 ) != IS_OCCLUDED ? 1 : 0;
+			}
+			auto endTime = std::chrono::steady_clock::now();
+			totalTime += std::chrono::duration_cast<std::chrono::nanoseconds>( pyramidStartTime - startTime ).count();
+			totalPyramidTime += std::chrono::duration_cast<std::chrono::nanoseconds>( endTime - pyramidStartTime ).count();
+		}
+		Logger::log( "hills occlusion fly-through (% chunks, % pyramid levels): marching % us, % occluded avg; pyramid % us, % occluded avg per frame; "
+					 "% chunk results differ over the path\n",
+					 std::to_string( occluded.size() ).c_str(),
+					 std::to_string( hillsOcclusion.getNumLevels() ).c_str(),
+					 std::to_string( totalTime / 1000.0f / FLY_THROUGH_FRAMES ).c_str(),
+					 std::to_string( totalOccluded / FLY_THROUGH_FRAMES ).c_str(),
+					 std::to_string( totalPyramidTime / 1000.0f / FLY_THROUGH_FRAMES ).c_str(),
+					 std::to_string( totalPyramidOccluded / FLY_THROUGH_FRAMES ).c_str(),
+					 std::to_string( numMismatches ).c_str() );
+	}
+
+	/**
+	* @brief flies the camera along the benchmark path and updates cached hills occlusion of every hills chunk each frame
+	* the same way plants generators do it, then compares cached results with fresh ones. A chunk cached as occluded while
+	* it is visible from the current position would pop in, such chunks are counted and expected to be zero
+	* @param hillsMap map of the hills
+	* @param hillsOcclusion occlusion queries built over the hills map
+	*/
+	void flyThroughOcclusionCache( const map2D_f & hillsMap,
+								   const HeightfieldOcclusion & hillsOcclusion )
+	{
+		ChunkOcclusionCache occlusionCache( SettingsManager::getInt( "PLANT_GENERATOR", "occlusion_test_budget_us" ) );
+		occlusionCache.reserve( NUM_CHUNKS );
+		std::vector<unsigned int> chunkIndices;
+		chunkIndices.reserve( NUM_CHUNKS );
+		for( unsigned int top = 0; top < WORLD_HEIGHT; top += CHUNK_SIZE )
+		{
+			for( unsigned int left = 0; left < WORLD_WIDTH; left += CHUNK_SIZE )
+			{
+				const float HEIGHT = std::max( { hillsMap[top][left], hillsMap[top][left + CHUNK_SIZE],
+												 hillsMap[top + CHUNK_SIZE][left], hillsMap[top + CHUNK_SIZE][left + CHUNK_SIZE] } ) +
+									 APPROXIMATE_HILL_PLANTS_CHUNK_HEIGHT;
+				chunkIndices.emplace_back( (unsigned int)chunkIndices.size() );
+				occlusionCache.addChunk( (float)left, float( left + CHUNK_SIZE ), (float)top, float( top + CHUNK_SIZE ), HEIGHT );
+			}
+		}
+
+		const glm::mat4 PROJECTION = getFlyThroughProjection();
+		Frustum viewFrustum;
+		std::vector<unsigned char> occluded( chunkIndices.size() );
+		size_t totalReused = 0, totalTested = 0, totalDeferred = 0;
+		size_t totalOccluded = 0, totalCachedOccluded = 0, numPoppedIn = 0;
+		long long totalTime = 0;
+		for( int frame = 0; frame < FLY_THROUGH_FRAMES; frame++ )
+		{
+			const glm::vec3 VIEW_POSITION_ON_MAP = updateFlyThroughFrustum( frame, PROJECTION, viewFrustum ) +
+												   glm::vec3( HALF_WORLD_WIDTH_F, 0.0f, HALF_WORLD_HEIGHT_F );
+			auto startTime = std::chrono::steady_clock::now();
+			occlusionCache.update( hillsOcclusion, VIEW_POSITION_ON_MAP, chunkIndices, occluded );
+			totalTime += std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - startTime ).count();
+			const ChunkOcclusionStatistics & STATISTICS = occlusionCache.getStatistics();
+			totalReused += STATISTICS.numReused;
+			totalTested += STATISTICS.numTested;
+			totalDeferred += STATISTICS.numDeferred;
+
+			for( unsigned int top = 0, chunkIndex = 0; top < WORLD_HEIGHT; top += CHUNK_SIZE )
+			{
+				for( unsigned int left = 0; left < WORLD_WIDTH; left += CHUNK_SIZE, chunkIndex++ )
+				{
+					const float HEIGHT = std::max( { hillsMap[top][left], hillsMap[top][left + CHUNK_SIZE],
+													 hillsMap[top + CHUNK_SIZE][left], hillsMap[top + CHUNK_SIZE][left + CHUNK_SIZE] } ) +
+										 APPROXIMATE_HILL_PLANTS_CHUNK_HEIGHT;
+					const float RIGHT = float( left + CHUNK_SIZE );
+					const float BOTTOM = float( top + CHUNK_SIZE );
+					const bool IS_OCCLUDED = hillsOcclusion.isOccluded( VIEW_POSITION_ON_MAP, glm::vec3( (float)left, HEIGHT, BOTTOM ) ) &&
+											 hillsOcclusion.isOccluded( VIEW_POSITION_ON_MAP, glm::vec3( RIGHT, HEIGHT, BOTTOM ) ) &&
+											 hillsOcclusion.isOccluded( VIEW_POSITION_ON_MAP, glm::vec3( (float)left, HEIGHT, (float)top ) ) &&
+											 hillsOcclusion.isOccluded( VIEW_POSITION_ON_MAP, glm::vec3( RIGHT, HEIGHT, (float)top ) );
+					totalOccluded += IS_OCCLUDED ? 1 : 0;
+					totalCachedOccluded += occluded[chunkIndex];
+					numPoppedIn += occluded[chunkIndex] && !IS_OCCLUDED ? 1 : 0;
+				}
+			}
+		}
+		Logger::log( "hills occlusion cache fly-through: % us per frame, reused % tested % deferred % avg per frame; "
+					 "occluded % fresh / % cached avg per frame; % chunks would pop in over the path\n",
+					 std::to_string( totalTime / 1000.0f / FLY_THROUGH_FRAMES ).c_str(),
+					 std::to_string( totalReused / FLY_THROUGH_FRAMES ).c_str(),
+					 std::to_string( totalTested / FLY_THROUGH_FRAMES ).c_str(),
+					 std::to_string( totalDeferred / FLY_THROUGH_FRAMES ).c_str(),
+					 std::to_string( totalOccluded / FLY_THROUGH_FRAMES ).c_str(),
+					 std::to_string( totalCachedOccluded / FLY_THROUGH_FRAMES ).c_str(),
+					 std::to_string( numPoppedIn ).c_str() );
+	}
+
+	/**
+	* @brief repeatedly generates hills from scratch and prints best and average generation time
+	* @param waterMap map of the water tiles
+	* @param runs number of generation runs
+	*/
+	void benchmarkHills( const map2D_f & waterMap,
+						 int runs )
+	{
+		long long bestTime = 0;
+		long long totalTime = 0;
+		for( int run = 0; run < runs; run++ )
+		{
+			HillsGenerator hills( waterMap );
+			auto startTime = std::chrono::steady_clock::now();
+			hills.setup();
+			long long runTime = std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now() - startTime ).count();
+			bestTime = run == 0 ? runTime : std::min( bestTime, runTime );
+			totalTime += runTime;
+		}
+		Logger::log( "hills benchmark (% x %, % runs): best % ms, average % ms\n",
+					 std::to_string( WORLD_WIDTH ).c_str(),
+					 std::to_string( WORLD_HEIGHT ).c_str(),
+					 std::to_string( runs ).c_str(),
+					 std::to_string( bestTime / 1000.0f ).c_str(),
+					 std::to_string( totalTime / 1000.0f / runs ).c_str() );
+	}
+
+	/**
+	* @brief writes one map as a section of the world file
+	* @param writer world file writer
+	* @param id section identifier
+	* @param generator generator holding the map
+	*/
+	void dumpMap( WorldFileWriter & writer,
+				  WORLD_FILE_SECTION id,
+				  const Generator & generator )
+	{
+		writer.beginSection( id );
+		generator.serialize( writer );
+		writer.endSection();
+	}
+}
+
+int main( int argc,
+		  char ** argv )
+{
+	SettingsManager::init( "config.ini" );
+
+	uint64_t seed = argc > 1 ? std::stoull( argv[1] ) : 0;
+	if( seed == 0 )
+	{
+		seed = (uint32_t)SettingsManager::getInt( "SCENE", "world_seed" );
+	}
+	RandomStream::setWorldSeed( seed != 0 ? seed : RandomStream::generateWorldSeed() );
+	const std::string OUTPUT_FILENAME = argc > 2 ? argv[2] : "world_" + std::to_string( RandomStream::getWorldSeed() ) + ".scdw";
+	const int BENCHMARK_RUNS = argc > 3 ? std::stoi( argv[3] ) : 0;
+	Logger::log( "world seed: %\n", std::to_string( RandomStream::getWorldSeed() ).c_str() );
+
+	WaterGenerator water;
+	HillsGenerator hills( water.getMap() );
+	ShoreGenerator shore( water.getMap() );
+	LandGenerator land;
+	TerrainMasks terrainMasks;
+	HeightfieldOcclusion hillsOcclusion;
+
+	auto startTime = std::chrono::steady_clock::now();
+	runStage( "water", [&](){ water.setup(); } );
+	runStage( "hills", [&](){ hills.setup(); } );
+	runStage( "shore", [&](){ shore.setup(); } );
+	runStage( "land", [&](){ land.setup( shore.getMap() ); } );
+	runStage( "water post-process", [&](){ water.setupConsiderTerrain( land.getMap() ); } );
+	runStage( "terrain masks", [&](){ terrainMasks.build( land.getMap(), hills.getMap() ); } );
+	runStage( "hills occlusion", [&](){ hillsOcclusion.build( hills.getMap(), HILLS_OFFSET_Y ); } );
+	auto duration = std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - startTime );
+	Logger::log( "world generated in % ms\n", std::to_string( duration.count() ).c_str() );
+
+	printMeshStatistics( "water", water.getTiles().size(), water.getMeshData() );
+	printMeshStatistics( "hills", hills.getTiles().size(), hills.getMeshData() );
+	printMeshStatistics( "shore", shore.getTiles().size(), shore.getMeshData() );
+	//each flat land rectangle is an instance of the same quad
+	printMeshStatistics( "land", land.getMeshData().instances.size(), land.getMeshData() );
+	flyThroughLevelsOfDetail( "water", water.getLevelsOfDetail() );
+	flyThroughLevelsOfDetail( "hills", hills.getLevelsOfDetail() );
+	flyThroughLevelsOfDetail( "shore", shore.getLevelsOfDetail() );
+	flyThroughChunkCulling( hills.getMap() );
+	flyThroughHillsOcclusion( hills.getMap(), hillsOcclusion );
+	flyThroughOcclusionCache( hills.getMap(), hillsOcclusion );
+	Logger::log( "free cells (buildable and plantable): %\n", std::to_string( terrainMasks.get( TERRAIN_MASK_FREE_CELLS ).count() ).c_str() );
+	if( BENCHMARK_RUNS > 0 )
+	{
+		benchmarkHills( water.getMap(), BENCHMARK_RUNS );
+	}
+
+	WorldFileWriter writer;
+	dumpMap( writer, SECTION_LAND, land );
+	dumpMap( writer, SECTION_HILLS, hills );
+	dumpMap( writer, SECTION_WATER, water );
+	dumpMap( writer, SECTION_SHORE, shore );
+	writer.beginSection( SECTION_WORLD_SEED );
+	writer.write( RandomStream::getWorldSeed() );
+	writer.endSection();
+	if( !writer.saveToFile( OUTPUT_FILENAME.c_str() ) )
+	{
+		Logger::log( "Could not write world file %\n", OUTPUT_FILENAME.c_str() );
+		return 1;
+	}
+	Logger::log( "maps dumped to %\n", OUTPUT_FILENAME.c_str() );
+	return 0;
+}